@@ -0,0 +1,161 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/*! \file AsmCache.h
+ * \brief persistent cache of assembled binaries
+ */
+
+#ifndef __CLRX_ASMCACHE_H__
+#define __CLRX_ASMCACHE_H__
+
+#include <CLRX/Config.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/utils/CString.h>
+
+/// main namespace
+namespace CLRX
+{
+
+class Assembler;
+
+/// key of assembler cache entry (128-bit hash of assembler inputs)
+class AsmCacheKey
+{
+private:
+    uint64_t hash[2];
+public:
+    /// constructor (empty key)
+    AsmCacheKey();
+    
+    /// add data to key
+    void add(size_t size, const void* data);
+    /// add 64-bit value to key
+    void add(uint64_t value);
+    /// add string (with its length) to key
+    void add(const CString& str)
+    {
+        add(uint64_t(str.size()));
+        add(str.size(), str.c_str());
+    }
+    
+    /// equal operator
+    bool operator==(const AsmCacheKey& key) const
+    { return hash[0]==key.hash[0] && hash[1]==key.hash[1]; }
+    /// not-equal operator
+    bool operator!=(const AsmCacheKey& key) const
+    { return !(*this == key); }
+    
+    /// get hash part (0 or 1)
+    uint64_t getHash(cxuint i) const
+    { return hash[i]; }
+    
+    /// get key as hexadecimal string
+    std::string toString() const;
+};
+
+/// persistent (on-disk) cache of assembled binaries
+/** Cache entries are stored in files in a cache directory and they are named by key.
+ * Each entry holds binary, assembler messages and list of included files
+ * (names given in source) with hashes of their contents. While loading, names of
+ * included files are resolved again (by current directory and include directories)
+ * and entry will be used only if resolved files have same content.
+ * Entries are written atomically (by renaming temporary file) and
+ * least recently used entries are removed if cache size exceeds maximal size.
+ * Size of cache is tracked in memory and directory is scanned only if this size
+ * exceeds maximal size or after many stores (to catch entries of other processes).
+ * While scanning, orphaned temporary files (from crashed writers) are removed.
+ * Methods of this class can be called concurrently.
+ */
+class AsmBinaryCache: public NonCopyableAndNonMovable
+{
+private:
+    std::string directory;
+    uint64_t maxSize;
+    std::atomic<uint64_t> hitsNum;
+    std::atomic<uint64_t> missesNum;
+    std::mutex evictionMutex;
+    bool totalSizeKnown;    // guarded by evictionMutex
+    uint64_t totalSize;     // guarded by evictionMutex
+    cxuint storesSinceScan; // guarded by evictionMutex
+    
+    std::string getEntryPath(const AsmCacheKey& key) const;
+    void entryStored(const std::string& entryPath, uint64_t entrySize);
+    void evictEntries(const std::string& keptPath);
+public:
+    /// constructor
+    /**
+     * \param directory cache directory (created if not exists)
+     * \param maxSize maximal size of cache in bytes
+     */
+    explicit AsmBinaryCache(const std::string& directory,
+                uint64_t maxSize = UINT64_C(256)<<20);
+    
+    /// make key from source code and assembler setup (before assembling)
+    /** key includes source code, initial defsyms, include directories, device type,
+     * bitness, binary format, flags, driver version and CLRX version */
+    static AsmCacheKey makeKey(const Assembler& assembler, size_t sourceSize,
+                const char* source);
+    
+    /// load binary and messages from cache
+    /**
+     * \param key cache key
+     * \param includeDirs include directories (used to resolve included files)
+     * \param binary output binary
+     * \param messages output assembler messages
+     * \return true if entry found and it is valid
+     */
+    bool load(const AsmCacheKey& key, const std::vector<CString>& includeDirs,
+              Array<cxbyte>& binary, std::string& messages);
+    
+    /// store binary and messages in cache
+    /**
+     * \param key cache key
+     * \param binary binary
+     * \param messages assembler messages
+     * \param includedFileNames names of files included while assembling
+     *          (as given in source)
+     * \param includedFiles paths of files included while assembling (resolved names)
+     */
+    void store(const AsmCacheKey& key, const Array<cxbyte>& binary,
+               const std::string& messages,
+               const std::vector<std::string>& includedFileNames,
+               const std::vector<std::string>& includedFiles);
+    
+    /// get cache directory
+    const std::string& getDirectory() const
+    { return directory; }
+    /// get maximal size of cache
+    uint64_t getMaxSize() const
+    { return maxSize; }
+    /// get number of cache hits
+    uint64_t getHitsNum() const
+    { return hitsNum.load(); }
+    /// get number of cache misses
+    uint64_t getMissesNum() const
+    { return missesNum.load(); }
+};
+
+};
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/*! \file AsmSession.h
+ * \brief assembler session (incremental reassembling)
+ */
+
+#ifndef __CLRX_ASMSESSION_H__
+#define __CLRX_ASMSESSION_H__
+
+#include <CLRX/Config.h>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/CString.h>
+#include <CLRX/amdasm/AsmSource.h>
+#include <CLRX/amdasm/Assembler.h>
+
+/// main namespace
+namespace CLRX
+{
+
+/// assembler session
+/** Assembler session holds settings of assembler and caches filtered content of
+ * included files (by path) and macros defined in these files. Cached file will be
+ * used only if file has same timestamp, size and inode. If file was modified
+ * shortly before reading (in timestamp granularity), then also its content
+ * will be compared (by hash).
+ * Assemblers created by session share that content, hence assembling this same
+ * source many times (for example with other defined symbols) does not read and
+ * filter again unchanged included files and does not collect again their macros.
+ * Changed included file will be read again. Session is not thread-safe:
+ * assemblers created by one session must not assemble simultaneously and
+ * must be deleted before session.
+ */
+class AsmSession: public NonCopyableAndNonMovable
+{
+private:
+    friend class Assembler;
+    
+    Flags flags;
+    BinaryFormat format;
+    GPUDeviceType deviceType;
+    uint32_t driverVersion;
+    bool _64bit;
+    std::vector<CString> includeDirs;
+    std::vector<Assembler::DefSym> defSyms;
+    std::ostream& messageStream;
+    std::ostream& printStream;
+    
+    std::unordered_map<CString, RefPtr<AsmCachedFile> > cachedFiles;
+    uint64_t cachedFileHits;
+    uint64_t cachedFileMisses;
+    uint64_t cachedMacroHits;
+    
+    AsmInputFilter* openIncludeFile(const AsmSourcePos& pos, const CString& filename);
+    void storeCachedFile(const RefPtr<AsmCachedFile>& cachedFile);
+public:
+    /// constructor
+    /**
+     * \param flags assembler flags
+     * \param format output format type
+     * \param deviceType GPU device type
+     * \param msgStream stream for warnings and errors
+     * \param printStream stream for printing message by .print pseudo-ops
+     */
+    explicit AsmSession(Flags flags = 0, BinaryFormat format = BinaryFormat::AMD,
+              GPUDeviceType deviceType = GPUDeviceType::CAPE_VERDE,
+              std::ostream& msgStream = std::cerr, std::ostream& printStream = std::cout);
+    /// destructor
+    ~AsmSession();
+    
+    /// create assembler for source with session settings
+    /** creates assembler that uses files cached by this session.
+     * \param filename filename
+     * \param input input stream
+     * \param defSyms defined symbols (added after session defined symbols)
+     * \return assembler (must be deleted by caller)
+     */
+    Assembler* createAssembler(const CString& filename, std::istream& input,
+            const std::vector<Assembler::DefSym>& defSyms =
+                    std::vector<Assembler::DefSym>());
+    
+    /// get flags
+    Flags getFlags() const
+    { return flags; }
+    /// set flags
+    void setFlags(Flags flags)
+    { this->flags = flags; }
+    /// get binary format
+    BinaryFormat getBinaryFormat() const
+    { return format; }
+    /// set binary format
+    void setBinaryFormat(BinaryFormat binFormat)
+    { format = binFormat; }
+    /// get GPU device type
+    GPUDeviceType getDeviceType() const
+    { return deviceType; }
+    /// set GPU device type
+    void setDeviceType(const GPUDeviceType deviceType)
+    { this->deviceType = deviceType; }
+    /// get AMD driver version
+    uint32_t getDriverVersion() const
+    { return driverVersion; }
+    /// set AMD driver version
+    void setDriverVersion(uint32_t driverVersion)
+    { this->driverVersion = driverVersion; }
+    /// get bitness
+    bool is64Bit() const
+    { return _64bit; }
+    /// set bitness
+    void set64Bit(bool this64Bit)
+    {  _64bit = this64Bit; }
+    /// get include directory list
+    const std::vector<CString>& getIncludeDirs() const
+    { return includeDirs; }
+    /// adds include directory
+    void addIncludeDir(const CString& includeDir)
+    { includeDirs.push_back(includeDir); }
+    /// get initial defsyms
+    const std::vector<Assembler::DefSym>& getInitialDefSyms() const
+    { return defSyms; }
+    /// add initial defsym (for all assemblers created by session)
+    void addInitialDefSym(const CString& symName, uint64_t value)
+    { defSyms.push_back({symName, value}); }
+    
+    /// get number of cached files
+    size_t getCachedFilesNum() const
+    { return cachedFiles.size(); }
+    /// get number of inclusions of files read from cache
+    uint64_t getCachedFileHits() const
+    { return cachedFileHits; }
+    /// get number of inclusions of files read from file system
+    uint64_t getCachedFileMisses() const
+    { return cachedFileMisses; }
+    /// get number of macro definitions reused from cache
+    uint64_t getCachedMacroHits() const
+    { return cachedMacroHits; }
+    /// remove all cached files
+    void clearCache()
+    { cachedFiles.clear(); }
+};
+
+};
+
+#endif
@@ -30,6 +30,7 @@
 #include <ostream>
 #include <vector>
 #include <utility>
+#include <unordered_map>
 #include <memory>
 #include <CLRX/amdasm/Commons.h>
 #include <CLRX/utils/Utilities.h>
@@ -169,6 +170,34 @@ struct LineTrans
     LineNo lineNo;    ///< source code line number
 };
 
+/// prepared statement of line of macro or repetition
+/** Prepared statement holds result of first parsing of statement start
+ * (statement type and lowercased name of statement) for line of body of macro or
+ * repetition. It will be reused by next expansions of that line if line begins
+ * with same text (prefix), hence name of statement is not parsed again.
+ */
+struct AsmPreparedStmt
+{
+    /// type of prepared statement
+    enum Type: cxbyte
+    {
+        NONE = 0,       ///< not prepared yet
+        INSTRUCTION,    ///< processor instruction
+        PSEUDO_OP,      ///< pseudo-operation
+        OTHER           ///< other statement (always parsed normally)
+    };
+    Type type;      ///< type of statement
+    size_t nameOffset;  ///< offset of statement name in line
+    size_t argsOffset;  ///< offset of arguments in line (size of prefix)
+    uint64_t macrosVersion;  ///< macros version (instruction is not macro substitution)
+    CString name;   ///< lowercased name of statement
+    CString prefix; ///< text of line before arguments
+    
+    /// empty constructor
+    AsmPreparedStmt() : type(NONE), nameOffset(0), argsOffset(0), macrosVersion(0)
+    { }
+};
+
 /// assembler macro aegument
 struct AsmMacroArg
 {
@@ -195,6 +224,7 @@ private:
     std::vector<char> content;
     std::vector<SourceTrans> sourceTranslations;
     std::vector<LineTrans> colTranslations;
+    mutable std::vector<AsmPreparedStmt> preparedStmts;
 public:
     /// constructor
     AsmMacro(const AsmSourcePos& pos, const Array<AsmMacroArg>& args);
@@ -229,6 +259,9 @@ public:
     /// get number of arguments
     const size_t getArgsNum() const
     { return args.size(); }
+    /// get prepared statement for content line
+    AsmPreparedStmt* getPreparedStmt(LineNo contentLineNo) const
+    { return &preparedStmts[contentLineNo]; }
     /// get argument
     const AsmMacroArg& getArg(size_t i) const
     { return args[i]; }
@@ -252,6 +285,8 @@ protected:
     std::vector<char> content;  ///< content
     std::vector<SourceTrans> sourceTranslations;    ///< source translations
     std::vector<LineTrans> colTranslations; ///< column translations
+    /// prepared statements of content lines
+    mutable std::vector<AsmPreparedStmt> preparedStmts;
 public:
     /// constructor
     explicit AsmRepeat(const AsmSourcePos& pos, uint64_t repeatsNum);
@@ -284,6 +319,9 @@ public:
     /// get number of repetitions
     uint64_t getRepeatsNum() const
     { return repeatsNum; }
+    /// get prepared statement for content line
+    AsmPreparedStmt* getPreparedStmt(LineNo contentLineNo) const
+    { return &preparedStmts[contentLineNo]; }
 };
 
 /// assembler IRP
@@ -314,6 +352,55 @@ public:
     { return irpc; }
 };
 
+/// filtered content of source file cached by assembler session
+/** holds filtered lines of included file (that will be read again without filtering
+ * by AsmCachedInputFilter) and macros defined in that file */
+struct AsmCachedFile: public FastRefCountable
+{
+    /// filtered line
+    struct Line
+    {
+        size_t contentPos;  ///< position of line in content
+        size_t size;        ///< line size
+        size_t colTransPos; ///< position of first column translation of line
+        LineNo lineNo;      ///< current line number after reading line
+    };
+    /// macro defined in file
+    struct Macro
+    {
+        size_t endLineIndex;    ///< index of first line after macro content
+        RefPtr<const AsmMacro> macro;   ///< macro
+    };
+    
+    CString path;   ///< file path
+    FileStatus status;  ///< status of file (timestamp, size and identity)
+    /// true if file was modified shortly before reading (its content must be checked)
+    bool racy;
+    uint64_t contentHash;   ///< hash of file content (only if racy)
+    bool complete;  ///< true if all lines of file are filled
+    RefPtr<const AsmSource> source; ///< source of file (from first inclusion)
+    std::vector<char> content;  ///< content (lines terminated by newline)
+    std::vector<Line> lines;    ///< lines
+    std::vector<LineTrans> colTranslations; ///< column translations of all lines
+    /// macros defined in file (key - index of line with '.macro')
+    std::unordered_map<size_t, Macro> macros;
+    
+    /// constructor
+    AsmCachedFile(const CString& _path, const FileStatus& _status)
+            : path(_path), status(_status), racy(false), contentHash(0), complete(false)
+    { }
+    
+    /// adds filtered line
+    /**
+     * \param colTrans column translations of line
+     * \param lineNo current line number after reading line
+     * \param lineSize line size
+     * \param line line text
+     */
+    void addLine(const std::vector<LineTrans>& colTrans, LineNo lineNo,
+             size_t lineSize, const char* line);
+};
+
 /// type of AsmInputFilter
 enum class AsmInputFilterType
 {
@@ -333,14 +420,19 @@ protected:
     std::vector<char> buffer;   ///< buffer of line (can be not used)
     std::vector<LineTrans> colTranslations; ///< column translations
     LineNo lineNo;    ///< current line number
+    AsmPreparedStmt* preparedStmt; ///< prepared statement of current line
+    RefPtr<AsmCachedFile> cachedFile;   ///< cached file (read or filled by filter)
+    size_t cachedLineIndex;     ///< index of next line of cached file
     
     /// empty constructor
-    explicit AsmInputFilter(AsmInputFilterType _type):  type(_type), pos(0), lineNo(1)
+    explicit AsmInputFilter(AsmInputFilterType _type):  type(_type), pos(0), lineNo(1),
+            preparedStmt(nullptr), cachedLineIndex(0)
     { }
     /// constructor with macro substitution and source
     explicit AsmInputFilter(RefPtr<const AsmMacroSubst> _macroSubst,
            RefPtr<const AsmSource> _source, AsmInputFilterType _type)
-            : type(_type), pos(0), macroSubst(_macroSubst), source(_source), lineNo(1)
+            : type(_type), pos(0), macroSubst(_macroSubst), source(_source), lineNo(1),
+              preparedStmt(nullptr), cachedLineIndex(0)
     { }
 public:
     /// destructor
@@ -380,6 +472,15 @@ public:
     /// get input filter type
     AsmInputFilterType getType() const
     { return type; }
+    /// get prepared statement of current line (null if line from stream)
+    AsmPreparedStmt* getPreparedStmt() const
+    { return preparedStmt; }
+    /// get file cached by session which is read or filled by filter (can be null)
+    const RefPtr<AsmCachedFile>& getCachedFile() const
+    { return cachedFile; }
+    /// get index of next line of cached file
+    size_t getCachedLineIndex() const
+    { return cachedLineIndex; }
 };
 
 /// assembler input layout filter
@@ -402,7 +503,9 @@ private:
     std::istream* stream;
     LineMode mode;
     size_t stmtPos;
+    std::string streamContent;  // content of stream read to memory
     
+    const char* filterLine(Assembler& assembler, size_t& lineSize);
 public:
     /// constructor with input stream and their filename
     explicit AsmStreamInputFilter(std::istream& is, const CString& filename = "");
@@ -417,6 +520,28 @@ public:
     ~AsmStreamInputFilter();
     
     const char* readLine(Assembler& assembler, size_t& lineSize);
+    
+    /// set cached file that will be filled by filtered lines
+    /** cached file will be abandoned (set to null) if any warning or error
+     * will be printed while filtering */
+    void setCachedFile(RefPtr<AsmCachedFile> cachedFile);
+    
+    /// read whole input stream to memory (before reading any line)
+    /** next lines will be read from memory
+     * \return content of input stream (available by whole lifecycle of filter)
+     */
+    const std::string& readWholeStream();
+};
+
+/// assembler input filter for file cached by assembler session
+/** reads filtered lines from cached file without reading and filtering file again */
+class AsmCachedInputFilter: public AsmInputFilter
+{
+public:
+    /// constructor with source position (place of inclusion) and cached file
+    AsmCachedInputFilter(const AsmSourcePos& pos, RefPtr<AsmCachedFile> cachedFile);
+    
+    const char* readLine(Assembler& assembler, size_t& lineSize);
 };
 
 /// assembler macro input filter (for macro filtering)
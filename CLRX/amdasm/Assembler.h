@@ -31,10 +31,14 @@
 #include <iostream>
 #include <vector>
 #include <utility>
+#include <iterator>
+#include <memory>
+#include <initializer_list>
 #include <stack>
 #include <unordered_set>
 #include <unordered_map>
 #include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/MemoryArena.h>
 #include <CLRX/amdasm/Commons.h>
 #include <CLRX/amdasm/AsmSource.h>
 #include <CLRX/amdasm/AsmFormats.h>
@@ -82,12 +86,48 @@ enum : AsmExprTargetType
     GCNTGT_SMEMIMM
 };
 
+/// statistics of assembling phase
+struct AsmStatsPhase
+{
+    uint64_t count; ///< number of calls
+    uint64_t time;  ///< total time in nanoseconds (includes nested phases)
+};
+
+/// assembler statistics (collected only if enabled by Assembler::setStatsEnabled)
+struct AsmStats
+{
+    /// reading lines (indexed by AsmInputFilterType)
+    AsmStatsPhase readLines[3];
+    AsmStatsPhase pseudoOps;    ///< parsing pseudo-ops
+    AsmStatsPhase instructions; ///< assembling instructions by ISA assembler
+    /// assembling instructions per encoding (indexed by ISA encoding)
+    std::vector<AsmStatsPhase> encodings;
+    /// names of ISA encodings
+    const char* const* encodingNames;
+    uint64_t preassembledInstrs;    ///< instructions preassembled in parallel
+    AsmStatsPhase exprParse;    ///< parsing expressions
+    AsmStatsPhase exprEvaluate; ///< evaluating expressions
+    AsmStatsPhase setSymbol;    ///< setting symbols (with resolving of expressions)
+    AsmStatsPhase prepareBinary;    ///< preparing binary by format handler
+    AsmStatsPhase writeBinary;  ///< writing binary
+    uint64_t macroSubsts;   ///< number of macro substitutions
+    uint64_t repetitions;   ///< number of repetitions ('.rept', '.irp', '.irpc')
+    size_t maxSymbolsNum;   ///< peak number of symbols
+    size_t exprsNum;    ///< current number of parsed expressions
+    size_t maxExprsNum; ///< peak number of parsed expressions
+    
+    /// constructor (zeroes all statistics)
+    AsmStats();
+};
+
 /// ISA assembler class
 class ISAAssembler: public NonCopyableAndNonMovable
 {
 protected:
     Assembler& assembler;       ///< assembler
     
+    /// get statistics of encoding (null if statistics are disabled)
+    AsmStatsPhase* getEncodingStats(cxuint encoding) const;
     /// print warning for position pointed by line pointer
     void printWarning(const char* linePtr, const char* message);
     /// print error for position pointed by line pointer
@@ -127,6 +167,8 @@ public:
                         cxuint& regStart, cxuint& regEnd) = 0;
     /// return true if expresion of target fit to value with specified bits
     virtual bool relocationIsFit(cxuint bits, AsmExprTargetType tgtType) = 0;
+    /// get names of instruction encodings (used by statistics)
+    virtual const char* const* getEncodingNames(cxuint& encodingsNum) const = 0;
 };
 
 /// GCN arch assembler
@@ -162,6 +204,7 @@ public:
     void fillAlignment(size_t size, cxbyte* output);
     bool parseRegisterRange(const char*& linePtr, cxuint& regStart, cxuint& regEnd);
     bool relocationIsFit(cxuint bits, AsmExprTargetType tgtType);
+    const char* const* getEncodingNames(cxuint& encodingsNum) const;
 };
 
 /*
@@ -287,10 +330,162 @@ struct AsmSymbol
     { return hasValue || expression!=nullptr; }
 };
 
-/// assembler symbol map
-typedef std::unordered_map<CString, AsmSymbol> AsmSymbolMap;
 /// assembler symbol entry
-typedef AsmSymbolMap::value_type AsmSymbolEntry;
+typedef std::pair<const CString, AsmSymbol> AsmSymbolEntry;
+
+/// assembler symbol map
+/** Hash table with open addressing (linear probing). Symbol names are interned:
+ * each name is held only once (in its entry) and finding or inserting symbol by name
+ * given as pointer and length does not allocate memory for name, if symbol exists.
+ * Entries are allocated in memory arena and their addresses do not change after
+ * rehashing, hence pointers to entries are valid until entries will be erased.
+ */
+class AsmSymbolMap: public NonCopyableAndNonMovable
+{
+public:
+    typedef CString key_type;   ///< key type
+    typedef AsmSymbol mapped_type;  ///< mapped type
+    typedef AsmSymbolEntry value_type;  ///< value type
+private:
+    struct Slot
+    {
+        size_t hash;    // if no entry: 0 - empty slot, 1 - erased slot
+        AsmSymbolEntry* entry;
+    };
+    
+    std::vector<Slot> slots;
+    size_t entriesNum;
+    size_t usedSlotsNum;    // with erased slots
+    MemoryArena entryArena;
+    
+    static size_t hashName(const char* name, size_t length);
+    size_t findSlot(const char* name, size_t length, size_t hash,
+                    size_t& freeSlot) const;
+    void rehash(size_t newSlotsNum);
+public:
+    /// iterator of symbol map
+    template<typename T>
+    class IteratorBase
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category; ///< iterator category
+        typedef T value_type;   ///< value type
+        typedef ptrdiff_t difference_type;  ///< difference type
+        typedef T* pointer; ///< pointer type
+        typedef T& reference;   ///< reference type
+    private:
+        friend class AsmSymbolMap;
+        template<typename T2>
+        friend class IteratorBase;
+        
+        const Slot* slot;
+        const Slot* slotsEnd;
+        
+        IteratorBase(const Slot* _slot, const Slot* _slotsEnd)
+                : slot(_slot), slotsEnd(_slotsEnd)
+        { skipFreeSlots(); }
+        void skipFreeSlots()
+        { while (slot != slotsEnd && slot->entry == nullptr) slot++; }
+    public:
+        /// empty constructor
+        IteratorBase() : slot(nullptr), slotsEnd(nullptr)
+        { }
+        /// conversion from other iterator (to constant iterator)
+        template<typename T2>
+        IteratorBase(const IteratorBase<T2>& it) : slot(it.slot), slotsEnd(it.slotsEnd)
+        { }
+        
+        /// get entry
+        T& operator*() const
+        { return *slot->entry; }
+        /// get entry pointer
+        T* operator->() const
+        { return slot->entry; }
+        /// go to next entry
+        IteratorBase& operator++()
+        {
+            slot++;
+            skipFreeSlots();
+            return *this;
+        }
+        /// go to next entry (postincrementation)
+        IteratorBase operator++(int)
+        {
+            IteratorBase old = *this;
+            ++(*this);
+            return old;
+        }
+        /// equal operator
+        template<typename T2>
+        bool operator==(const IteratorBase<T2>& it) const
+        { return slot == it.slot; }
+        /// not-equal operator
+        template<typename T2>
+        bool operator!=(const IteratorBase<T2>& it) const
+        { return slot != it.slot; }
+    };
+    
+    typedef IteratorBase<AsmSymbolEntry> iterator; ///< iterator
+    typedef IteratorBase<const AsmSymbolEntry> const_iterator; ///< constant iterator
+    
+    /// constructor
+    AsmSymbolMap();
+    /// constructor with initial symbols
+    AsmSymbolMap(std::initializer_list<std::pair<CString, AsmSymbol> > list);
+    /// destructor
+    ~AsmSymbolMap();
+    
+    /// get number of symbols
+    size_t size() const
+    { return entriesNum; }
+    /// return true if empty
+    bool empty() const
+    { return entriesNum == 0; }
+    
+    /// get iterator to first symbol
+    iterator begin()
+    { return iterator(slots.data(), slots.data()+slots.size()); }
+    /// get iterator after last symbol
+    iterator end()
+    { return iterator(slots.data()+slots.size(), slots.data()+slots.size()); }
+    /// get iterator to first symbol
+    const_iterator begin() const
+    { return const_iterator(slots.data(), slots.data()+slots.size()); }
+    /// get iterator after last symbol
+    const_iterator end() const
+    { return const_iterator(slots.data()+slots.size(), slots.data()+slots.size()); }
+    
+    /// find symbol by name (given as pointer and length)
+    iterator find(const char* name, size_t length);
+    /// find symbol by name (given as pointer and length)
+    const_iterator find(const char* name, size_t length) const;
+    /// find symbol by name
+    iterator find(const CString& name)
+    { return find(name.c_str(), name.size()); }
+    /// find symbol by name
+    const_iterator find(const CString& name) const
+    { return find(name.c_str(), name.size()); }
+    
+    /// insert symbol if not exists
+    /**
+     * \param name symbol name
+     * \param length length of symbol name
+     * \param symbol symbol that will be inserted if symbol with same name not exists
+     * \return iterator to symbol and true if symbol has been inserted
+     */
+    std::pair<iterator, bool> insert(const char* name, size_t length,
+                const AsmSymbol& symbol = AsmSymbol());
+    /// insert symbol if not exists
+    std::pair<iterator, bool> insert(const std::pair<CString, AsmSymbol>& entry)
+    { return insert(entry.first.c_str(), entry.first.size(), entry.second); }
+    
+    /// get symbol by name (insert if not exists)
+    AsmSymbol& operator[](const CString& name)
+    { return insert(name.c_str(), name.size()).first->second; }
+    
+    /// erase symbol
+    void erase(iterator it);
+};
 
 /// target for assembler expression
 struct AsmExprTarget
@@ -358,9 +553,10 @@ private:
     size_t symOccursNum;
     bool relativeSymOccurs;
     bool baseExpr;
-    Array<AsmExprOp> ops;
-    std::unique_ptr<LineCol[]> messagePositions;    ///< for every potential message
-    std::unique_ptr<AsmExprArg[]> args;
+    MemoryArena* arena; ///< arena that holds expression arrays (null if in heap)
+    ArenaArray<AsmExprOp> ops;
+    ArenaArray<LineCol> messagePositions;    ///< for every potential message
+    ArenaArray<AsmExprArg> args;
     
     AsmSourcePos getSourcePos(size_t msgPosIndex) const
     {
@@ -374,7 +570,8 @@ private:
                TempSymbolSnapshotMap* snapshotMap, const AsmSymbolEntry& symEntry,
                AsmSymbolEntry*& outSymEntry, const AsmSourcePos* topParentSourcePos);
     
-    AsmExpression();
+    explicit AsmExpression(MemoryArena* arena);
+    void allocateArrays(size_t opsNum, size_t opPosNum, size_t argsNum);
     void setParams(size_t symOccursNum, bool relativeSymOccurs,
             size_t _opsNum, const AsmExprOp* ops, size_t opPosNum, const LineCol* opPos,
             size_t argsNum, const AsmExprArg* args, bool baseExpr = false);
@@ -390,6 +587,15 @@ public:
     /// destructor
     ~AsmExpression();
     
+    /// allocate expression in heap
+    static void* operator new(size_t size);
+    /// allocate expression in memory arena
+    static void* operator new(size_t size, MemoryArena& arena);
+    /// free expression
+    static void operator delete(void* ptr, size_t size);
+    /// free expression allocated in memory arena (if constructor throws exception)
+    static void operator delete(void* ptr, MemoryArena& arena);
+    
     /// return true if expression is empty
     bool isEmpty() const
     { return ops.empty(); }
@@ -471,11 +677,11 @@ public:
     void substituteOccurrence(AsmExprSymbolOccurrence occurrence, uint64_t value,
                   cxuint sectionId = ASMSECT_ABS);
     /// get operators list
-    const Array<AsmExprOp>& getOps() const
+    const ArenaArray<AsmExprOp>& getOps() const
     { return ops; }
     /// get argument list
     const AsmExprArg* getArgs() const
-    { return args.get(); }
+    { return args.data(); }
     /// get source position
     const AsmSourcePos& getSourcePos() const
     { return sourcePos; }
@@ -556,6 +762,9 @@ struct AsmClause
     AsmSourcePos prevIfPos; ///< position of previous if-clause
 };
 
+class AsmSession;
+class AsmParallelCode;
+
 /// main class of assembler
 class Assembler: public NonCopyableAndNonMovable
 {
@@ -576,6 +785,7 @@ private:
     friend class AsmAmdCL2Handler;
     friend class AsmGalliumHandler;
     friend class ISAAssembler;
+    friend class AsmSession;
     
     friend struct AsmParseUtils; // INTERNAL LOGIC
     friend struct AsmPseudoOps; // INTERNAL LOGIC
@@ -583,6 +793,7 @@ private:
     friend struct AsmAmdPseudoOps; // INTERNAL LOGIC
     friend struct AsmAmdCL2PseudoOps; // INTERNAL LOGIC
     friend struct GCNAsmUtils; // INTERNAL LOGIC
+    friend class AsmParallelCode; // INTERNAL LOGIC
 
     Array<CString> filenames;
     BinaryFormat format;
@@ -594,11 +805,26 @@ private:
     ISAAssembler* isaAssembler;
     std::vector<DefSym> defSyms;
     std::vector<CString> includeDirs;
+    std::vector<std::string> includedFiles;
+    std::vector<std::string> includedFileNames;
+    // statistics (null if disabled), must be destroyed after all expressions
+    std::unique_ptr<AsmStats> stats;
+    MemoryArena exprArena;  // must be destroyed after all expressions
     std::vector<AsmSection> sections;
     AsmSymbolMap symbolMap;
+    // entries of local labels ('Nb' and 'Nf' symbols) indexed by label number
+    struct LocalLabel
+    {
+        AsmSymbolEntry* prev;   // 'Nb' symbol
+        AsmSymbolEntry* next;   // 'Nf' symbol
+    };
+    std::vector<LocalLabel> localLabels;
     std::unordered_set<AsmSymbolEntry*> symbolSnapshots;
     std::vector<AsmRelocation> relocations;
     MacroMap macroMap;
+    // changed after any change in macro map (unique in process, because
+    // macros can be shared between assemblers by session)
+    uint64_t macrosVersion;
     KernelMap kernelMap;
     std::vector<AsmKernel> kernels;
     Flags flags;
@@ -623,6 +849,14 @@ private:
     std::ostream& messageStream;
     std::ostream& printStream;
     
+    AsmSession* session; // session that holds cached included files
+    
+    cxuint threadsNum;
+    // code preassembled in parallel (only if threadsNum is not 1)
+    std::unique_ptr<AsmParallelCode> parallelCode;
+    size_t symbolRefsNum;   // number of references of symbols
+    bool regRangeSymbols;   // if any symbol with register range has been defined
+    
     AsmFormatHandler* formatHandler;
     
     std::stack<AsmClause> clauses;
@@ -676,6 +910,9 @@ private:
     ParseState parseSymbol(const char*& linePtr, AsmSymbolEntry*& entry,
                    bool localLabel = true, bool dontCreateSymbol = false);
     bool skipSymbol(const char*& linePtr);
+    AsmSymbolEntry* getLocalLabel(const char* digits, size_t digitsNum, bool next);
+    // erase symbol and remove its entry from local labels table
+    void eraseSymbol(AsmSymbolMap::iterator it);
     
     bool setSymbol(AsmSymbolEntry& symEntry, uint64_t value, cxuint sectionId);
     
@@ -695,6 +932,14 @@ private:
     
     void initializeOutputFormat();
     
+    const char* readLineFromFilter();
+    
+    void prepareStmt(AsmPreparedStmt& stmt, AsmPreparedStmt::Type type,
+            const CString& name, const char* stmtPlace, const char* linePtr);
+    bool assemblePreparedStmt(const AsmPreparedStmt& stmt);
+    void assembleInstruction(const CString& mnemonic, const char* stmtPlace,
+                const char* linePtr, const char* end);
+    
     bool pushClause(const char* string, AsmClauseType clauseType)
     {
         bool included; // to ignore
@@ -708,6 +953,13 @@ private:
     /// returns false when includeLevel is too deep, throw error if failed a file opening
     bool includeFile(const char* pseudoOpPlace, const std::string& filename);
     
+    void updateMacrosVersion();
+    /// get file cached by session for current line if macros can be cached for it
+    RefPtr<AsmCachedFile> getMacroCachedFile() const;
+    /// get macro defined in current line from cached file and skip macro content
+    RefPtr<const AsmMacro> useCachedMacro(const RefPtr<AsmCachedFile>& cachedFile,
+                const std::vector<AsmMacroArg>& args);
+    
     ParseState makeMacroSubstitution(const char* string);
     
     bool parseMacroArgValue(const char*& linePtr, std::string& outStr);
@@ -830,11 +1082,38 @@ public:
     /// set flags
     void setFlags(Flags flags)
     { this->flags = flags; }
+    /// get threads number used to assemble instructions of kernels
+    cxuint getThreadsNum() const
+    { return threadsNum; }
+    /// set threads number used to assemble instructions of kernels
+    /** instructions of main source after first '.kernel' will be preassembled
+     * in parallel if threads number is not 1 (assembler reads whole main source to
+     * memory before assembling). Zero means hardware threads number. Result is
+     * same as in serial assembling.
+     * \param threadsNum threads number
+     */
+    void setThreadsNum(cxuint threadsNum)
+    { this->threadsNum = threadsNum; }
+    /// enable or disable collecting statistics (disabled by default)
+    /** statistics holds times and counts of phases of assembling and writing binary.
+     * enabling resets statistics.
+     * \param enabled true if statistics should be collected
+     */
+    void setStatsEnabled(bool enabled);
+    /// get statistics (null if collecting statistics is disabled)
+    const AsmStats* getStats() const
+    { return stats.get(); }
     /// get include directory list
     const std::vector<CString>& getIncludeDirs() const
     { return includeDirs; }
     /// adds include directory
     void addIncludeDir(const CString& includeDir);
+    /// get paths of files included by '.include' and '.incbin' (in order of inclusion)
+    const std::vector<std::string>& getIncludedFiles() const
+    { return includedFiles; }
+    /// get names (as given in source) of included files (in order of inclusion)
+    const std::vector<std::string>& getIncludedFileNames() const
+    { return includedFileNames; }
     /// get symbols map
     const AsmSymbolMap& getSymbolMap() const
     { return symbolMap; }
@@ -853,12 +1132,18 @@ public:
     
     /// add initiali defsyms
     void addInitialDefSym(const CString& symName, uint64_t value);
+    /// get initial defsyms
+    const std::vector<DefSym>& getInitialDefSyms() const
+    { return defSyms; }
     
     /// get format handler
     const AsmFormatHandler* getFormatHandler() const
     { return formatHandler; }
 };
 
+inline AsmStatsPhase* ISAAssembler::getEncodingStats(cxuint encoding) const
+{ return (assembler.stats != nullptr) ? &assembler.stats->encodings[encoding] : nullptr; }
+
 inline void ISAAssembler::printWarning(const char* linePtr, const char* message)
 { return assembler.printWarning(linePtr, message); }
 
@@ -92,9 +92,14 @@ protected:
     std::vector<CString> relSymbols;    ///< symbols used by relocations
     std::vector<std::pair<size_t, Relocation> > relocations;    ///< relocations
     FastOutputBuffer output;    ///< output buffer
+    size_t sectionCount;    ///< section counter (used by numbered labels)
+    size_t instrsNum;   ///< number of disassembled instructions
     
     /// constructor
     explicit ISADisassembler(Disassembler& disassembler, cxuint outBufSize = 500);
+    /// constructor with own output stream
+    ISADisassembler(Disassembler& disassembler, std::ostream& output,
+                    cxuint outBufSize = 500);
     
     /// write all labels before specified position
     void writeLabelsToPosition(size_t pos, LabelIter& labelIter,
@@ -115,6 +120,21 @@ public:
         this->input = input;
     }
 
+    /// set section counter (used by numbered labels)
+    void setSectionCount(size_t sectionCount)
+    { this->sectionCount = sectionCount; }
+    
+    /// get disassembler
+    Disassembler& getDisassembler() const
+    { return disassembler; }
+    
+    /// get number of disassembled instructions
+    size_t getInstrsNum() const
+    { return instrsNum; }
+    /// add to number of disassembled instructions (used by parallel disassembling)
+    void addInstrsNum(size_t num)
+    { instrsNum += num; }
+
     /// makes some things before disassemblying
     virtual void beforeDisassemble() = 0;
     /// disassembles input code
@@ -150,11 +170,16 @@ class GCNDisassembler: public ISADisassembler
 {
 private:
     bool instrOutOfCode;
+    std::vector<cxbyte> instrIndex; // decoded encoding and length for every word
+    
+    bool buildInstrIndex(bool collectLabels);
     
     friend struct GCNDisasmUtils; // INTERNAL LOGIC
 public:
     /// constructor
     GCNDisassembler(Disassembler& disassembler);
+    /// constructor with own output stream
+    GCNDisassembler(Disassembler& disassembler, std::ostream& output);
     /// destructor
     ~GCNDisassembler();
     
@@ -284,6 +309,7 @@ private:
     std::ostream& output;
     Flags flags;
     size_t sectionCount;
+    cxuint threadsNum;
 public:
     /// constructor for 32-bit GPU binary
     /**
@@ -361,6 +387,20 @@ public:
     void setFlags(Flags flags)
     { this->flags = flags; }
     
+    /// get threads number used to disassemble kernels
+    cxuint getThreadsNum() const
+    { return threadsNum; }
+    /// set threads number used to disassemble kernels
+    /** if threads number is greater than 1, then kernels will be disassembled
+     * in parallel, every kernel to own buffer. Zero - use all hardware threads.
+     * Output is same as in serial mode. */
+    void setThreadsNum(cxuint threadsNum)
+    { this->threadsNum = threadsNum; }
+    
+    /// get number of disassembled instructions
+    size_t getInstrsNum() const
+    { return isaDisassembler->getInstrsNum(); }
+    
     /// get deviceType
     GPUDeviceType getDeviceType() const;
     
@@ -0,0 +1,126 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/*! \file GCNAnalyzer.h
+ * \brief GCN static code analyzer
+ */
+
+#ifndef __CLRX_GCNANALYZER_H__
+#define __CLRX_GCNANALYZER_H__
+
+#include <CLRX/Config.h>
+#include <cstdint>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/utils/CString.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include <CLRX/amdbin/AmdCL2Binaries.h>
+#include <CLRX/amdbin/GalliumBinaries.h>
+#include <CLRX/amdasm/GCNDecoder.h>
+
+/// main namespace
+namespace CLRX
+{
+
+/// statistics of GCN code (result of static code analysis)
+/** Statistics are collected without disassembling to text: instructions are only
+ * decoded (encoding, length, operands).
+ */
+struct GCNCodeStats
+{
+    GPUArchitecture arch;   ///< GPU architecture
+    size_t instrsNum;       ///< number of instructions
+    size_t illegalInstrsNum;    ///< number of illegal instructions
+    /// number of instructions by encoding (index is GCNEncoding)
+    size_t encodingInstrsNum[size_t(GCNEncoding::MAXVAL)+1];
+    size_t scalarMemOps;    ///< number of scalar memory operations (SMRD/SMEM)
+    /// number of vector memory operations (MUBUF, MTBUF, MIMG and FLAT)
+    size_t vectorMemOps;
+    size_t localMemOps;     ///< number of local memory operations (DS)
+    size_t waitcntsNum;     ///< number of S_WAITCNT instructions
+    cxuint usedSGPRsNum;    ///< highest referenced SGPR + 1 (without VCC and others)
+    cxuint usedVGPRsNum;    ///< highest referenced VGPR + 1
+    Flags regFlags;     ///< referenced extra registers (GCN_VCC, GCN_FLAT, GCN_XNACK)
+    size_t localSize;   ///< local memory (LDS) size in bytes (from kernel setup)
+
+    /// get number of S_WAITCNT per instruction
+    double getWaitcntDensity() const
+    { return (instrsNum != 0) ? double(waitcntsNum) / double(instrsNum) : 0.0; }
+
+    /// get estimated occupancy (maximal number of waves per SIMD)
+    /**
+     * \param workGroupSize work group size (used while computing LDS limit)
+     * \return number of waves per SIMD or 0 if kernel can not be run
+     */
+    cxuint getOccupancy(cxuint workGroupSize = 256) const;
+};
+
+/// statistics of kernel code
+struct GCNKernelStats
+{
+    CString kernelName; ///< kernel name
+    GCNCodeStats stats; ///< code statistics
+};
+
+/// estimate occupancy (maximal number of waves per SIMD) of GCN kernel
+/**
+ * \param arch GPU architecture
+ * \param sgprsNum number of used SGPRs (without extra registers)
+ * \param vgprsNum number of used VGPRs
+ * \param regFlags used extra registers (GCN_VCC, GCN_FLAT, GCN_XNACK)
+ * \param localSize local memory (LDS) size in bytes
+ * \param workGroupSize work group size
+ * \return number of waves per SIMD or 0 if kernel can not be run
+ */
+extern cxuint estimateGCNOccupancy(GPUArchitecture arch, cxuint sgprsNum,
+            cxuint vgprsNum, Flags regFlags, size_t localSize,
+            cxuint workGroupSize = 256);
+
+/// analyze GCN code
+/**
+ * \param arch GPU architecture
+ * \param codeSize code size in bytes
+ * \param code code
+ * \param localSize local memory (LDS) size in bytes (set in result)
+ * \return code statistics
+ */
+extern GCNCodeStats analyzeGCNCode(GPUArchitecture arch, size_t codeSize,
+            const cxbyte* code, size_t localSize = 0);
+
+/// analyze code of kernels from AMD Catalyst binary (32-bit)
+extern std::vector<GCNKernelStats> analyzeGCNKernels(const AmdMainGPUBinary32& binary);
+
+/// analyze code of kernels from AMD Catalyst binary (64-bit)
+extern std::vector<GCNKernelStats> analyzeGCNKernels(const AmdMainGPUBinary64& binary);
+
+/// analyze code of kernels from AMD Catalyst OpenCL 2.0 binary
+extern std::vector<GCNKernelStats> analyzeGCNKernels(const AmdCL2MainGPUBinary& binary);
+
+/// analyze code of kernels from GalliumCompute binary
+/**
+ * \param deviceType GPU device type (Gallium binaries does not hold it)
+ * \param binary binary
+ * \return statistics of kernels
+ */
+extern std::vector<GCNKernelStats> analyzeGCNKernels(GPUDeviceType deviceType,
+            const GalliumBinary& binary);
+
+};
+
+#endif
@@ -0,0 +1,130 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/*! \file GCNDecoder.h
+ * \brief GCN instruction decoder (structured decoding without text output)
+ */
+
+#ifndef __CLRX_GCNDECODER_H__
+#define __CLRX_GCNDECODER_H__
+
+#include <CLRX/Config.h>
+#include <cstdint>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+
+/// main namespace
+namespace CLRX
+{
+
+/// GCN instruction encoding
+enum class GCNEncoding: cxbyte
+{
+    NONE = 0,   ///< illegal encoding
+    SOPC,
+    SOPP,
+    SOP1,
+    SOP2,
+    SOPK,
+    SMRD,
+    SMEM = SMRD,    ///< SMEM (GCN1.2) in place of SMRD
+    VOPC,
+    VOP1,
+    VOP2,
+    VOP3A,
+    VOP3B,
+    VINTRP,
+    DS,
+    MUBUF,
+    MTBUF,
+    MIMG,
+    EXP,
+    FLAT,
+    MAXVAL = FLAT   ///< last value
+};
+
+/// GCN operand type
+enum class GCNOperandType: cxbyte
+{
+    NONE = 0,   ///< no operand
+    SGPR,       ///< scalar registers (value - first register)
+    VGPR,       ///< vector registers (value - first register)
+    /// other scalar registers: VCC, EXEC, M0, FLAT_SCRATCH... (value - operand code)
+    SREG,
+    CONSTANT,   ///< inline constant (value - operand code)
+    LITERAL,    ///< literal (value - literal value)
+    IMMEDIATE   ///< immediate value (offset, SOPP/SOPK immediate)
+};
+
+/// GCN operand descriptor
+struct GCNOperand
+{
+    GCNOperandType type;    ///< operand type
+    cxbyte regsNum;     ///< number of registers (zero for immediate)
+    uint32_t value;     ///< register number, operand code or value
+};
+
+/// maximal number of operands in instruction record
+const cxuint GCN_MAX_OPERANDS = 6;
+
+/// instruction identifier for illegal instructions
+const uint16_t GCNINSTR_ILLEGAL = UINT16_MAX;
+
+/// decoded GCN instruction
+/** Operand list holds operands in order of assembler syntax (destinations first).
+ * VCC in VOPC and VOP2 instructions is included, S_CBRANCH_VCCZ and S_CBRANCH_VCCNZ
+ * have VCC as last operand. Modifiers (GLC, SLC, ABS, NEG...) and other fields
+ * can be read from instruction words.
+ */
+struct GCNInstrRecord
+{
+    size_t offset;      ///< offset of instruction in code (in bytes)
+    GCNEncoding encoding;   ///< encoding
+    cxbyte length;      ///< length in words (with literal)
+    cxbyte operandsNum;     ///< number of operands
+    uint16_t opcode;        ///< opcode
+    uint16_t instrId;   ///< instruction identifier (GCNINSTR_ILLEGAL if illegal)
+    cxuint relocIndex;  ///< index of relocation (UINT_MAX if no relocation)
+    uint32_t words[2];  ///< instruction words (second word is literal or extra word)
+    GCNOperand operands[GCN_MAX_OPERANDS];  ///< operands
+};
+
+/// decode GCN code to instruction records
+/**
+ * \param arch GPU architecture
+ * \param codeSize code size in bytes
+ * \param code code
+ * \param records output instruction records (replaced)
+ * \param relocOffsetsNum number of relocation offsets
+ * \param relocOffsets sorted offsets (in bytes) of relocations in code
+ */
+extern void decodeGCNCode(GPUArchitecture arch, size_t codeSize, const cxbyte* code,
+            std::vector<GCNInstrRecord>& records, size_t relocOffsetsNum = 0,
+            const size_t* relocOffsets = nullptr);
+
+/// get mnemonic of GCN instruction from instruction identifier
+/**
+ * \param instrId instruction identifier from instruction record
+ * \return mnemonic or null if instruction is illegal
+ */
+extern const char* getGCNInstrMnemonic(uint16_t instrId);
+
+};
+
+#endif
@@ -208,6 +208,7 @@ class AmdGPUBinGenerator: public NonCopyableAndNonMovable
 private:
     bool manageable;
     const AmdInput* input;
+    cxuint threadsNum;
     
     void generateInternal(std::ostream* osPtr, std::vector<char>* vPtr,
              Array<cxbyte>* aPtr) const;
@@ -241,6 +242,19 @@ public:
     /// set input
     void setInput(const AmdInput* input);
     
+    /// get threads number used to prepare kernels
+    cxuint getThreadsNum() const
+    { return threadsNum; }
+    
+    /// set threads number used to prepare kernels
+    /** kernels (metadatas, CALNotes and inner binaries) are prepared in parallel
+     * if threads number is not 1. Zero means hardware threads number.
+     * Generated binary is same as binary generated serially.
+     * \param threadsNum threads number
+     */
+    void setThreadsNum(cxuint threadsNum)
+    { this->threadsNum = threadsNum; }
+    
     /// generates binary
     void generate(Array<cxbyte>& array) const;
     
@@ -29,6 +29,7 @@
 #include <string>
 #include <utility>
 #include <memory>
+#include <mutex>
 #include <CLRX/amdbin/Elf.h>
 #include <CLRX/amdbin/ElfBinaries.h>
 #include <CLRX/utils/MemAccess.h>
@@ -56,6 +57,9 @@ enum : Flags {
     AMDBIN_INNER_CREATE_CALNOTES = 0x10000, ///< create CAL notes for AMD inner GPU binary
     
     AMDBIN_CREATE_ALL = ELF_CREATE_ALL | 0xffff0, ///< all AMD binaries creation flags
+    /** create inner binaries and kernel informations on demand (when they are
+     * requested first time), only for AMD main GPU binaries */
+    AMDBIN_CREATE_LAZY = 0x100000,
     AMDBIN_INNER_SHIFT = 12 ///< shift for convert inner binary flags into elf binary flags
 };
 
@@ -403,14 +407,18 @@ public:
     typedef Array<std::pair<CString, size_t> > KernelInfoMap;
 protected:
     AmdMainType type;   ///< type of binaries
-    Array<KernelInfo> kernelInfos;    ///< kernel informations
+    mutable Array<KernelInfo> kernelInfos;    ///< kernel informations
     KernelInfoMap kernelInfosMap;   ///< kernel informations map
+    bool lazyKernelInfos;   ///< if true, kernel informations are created on demand
     
     CString driverInfo; ///< driver info string
     CString compileOptions; ///< compiler options string
     
     /// constructor
     explicit AmdMainBinaryBase(AmdMainType type);
+    
+    /// create kernel information on demand (internal use only)
+    virtual void createKernelInfo(size_t index) const;
 public:
     virtual ~AmdMainBinaryBase();
     
@@ -422,13 +430,16 @@ public:
     size_t getKernelInfosNum() const
     { return kernelInfos.size(); }
     
-    /// get kernel informations array
-    const KernelInfo* getKernelInfos() const
-    { return kernelInfos.data(); }
+    /// get kernel informations array (creates all kernel informations if lazy)
+    const KernelInfo* getKernelInfos() const;
     
     /// get kernel information with specified index
     const KernelInfo& getKernelInfo(size_t index) const
-    { return kernelInfos[index]; }
+    {
+        if (lazyKernelInfos)
+            createKernelInfo(index);
+        return kernelInfos[index];
+    }
     
     /// get kernel information with specified kernel name (requires kernel info map)
     const KernelInfo& getKernelInfo(const char* name) const;
@@ -466,8 +477,22 @@ public:
     /// kernel header map type
     typedef Array<std::pair<CString, size_t> > KernelHeaderMap;
 protected:
-    Array<AmdInnerGPUBinary32> innerBinaries;   ///< inner binaries
+    /// inner binary code location (used by lazy creation)
+    struct InnerBinaryCode
+    {
+        CString kernelName; ///< kernel name
+        size_t size;    ///< size
+        cxbyte* code;   ///< code
+    };
+    
+    mutable Array<AmdInnerGPUBinary32> innerBinaries;   ///< inner binaries
     InnerBinaryMap innerBinaryMap;  ///< inner binary map
+    Array<InnerBinaryCode> innerBinaryCodes;    ///< inner binary codes (if lazy)
+    Flags innerBinaryFlags; ///< creation flags for inner binaries
+    /// once flags for lazy created inner binaries
+    std::unique_ptr<std::once_flag[]> innerBinaryOnceFlags;
+    /// once flags for lazy created kernel informations
+    std::unique_ptr<std::once_flag[]> kernelInfoOnceFlags;
     std::unique_ptr<AmdGPUKernelMetadata[]> metadatas;  ///< AMD metadatas
     Array<AmdGPUKernelHeader> kernelHeaders;    ///< kernel headers
     KernelHeaderMap kernelHeaderMap;    ///< kernel header map
@@ -480,6 +505,11 @@ protected:
     /// initialize main gpu binary (internal use only)
     template<typename Types>
     void initMainGPUBinary(typename Types::ElfBinary& binary);
+    
+    /// create inner binary on demand (internal use only)
+    void createInnerBinary(size_t index) const;
+    /// create kernel information on demand (internal use only)
+    void createKernelInfo(size_t index) const;
 public:
     /// get number of inner binaries
     size_t getInnerBinariesNum() const
@@ -487,11 +517,19 @@ public:
     
     /// get inner binary with specified index
     AmdInnerGPUBinary32& getInnerBinary(size_t index)
-    { return innerBinaries[index]; }
+    {
+        if (innerBinaryOnceFlags)
+            createInnerBinary(index);
+        return innerBinaries[index];
+    }
     
     /// get inner binary with specified index
     const AmdInnerGPUBinary32& getInnerBinary(size_t index) const
-    { return innerBinaries[index]; }
+    {
+        if (innerBinaryOnceFlags)
+            createInnerBinary(index);
+        return innerBinaries[index];
+    }
     
     /// get inner binary with specified name (requires inner binary map)
     const AmdInnerGPUBinary32& getInnerBinary(const char* name) const;
@@ -586,6 +624,10 @@ public:
     /// return true if binary has kernel header map
     bool hasKernelHeaderMap() const
     { return (creationFlags & AMDBIN_CREATE_KERNELHEADERMAP) != 0; }
+    
+    /// returns true if inner binaries and kernel infos are created on demand
+    bool isLazy() const
+    { return (creationFlags & AMDBIN_CREATE_LAZY) != 0; }
 };
 
 /// AMD main binary for GPU for 64-bit mode
@@ -627,6 +669,10 @@ public:
     /// return true if binary has kernel header map
     bool hasKernelHeaderMap() const
     { return (creationFlags & AMDBIN_CREATE_KERNELHEADERMAP) != 0; }
+    
+    /// returns true if inner binaries and kernel infos are created on demand
+    bool isLazy() const
+    { return (creationFlags & AMDBIN_CREATE_LAZY) != 0; }
 };
 
 /// AMD main binary for X86 systems
@@ -142,6 +142,7 @@ class AmdCL2GPUBinGenerator: public NonCopyableAndNonMovable
 private:
     bool manageable;
     const AmdCL2Input* input;
+    cxuint threadsNum;
     
     void generateInternal(std::ostream* osPtr, std::vector<char>* vPtr,
              Array<cxbyte>* aPtr) const;
@@ -178,6 +179,19 @@ public:
     /// set input
     void setInput(const AmdCL2Input* input);
     
+    /// get threads number used to prepare kernels
+    cxuint getThreadsNum() const
+    { return threadsNum; }
+    
+    /// set threads number used to prepare kernels
+    /** kernels are prepared in parallel if threads number is not 1.
+     * Zero means hardware threads number. Generated binary is same as
+     * binary generated serially.
+     * \param threadsNum threads number
+     */
+    void setThreadsNum(cxuint threadsNum)
+    { this->threadsNum = threadsNum; }
+    
     /// generates binary
     void generate(Array<cxbyte>& array) const;
     
@@ -739,6 +739,17 @@ public:
         FastOutputBuffer fob(256, os);
         generate(fob);
     }
+    
+    /// generate binary directly to memory
+    /**
+     * \param outputSize size of output memory (must be not smaller than binary size)
+     * \param output output memory
+     */
+    void generate(size_t outputSize, cxbyte* output)
+    {
+        FastOutputBuffer fob(outputSize, output);
+        generate(fob);
+    }
 };
 
 extern template class ElfBinaryGenTemplate<Elf32Types>;
@@ -347,51 +347,83 @@ public:
 };
 
 /// fast and direct output buffer
+/** Output buffer works in two modes: stream mode (data are written through small
+ * buffer to output stream) and memory mode (data are written directly to
+ * preallocated memory without any copying). In memory mode writing
+ * beyond the memory size throws exception.
+ */
 class FastOutputBuffer: public NonCopyableAndNonMovable
 {
 private:
-    std::ostream& os;
-    cxuint endPos;
-    cxuint bufSize;
-    std::unique_ptr<char[]> buffer;
+    std::ostream* os;
+    size_t endPos;
+    size_t bufSize;
+    std::unique_ptr<char[]> bufferHolder;
+    char* buffer;
     uint64_t written;
+    
+    static void throwMemoryOverflow();
+    void checkMemoryOverflow() const
+    {
+        if (os == nullptr)
+            throwMemoryOverflow();
+    }
 public:
     /// constructor with inBufSize and output
     /**
      * \param _bufSize max buffer size
      * \param output output stream
      */
-    FastOutputBuffer(cxuint _bufSize, std::ostream& output) : os(output), endPos(0),
-            bufSize(_bufSize), buffer(new char[_bufSize]), written(0)
+    FastOutputBuffer(size_t _bufSize, std::ostream& output) : os(&output), endPos(0),
+            bufSize(_bufSize), bufferHolder(new char[_bufSize]),
+            buffer(bufferHolder.get()), written(0)
+    { }
+    /// constructor with output memory (memory mode)
+    /**
+     * \param outputSize size of output memory
+     * \param output output memory
+     */
+    FastOutputBuffer(size_t outputSize, cxbyte* output) : os(nullptr), endPos(0),
+            bufSize(outputSize), buffer(reinterpret_cast<char*>(output)), written(0)
     { }
     /// destructor
     ~FastOutputBuffer()
     { 
         flush();
-        os.flush();
+        if (os != nullptr)
+            os->flush();
     }
     
+    /// return true if output buffer writes directly to memory
+    bool isMemoryBuffer() const
+    { return os == nullptr; }
+    
     /// get written bytes number
     uint64_t getWritten() const
     { return written; }
     
-    /// write output buffer
+    /// write output buffer (does nothing in memory mode)
     void flush()
     {
-        os.write(buffer.get(), endPos);
+        if (os == nullptr)
+            return;
+        os->write(buffer, endPos);
         endPos = 0;
     }
     
     /// reserve and write out buffer if too few free bytes in buffer
-    char* reserve(cxuint toReserve)
+    char* reserve(size_t toReserve)
     {
         if (toReserve > bufSize-endPos)
+        {
+            checkMemoryOverflow();
             flush();
-        return buffer.get() + endPos;
+        }
+        return buffer + endPos;
     }
     
     /// finish reservation and go forward
-    void forward(cxuint toWrite)
+    void forward(size_t toWrite)
     {
         endPos += toWrite;
         written += toWrite;
@@ -402,12 +434,13 @@ public:
     {
         if (length > bufSize-endPos)
         {
+            checkMemoryOverflow();
             flush();
-            os.write(string, length);
+            os->write(string, length);
         }
         else
         {
-            ::memcpy(buffer.get()+endPos, string, length);
+            ::memcpy(buffer+endPos, string, length);
             endPos += length;
         }
         written += length;
@@ -431,7 +464,10 @@ public:
     void put(char c)
     {
         if (endPos == bufSize)
+        {
+            checkMemoryOverflow();
             flush();
+        }
         buffer[endPos++] = c;
         written++;
     }
@@ -439,11 +475,20 @@ public:
     /// fill (put num c character)
     void fill(size_t num, char c)
     {
+        if (os == nullptr)
+        {
+            if (num > bufSize-endPos)
+                checkMemoryOverflow();
+            ::memset(buffer+endPos, c, num);
+            endPos += num;
+            written += num;
+            return;
+        }
         size_t count = num;
         while (count != 0)
         {
              size_t bufNum = std::min(size_t(bufSize-endPos), count);
-             ::memset(buffer.get()+endPos, c, bufNum);
+             ::memset(buffer+endPos, c, bufNum);
              count -= bufNum;
              endPos += bufNum;
              if (endPos == bufSize)
@@ -452,12 +497,12 @@ public:
         written += num;
     }
     
-    /// get output stream
+    /// get output stream (only in stream mode)
     const std::ostream& getOStream() const
-    { return os; }
-    /// get output stream
+    { return *os; }
+    /// get output stream (only in stream mode)
     std::ostream& getOStream()
-    { return os; }
+    { return *os; }
 };
 
 };
@@ -0,0 +1,246 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/*! \file MemoryArena.h
+ * \brief memory arena (bump allocator)
+ */
+
+#ifndef __CLRX_MEMORYARENA_H__
+#define __CLRX_MEMORYARENA_H__
+
+#include <CLRX/Config.h>
+#include <cstddef>
+#include <cstdint>
+#include <CLRX/utils/Utilities.h>
+
+/// main namespace
+namespace CLRX
+{
+
+/// memory arena (bump allocator)
+/** Memory arena allocates memory blocks from big chunks and releases all chunks
+ * at destruction. Freed small blocks are kept in free lists (one list per size) and
+ * they will be reused by next allocations with same size. Medium blocks are rounded
+ * to power of two and kept in free lists (one list per power of two). Big blocks
+ * (greater than quarter of chunk) are allocated in heap and freed immediately.
+ * Arena is not thread-safe.
+ */
+class MemoryArena: public NonCopyableAndNonMovable
+{
+public:
+    /// alignment of allocated blocks
+    static const size_t alignment = 8;
+    /// maximal size of small block (reused by free list of this same size)
+    static const size_t maxReusedSize = 512;
+    /// maximal number of free lists of medium blocks (powers of two above 512)
+    static const cxuint mediumListsNum = 32;
+private:
+    struct Chunk
+    {
+        Chunk* next;
+        size_t size;
+    };
+    struct BigBlock
+    {
+        BigBlock* prev;
+        BigBlock* next;
+        size_t size;
+    };
+    union FreeBlock
+    {
+        FreeBlock* next;
+        uint64_t dummy; // for alignment
+    };
+    
+    size_t chunkSize;
+    size_t maxMediumSize;   // greatest power of two not greater than chunkSize/4
+    Chunk* chunks;
+    BigBlock* bigBlocks;
+    cxbyte* current;
+    cxbyte* end;
+    FreeBlock* freeLists[maxReusedSize/alignment];
+    FreeBlock* mediumFreeLists[mediumListsNum];
+    size_t allocationsNum;
+    size_t chunksNum;
+    size_t allocatedSize;
+    
+    // get index of medium free list and round size to power of two
+    static cxuint getMediumIndex(size_t& size)
+    {
+        cxuint index = 0;
+        size_t classSize = maxReusedSize<<1;
+        for (; classSize < size; classSize <<= 1, index++);
+        size = classSize;
+        return index;
+    }
+    
+    void* allocateSlow(size_t size);
+    void* allocateBig(size_t size);
+    void deallocateBig(void* ptr);
+public:
+    /// constructor
+    /**
+     * \param chunkSize size of single chunk
+     */
+    explicit MemoryArena(size_t chunkSize = 65536);
+    /// destructor (frees all chunks)
+    ~MemoryArena();
+    
+    /// round size to alignment
+    static size_t alignSize(size_t size)
+    { return (size + alignment-1) & ~(alignment-1); }
+    
+    /// allocate block
+    void* allocate(size_t size)
+    {
+        size = alignSize(size);
+        allocationsNum++;
+        FreeBlock** freeList = nullptr;
+        if (size <= maxReusedSize)
+        {
+            if (size != 0)
+                freeList = &freeLists[size/alignment-1];
+        }
+        else if (size <= maxMediumSize)
+            freeList = &mediumFreeLists[getMediumIndex(size)];
+        else
+            return allocateBig(size);
+        if (freeList != nullptr && *freeList != nullptr)
+        {   // reuse freed block
+            FreeBlock* block = *freeList;
+            *freeList = block->next;
+            return block;
+        }
+        if (size_t(end-current) >= size)
+        {
+            void* ptr = current;
+            current += size;
+            return ptr;
+        }
+        return allocateSlow(size);
+    }
+    
+    /// free block (size must be same as size passed to allocate)
+    /** small and medium blocks will be reused, big blocks are returned to heap */
+    void deallocate(void* ptr, size_t size)
+    {
+        size = alignSize(size);
+        if (ptr == nullptr || size == 0)
+            return;
+        FreeBlock** freeList;
+        if (size <= maxReusedSize)
+            freeList = &freeLists[size/alignment-1];
+        else if (size <= maxMediumSize)
+            freeList = &mediumFreeLists[getMediumIndex(size)];
+        else
+        {
+            deallocateBig(ptr);
+            return;
+        }
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(ptr);
+        block->next = *freeList;
+        *freeList = block;
+    }
+    
+    /// allocate array of elements (elements must be trivially destructible)
+    template<typename T>
+    T* allocateArray(size_t n)
+    { return (n != 0) ? reinterpret_cast<T*>(allocate(sizeof(T)*n)) : nullptr; }
+    
+    /// free array of elements
+    template<typename T>
+    void deallocateArray(T* ptr, size_t n)
+    { deallocate(ptr, sizeof(T)*n); }
+    
+    /// get number of allocations
+    size_t getAllocationsNum() const
+    { return allocationsNum; }
+    /// get number of allocated chunks (without big blocks)
+    size_t getChunksNum() const
+    { return chunksNum; }
+    /// get total size of memory held by arena (chunks and big blocks)
+    size_t getAllocatedSize() const
+    { return allocatedSize; }
+};
+
+/// array which elements are held in memory arena or in heap (does not own elements)
+template<typename T>
+class ArenaArray
+{
+public:
+    typedef T* iterator;    ///< type of iterator
+    typedef const T* const_iterator;    ///< type of constant iterator
+    typedef T element_type; ///< element type
+private:
+    T* ptr;
+    size_t n;
+public:
+    /// empty constructor
+    ArenaArray() : ptr(nullptr), n(0)
+    { }
+    /// constructor
+    ArenaArray(T* _ptr, size_t _n) : ptr(_ptr), n(_n)
+    { }
+    
+    /// return true if empty
+    bool empty() const
+    { return n == 0; }
+    /// get size
+    size_t size() const
+    { return n; }
+    /// get data
+    T* data()
+    { return ptr; }
+    /// get data
+    const T* data() const
+    { return ptr; }
+    /// get iterator to first element
+    T* begin()
+    { return ptr; }
+    /// get iterator to first element
+    const T* begin() const
+    { return ptr; }
+    /// get iterator after last element
+    T* end()
+    { return ptr+n; }
+    /// get iterator after last element
+    const T* end() const
+    { return ptr+n; }
+    /// get first element
+    T& front()
+    { return ptr[0]; }
+    /// get first element
+    const T& front() const
+    { return ptr[0]; }
+    /// get last element
+    T& back()
+    { return ptr[n-1]; }
+    /// get last element
+    const T& back() const
+    { return ptr[n-1]; }
+    /// operator of indexing
+    T& operator[](size_t i)
+    { return ptr[i]; }
+    /// operator of indexing
+    const T& operator[](size_t i) const
+    { return ptr[i]; }
+};
+
+};
+
+#endif
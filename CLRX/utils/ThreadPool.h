@@ -0,0 +1,102 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/*! \file ThreadPool.h
+ * \brief simple thread pool
+ */
+
+#ifndef __CLRX_THREADPOOL_H__
+#define __CLRX_THREADPOOL_H__
+
+#include <CLRX/Config.h>
+#include <cstddef>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+
+/// main namespace
+namespace CLRX
+{
+
+/// simple thread pool
+/** The thread pool holds worker threads and runs on them indexed tasks.
+ * The calling thread also executes tasks. If any task throws exception, the run
+ * method rethrows exception from task with lowest index after finishing all tasks.
+ */
+class ThreadPool: public NonCopyableAndNonMovable
+{
+private:
+    std::vector<std::thread> threads;
+    std::mutex runMutex;    // serializes run calls
+    std::mutex mutex;
+    std::condition_variable workCond;
+    std::condition_variable doneCond;
+    const std::function<void(size_t)>* task;
+    size_t tasksNum;
+    std::atomic<size_t> nextTask;
+    cxuint busyWorkers;
+    uint64_t generation;
+    bool stopping;
+    std::exception_ptr exception;
+    size_t exceptionIndex;
+    
+    void workerRoutine();
+    void executeTasks(const std::function<void(size_t)>& curTask, size_t curTasksNum);
+public:
+    /// constructor
+    /**
+     * \param threadsNum threads number (with calling thread),
+     * if zero then use hardware threads number
+     */
+    explicit ThreadPool(cxuint threadsNum = 0);
+    /// destructor
+    ~ThreadPool();
+    
+    /// get threads number (with calling thread)
+    cxuint getThreadsNum() const
+    { return threads.size()+1; }
+    
+    /// run tasks and wait for finish
+    /**
+     * \param tasksNum tasks number
+     * \param task task routine that get index of task
+     */
+    void run(size_t tasksNum, const std::function<void(size_t)>& task);
+    
+    /// get hardware threads number (at least 1)
+    static cxuint getHardwareThreadsNum();
+    
+    /// run tasks in temporary thread pool or serially
+    /** tasks are executed serially in calling thread if threadsNum is 1 or
+     * if there are fewer than two tasks
+     * \param threadsNum threads number (if zero then use hardware threads number)
+     * \param tasksNum tasks number
+     * \param task task routine that get index of task
+     */
+    static void runTasks(cxuint threadsNum, size_t tasksNum,
+                const std::function<void(size_t)>& task);
+};
+
+};
+
+#endif
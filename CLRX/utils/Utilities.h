@@ -610,6 +610,8 @@ size_t itocstrCStyle<cxllong>(cxllong value, char* str, size_t maxSize, cxuint r
 { return iXtocstrCStyle(value, str, maxSize, radix, width, prefix); }
 
 /// format float value to string
+/** value is printed with shortest number of digits that gives same value after
+ * parsing (if many, then nearest to exact value is choosen) */
 extern size_t fXtocstrCStyle(uint64_t value, char* str, size_t maxSize,
         bool scientific, cxuint expBits, cxuint mantisaBits);
 
@@ -690,6 +692,43 @@ extern bool isDirectory(const char* path);
  */
 extern Array<cxbyte> loadDataFromFile(const char* filename);
 
+/// file mapped to memory
+/** Regular files are mapped privately (copy-on-write), hence any writes to data
+ * do not change file. Files that can not be mapped (pipes, devices) will be loaded
+ * by loadDataFromFile. Data can be passed directly to binary constructors.
+ */
+class MappedFile: public NonCopyableAndNonMovable
+{
+private:
+    size_t dataSize;
+    cxbyte* mappedData;
+    Array<cxbyte> loadedData;
+#ifdef HAVE_WINDOWS
+    void* mapHandle;
+#endif
+public:
+    /// constructor
+    /**
+     * \param filename filename
+     */
+    explicit MappedFile(const char* filename);
+    /// destructor
+    ~MappedFile();
+
+    /// get data size
+    size_t size() const
+    { return dataSize; }
+    /// get data (can be null if file is empty)
+    cxbyte* data()
+    { return (mappedData!=nullptr) ? mappedData : loadedData.data(); }
+    /// get data (can be null if file is empty)
+    const cxbyte* data() const
+    { return (mappedData!=nullptr) ? mappedData : loadedData.data(); }
+    /// returns true if file has been mapped (false if loaded to memory)
+    bool isMapped() const
+    { return mappedData!=nullptr; }
+};
+
 /// convert to filesystem from unified path (with slashes)
 extern void filesystemPath(char* path);
 /// convert to filesystem from unified path (with slashes)
@@ -701,10 +740,36 @@ extern std::string joinPaths(const std::string& path1, const std::string& path2)
 /// get file timestamp in nanosecond since Unix epoch
 extern uint64_t getFileTimestamp(const char* filename);
 
+/// file status (used to detect changes of file)
+struct FileStatus
+{
+    uint64_t timestamp; ///< modification time in nanoseconds since Unix epoch
+    uint64_t size;      ///< file size
+    uint64_t inode;     ///< inode number (zero if not supported by system)
+    uint64_t device;    ///< device number
+    
+    /// equal operator
+    bool operator==(const FileStatus& status) const
+    { return timestamp==status.timestamp && size==status.size &&
+            inode==status.inode && device==status.device; }
+    /// not-equal operator
+    bool operator!=(const FileStatus& status) const
+    { return !(*this == status); }
+};
+
+/// get file status (modification time, size and identity)
+extern FileStatus getFileStatus(const char* filename);
+
 /// get user's home directory
 extern std::string getHomeDir();
 /// create directory
 extern void makeDir(const char* dirname);
+/// list regular files in directory
+/**
+ * \param dirname directory name
+ * \return sorted names of regular files (without directory path)
+ */
+extern std::vector<std::string> listDirectory(const char* dirname);
 
 /*
  * Reference support
@@ -1532,7 +1532,7 @@ bool AsmAmdCL2Handler::resolveRelocation(const AsmExpression* expr, uint64_t& ou
                 "code section");
         return false;
     }
-    const Array<AsmExprOp>& ops = expr->getOps();
+    const ArenaArray<AsmExprOp>& ops = expr->getOps();
     
     size_t relOpStart = 0;
     size_t relOpEnd = ops.size();
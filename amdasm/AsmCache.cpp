@@ -0,0 +1,419 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#ifdef HAVE_WINDOWS
+#include <windows.h>
+#include <sys/utime.h>
+#else
+#include <unistd.h>
+#include <utime.h>
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <functional>
+#include <chrono>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/AsmCache.h>
+
+using namespace CLRX;
+
+static const char asmCacheMagic[8] = { 'C', 'L', 'R', 'X', 'A', 'S', 'M', 'C' };
+static const uint32_t asmCacheFormatVersion = 2;
+static const char* asmCacheEntryExt = ".clrxbin";
+static const char* asmCacheTempExt = ".clrxbin.tmp";
+// number of stores after which directory will be scanned again
+static const cxuint asmCacheRescanPeriod = 64;
+// age (in nanoseconds) after which temporary file is treated as orphaned
+static const uint64_t asmCacheOrphanAge = UINT64_C(3600)*1000000000U;
+
+/*
+ * AsmCacheKey
+ */
+
+AsmCacheKey::AsmCacheKey()
+{
+    hash[0] = UINT64_C(0xcbf29ce484222325);
+    hash[1] = UINT64_C(0x6a09e667f3bcc909);
+}
+
+void AsmCacheKey::add(size_t size, const void* data)
+{
+    const cxbyte* bytes = reinterpret_cast<const cxbyte*>(data);
+    uint64_t h0 = hash[0], h1 = hash[1];
+    for (size_t i = 0; i < size; i++)
+    {
+        // FNV-1a
+        h0 = (h0 ^ bytes[i]) * UINT64_C(0x100000001b3);
+        // multiply-rotate
+        h1 = (h1 ^ bytes[i]) * UINT64_C(0x9e3779b97f4a7c15);
+        h1 = (h1<<31) | (h1>>33);
+    }
+    hash[0] = h0;
+    hash[1] = h1;
+}
+
+void AsmCacheKey::add(uint64_t value)
+{
+    cxbyte bytes[8];
+    for (cxuint i = 0; i < 8; i++)
+        bytes[i] = value>>(i<<3);
+    add(8, bytes);
+}
+
+std::string AsmCacheKey::toString() const
+{
+    static const char* hexDigits = "0123456789abcdef";
+    std::string out(32, '0');
+    for (cxuint k = 0; k < 2; k++)
+        for (cxuint i = 0; i < 16; i++)
+            out[k*16+i] = hexDigits[(hash[k]>>((15-i)<<2)) & 15];
+    return out;
+}
+
+/*
+ * AsmBinaryCache
+ */
+
+AsmBinaryCache::AsmBinaryCache(const std::string& _directory, uint64_t _maxSize)
+        : directory(_directory), maxSize(_maxSize), hitsNum(0), missesNum(0),
+          totalSizeKnown(false), totalSize(0), storesSinceScan(0)
+{
+    try
+    { makeDir(directory.c_str()); }
+    catch(const Exception& ex)
+    { } // ignore if exists
+}
+
+AsmCacheKey AsmBinaryCache::makeKey(const Assembler& assembler, size_t sourceSize,
+                const char* source)
+{
+    AsmCacheKey key;
+    key.add(CString(CLRX_VERSION));
+    key.add(uint64_t(asmCacheFormatVersion));
+    key.add(uint64_t(sourceSize));
+    key.add(sourceSize, source);
+    key.add(uint64_t(assembler.getInitialDefSyms().size()));
+    for (const Assembler::DefSym& defSym: assembler.getInitialDefSyms())
+    {
+        key.add(defSym.first);
+        key.add(defSym.second);
+    }
+    key.add(uint64_t(assembler.getIncludeDirs().size()));
+    for (const CString& incDir: assembler.getIncludeDirs())
+        key.add(incDir);
+    key.add(uint64_t(assembler.getDeviceType()));
+    key.add(uint64_t(assembler.is64Bit()));
+    key.add(uint64_t(assembler.getBinaryFormat()));
+    key.add(uint64_t(assembler.getFlags()));
+    key.add(uint64_t(assembler.getDriverVersion()));
+    return key;
+}
+
+std::string AsmBinaryCache::getEntryPath(const AsmCacheKey& key) const
+{
+    return joinPaths(directory, key.toString() + asmCacheEntryExt);
+}
+
+static void putU32(std::string& out, uint32_t value)
+{
+    for (cxuint i = 0; i < 4; i++)
+        out.push_back(char(value>>(i<<3)));
+}
+
+static void putU64(std::string& out, uint64_t value)
+{
+    for (cxuint i = 0; i < 8; i++)
+        out.push_back(char(value>>(i<<3)));
+}
+
+/// reader of cache entry, throws exception if data is truncated
+struct CLRX_INTERNAL AsmCacheEntryReader
+{
+    const cxbyte* data;
+    size_t size;
+    size_t pos;
+    
+    const cxbyte* get(size_t n)
+    {
+        if (n > size-pos)
+            throw Exception("Cache entry is truncated");
+        const cxbyte* ptr = data+pos;
+        pos += n;
+        return ptr;
+    }
+    uint32_t getU32()
+    {
+        const cxbyte* p = get(4);
+        uint32_t value = 0;
+        for (cxuint i = 0; i < 4; i++)
+            value |= uint32_t(p[i])<<(i<<3);
+        return value;
+    }
+    uint64_t getU64()
+    {
+        const cxbyte* p = get(8);
+        uint64_t value = 0;
+        for (cxuint i = 0; i < 8; i++)
+            value |= uint64_t(p[i])<<(i<<3);
+        return value;
+    }
+};
+
+static AsmCacheKey hashFileContent(const char* filename)
+{
+    Array<cxbyte> content = loadDataFromFile(filename);
+    AsmCacheKey key;
+    key.add(uint64_t(content.size()));
+    key.add(content.size(), content.data());
+    return key;
+}
+
+/* resolve included file in this same way as assembler (current directory,
+ * next include directories) and hash its content */
+static AsmCacheKey hashIncludedFile(const std::string& name,
+            const std::vector<CString>& includeDirs)
+{
+    try
+    { return hashFileContent(name.c_str()); }
+    catch(const Exception& ex)
+    { }
+    for (const CString& incDir: includeDirs)
+    {
+        std::string incDirPath(incDir.c_str());
+        filesystemPath(incDirPath);
+        try
+        { return hashFileContent(joinPaths(incDirPath, name).c_str()); }
+        catch(const Exception& ex)
+        { }
+    }
+    throw Exception("Included file not found");
+}
+
+bool AsmBinaryCache::load(const AsmCacheKey& key, const std::vector<CString>& includeDirs,
+                Array<cxbyte>& binary, std::string& messages)
+{
+    const std::string entryPath = getEntryPath(key);
+    try
+    {
+        MappedFile entryFile(entryPath.c_str());
+        AsmCacheEntryReader reader{ entryFile.data(), entryFile.size(), 0 };
+        if (::memcmp(reader.get(8), asmCacheMagic, 8) != 0 ||
+            reader.getU32() != asmCacheFormatVersion)
+            throw Exception("Wrong cache entry format");
+        if (reader.getU64() != key.getHash(0) || reader.getU64() != key.getHash(1))
+            throw Exception("Cache entry key doesn't match");
+        
+        /* check whether included files resolve to files with same content
+         * (file can be changed or shadowed by file in other include directory) */
+        const uint32_t includedFilesNum = reader.getU32();
+        for (uint32_t i = 0; i < includedFilesNum; i++)
+        {
+            const uint32_t nameSize = reader.getU32();
+            const char* namePtr = reinterpret_cast<const char*>(reader.get(nameSize));
+            const std::string name(namePtr, namePtr + nameSize);
+            const uint64_t hash0 = reader.getU64();
+            const uint64_t hash1 = reader.getU64();
+            const AsmCacheKey contentHash = hashIncludedFile(name, includeDirs);
+            if (contentHash.getHash(0) != hash0 || contentHash.getHash(1) != hash1)
+                throw Exception("Included file has been changed");
+        }
+        
+        const uint64_t messagesSize = reader.getU64();
+        if (messagesSize > SIZE_MAX)
+            throw Exception("Cache entry is truncated");
+        const char* messagesPtr = reinterpret_cast<const char*>(
+                    reader.get(messagesSize));
+        const uint64_t binarySize = reader.getU64();
+        if (binarySize > SIZE_MAX)
+            throw Exception("Cache entry is truncated");
+        const cxbyte* binaryPtr = reader.get(binarySize);
+        
+        messages.assign(messagesPtr, messagesPtr + messagesSize);
+        binary.assign(binaryPtr, binaryPtr + binarySize);
+    }
+    catch(const Exception& ex)
+    {   // entry not found or invalid
+        missesNum.fetch_add(1);
+        return false;
+    }
+    // update access time (for LRU eviction)
+    ::utime(entryPath.c_str(), nullptr);
+    hitsNum.fetch_add(1);
+    return true;
+}
+
+void AsmBinaryCache::store(const AsmCacheKey& key, const Array<cxbyte>& binary,
+            const std::string& messages, const std::vector<std::string>& includedFileNames,
+            const std::vector<std::string>& includedFiles)
+{
+    if (includedFileNames.size() != includedFiles.size())
+        return;
+    std::string content;
+    content.append(asmCacheMagic, 8);
+    putU32(content, asmCacheFormatVersion);
+    putU64(content, key.getHash(0));
+    putU64(content, key.getHash(1));
+    putU32(content, includedFiles.size());
+    for (size_t i = 0; i < includedFiles.size(); i++)
+    {
+        // hash content of resolved file, name will be resolved while loading
+        AsmCacheKey contentHash;
+        try
+        { contentHash = hashFileContent(includedFiles[i].c_str()); }
+        catch(const Exception& ex)
+        { return; } // included file is not readable, do not store
+        putU32(content, includedFileNames[i].size());
+        content.append(includedFileNames[i]);
+        putU64(content, contentHash.getHash(0));
+        putU64(content, contentHash.getHash(1));
+    }
+    putU64(content, messages.size());
+    content.append(messages);
+    putU64(content, binary.size());
+    content.append(reinterpret_cast<const char*>(binary.data()), binary.size());
+    
+    // write to temporary file and rename to entry file (atomic replacing)
+    const std::string entryPath = getEntryPath(key);
+    char suffixBuf[48];
+#ifdef HAVE_WINDOWS
+    const uint64_t processId = GetCurrentProcessId();
+#else
+    const uint64_t processId = ::getpid();
+#endif
+    ::snprintf(suffixBuf, sizeof suffixBuf, ".tmp%llu_%llx", (unsigned long long)processId,
+            (unsigned long long)std::hash<std::thread::id>()(std::this_thread::get_id()));
+    const std::string tmpPath = entryPath + suffixBuf;
+    {
+        std::ofstream ofs(tmpPath.c_str(), std::ios::binary);
+        if (!ofs)
+            return; // silently ignore if cache is not writeable
+        ofs.write(content.data(), content.size());
+        ofs.close();
+        if (!ofs)
+        {
+            ::remove(tmpPath.c_str());
+            return;
+        }
+    }
+    if (::rename(tmpPath.c_str(), entryPath.c_str()) != 0)
+    {
+#ifdef HAVE_WINDOWS
+        // rename does not replace existing file
+        ::remove(entryPath.c_str());
+        if (::rename(tmpPath.c_str(), entryPath.c_str()) != 0)
+#endif
+        {
+            ::remove(tmpPath.c_str());
+            return;
+        }
+    }
+    entryStored(entryPath, content.size());
+}
+
+void AsmBinaryCache::entryStored(const std::string& entryPath, uint64_t entrySize)
+{
+    std::lock_guard<std::mutex> lock(evictionMutex);
+    if (totalSizeKnown && storesSinceScan < asmCacheRescanPeriod)
+    {   /* estimated size (replaced entry is counted twice, hence estimated size
+         * can only be greater than real size) */
+        totalSize += entrySize;
+        storesSinceScan++;
+        if (totalSize <= maxSize)
+            return;
+    }
+    evictEntries(entryPath);
+}
+
+// called with locked evictionMutex
+void AsmBinaryCache::evictEntries(const std::string& keptPath)
+{
+    struct EntryInfo
+    {
+        std::string path;
+        uint64_t size;
+        uint64_t accessTime;
+    };
+    std::vector<EntryInfo> entries;
+    uint64_t scannedSize = 0;
+    std::vector<std::string> names;
+    try
+    { names = listDirectory(directory.c_str()); }
+    catch(const Exception& ex)
+    { return; }
+    const uint64_t currentTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    const size_t extLen = ::strlen(asmCacheEntryExt);
+    for (const std::string& name: names)
+    {
+        if (name.find(asmCacheTempExt) != std::string::npos)
+        {   // remove temporary file left by crashed writer
+            const std::string path = joinPaths(directory, name);
+            try
+            {
+                const uint64_t modTime = getFileTimestamp(path.c_str());
+                if (modTime + asmCacheOrphanAge < currentTime)
+                    ::remove(path.c_str());
+            }
+            catch(const Exception& ex)
+            { }
+            continue;
+        }
+        if (name.size() <= extLen ||
+            name.compare(name.size()-extLen, extLen, asmCacheEntryExt) != 0)
+            continue; // not cache entry
+        const std::string path = joinPaths(directory, name);
+        struct stat stBuf;
+        if (::stat(path.c_str(), &stBuf) != 0)
+            continue;
+        scannedSize += stBuf.st_size;
+        if (path == keptPath)
+            continue; // do not remove just stored entry
+        uint64_t accessTime = 0;
+        try
+        { accessTime = getFileTimestamp(path.c_str()); }
+        catch(const Exception& ex)
+        { }
+        entries.push_back({ path, uint64_t(stBuf.st_size), accessTime });
+    }
+    totalSize = scannedSize;
+    totalSizeKnown = true;
+    storesSinceScan = 0;
+    if (totalSize <= maxSize)
+        return;
+    // remove least recently used entries
+    std::sort(entries.begin(), entries.end(),
+            [](const EntryInfo& a, const EntryInfo& b)
+            { return a.accessTime < b.accessTime; });
+    for (const EntryInfo& entry: entries)
+    {
+        if (totalSize <= maxSize)
+            break;
+        if (::remove(entry.path.c_str()) == 0)
+            totalSize -= entry.size;
+    }
+}
@@ -18,6 +18,7 @@
  */
 
 #include <CLRX/Config.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <stack>
@@ -39,10 +40,98 @@ static const uint64_t operatorWithMessage =
         (1ULL<<int(AsmExprOp::SHIFT_LEFT)) | (1ULL<<int(AsmExprOp::SHIFT_RIGHT)) |
         (1ULL<<int(AsmExprOp::SIGNED_SHIFT_RIGHT));
 
-AsmExpression::AsmExpression() : symOccursNum(0), relativeSymOccurs(false),
-            baseExpr(false)
+/// header of expression allocation, holds arena (or null if expression is in heap).
+/// expression counted in statistics is always allocated in expression arena
+/// of assembler, hence header holds that assembler with lowest bit set
+union CLRX_INTERNAL AsmExprAllocHeader
+{
+    uintptr_t arenaOrAssembler;
+    uint64_t dummy; // for alignment
+};
+
+void* AsmExpression::operator new(size_t size)
+{
+    AsmExprAllocHeader* header = reinterpret_cast<AsmExprAllocHeader*>(
+                ::operator new(sizeof(AsmExprAllocHeader) + size));
+    header->arenaOrAssembler = 0;
+    return header+1;
+}
+
+void* AsmExpression::operator new(size_t size, MemoryArena& arena)
+{
+    AsmExprAllocHeader* header = reinterpret_cast<AsmExprAllocHeader*>(
+                arena.allocate(sizeof(AsmExprAllocHeader) + size));
+    header->arenaOrAssembler = reinterpret_cast<uintptr_t>(&arena);
+    return header+1;
+}
+
+// count expression (allocated in expression arena) in statistics of assembler
+static void countExpression(AsmExpression* expr, Assembler& assembler, AsmStats& stats)
+{
+    reinterpret_cast<AsmExprAllocHeader*>(expr)[-1].arenaOrAssembler =
+                reinterpret_cast<uintptr_t>(&assembler) | 1;
+    stats.exprsNum++;
+    stats.maxExprsNum = std::max(stats.maxExprsNum, stats.exprsNum);
+}
+
+void AsmExpression::operator delete(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+        return;
+    AsmExprAllocHeader* header = reinterpret_cast<AsmExprAllocHeader*>(ptr)-1;
+    MemoryArena* arena;
+    if ((header->arenaOrAssembler & 1) != 0)
+    {   // uncount expression (statistics can be reset after counting)
+        Assembler* assembler = reinterpret_cast<Assembler*>(
+                    header->arenaOrAssembler & ~uintptr_t(1));
+        AsmStats* stats = assembler->stats.get();
+        if (stats != nullptr && stats->exprsNum != 0)
+            stats->exprsNum--;
+        arena = &assembler->exprArena;
+    }
+    else
+        arena = reinterpret_cast<MemoryArena*>(header->arenaOrAssembler);
+    if (arena != nullptr)
+        arena->deallocate(header, sizeof(AsmExprAllocHeader) + size);
+    else
+        ::operator delete(header);
+}
+
+void AsmExpression::operator delete(void* ptr, MemoryArena& arena)
+{
+    arena.deallocate(reinterpret_cast<AsmExprAllocHeader*>(ptr)-1,
+                sizeof(AsmExprAllocHeader) + sizeof(AsmExpression));
+}
+
+// allocate array of expression from arena or from heap (if arena is null)
+template<typename T>
+static inline ArenaArray<T> allocateExprArray(MemoryArena* arena, size_t n)
+{
+    if (n == 0)
+        return ArenaArray<T>();
+    return ArenaArray<T>((arena != nullptr) ? arena->allocateArray<T>(n) : new T[n], n);
+}
+
+template<typename T>
+static inline void freeExprArray(MemoryArena* arena, ArenaArray<T>& array)
+{
+    if (arena != nullptr)
+        arena->deallocateArray(array.data(), array.size());
+    else
+        delete[] array.data();
+}
+
+AsmExpression::AsmExpression(MemoryArena* _arena) : symOccursNum(0),
+            relativeSymOccurs(false), baseExpr(false), arena(_arena)
 { }
 
+void AsmExpression::allocateArrays(size_t opsNum, size_t opPosNum, size_t argsNum)
+{
+    ops = allocateExprArray<AsmExprOp>(arena, opsNum);
+    messagePositions = allocateExprArray<LineCol>(arena, opPosNum);
+    args = allocateExprArray<AsmExprArg>(arena, argsNum);
+}
+
 void AsmExpression::setParams(size_t _symOccursNum,
           bool _relativeSymOccurs, size_t _opsNum, const AsmExprOp* _ops, size_t _opPosNum,
           const LineCol* _opPos, size_t _argsNum, const AsmExprArg* _args, bool _baseExpr)
@@ -50,11 +139,10 @@ void AsmExpression::setParams(size_t _symOccursNum,
     symOccursNum = _symOccursNum;
     relativeSymOccurs = _relativeSymOccurs;
     baseExpr = _baseExpr;
-    args.reset(new AsmExprArg[_argsNum]);
-    ops.assign(_ops, _ops+_opsNum);
-    messagePositions.reset(new LineCol[_opPosNum]);
-    std::copy(_args, _args+_argsNum, args.get());
-    std::copy(_opPos, _opPos+_opPosNum, messagePositions.get());
+    allocateArrays(_opsNum, _opPosNum, _argsNum);
+    std::copy(_ops, _ops+_opsNum, ops.data());
+    std::copy(_args, _args+_argsNum, args.data());
+    std::copy(_opPos, _opPos+_opPosNum, messagePositions.data());
 }
 
 AsmExpression::AsmExpression(const AsmSourcePos& _pos, size_t _symOccursNum,
@@ -62,22 +150,21 @@ AsmExpression::AsmExpression(const AsmSourcePos& _pos, size_t _symOccursNum,
           const LineCol* _opPos, size_t _argsNum, const AsmExprArg* _args,
           bool _baseExpr)
         : sourcePos(_pos), symOccursNum(_symOccursNum), relativeSymOccurs(_relSymOccurs),
-          baseExpr(_baseExpr), ops(_ops, _ops+_opsNum)
+          baseExpr(_baseExpr), arena(nullptr)
 {
-    args.reset(new AsmExprArg[_argsNum]);
-    messagePositions.reset(new LineCol[_opPosNum]);
-    std::copy(_args, _args+_argsNum, args.get());
-    std::copy(_opPos, _opPos+_opPosNum, messagePositions.get());
+    allocateArrays(_opsNum, _opPosNum, _argsNum);
+    std::copy(_ops, _ops+_opsNum, ops.data());
+    std::copy(_args, _args+_argsNum, args.data());
+    std::copy(_opPos, _opPos+_opPosNum, messagePositions.data());
 }
 
 AsmExpression::AsmExpression(const AsmSourcePos& _pos, size_t _symOccursNum,
             bool _relSymOccurs, size_t _opsNum, size_t _opPosNum, size_t _argsNum,
             bool _baseExpr)
         : sourcePos(_pos), symOccursNum(_symOccursNum), relativeSymOccurs(_relSymOccurs),
-          baseExpr(_baseExpr), ops(_opsNum)
+          baseExpr(_baseExpr), arena(nullptr)
 {
-    args.reset(new AsmExprArg[_argsNum]);
-    messagePositions.reset(new LineCol[_opPosNum]);
+    allocateArrays(_opsNum, _opPosNum, _argsNum);
 }
 
 AsmExpression::~AsmExpression()
@@ -93,11 +180,15 @@ AsmExpression::~AsmExpression()
             else if (ops[i]==AsmExprOp::ARG_VALUE)
                 j++;
     }
+    freeExprArray(arena, ops);
+    freeExprArray(arena, messagePositions);
+    freeExprArray(arena, args);
 }
 
 bool AsmExpression::evaluate(Assembler& assembler, size_t opStart, size_t opEnd,
                  uint64_t& outValue, cxuint& outSectionId) const
 {
+    AsmStatsTimer timer(assembler.stats.get(), &AsmStats::exprEvaluate);
     if (symOccursNum != 0)
         throw Exception("Expression can't be evaluated if symbols still are unresolved!");
     
@@ -821,7 +912,8 @@ class CLRX_INTERNAL CLRX::AsmExpression::TempSymbolSnapshotMap:
 
 AsmExpression* AsmExpression::createForSnapshot(const AsmSourcePos* exprSourcePos) const
 {
-    std::unique_ptr<AsmExpression> expr(new AsmExpression);
+    std::unique_ptr<AsmExpression> expr((arena != nullptr) ?
+            new(*arena) AsmExpression(arena) : new AsmExpression(nullptr));
     size_t argsNum = 0;
     size_t msgPosNum = 0;
     for (AsmExprOp op: ops)
@@ -831,12 +923,11 @@ AsmExpression* AsmExpression::createForSnapshot(const AsmSourcePos* exprSourcePo
             msgPosNum++;
     expr->sourcePos = sourcePos;
     expr->sourcePos.exprSourcePos = exprSourcePos;
-    expr->ops = ops;
-    expr->args.reset(new AsmExprArg[argsNum]);
-    std::copy(args.get(), args.get()+argsNum, expr->args.get());
-    expr->messagePositions.reset(new LineCol[msgPosNum]);
-    std::copy(messagePositions.get(), messagePositions.get()+msgPosNum,
-              expr->messagePositions.get());
+    expr->allocateArrays(ops.size(), msgPosNum, argsNum);
+    std::copy(ops.begin(), ops.end(), expr->ops.data());
+    std::copy(args.data(), args.data()+argsNum, expr->args.data());
+    std::copy(messagePositions.data(), messagePositions.data()+msgPosNum,
+              expr->messagePositions.data());
     return expr.release();
 }
 
@@ -905,7 +996,7 @@ bool AsmExpression::makeSymbolSnapshot(Assembler& assembler,
         AsmExpression* expr = se.entry->second.expression;
         const size_t opsSize = expr->ops.size();
         
-        AsmExprArg* args = expr->args.get();
+        AsmExprArg* args = expr->args.data();
         AsmExprOp* ops = expr->ops.data();
         if (opIndex < opsSize)
         {
@@ -1045,6 +1136,7 @@ bool AsmExpression::makeSymbolSnapshot(Assembler& assembler,
 AsmExpression* AsmExpression::parse(Assembler& assembler, const char*& linePtr,
             bool makeBase, bool dontResolveSymbolsLater)
 {
+    AsmStatsTimer timer(assembler.stats.get(), &AsmStats::exprParse);
     struct ConExprOpEntry
     {
         AsmExprOp op;
@@ -1076,7 +1168,10 @@ AsmExpression* AsmExpression::parse(Assembler& assembler, const char*& linePtr,
         XT_ARG = 2
     };
     ExpectedToken expectedToken = XT_FIRST;
-    std::unique_ptr<AsmExpression> expr(new AsmExpression);
+    std::unique_ptr<AsmExpression> expr(
+            new(assembler.exprArena) AsmExpression(&assembler.exprArena));
+    if (assembler.stats != nullptr)
+        countExpression(expr.get(), assembler, *assembler.stats);
     expr->sourcePos = assembler.getSourcePos(startString);
     
     while (linePtr != end)
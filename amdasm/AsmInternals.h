@@ -22,8 +22,11 @@
 
 #include <CLRX/Config.h>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <utility>
+#include <vector>
+#include <chrono>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/amdasm/Assembler.h>
 #include "GCNInternals.h"
@@ -40,8 +43,8 @@ static inline void skipCharAndSpacesToEnd(const char*& string, const char* end)
 static inline void skipSpacesToEnd(const char*& string, const char* end)
 { while (string!=end && *string == ' ') string++; }
 
-// extract sybol name or argument name or other identifier
-static inline CString extractSymName(const char*& string, const char* end,
+// skip sybol name or argument name or other identifier
+static inline void skipSymName(const char*& string, const char* end,
            bool localLabelSymName)
 {
     const char* startString = string;
@@ -61,6 +64,14 @@ static inline CString extractSymName(const char*& string, const char* end,
                 string = startString;
         }
     }
+}
+
+// extract sybol name or argument name or other identifier
+static inline CString extractSymName(const char*& string, const char* end,
+           bool localLabelSymName)
+{
+    const char* startString = string;
+    skipSymName(string, end, localLabelSymName);
     return CString(startString, string);
 }
 
@@ -512,6 +523,89 @@ struct CLRX_INTERNAL AsmAmdCL2PseudoOps: AsmPseudoOps
                       const char* linePtr);
 };
 
+// measures time of phase of assembling and counts its calls (if phase is not null)
+class CLRX_INTERNAL AsmStatsTimer: public NonCopyableAndNonMovable
+{
+private:
+    AsmStatsPhase* phase;
+    std::chrono::steady_clock::time_point startTime;
+public:
+    explicit AsmStatsTimer(AsmStatsPhase* _phase) : phase(_phase)
+    {
+        if (phase != nullptr)
+            startTime = std::chrono::steady_clock::now();
+    }
+    // phase of statistics (if statistics are enabled)
+    AsmStatsTimer(AsmStats* stats, AsmStatsPhase AsmStats::*statsPhase)
+            : AsmStatsTimer((stats != nullptr) ? &(stats->*statsPhase) : nullptr)
+    { }
+    ~AsmStatsTimer()
+    {
+        if (phase != nullptr)
+        {
+            phase->count++;
+            phase->time += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - startTime).count();
+        }
+    }
+};
+
+/* code of instructions preassembled in parallel before main (serial) assembling.
+ * code is stored only for statements that does not refer to any symbol and
+ * does not print any message. hence, this code is same as code of statement with
+ * same text assembled in main assembling. codes are held by chunks of source in
+ * order of lines, and they are found by line number of main source and
+ * text of statement */
+class CLRX_INTERNAL AsmParallelCode: public NonCopyableAndNonMovable
+{
+public:
+    struct Code
+    {
+        LineNo lineNo;  // line number of main source after reading line
+        size_t textPos; // text of statement in chunk texts
+        size_t textSize;
+        cxbyte size;
+        cxbyte data[16];
+        cxuint regs[2];     // allocated registers by instruction
+        Flags regFlags;
+    };
+private:
+    // chunk of main source preassembled by separate assembler
+    struct Chunk
+    {
+        const char* start;
+        const char* end;
+        LineNo lineNo;  // first line of chunk in main source
+        std::string texts;  // texts of statements
+        std::vector<Code> codes;
+    };
+    
+    const AsmInputFilter* mainFilter;
+    const std::string& content;    // content of main source
+    GPUDeviceType deviceType;   // device type of ISA assembler
+    bool buggyFPLit;
+    bool preassembled;
+    std::vector<Chunk> chunks;
+    size_t curChunk;    // chunk of current line of main source
+    size_t curCode;     // first code of current line of main source in chunk
+    
+    void preassembleChunk(const Assembler& asmr, Chunk& chunk) const;
+public:
+    AsmParallelCode(const AsmInputFilter* mainFilter, const std::string& content);
+    
+    void setDeviceType(GPUDeviceType deviceType)
+    { this->deviceType = deviceType; }
+    
+    // return true if statements of main source can be preassembled from current line
+    bool canPreassemble(const Assembler& asmr) const
+    { return !preassembled && asmr.currentInputFilter == mainFilter; }
+    // preassemble statements of main source after specified line
+    void preassemble(const Assembler& asmr, LineNo lineNo);
+    
+    // find code of statement (returns null if not found or can not be used)
+    const Code* findCode(const Assembler& asmr, const char* stmtPlace, const char* end);
+};
+
 extern CLRX_INTERNAL cxbyte cstrtobyte(const char*& str, const char* end);
 
 extern const cxbyte tokenCharTable[96] CLRX_INTERNAL;
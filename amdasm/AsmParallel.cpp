@@ -0,0 +1,189 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <cstring>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/InputOutput.h>
+#include <CLRX/utils/ThreadPool.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "AsmInternals.h"
+
+using namespace CLRX;
+
+/* chunks of source are assembled by separate assemblers. new chunk begins at
+ * '.kernel' statement (if current chunk have enough lines) or if
+ * current chunk is too long */
+static const size_t minChunkLinesNum = 256;
+static const size_t maxChunkLinesNum = 4096;
+
+static const char* skipLine(const char* ptr, const char* end)
+{
+    const char* next = reinterpret_cast<const char*>(::memchr(ptr, '\n', end-ptr));
+    return (next != nullptr) ? next+1 : end;
+}
+
+static bool isKernelStatement(const char* ptr, const char* end)
+{
+    while (ptr != end && (*ptr == ' ' || *ptr == '\t')) ptr++;
+    if (end-ptr < 8)
+        return false;
+    for (cxuint i = 0; i < 7; i++)
+        if (toLower(ptr[i]) != ".kernel"[i])
+            return false;
+    return ptr[7] == ' ' || ptr[7] == '\t';
+}
+
+AsmParallelCode::AsmParallelCode(const AsmInputFilter* _mainFilter,
+            const std::string& _content) : mainFilter(_mainFilter), content(_content),
+            deviceType(GPUDeviceType::CAPE_VERDE), buggyFPLit(false), preassembled(false),
+            curChunk(0), curCode(0)
+{ }
+
+void AsmParallelCode::preassembleChunk(const Assembler& asmr, Chunk& chunk) const
+{
+    ArrayIStream input(chunk.end-chunk.start, chunk.start);
+    std::ostringstream msgStream;
+    std::ostringstream printStream;
+    Assembler chunkAsmr("", input, asmr.flags, BinaryFormat::RAWCODE, deviceType,
+                msgStream, printStream);
+    chunkAsmr.buggyFPLit = buggyFPLit;
+    chunkAsmr.initializeOutputFormat();
+    ISAAssembler* isaAssembler = chunkAsmr.isaAssembler;
+    std::vector<cxbyte>& output = chunkAsmr.sections[chunkAsmr.currentSection].content;
+    
+    while (chunkAsmr.readLine())
+    {   // parse statement in this same way as in main assembling
+        const char* linePtr = chunkAsmr.line;
+        const char* end = chunkAsmr.line+chunkAsmr.lineSize;
+        skipSpacesToEnd(linePtr, end);
+        const char* stmtPlace = linePtr;
+        CString firstName = extractLabelName(linePtr, end);
+        skipSpacesToEnd(linePtr, end);
+        while (!firstName.empty() && linePtr != end && *linePtr == ':')
+        {   // skip labels
+            skipCharAndSpacesToEnd(linePtr, end);
+            stmtPlace = linePtr;
+            firstName = extractLabelName(linePtr, end);
+        }
+        skipSpacesToEnd(linePtr, end);
+        if (firstName.empty() || firstName[0] == '.' || isDigit(firstName[0]) ||
+            (linePtr != end && *linePtr == '='))
+            continue; // not instruction
+        toLowerString(firstName);
+        
+        const size_t oldSymbolRefsNum = chunkAsmr.symbolRefsNum;
+        const std::streampos oldMsgPos = msgStream.tellp();
+        output.clear();
+        isaAssembler->setAllocatedRegisters();
+        isaAssembler->assemble(firstName, stmtPlace, linePtr, end, output);
+        // store only code that does not depend on symbols and messages
+        if (chunkAsmr.symbolRefsNum != oldSymbolRefsNum ||
+            msgStream.tellp() != oldMsgPos || output.empty() ||
+            output.size() > sizeof(Code::data))
+            continue;
+        
+        Code code;
+        // line number of chunk's filter translated to line number of main source
+        code.lineNo = chunk.lineNo-1 + chunkAsmr.currentInputFilter->getLineNo();
+        code.textPos = chunk.texts.size();
+        code.textSize = end-stmtPlace;
+        code.size = output.size();
+        std::copy(output.begin(), output.end(), code.data);
+        size_t regTypesNum;
+        const cxuint* regs = isaAssembler->getAllocatedRegisters(regTypesNum,
+                    code.regFlags);
+        code.regs[0] = regs[0];
+        code.regs[1] = regs[1];
+        chunk.texts.append(stmtPlace, end);
+        chunk.codes.push_back(code);
+    }
+}
+
+void AsmParallelCode::preassemble(const Assembler& asmr, LineNo lineNo)
+{
+    preassembled = true;
+    buggyFPLit = asmr.buggyFPLit;
+    const char* end = content.data()+content.size();
+    const char* ptr = content.data();
+    // skip lines before first kernel
+    for (LineNo i = 0; i < lineNo && ptr != end; i++)
+        ptr = skipLine(ptr, end);
+    
+    const char* chunkStart = ptr;
+    LineNo chunkLineNo = lineNo+1;
+    size_t chunkLinesNum = 0;
+    for (; ptr != end; ptr = skipLine(ptr, end), chunkLinesNum++)
+        if (chunkLinesNum >= maxChunkLinesNum ||
+            (chunkLinesNum >= minChunkLinesNum && isKernelStatement(ptr, end)))
+        {
+            chunks.push_back({ chunkStart, ptr, chunkLineNo });
+            chunkStart = ptr;
+            chunkLineNo += chunkLinesNum;
+            chunkLinesNum = 0;
+        }
+    if (chunkStart != end)
+        chunks.push_back({ chunkStart, end, chunkLineNo });
+    
+    // codes are stored in their chunks (no merging after preassembling)
+    ThreadPool::runTasks(asmr.threadsNum, chunks.size(), [this, &asmr](size_t i)
+    { preassembleChunk(asmr, chunks[i]); });
+}
+
+const AsmParallelCode::Code* AsmParallelCode::findCode(const Assembler& asmr,
+            const char* stmtPlace, const char* end)
+{
+    if (chunks.empty() || asmr.deviceType != deviceType ||
+        asmr.buggyFPLit != buggyFPLit || asmr.regRangeSymbols)
+        return nullptr;
+    // skip codes of previous lines (main source is read in order of lines)
+    const LineNo lineNo = mainFilter->getLineNo();
+    while (curChunk < chunks.size())
+    {
+        const std::vector<Code>& codes = chunks[curChunk].codes;
+        while (curCode < codes.size() && codes[curCode].lineNo < lineNo)
+            curCode++;
+        if (curCode < codes.size())
+            break;
+        curChunk++;
+        curCode = 0;
+    }
+    if (curChunk == chunks.size())
+        return nullptr;
+    // check statements of current line
+    const Chunk& chunk = chunks[curChunk];
+    const size_t stmtSize = end-stmtPlace;
+    for (size_t i = curCode; i < chunk.codes.size() &&
+                chunk.codes[i].lineNo == lineNo; i++)
+    {
+        const Code& code = chunk.codes[i];
+        if (code.textSize == stmtSize &&
+            ::memcmp(chunk.texts.data()+code.textPos, stmtPlace, stmtSize) == 0)
+        {
+            curCode = i+1;
+            return &code;
+        }
+    }
+    return nullptr;
+}
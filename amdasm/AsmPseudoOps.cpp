@@ -427,6 +427,7 @@ void AsmPseudoOps::includeFile(Assembler& asmr, const char* pseudoOpPlace,
         try
         {
             asmr.includeFile(pseudoOpPlace, sysfilename);
+            asmr.includedFileNames.push_back(sysfilename);
             return;
         }
         catch(const Exception& ex)
@@ -441,6 +442,7 @@ void AsmPseudoOps::includeFile(Assembler& asmr, const char* pseudoOpPlace,
             {
                 asmr.includeFile(pseudoOpPlace, joinPaths(
                             std::string(incDirPath.c_str()), sysfilename));
+                asmr.includedFileNames.push_back(sysfilename);
                 break;
             }
             catch(const Exception& ex)
@@ -519,6 +521,7 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
     std::ifstream ifs;
     sysfilename = filename;
     filesystemPath(sysfilename);
+    const std::string includedName = sysfilename;
     ifs.open(sysfilename.c_str(), std::ios::binary);
     if (!ifs)
     {
@@ -526,9 +529,13 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
         {
             std::string incDirPath(incDir.c_str());
             filesystemPath(incDirPath);
-            ifs.open(joinPaths(incDirPath.c_str(), sysfilename).c_str(), std::ios::binary);
+            std::string incFilename = joinPaths(incDirPath.c_str(), sysfilename);
+            ifs.open(incFilename.c_str(), std::ios::binary);
             if (ifs)
+            {
+                sysfilename = std::move(incFilename);
                 break;
+            }
         }
     }
     if (!ifs)
@@ -537,6 +544,8 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
                     "' not found or unavailable in any directory").c_str());
         return;
     }
+    asmr.includedFiles.push_back(sysfilename);
+    asmr.includedFileNames.push_back(includedName);
     // exception for checking file seeking
     bool seekingIsWorking = true;
     ifs.exceptions(std::ios::badbit | std::ios::failbit); // exceptions
@@ -1665,6 +1674,8 @@ void AsmPseudoOps::doRepeat(Assembler& asmr, const char* pseudoOpPlace,
         asmr.asmInputFilters.push(newInputFilter.release());
         asmr.currentInputFilter = asmr.asmInputFilters.top();
         asmr.repetitionLevel++;
+        if (asmr.stats != nullptr)
+            asmr.stats->repetitions++;
     }
 }
 
@@ -1797,13 +1808,34 @@ void AsmPseudoOps::doMacro(Assembler& asmr, const char* pseudoOpPlace, const cha
             asmr.printWarning(pseudoOpPlace, (std::string(
                     "Attempt to redefine instruction or prefix '")+macroName.c_str()+
                     "' as macro.").c_str());
+        RefPtr<AsmCachedFile> cachedFile = asmr.getMacroCachedFile();
+        if (cachedFile)
+        {   // reuse macro from included file cached by session
+            RefPtr<const AsmMacro> macro = asmr.useCachedMacro(cachedFile, args);
+            if (macro)
+            {
+                asmr.macroMap.insert(std::make_pair(std::move(macroName),
+                            std::move(macro)));
+                asmr.updateMacrosVersion();
+                return;
+            }
+        }
+        const AsmInputFilter* macroFilter = asmr.currentInputFilter;
+        const size_t macroLineIndex = macroFilter->getCachedLineIndex()-1;
         // create a macro
         RefPtr<const AsmMacro> macro(new AsmMacro(asmr.getSourcePos(pseudoOpPlace),
                         Array<AsmMacroArg>(args.begin(), args.end())));
         asmr.pushClause(pseudoOpPlace, AsmClauseType::MACRO);
         if (!asmr.putMacroContent(macro.constCast<AsmMacro>()))
             return;
+        /* put macro to cached file if whole macro content is in this file
+         * and file is still cached */
+        if (cachedFile && asmr.currentInputFilter == macroFilter &&
+            macroFilter->getCachedFile() == cachedFile)
+            cachedFile->macros[macroLineIndex] = { macroFilter->getCachedLineIndex(),
+                        macro };
         asmr.macroMap.insert(std::make_pair(std::move(macroName), std::move(macro)));
+        asmr.updateMacrosVersion();
     }
 }
 
@@ -1901,6 +1933,8 @@ void AsmPseudoOps::doIRP(Assembler& asmr, const char* pseudoOpPlace, const char*
             asmr.asmInputFilters.push(newInputFilter.release());
             asmr.currentInputFilter = asmr.asmInputFilters.top();
             asmr.repetitionLevel++;
+            if (asmr.stats != nullptr)
+                asmr.stats->repetitions++;
         }
     }
 }
@@ -1951,7 +1985,12 @@ void AsmPseudoOps::undefSymbol(Assembler& asmr, const char* linePtr)
         asmr.printWarning(symNamePlace, (std::string("Symbol '") + symName.c_str() +
                 "' already doesn't exist").c_str());
     else if (it->second.occurrencesInExprs.empty())
-        asmr.symbolMap.erase(it);
+    {
+        if (asmr.stats != nullptr)
+            asmr.stats->maxSymbolsNum = std::max(asmr.stats->maxSymbolsNum,
+                        asmr.symbolMap.size());
+        asmr.eraseSymbol(it);
+    }
     else
         it->second.undefine();
 }
@@ -1999,6 +2038,7 @@ bool AsmPseudoOps::checkPseudoOpName(const CString& string)
 void Assembler::parsePseudoOps(const CString& firstName,
        const char* stmtPlace, const char* linePtr)
 {
+    AsmStatsTimer timer(stats.get(), &AsmStats::pseudoOps);
     const size_t pseudoOp = binaryFind(pseudoOpNamesTbl, pseudoOpNamesTbl +
                     sizeof(pseudoOpNamesTbl)/sizeof(char*), firstName.c_str()+1,
                    CStringLess()) - pseudoOpNamesTbl;
@@ -0,0 +1,117 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/AsmSource.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/AsmSession.h>
+
+using namespace CLRX;
+
+AsmSession::AsmSession(Flags _flags, BinaryFormat _format, GPUDeviceType _deviceType,
+        std::ostream& msgStream, std::ostream& _printStream)
+        : flags(_flags), format(_format), deviceType(_deviceType), driverVersion(0),
+          _64bit(false), messageStream(msgStream), printStream(_printStream),
+          cachedFileHits(0), cachedFileMisses(0), cachedMacroHits(0)
+{ }
+
+AsmSession::~AsmSession()
+{ }
+
+Assembler* AsmSession::createAssembler(const CString& filename, std::istream& input,
+            const std::vector<Assembler::DefSym>& extraDefSyms)
+{
+    std::unique_ptr<Assembler> assembler(new Assembler(filename, input, flags, format,
+                deviceType, messageStream, printStream));
+    assembler->setDriverVersion(driverVersion);
+    assembler->set64Bit(_64bit);
+    for (const CString& includeDir: includeDirs)
+        assembler->addIncludeDir(includeDir);
+    for (const Assembler::DefSym& defSym: defSyms)
+        assembler->addInitialDefSym(defSym.first, defSym.second);
+    for (const Assembler::DefSym& defSym: extraDefSyms)
+        assembler->addInitialDefSym(defSym.first, defSym.second);
+    assembler->session = this;
+    return assembler.release();
+}
+
+// files modified in this period before reading can be changed again without
+// change of timestamp (timestamp granularity of some filesystems is 2 seconds)
+static const uint64_t racyFilePeriod = 2000000000ULL;
+
+static uint64_t getCurrentTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// FNV-1a hash of file content
+static uint64_t hashFileContent(const char* filename)
+{
+    const Array<cxbyte> content = loadDataFromFile(filename);
+    uint64_t hash = UINT64_C(0xcbf29ce484222325);
+    for (cxbyte c: content)
+        hash = (hash ^ c) * UINT64_C(0x100000001b3);
+    return hash;
+}
+
+AsmInputFilter* AsmSession::openIncludeFile(const AsmSourcePos& pos,
+            const CString& filename)
+{
+    // throws exception if file doesn't exists
+    const FileStatus status = getFileStatus(filename.c_str());
+    const bool racy = status.timestamp + racyFilePeriod > getCurrentTime();
+    auto it = cachedFiles.find(filename);
+    if (it != cachedFiles.end() && it->second->status == status)
+    {
+        const RefPtr<AsmCachedFile>& cachedFile = it->second;
+        // file can be rewritten without changing status, hence compare content
+        if (!cachedFile->racy ||
+            cachedFile->contentHash == hashFileContent(filename.c_str()))
+        {   // file not changed
+            if (!racy) // next change will be visible in timestamp
+                cachedFile->racy = false;
+            cachedFileHits++;
+            return new AsmCachedInputFilter(pos, it->second);
+        }
+    }
+    // read file and fill new cached file while reading
+    std::unique_ptr<AsmStreamInputFilter> filter(new AsmStreamInputFilter(pos, filename));
+    RefPtr<AsmCachedFile> cachedFile(new AsmCachedFile(filename, status));
+    if (racy)
+    {
+        cachedFile->racy = true;
+        cachedFile->contentHash = hashFileContent(filename.c_str());
+    }
+    filter->setCachedFile(cachedFile);
+    cachedFileMisses++;
+    return filter.release();
+}
+
+void AsmSession::storeCachedFile(const RefPtr<AsmCachedFile>& cachedFile)
+{
+    if (cachedFile->complete)
+        return; // already stored (read by cached input filter)
+    cachedFile->complete = true;
+    cachedFiles[cachedFile->path] = cachedFile;
+}
@@ -18,12 +18,18 @@
  */
 
 #include <CLRX/Config.h>
+#include <cstring>
 #include <string>
 #include <fstream>
 #include <vector>
 #include <utility>
 #include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ASMSOURCE_USE_SSE2 1
+#endif
 #include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/InputOutput.h>
 #include <CLRX/amdasm/Assembler.h>
 #include "AsmInternals.h"
 
@@ -87,6 +93,7 @@ void AsmMacro::addLine(RefPtr<const AsmMacroSubst> macro, RefPtr<const AsmSource
             sourceTranslations.push_back({contentLineNo, RefPtr<const AsmSource>(
                 new AsmMacroSource{macro, source})});
     }
+    preparedStmts.push_back(AsmPreparedStmt());
     contentLineNo++;
 }
 
@@ -106,6 +113,7 @@ void AsmRepeat::addLine(RefPtr<const AsmMacroSubst> macro, RefPtr<const AsmSourc
     if (sourceTranslations.empty() || sourceTranslations.back().source != source ||
         sourceTranslations.back().macro != macro)
         sourceTranslations.push_back({contentLineNo, macro, source});
+    preparedStmts.push_back(AsmPreparedStmt());
     contentLineNo++;
 }
 
@@ -127,6 +135,17 @@ AsmIRP::AsmIRP(const AsmSourcePos& _pos, const CString& _symbolName,
           symbolName(_symbolName), symValues({_symValString})
 { }
 
+/* AsmCachedFile */
+
+void AsmCachedFile::addLine(const std::vector<LineTrans>& colTrans, LineNo lineNo,
+            size_t lineSize, const char* line)
+{
+    lines.push_back({ content.size(), lineSize, colTranslations.size(), lineNo });
+    content.insert(content.end(), line, line+lineSize);
+    content.push_back('\n');
+    colTranslations.insert(colTranslations.end(), colTrans.begin(), colTrans.end());
+}
+
 /* AsmInputFilter */
 
 AsmInputFilter::~AsmInputFilter()
@@ -146,6 +165,46 @@ LineCol AsmInputFilter::translatePos(size_t position) const
  */
 
 static const size_t AsmParserLineMaxSize = 100;
+// size of chunk read from stream
+static const size_t AsmStreamChunkSize = 65536;
+
+// characters that stop fast line scanning: control characters (newline, tabs, ...),
+// quotes, '#', '*' (begin of long comment), ';' and backslash
+static inline bool isLineSpecialChar(cxbyte c)
+{
+    return c < 0x20 || c == '"' || c == '\'' || c == '#' || c == '*' || c == ';' ||
+            c == '\\';
+}
+
+// find first special character in range (return end if not found)
+static inline const char* findLineSpecialChar(const char* ptr, const char* end)
+{
+#ifdef ASMSOURCE_USE_SSE2
+    const __m128i ctrlMax = _mm_set1_epi8(0x1f);
+    const __m128i dquote = _mm_set1_epi8('"');
+    const __m128i squote = _mm_set1_epi8('\'');
+    const __m128i hash = _mm_set1_epi8('#');
+    const __m128i asterisk = _mm_set1_epi8('*');
+    const __m128i semicolon = _mm_set1_epi8(';');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; end-ptr >= 16; ptr += 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        // unsigned v <= 0x1f
+        __m128i mask = _mm_cmpeq_epi8(_mm_min_epu8(v, ctrlMax), v);
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi8(v, dquote));
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi8(v, squote));
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi8(v, hash));
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi8(v, asterisk));
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi8(v, semicolon));
+        mask = _mm_or_si128(mask, _mm_cmpeq_epi8(v, backslash));
+        if (_mm_movemask_epi8(mask) != 0)
+            break; // find exact place in scalar loop
+    }
+#endif
+    while (ptr != end && !isLineSpecialChar(*ptr)) ptr++;
+    return ptr;
+}
 
 AsmStreamInputFilter::AsmStreamInputFilter(const CString& filename)
 try : AsmInputFilter(AsmInputFilterType::STREAM), managed(true),
@@ -217,7 +276,43 @@ AsmStreamInputFilter::~AsmStreamInputFilter()
         delete stream;
 }
 
+void AsmStreamInputFilter::setCachedFile(RefPtr<AsmCachedFile> _cachedFile)
+{
+    cachedFile = _cachedFile;
+    cachedFile->source = source;
+    cachedLineIndex = 0;
+}
+
+const std::string& AsmStreamInputFilter::readWholeStream()
+{
+    streamContent.clear();
+    char readBuffer[65536];
+    do {
+        stream->read(readBuffer, sizeof(readBuffer));
+        streamContent.append(readBuffer, stream->gcount());
+    } while (*stream);
+    std::istream* memStream = new ArrayIStream(streamContent.size(),
+                streamContent.data());
+    if (managed)
+        delete stream;
+    stream = memStream;
+    managed = true;
+    stream->exceptions(std::ios::badbit);
+    return streamContent;
+}
+
 const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSize)
+{
+    const char* line = filterLine(assembler, lineSize);
+    if (line != nullptr && cachedFile)
+    {   // fill cached file
+        cachedFile->addLine(colTranslations, lineNo, lineSize, line);
+        cachedLineIndex++;
+    }
+    return line;
+}
+
+const char* AsmStreamInputFilter::filterLine(Assembler& assembler, size_t& lineSize)
 {
     colTranslations.clear();
     bool endOfLine = false;
@@ -228,6 +323,33 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
     bool prevAsterisk = false;
     bool asterisk = false;
     colTranslations.push_back({ssize_t(-stmtPos), lineNo});
+    if (mode == LineMode::NORMAL && pos < buffer.size())
+    {   /* fast path: line without strings, comments, statement separators and
+         * line splitting is returned without copying (only whitespaces will be
+         * replaced by spaces). otherwise line will be processed by slow path */
+        char* lineData = buffer.data()+pos;
+        const char* bufferEnd = buffer.data()+buffer.size();
+        for (char* ptr = lineData; ; ptr++)
+        {
+            ptr = const_cast<char*>(findLineSpecialChar(ptr, bufferEnd));
+            if (ptr == bufferEnd)
+                break; // line is not complete
+            const char c = *ptr;
+            if (c == '\n')
+            {
+                lineNo++;
+                stmtPos = 0;
+                lineSize = ptr-lineData;
+                pos += lineSize+1;
+                return lineData;
+            }
+            if (isSpace(c))
+                *ptr = ' ';
+            else if ((c == '*' && ptr != lineData && ptr[-1] == '/') ||
+                (c != '*' && cxbyte(c) >= 0x20))
+                break; // comment, string, statement separator or backslash
+        }
+    }
     while (!endOfLine)
     {
         switch(mode)
@@ -420,8 +542,11 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
                                 {ssize_t(destPos-lineStart), lineNo});
                         }
                         else
+                        {   // do not cache file with warnings
+                            cachedFile.reset();
                             assembler.printWarning({lineNo, pos-joinStart+stmtPos+1},
                                         "Unterminated string: newline inserted");
+                        }
                         pos++;
                         joinStart = pos;
                         stmtPos = 0;
@@ -449,7 +574,7 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
                 lineStart = 0;
             }
             if (pos == buffer.size())
-                buffer.resize(std::max(AsmParserLineMaxSize, (pos>>1)+pos));
+                buffer.resize(pos + AsmStreamChunkSize);
             
             stream->read(buffer.data()+pos, buffer.size()-pos);
             const size_t readed = stream->gcount();
@@ -457,8 +582,11 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
             if (readed == 0)
             {   // end of file. check comments
                 if (mode == LineMode::LONG_COMMENT && lineStart!=pos)
+                {
+                    cachedFile.reset();
                     assembler.printError({lineNo, pos-joinStart+stmtPos+1},
                            "Unterminated multi-line comment");
+                }
                 if (destPos-lineStart == 0)
                 {
                     lineSize = 0;
@@ -472,6 +600,65 @@ const char* AsmStreamInputFilter::readLine(Assembler& assembler, size_t& lineSiz
     return buffer.data()+lineStart;
 }
 
+/*
+ * AsmCachedInputFilter
+ */
+
+// compare file sources by file paths and places of inclusion
+static bool isSameFileSource(RefPtr<const AsmSource> source1,
+            RefPtr<const AsmSource> source2)
+{
+    while (source1 != source2)
+    {
+        if (!source1 || !source2 || source1->type != AsmSourceType::FILE ||
+            source2->type != AsmSourceType::FILE)
+            return false;
+        RefPtr<const AsmFile> file1 = source1.staticCast<const AsmFile>();
+        RefPtr<const AsmFile> file2 = source2.staticCast<const AsmFile>();
+        if (file1->file != file2->file || (file1->parent &&
+            (file1->lineNo != file2->lineNo || file1->colNo != file2->colNo)))
+            return false;
+        source1 = file1->parent;
+        source2 = file2->parent;
+    }
+    return true;
+}
+
+AsmCachedInputFilter::AsmCachedInputFilter(const AsmSourcePos& pos,
+           RefPtr<AsmCachedFile> _cachedFile) : AsmInputFilter(AsmInputFilterType::STREAM)
+{
+    cachedFile = _cachedFile;
+    if (!pos.macro)
+        source = RefPtr<const AsmSource>(new AsmFile(pos.source, pos.lineNo,
+                         pos.colNo, cachedFile->path));
+    else // if inside macro
+        source = RefPtr<const AsmSource>(new AsmFile(
+            RefPtr<const AsmSource>(new AsmMacroSource(pos.macro, pos.source)),
+                 pos.lineNo, pos.colNo, cachedFile->path));
+    /* use source of cached file if file included in this same place,
+     * hence macros from cached file can be reused */
+    if (isSameFileSource(source, cachedFile->source))
+        source = cachedFile->source;
+}
+
+const char* AsmCachedInputFilter::readLine(Assembler& assembler, size_t& lineSize)
+{
+    if (cachedLineIndex >= cachedFile->lines.size())
+    {   // end of file
+        lineSize = 0;
+        return nullptr;
+    }
+    const AsmCachedFile::Line& cachedLine = cachedFile->lines[cachedLineIndex++];
+    const size_t colTransEnd = (cachedLineIndex < cachedFile->lines.size()) ?
+            cachedFile->lines[cachedLineIndex].colTransPos :
+            cachedFile->colTranslations.size();
+    colTranslations.assign(cachedFile->colTranslations.begin() + cachedLine.colTransPos,
+                cachedFile->colTranslations.begin() + colTransEnd);
+    lineNo = cachedLine.lineNo;
+    lineSize = cachedLine.size;
+    return cachedFile->content.data() + cachedLine.contentPos;
+}
+
 AsmMacroInputFilter::AsmMacroInputFilter(RefPtr<const AsmMacro> _macro,
          const AsmSourcePos& pos, const MacroArgMap& _argMap, uint64_t _macroCount,
          bool _alternateMacro)
@@ -519,6 +706,7 @@ const char* AsmMacroInputFilter::readLine(Assembler& assembler, size_t& lineSize
     if (pos == contentSize)
     {
         lineSize = 0;
+        preparedStmt = nullptr;
         return nullptr;
     }
     
@@ -648,6 +836,14 @@ const char* AsmMacroInputFilter::readLine(Assembler& assembler, size_t& lineSize
                     // after unmatched alternate substitution, we copy unmatched name
                     wordSkip--;
                 pos++;
+                if (!alternateMacro)
+                {   // fast skip to next backslash (or to next column translation)
+                    const size_t limit = std::max(pos,
+                                std::min(nextLinePos, colTransThreshold));
+                    const char* bsPtr = reinterpret_cast<const char*>(
+                                ::memchr(content+pos, '\\', limit-pos));
+                    pos = (bsPtr != nullptr) ? bsPtr-content : limit;
+                }
             }
         }
         else
@@ -797,6 +993,7 @@ const char* AsmMacroInputFilter::readLine(Assembler& assembler, size_t& lineSize
             sourceTransIndex++;
         }
     }
+    preparedStmt = macro->getPreparedStmt(contentLineNo);
     contentLineNo++;
     if (localStmtStart!=nullptr)
     {   // if really is local statement, we add local defs to map
@@ -852,6 +1049,7 @@ const char* AsmRepeatInputFilter::readLine(Assembler& assembler, size_t& lineSiz
         if (repeatCount == repeat->getRepeatsNum() || contentSize==0)
         {
             lineSize = 0;
+            preparedStmt = nullptr;
             return nullptr;
         }
         sourceTransIndex = 0;
@@ -888,6 +1086,7 @@ const char* AsmRepeatInputFilter::readLine(Assembler& assembler, size_t& lineSiz
                 fpos.source, repeatCount, repeat->getRepeatsNum()));
         }
     }
+    preparedStmt = repeat->getPreparedStmt(contentLineNo);
     contentLineNo++;
     return content + oldPos;
 }
@@ -926,6 +1125,7 @@ const char* AsmIRPInputFilter::readLine(Assembler& assembler, size_t& lineSize)
         if (repeatCount == irp->getRepeatsNum() || contentSize==0)
         {
             lineSize = 0;
+            preparedStmt = nullptr;
             return nullptr;
         }
         sourceTransIndex = 0;
@@ -1092,6 +1292,7 @@ const char* AsmIRPInputFilter::readLine(Assembler& assembler, size_t& lineSize)
                 fpos.source, repeatCount, irp->getRepeatsNum()));
         }
     }
+    preparedStmt = irp->getPreparedStmt(contentLineNo);
     contentLineNo++;
     return (!buffer.empty()) ? buffer.data() : "";
 }
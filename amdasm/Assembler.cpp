@@ -19,17 +19,22 @@
 
 #include <CLRX/Config.h>
 #include <string>
+#include <cstring>
 #include <cassert>
+#include <new>
 #include <fstream>
 #include <vector>
 #include <stack>
 #include <unordered_set>
 #include <utility>
 #include <algorithm>
+#include <atomic>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/MemAccess.h>
 #include <CLRX/utils/GPUId.h>
+#include <CLRX/utils/ThreadPool.h>
 #include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/AsmSession.h>
 #include "AsmInternals.h"
 
 using namespace CLRX;
@@ -361,6 +366,15 @@ bool AsmParseUtils::getEnumeration(Assembler& asmr, const char*& linePtr,
     return false;
 }
 
+AsmStats::AsmStats() : encodingNames(nullptr), preassembledInstrs(0), macroSubsts(0),
+        repetitions(0), maxSymbolsNum(0), exprsNum(0), maxExprsNum(0)
+{
+    const AsmStatsPhase zeroPhase = { 0, 0 };
+    std::fill(readLines, readLines+3, zeroPhase);
+    pseudoOps = instructions = exprParse = exprEvaluate = setSymbol = zeroPhase;
+    prepareBinary = writeBinary = zeroPhase;
+}
+
 ISAAssembler::ISAAssembler(Assembler& _assembler) : assembler(_assembler)
 { }
 
@@ -404,6 +418,149 @@ void AsmSymbol::undefine()
     onceDefined = false;
 }
 
+/*
+ * AsmSymbolMap
+ */
+
+static const size_t asmSymbolMapInitSlotsNum = 64;
+
+AsmSymbolMap::AsmSymbolMap() : slots(asmSymbolMapInitSlotsNum, Slot{ 0, nullptr }),
+        entriesNum(0), usedSlotsNum(0)
+{ }
+
+AsmSymbolMap::AsmSymbolMap(std::initializer_list<std::pair<CString, AsmSymbol> > list)
+        : slots(asmSymbolMapInitSlotsNum, Slot{ 0, nullptr }),
+          entriesNum(0), usedSlotsNum(0)
+{
+    for (const std::pair<CString, AsmSymbol>& entry: list)
+        insert(entry);
+}
+
+AsmSymbolMap::~AsmSymbolMap()
+{
+    // memory of entries will be freed with arena
+    for (const Slot& slot: slots)
+        if (slot.entry != nullptr)
+            slot.entry->~AsmSymbolEntry();
+}
+
+size_t AsmSymbolMap::hashName(const char* name, size_t length)
+{
+    // FNV-1a hash
+    uint64_t hash = UINT64_C(0xcbf29ce484222325);
+    for (size_t i = 0; i < length; i++)
+        hash = (hash ^ cxbyte(name[i])) * UINT64_C(0x100000001b3);
+    hash ^= hash >> 32;
+    // values 0 and 1 are reserved for empty and erased slots
+    return (size_t(hash) >= 2) ? size_t(hash) : size_t(hash)+2;
+}
+
+/* returns index of slot that holds symbol with this name or SIZE_MAX if not found.
+ * freeSlot - first free slot (empty or erased) on probe sequence */
+size_t AsmSymbolMap::findSlot(const char* name, size_t length, size_t hash,
+                size_t& freeSlot) const
+{
+    const size_t mask = slots.size()-1;
+    freeSlot = SIZE_MAX;
+    for (size_t i = hash & mask; ; i = (i+1) & mask)
+    {
+        const Slot& slot = slots[i];
+        if (slot.entry == nullptr)
+        {
+            if (freeSlot == SIZE_MAX)
+                freeSlot = i;
+            if (slot.hash == 0) // empty slot, end of probe sequence
+                return SIZE_MAX;
+        }
+        else if (slot.hash == hash)
+        {
+            const char* entryName = slot.entry->first.c_str();
+            if (::strncmp(entryName, name, length) == 0 && entryName[length] == 0)
+                return i;
+        }
+    }
+}
+
+void AsmSymbolMap::rehash(size_t newSlotsNum)
+{
+    std::vector<Slot> newSlots(newSlotsNum, Slot{ 0, nullptr });
+    const size_t mask = newSlotsNum-1;
+    for (const Slot& slot: slots)
+        if (slot.entry != nullptr)
+        {
+            size_t i = slot.hash & mask;
+            while (newSlots[i].entry != nullptr)
+                i = (i+1) & mask;
+            newSlots[i] = slot;
+        }
+    slots.swap(newSlots);
+    usedSlotsNum = entriesNum;
+}
+
+AsmSymbolMap::iterator AsmSymbolMap::find(const char* name, size_t length)
+{
+    size_t freeSlot;
+    const size_t index = findSlot(name, length, hashName(name, length), freeSlot);
+    Slot* slotsEnd = slots.data()+slots.size();
+    return iterator((index != SIZE_MAX) ? slots.data()+index : slotsEnd, slotsEnd);
+}
+
+AsmSymbolMap::const_iterator AsmSymbolMap::find(const char* name, size_t length) const
+{
+    size_t freeSlot;
+    const size_t index = findSlot(name, length, hashName(name, length), freeSlot);
+    const Slot* slotsEnd = slots.data()+slots.size();
+    return const_iterator((index != SIZE_MAX) ? slots.data()+index : slotsEnd, slotsEnd);
+}
+
+std::pair<AsmSymbolMap::iterator, bool> AsmSymbolMap::insert(const char* name,
+            size_t length, const AsmSymbol& symbol)
+{
+    const size_t hash = hashName(name, length);
+    size_t freeSlot;
+    size_t index = findSlot(name, length, hash, freeSlot);
+    Slot* slotsEnd = slots.data()+slots.size();
+    if (index != SIZE_MAX) // if found
+        return std::make_pair(iterator(slots.data()+index, slotsEnd), false);
+    
+    if (slots[freeSlot].hash == 0 && (usedSlotsNum+1)*4 > slots.size()*3)
+    {   // too many used slots (load factor is greater than 3/4)
+        size_t newSlotsNum = slots.size();
+        while ((entriesNum+1)*2 > newSlotsNum)
+            newSlotsNum <<= 1;
+        rehash(newSlotsNum);
+        findSlot(name, length, hash, freeSlot);
+        slotsEnd = slots.data()+slots.size();
+    }
+    
+    void* entryPlace = entryArena.allocate(sizeof(AsmSymbolEntry));
+    AsmSymbolEntry* entry;
+    try
+    { entry = new(entryPlace) AsmSymbolEntry(CString(name, length), symbol); }
+    catch(...)
+    {
+        entryArena.deallocate(entryPlace, sizeof(AsmSymbolEntry));
+        throw;
+    }
+    Slot& slot = slots[freeSlot];
+    if (slot.hash == 0)
+        usedSlotsNum++;
+    slot.hash = hash;
+    slot.entry = entry;
+    entriesNum++;
+    return std::make_pair(iterator(&slot, slotsEnd), true);
+}
+
+void AsmSymbolMap::erase(iterator it)
+{
+    Slot& slot = const_cast<Slot&>(*it.slot);
+    slot.entry->~AsmSymbolEntry();
+    entryArena.deallocate(slot.entry, sizeof(AsmSymbolEntry));
+    slot.entry = nullptr;
+    slot.hash = 1; // mark as erased
+    entriesNum--;
+}
+
 /*
  * Assembler
  */
@@ -431,9 +588,14 @@ Assembler::Assembler(const CString& filename, std::istream& input, Flags _flags,
     buggyFPLit = (flags & ASM_BUGGYFPLIT)!=0;
     localCount = macroCount = inclusionLevel = 0;
     macroSubstLevel = repetitionLevel = 0;
+    macrosVersion = 0;
     lineAlreadyRead = false;
     good = true;
     resolvingRelocs = false;
+    session = nullptr;
+    threadsNum = 1;
+    symbolRefsNum = 0;
+    regRangeSymbols = false;
     formatHandler = nullptr;
     input.exceptions(std::ios::badbit);
     std::unique_ptr<AsmInputFilter> thatInputFilter(
@@ -466,9 +628,14 @@ Assembler::Assembler(const Array<CString>& _filenames, Flags _flags,
     buggyFPLit = (flags & ASM_BUGGYFPLIT)!=0;
     localCount = macroCount = inclusionLevel = 0;
     macroSubstLevel = repetitionLevel = 0;
+    macrosVersion = 0;
     lineAlreadyRead = false;
     good = true;
     resolvingRelocs = false;
+    session = nullptr;
+    threadsNum = 1;
+    symbolRefsNum = 0;
+    regRangeSymbols = false;
     formatHandler = nullptr;
     std::unique_ptr<AsmInputFilter> thatInputFilter(
                 new AsmStreamInputFilter(filenames[filenameIndex++]));
@@ -771,36 +938,42 @@ Assembler::ParseState Assembler::parseSymbol(const char*& linePtr,
                 AsmSymbolEntry*& entry, bool localLabel, bool dontCreateSymbol)
 {
     const char* startPlace = linePtr;
-    const CString symName = extractSymName(linePtr, line+lineSize, localLabel);
-    if (symName.empty())
+    skipSymName(linePtr, line+lineSize, localLabel);
+    const size_t symNameLength = linePtr-startPlace;
+    if (symNameLength == 0)
     {   // this is not symbol or a missing symbol
         while (linePtr != line+lineSize && !isSpace(*linePtr) && *linePtr != ',')
             linePtr++;
         entry = nullptr;
         return Assembler::ParseState::MISSING;
     }
-    if (symName == ".") // any usage of '.' causes format initialization
+    if (symNameLength == 1 && *startPlace == '.')
+        // any usage of '.' causes format initialization
         initializeOutputFormat();
     
     Assembler::ParseState state = Assembler::ParseState::PARSED;
     bool symHasValue;
     if (!dontCreateSymbol)
     {   // create symbol if not found
-        std::pair<AsmSymbolMap::iterator, bool> res =
-                symbolMap.insert(std::make_pair(symName, AsmSymbol()));
-        entry = &*res.first;
-        symHasValue = res.first->second.hasValue;
+        if (isDigit(*startPlace)) // local label
+            entry = getLocalLabel(startPlace, symNameLength-1,
+                        startPlace[symNameLength-1] == 'f');
+        else
+            entry = &*symbolMap.insert(startPlace, symNameLength).first;
+        symHasValue = entry->second.hasValue;
     }
     else
     {   // only find symbol and set isDefined and entry
-        AsmSymbolMap::iterator it = symbolMap.find(symName);
+        AsmSymbolMap::iterator it = symbolMap.find(startPlace, symNameLength);
         entry = (it != symbolMap.end()) ? &*it : nullptr;
         symHasValue = (it != symbolMap.end() && it->second.hasValue);
     }
-    if (isDigit(symName.front()) && symName[linePtr-startPlace-1] == 'b' && !symHasValue)
+    if (entry != nullptr)
+        symbolRefsNum++;
+    if (isDigit(*startPlace) && startPlace[symNameLength-1] == 'b' && !symHasValue)
     {   // failed at finding
         std::string error = "Undefined previous local label '";
-        error.append(symName.begin(), linePtr-startPlace);
+        error.append(startPlace, symNameLength);
         error += "'";
         printError(linePtr, error.c_str());
         state = Assembler::ParseState::FAILED;
@@ -809,6 +982,59 @@ Assembler::ParseState Assembler::parseSymbol(const char*& linePtr,
     return state;
 }
 
+AsmSymbolEntry* Assembler::getLocalLabel(const char* digits, size_t digitsNum, bool next)
+{
+    // label number (only for short numbers without leading zeroes)
+    size_t number = SIZE_MAX;
+    if (digitsNum <= 4 && (digitsNum == 1 || digits[0] != '0'))
+    {
+        number = 0;
+        for (size_t i = 0; i < digitsNum; i++)
+            number = number*10 + (digits[i]-'0');
+        if (number < localLabels.size())
+        {
+            AsmSymbolEntry* entry = (next) ? localLabels[number].next :
+                        localLabels[number].prev;
+            if (entry != nullptr)
+                return entry;
+        }
+    }
+    std::string symName(digits, digitsNum);
+    symName.push_back(next ? 'f' : 'b');
+    AsmSymbolEntry* entry = &*symbolMap.insert(symName.c_str(), symName.size()).first;
+    if (number != SIZE_MAX)
+    {   // put to local labels table
+        if (number >= localLabels.size())
+            localLabels.resize(number+1, LocalLabel{ nullptr, nullptr });
+        if (next)
+            localLabels[number].next = entry;
+        else
+            localLabels[number].prev = entry;
+    }
+    return entry;
+}
+
+void Assembler::eraseSymbol(AsmSymbolMap::iterator it)
+{
+    AsmSymbolEntry* entry = &*it;
+    const CString& symName = entry->first;
+    // local label symbols: digits with 'b' or 'f' at end
+    if (symName.size() >= 2 && symName.size() <= 5 && isDigit(symName[0]))
+    {
+        size_t number = 0;
+        for (size_t i = 0; i+1 < symName.size(); i++)
+            number = number*10 + (symName[i]-'0');
+        if (number < localLabels.size())
+        {   // entry will be freed, hence clear its cache slot
+            if (localLabels[number].prev == entry)
+                localLabels[number].prev = nullptr;
+            if (localLabels[number].next == entry)
+                localLabels[number].next = nullptr;
+        }
+    }
+    symbolMap.erase(it);
+}
+
 bool Assembler::parseMacroArgValue(const char*& string, std::string& outStr)
 {
     const char* end = line+lineSize;
@@ -910,6 +1136,7 @@ bool Assembler::parseMacroArgValue(const char*& string, std::string& outStr)
 
 bool Assembler::setSymbol(AsmSymbolEntry& symEntry, uint64_t value, cxuint sectionId)
 {
+    AsmStatsTimer timer(stats.get(), &AsmStats::setSymbol);
     symEntry.second.value = value;
     symEntry.second.expression = nullptr;
     symEntry.second.sectionId = sectionId;
@@ -1101,6 +1328,7 @@ bool Assembler::assignSymbol(const CString& symbolName, const char* symbolPlace,
         symEntry.second.sectionId = ASMSECT_ABS;
         symEntry.second.regRange = symEntry.second.hasValue = true;
         symEntry.second.value = (regStart | (uint64_t(regEnd)<<32));
+        regRangeSymbols = true;
         return true;
     }
     
@@ -1288,6 +1516,25 @@ bool Assembler::checkReservedName(const CString& name)
     return false;
 }
 
+static void initializeEncodingStats(AsmStats& stats, const ISAAssembler& isaAssembler)
+{
+    cxuint encodingsNum;
+    stats.encodingNames = isaAssembler.getEncodingNames(encodingsNum);
+    stats.encodings.assign(encodingsNum, AsmStatsPhase{ 0, 0 });
+}
+
+void Assembler::setStatsEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        stats.reset();
+        return;
+    }
+    stats.reset(new AsmStats);
+    if (isaAssembler != nullptr)
+        initializeEncodingStats(*stats, *isaAssembler);
+}
+
 void Assembler::addIncludeDir(const CString& includeDir)
 {
     includeDirs.push_back(includeDir);
@@ -1517,6 +1764,8 @@ Assembler::ParseState Assembler::makeMacroSubstitution(const char* linePtr)
     asmInputFilters.push(macroFilter.release());
     currentInputFilter = asmInputFilters.top();
     macroSubstLevel++;
+    if (stats != nullptr)
+        stats->macroSubsts++;
     return ParseState::PARSED;
 }
 
@@ -1527,17 +1776,77 @@ bool Assembler::includeFile(const char* pseudoOpPlace, const std::string& filena
         printError(pseudoOpPlace, "Inclusion level is greater than 500");
         return false;
     }
-    std::unique_ptr<AsmInputFilter> newInputFilter(new AsmStreamInputFilter(
-                getSourcePos(pseudoOpPlace), filename));
+    std::unique_ptr<AsmInputFilter> newInputFilter;
+    if (session != nullptr)
+        // use filtered content of file cached by session
+        newInputFilter.reset(session->openIncludeFile(getSourcePos(pseudoOpPlace),
+                    filename));
+    else
+        newInputFilter.reset(new AsmStreamInputFilter(getSourcePos(pseudoOpPlace),
+                    filename));
     asmInputFilters.push(newInputFilter.release());
     currentInputFilter = asmInputFilters.top();
     inclusionLevel++;
+    includedFiles.push_back(filename);
     return true;
 }
 
+// macros versions must be unique in process, because macros can be shared
+static std::atomic<uint64_t> macrosVersionCounter(0);
+
+void Assembler::updateMacrosVersion()
+{
+    macrosVersion = ++macrosVersionCounter;
+}
+
+RefPtr<AsmCachedFile> Assembler::getMacroCachedFile() const
+{
+    if (session == nullptr)
+        return RefPtr<AsmCachedFile>();
+    const RefPtr<AsmCachedFile>& cachedFile = currentInputFilter->getCachedFile();
+    /* macro refers to source of file, hence macros can be cached only if
+     * file has source of cached file (is included in this same place) */
+    if (!cachedFile || cachedFile->source != currentInputFilter->getSource())
+        return RefPtr<AsmCachedFile>();
+    return cachedFile;
+}
+
+RefPtr<const AsmMacro> Assembler::useCachedMacro(const RefPtr<AsmCachedFile>& cachedFile,
+            const std::vector<AsmMacroArg>& args)
+{
+    const AsmInputFilter* filter = currentInputFilter;
+    auto it = cachedFile->macros.find(filter->getCachedLineIndex()-1);
+    if (it == cachedFile->macros.end())
+        return RefPtr<const AsmMacro>();
+    // check arguments (default values depends on alternate macro mode)
+    const RefPtr<const AsmMacro>& macro = it->second.macro;
+    if (macro->getArgsNum() != args.size())
+        return RefPtr<const AsmMacro>();
+    for (size_t i = 0; i < args.size(); i++)
+    {
+        const AsmMacroArg& arg = macro->getArg(i);
+        if (arg.name != args[i].name || arg.defaultValue != args[i].defaultValue ||
+            arg.vararg != args[i].vararg || arg.required != args[i].required)
+            return RefPtr<const AsmMacro>();
+    }
+    // skip macro content (whole content is in this same file)
+    while (filter->getCachedLineIndex() < it->second.endLineIndex)
+        readLine();
+    session->cachedMacroHits++;
+    return macro;
+}
+
+inline const char* Assembler::readLineFromFilter()
+{
+    if (stats == nullptr)
+        return currentInputFilter->readLine(*this, lineSize);
+    AsmStatsTimer timer(&stats->readLines[cxuint(currentInputFilter->getType())]);
+    return currentInputFilter->readLine(*this, lineSize);
+}
+
 bool Assembler::readLine()
 {
-    line = currentInputFilter->readLine(*this, lineSize);
+    line = readLineFromFilter();
     while (line == nullptr)
     {   // no line
         if (asmInputFilters.size() > 1)
@@ -1545,7 +1854,12 @@ bool Assembler::readLine()
             if (currentInputFilter->getType() == AsmInputFilterType::MACROSUBST)
                 macroSubstLevel--;
             else if (currentInputFilter->getType() == AsmInputFilterType::STREAM)
+            {
                 inclusionLevel--;
+                // store whole filtered content of included file in session
+                if (session != nullptr && currentInputFilter->getCachedFile())
+                    session->storeCachedFile(currentInputFilter->getCachedFile());
+            }
             else if (currentInputFilter->getType() == AsmInputFilterType::REPEAT)
                 repetitionLevel--;
             delete asmInputFilters.top();
@@ -1561,7 +1875,7 @@ bool Assembler::readLine()
                     new AsmStreamInputFilter(filenames[filenameIndex++]));
                 asmInputFilters.push(thatFilter.get());
                 currentInputFilter = thatFilter.release();
-                line = currentInputFilter->readLine(*this, lineSize);
+                line = readLineFromFilter();
             } while (line==nullptr && filenameIndex<filenames.size());
             
             return (line!=nullptr);
@@ -1569,7 +1883,7 @@ bool Assembler::readLine()
         else
             return false;
         currentInputFilter = asmInputFilters.top();
-        line = currentInputFilter->readLine(*this, lineSize);
+        line = readLineFromFilter();
     }
     return true;
 }
@@ -1643,6 +1957,9 @@ void Assembler::goToKernel(const char* pseudoOpPlace, const char* kernelName)
         
         currentOutPos = sections[currentSection].getSize();
     }
+    // first kernel in main source: preassemble rest of source in parallel
+    if (parallelCode != nullptr && parallelCode->canPreassemble(*this))
+        parallelCode->preassemble(*this, getSourcePos(pseudoOpPlace).lineNo);
 }
 
 void Assembler::goToSection(const char* pseudoOpPlace, const char* sectionName,
@@ -1757,12 +2074,86 @@ void Assembler::initializeOutputFormat()
             break;
     }
     isaAssembler = new GCNAssembler(*this);
+    if (stats != nullptr)
+        initializeEncodingStats(*stats, *isaAssembler);
+    if (parallelCode != nullptr)
+        parallelCode->setDeviceType(deviceType);
     // add first section
     auto info = formatHandler->getSectionInfo(currentSection);
     sections.push_back({ info.name, currentKernel, info.type, info.flags, 0 });
     currentOutPos = 0;
 }
 
+void Assembler::prepareStmt(AsmPreparedStmt& stmt, AsmPreparedStmt::Type type,
+            const CString& name, const char* stmtPlace, const char* linePtr)
+{
+    stmt.type = type;
+    stmt.nameOffset = stmtPlace-line;
+    stmt.argsOffset = linePtr-line;
+    stmt.macrosVersion = macrosVersion;
+    stmt.name = name;
+    stmt.prefix.assign(line, linePtr);
+}
+
+bool Assembler::assemblePreparedStmt(const AsmPreparedStmt& stmt)
+{
+    const size_t argsOffset = stmt.argsOffset;
+    if (lineSize < argsOffset || ::memcmp(line, stmt.prefix.c_str(), argsOffset) != 0)
+        return false; // line begins with other text
+    const char* end = line+lineSize;
+    const char* linePtr = line+argsOffset;
+    if (linePtr != end)
+    {   // name must be terminated by space and statement must not be label or assignment
+        if (!isSpace(linePtr[-1]))
+            return false;
+        skipSpacesToEnd(linePtr, end);
+        if (linePtr != end && (*linePtr == ':' || *linePtr == '='))
+            return false;
+    }
+    const char* stmtPlace = line+stmt.nameOffset;
+    if (stmt.type == AsmPreparedStmt::PSEUDO_OP)
+    {   // copy name, because pseudo-op can remove content of macro
+        const CString name = stmt.name;
+        parsePseudoOps(name, stmtPlace, linePtr);
+        return true;
+    }
+    assembleInstruction(stmt.name, stmtPlace, linePtr, end);
+    return true;
+}
+
+void Assembler::assembleInstruction(const CString& mnemonic, const char* stmtPlace,
+            const char* linePtr, const char* end)
+{
+    initializeOutputFormat();
+    if (!isWriteableSection())
+    {
+        printError(stmtPlace, "Writing data into non-writeable section is illegal");
+        return;
+    }
+    std::vector<cxbyte>& content = sections[currentSection].content;
+    const AsmParallelCode::Code* code = (parallelCode != nullptr) ?
+            parallelCode->findCode(*this, stmtPlace, end) : nullptr;
+    if (code != nullptr)
+    {   // use preassembled code and update allocated registers
+        if (stats != nullptr)
+            stats->preassembledInstrs++;
+        content.insert(content.end(), code->data, code->data + code->size);
+        size_t regTypesNum;
+        Flags regFlags;
+        const cxuint* curRegs = isaAssembler->getAllocatedRegisters(regTypesNum,
+                    regFlags);
+        const cxuint regs[2] = { std::max(curRegs[0], code->regs[0]),
+                    std::max(curRegs[1], code->regs[1]) };
+        isaAssembler->setAllocatedRegisters(regs, regFlags | code->regFlags);
+    }
+    else
+    {
+        AsmStatsTimer timer(stats.get(), &AsmStats::instructions);
+        isaAssembler->assemble(mnemonic, stmtPlace, linePtr, end, content);
+    }
+    currentOutPos = sections[currentSection].getSize();
+}
+
 bool Assembler::assemble()
 {
     resolvingRelocs = false;
@@ -1774,6 +2165,16 @@ bool Assembler::assemble()
             messageStream << "<command-line>: Warning: Definition for symbol '.' "
                     "was ignored" << std::endl;
     
+    if (threadsNum != 1 && parallelCode == nullptr && filenames.size() <= 1 &&
+        asmInputFilters.size() == 1 && !lineAlreadyRead &&
+        (threadsNum != 0 || ThreadPool::getHardwareThreadsNum() > 1))
+    {   // read main source to memory to preassemble its instructions in parallel
+        AsmStreamInputFilter* mainFilter =
+                static_cast<AsmStreamInputFilter*>(currentInputFilter);
+        const std::string& content = mainFilter->readWholeStream();
+        parallelCode.reset(new AsmParallelCode(mainFilter, content));
+    }
+    
     good = true;
     while (!endOfAssembly)
     {
@@ -1789,6 +2190,25 @@ bool Assembler::assemble()
                 break; // end of stream
         }
         
+        /* prepared statement of line from macro or repetition content.
+         * statement from previous pass will be used if line begins with same text */
+        AsmPreparedStmt* prepStmt = currentInputFilter->getPreparedStmt();
+        if (prepStmt != nullptr)
+        {
+            if (prepStmt->type == AsmPreparedStmt::INSTRUCTION &&
+                prepStmt->macrosVersion != macrosVersion)
+                prepStmt->type = AsmPreparedStmt::NONE; // macros changed, prepare again
+            if (prepStmt->type == AsmPreparedStmt::NONE)
+                prepStmt->type = AsmPreparedStmt::OTHER; // prepare in this pass
+            else
+            {
+                if (prepStmt->type != AsmPreparedStmt::OTHER &&
+                    assemblePreparedStmt(*prepStmt))
+                    continue;
+                prepStmt = nullptr; // do not prepare again
+            }
+        }
+        
         const char* linePtr = line; // string points to place of line
         const char* end = line+lineSize;
         skipSpacesToEnd(linePtr, end);
@@ -1804,6 +2224,7 @@ bool Assembler::assemble()
         bool doNextLine = false;
         while (!firstName.empty() && linePtr != end && *linePtr == ':')
         {   // labels
+            prepStmt = nullptr; // do not prepare statements with labels
             linePtr++;
             skipSpacesToEnd(linePtr, end);
             initializeOutputFormat();
@@ -1822,23 +2243,21 @@ bool Assembler::assemble()
                     doNextLine = true;
                     break;
                 }
-                /* prevLRes - iterator to previous instance of local label (with 'b)
-                 * nextLRes - iterator to next instance of local label (with 'f) */
-                std::pair<AsmSymbolMap::iterator, bool> prevLRes =
-                        symbolMap.insert(std::make_pair(
-                            std::string(firstName.c_str())+"b", AsmSymbol()));
-                std::pair<AsmSymbolMap::iterator, bool> nextLRes =
-                        symbolMap.insert(std::make_pair(
-                            std::string(firstName.c_str())+"f", AsmSymbol()));
+                /* prevLEntry - previous instance of local label (with 'b)
+                 * nextLEntry - next instance of local label (with 'f) */
+                AsmSymbolEntry* prevLEntry = getLocalLabel(firstName.c_str(),
+                            firstName.size(), false);
+                AsmSymbolEntry* nextLEntry = getLocalLabel(firstName.c_str(),
+                            firstName.size(), true);
                 /* resolve forward symbol of label now */
-                assert(setSymbol(*nextLRes.first, currentOutPos, currentSection));
+                assert(setSymbol(*nextLEntry, currentOutPos, currentSection));
                 // move symbol value from next local label into previous local label
                 // clearOccurrences - obsolete - back local labels are undefined!
-                prevLRes.first->second.value = nextLRes.first->second.value;
-                prevLRes.first->second.hasValue = isResolvableSection();
-                prevLRes.first->second.sectionId = currentSection;
+                prevLEntry->second.value = nextLEntry->second.value;
+                prevLEntry->second.hasValue = isResolvableSection();
+                prevLEntry->second.sectionId = currentSection;
                 /// make forward symbol of label as undefined
-                nextLRes.first->second.hasValue = false;
+                nextLEntry->second.hasValue = false;
             }
             else
             {   // regular labels
@@ -1901,8 +2320,17 @@ bool Assembler::assemble()
         // make firstname as lowercase
         toLowerString(firstName);
         
+        // prepared statement can be used only if arguments are separated by space
+        if (prepStmt != nullptr && linePtr != end && !isSpace(linePtr[-1]))
+            prepStmt = nullptr;
+        
         if (firstName.size() >= 2 && firstName[0] == '.') // check for pseudo-op
+        {
+            if (prepStmt != nullptr)
+                prepareStmt(*prepStmt, AsmPreparedStmt::PSEUDO_OP, firstName,
+                            stmtPlace, linePtr);
             parsePseudoOps(firstName, stmtPlace, linePtr);
+        }
         else if (firstName.size() >= 1 && isDigit(firstName[0]))
             printError(stmtPlace, "Illegal number at statement begin");
         else
@@ -1915,17 +2343,11 @@ bool Assembler::assemble()
                         printError(stmtPlace, "Garbages at statement place");
                     continue;
                 }
-                initializeOutputFormat();
+                if (prepStmt != nullptr)
+                    prepareStmt(*prepStmt, AsmPreparedStmt::INSTRUCTION, firstName,
+                                stmtPlace, linePtr);
                 // try parse instruction
-                if (!isWriteableSection())
-                {
-                    printError(stmtPlace,
-                       "Writing data into non-writeable section is illegal");
-                    continue;
-                }
-                isaAssembler->assemble(firstName, stmtPlace, linePtr, end,
-                           sections[currentSection].content);
-                currentOutPos = sections[currentSection].getSize();
+                assembleInstruction(firstName, stmtPlace, linePtr, end);
             }
         }
     }
@@ -1976,8 +2398,13 @@ bool Assembler::assemble()
                     printError(occur.expression->getSourcePos(),(std::string(
                         "Unresolved symbol '")+symEntry.first.c_str()+"'").c_str());
     
+    if (stats != nullptr)
+        stats->maxSymbolsNum = std::max(stats->maxSymbolsNum, symbolMap.size());
     if (good && formatHandler!=nullptr)
+    {
+        AsmStatsTimer timer(stats.get(), &AsmStats::prepareBinary);
         formatHandler->prepareBinary();
+    }
     return good;
 }
 
@@ -1990,7 +2417,10 @@ void Assembler::writeBinary(const char* filename) const
         {
             std::ofstream ofs(filename, std::ios::binary);
             if (ofs)
+            {
+                AsmStatsTimer timer(stats.get(), &AsmStats::writeBinary);
                 formatHandler->writeBinary(ofs);
+            }
             else
                 throw Exception(std::string("Can't open output file '")+filename+"'");
         }
@@ -2007,7 +2437,10 @@ void Assembler::writeBinary(std::ostream& outStream) const
     {
         const AsmFormatHandler* formatHandler = getFormatHandler();
         if (formatHandler!=nullptr)
+        {
+            AsmStatsTimer timer(stats.get(), &AsmStats::writeBinary);
             formatHandler->writeBinary(outStream);
+        }
         else
             throw Exception("No output binary");
     }
@@ -2021,7 +2454,10 @@ void Assembler::writeBinary(Array<cxbyte>& array) const
     {
         const AsmFormatHandler* formatHandler = getFormatHandler();
         if (formatHandler!=nullptr)
+        {
+            AsmStatsTimer timer(stats.get(), &AsmStats::writeBinary);
             formatHandler->writeBinary(array);
+        }
         else
             throw Exception("No output binary");
     }
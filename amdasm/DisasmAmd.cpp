@@ -1491,7 +1491,8 @@ static void dumpAmdKernelConfig(std::ostream& output, const AmdKernelConfig& con
 }
 
 void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
-       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags,
+       cxuint threadsNum)
 {
     if (amdInput->is64BitMode)
         output.write(".64bit\n", 7);
@@ -1521,8 +1522,21 @@ void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
         printDisasmData(amdInput->globalDataSize, amdInput->globalData, output);
     }
     
-    for (const AmdDisasmKernelInput& kinput: amdInput->kernels)
+    // section counters for kernels
+    std::vector<size_t> kernelSectionCounts(amdInput->kernels.size());
+    for (size_t i = 0; i < amdInput->kernels.size(); i++)
     {
+        const AmdDisasmKernelInput& kinput = amdInput->kernels[i];
+        kernelSectionCounts[i] = sectionCount;
+        if (doDumpCode && kinput.code != nullptr && kinput.codeSize != 0)
+            sectionCount++;
+    }
+    
+    disassembleKernels(output, isaDisassembler, amdInput->kernels.size(), threadsNum,
+        [amdInput, flags, doDumpCode, &kernelSectionCounts]
+        (std::ostream& output, ISADisassembler* isaDisassembler, size_t kernelIndex)
+    {
+        const AmdDisasmKernelInput& kinput = amdInput->kernels[kernelIndex];
         output.write(".kernel ", 8);
         output.write(kinput.kernelName.c_str(), kinput.kernelName.size());
         output.put('\n');
@@ -1539,10 +1553,10 @@ void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
         if (doDumpCode && kinput.code != nullptr && kinput.codeSize != 0)
         {   // input kernel code (main disassembly)
             output.write("    .text\n", 10);
+            isaDisassembler->setSectionCount(kernelSectionCounts[kernelIndex]);
             isaDisassembler->setInput(kinput.codeSize, kinput.code);
             isaDisassembler->beforeDisassemble();
             isaDisassembler->disassemble();
-            sectionCount++;
         }
-    }
+    });
 }
@@ -770,7 +770,8 @@ static void dumpAmdCL2KernelConfig(std::ostream& output, const AmdCL2KernelConfi
 }
 
 void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdCL2Input,
-       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags,
+       cxuint threadsNum)
 {
     const bool doMetadata = ((flags & DISASM_METADATA) != 0);
     const bool doDumpData = ((flags & DISASM_DUMPDATA) != 0);
@@ -870,8 +871,22 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
         }
     }
     
-    for (const AmdCL2DisasmKernelInput& kinput: amdCL2Input->kernels)
+    // section counters for kernels
+    std::vector<size_t> kernelSectionCounts(amdCL2Input->kernels.size());
+    for (size_t i = 0; i < amdCL2Input->kernels.size(); i++)
     {
+        const AmdCL2DisasmKernelInput& kinput = amdCL2Input->kernels[i];
+        kernelSectionCounts[i] = sectionCount;
+        if (doDumpCode && kinput.code != nullptr && kinput.codeSize != 0)
+            sectionCount++;
+    }
+    
+    disassembleKernels(output, isaDisassembler, amdCL2Input->kernels.size(), threadsNum,
+        [amdCL2Input, doMetadata, doSetup, doDumpConfig, doDumpCode, &samplerOffsets,
+         &kernelSectionCounts]
+        (std::ostream& output, ISADisassembler* isaDisassembler, size_t kernelIndex)
+    {
+        const AmdCL2DisasmKernelInput& kinput = amdCL2Input->kernels[kernelIndex];
         output.write(".kernel ", 8);
         output.write(kinput.kernelName.c_str(), kinput.kernelName.size());
         output.put('\n');
@@ -921,10 +936,10 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
                                cxuint(entry.symbol), entry.addend);
     
             output.write("    .text\n", 10);
+            isaDisassembler->setSectionCount(kernelSectionCounts[kernelIndex]);
             isaDisassembler->setInput(kinput.codeSize, kinput.code);
             isaDisassembler->beforeDisassemble();
             isaDisassembler->disassemble();
-            sectionCount++;
         }
-    }
+    });
 }
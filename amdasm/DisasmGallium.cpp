@@ -276,6 +276,7 @@ void CLRX::disassembleGallium(std::ostream& output,
     if (doDumpCode && galliumInput->code != nullptr && galliumInput->codeSize != 0)
     {   // print text
         output.write(".text\n", 6);
+        isaDisassembler->setSectionCount(sectionCount);
         isaDisassembler->setInput(galliumInput->codeSize, galliumInput->code);
         isaDisassembler->beforeDisassemble();
         isaDisassembler->disassemble();
@@ -25,6 +25,7 @@
 #include <string>
 #include <ostream>
 #include <utility>
+#include <functional>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/amdbin/AmdBinaries.h>
 #include <CLRX/amdbin/AmdCL2Binaries.h>
@@ -43,13 +44,24 @@ extern CLRX_INTERNAL void printDisasmDataU32(size_t size, const uint32_t* data,
 extern CLRX_INTERNAL void printDisasmLongString(size_t size, const char* data,
             std::ostream& output, bool secondAlign = false);
 
+/* routine that disassembles single kernel (with index) to specified output
+ * with using specified ISA disassembler */
+typedef std::function<void(std::ostream& output, ISADisassembler* isaDisassembler,
+            size_t kernelIndex)> DisasmKernelFunc;
+
+/* disassembles kernels in order. if threadsNum is not 1, kernels are disassembled
+ * in parallel (every kernel to own buffer) and outputs are written in original order */
+extern CLRX_INTERNAL void disassembleKernels(std::ostream& output,
+       ISADisassembler* isaDisassembler, size_t kernelsNum, cxuint threadsNum,
+       const DisasmKernelFunc& disasmKernel);
+
 extern CLRX_INTERNAL void disassembleAmd(std::ostream& output,
        const AmdDisasmInput* amdInput, ISADisassembler* isaDisassembler,
-       size_t& sectionCount, Flags flags);
+       size_t& sectionCount, Flags flags, cxuint threadsNum);
 
 extern CLRX_INTERNAL void disassembleAmdCL2(std::ostream& output,
         const AmdCL2DisasmInput* amdCL2Input, ISADisassembler* isaDisassembler,
-        size_t& sectionCount, Flags flags);
+        size_t& sectionCount, Flags flags, cxuint threadsNum);
 
 extern CLRX_INTERNAL void disassembleGallium(std::ostream& output,
        const GalliumDisasmInput* galliumInput, ISADisassembler* isaDisassembler,
@@ -26,7 +26,9 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <sstream>
 #include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/ThreadPool.h>
 #include <CLRX/amdbin/GalliumBinaries.h>
 #include <CLRX/utils/MemAccess.h>
 #include <CLRX/utils/GPUId.h>
@@ -36,7 +38,13 @@
 using namespace CLRX;
 
 ISADisassembler::ISADisassembler(Disassembler& _disassembler, cxuint outBufSize)
-        : disassembler(_disassembler), output(outBufSize, _disassembler.getOutput())
+        : disassembler(_disassembler), output(outBufSize, _disassembler.getOutput()),
+          sectionCount(0), instrsNum(0)
+{ }
+
+ISADisassembler::ISADisassembler(Disassembler& _disassembler, std::ostream& _output,
+            cxuint outBufSize) : disassembler(_disassembler), output(outBufSize, _output),
+            sectionCount(0), instrsNum(0)
 { }
 
 ISADisassembler::~ISADisassembler()
@@ -79,7 +87,7 @@ void ISADisassembler::writeLabelsToPosition(size_t pos, LabelIter& labelIter,
                 buf[bufPos++] = 'L';
                 bufPos += itocstrCStyle(*labelIter, buf+bufPos, 22, 10, 0, false);
                 buf[bufPos++] = '_';
-                bufPos += itocstrCStyle(disassembler.sectionCount,
+                bufPos += itocstrCStyle(sectionCount,
                                 buf+bufPos, 22, 10, 0, false);
                 if (curPos != pos)
                 {   // if label shifted back by some bytes before encoded instruction
@@ -159,7 +167,7 @@ void ISADisassembler::writeLabelsToEnd(size_t start, LabelIter labelIter,
             buf[bufPos++] = 'L';
             bufPos += itocstrCStyle(*labelIter, buf+bufPos, 22, 10, 0, false);
             buf[bufPos++] = '_';
-            bufPos += itocstrCStyle(disassembler.sectionCount,
+            bufPos += itocstrCStyle(sectionCount,
                             buf+bufPos, 22, 10, 0, false);
             buf[bufPos++] = ':';
             buf[bufPos++] = '\n';
@@ -202,7 +210,7 @@ void ISADisassembler::writeLocation(size_t pos)
     buf[bufPos++] = 'L';
     bufPos += itocstrCStyle(pos, buf+bufPos, 22, 10, 0, false);
     buf[bufPos++] = '_';
-    bufPos += itocstrCStyle(disassembler.sectionCount, buf+bufPos, 22, 10, 0, false);
+    bufPos += itocstrCStyle(sectionCount, buf+bufPos, 22, 10, 0, false);
     output.forward(bufPos);
 }
 
@@ -245,7 +253,7 @@ bool ISADisassembler::writeRelocation(size_t pos, RelocIter& relocIter)
 
 Disassembler::Disassembler(const AmdMainGPUBinary32& binary, std::ostream& _output,
             Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
-            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdInput = getAmdDisasmInputFromBinary32(binary, flags);
@@ -253,7 +261,7 @@ Disassembler::Disassembler(const AmdMainGPUBinary32& binary, std::ostream& _outp
 
 Disassembler::Disassembler(const AmdMainGPUBinary64& binary, std::ostream& _output,
             Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
-            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdInput = getAmdDisasmInputFromBinary64(binary, flags);
@@ -261,7 +269,7 @@ Disassembler::Disassembler(const AmdMainGPUBinary64& binary, std::ostream& _outp
 
 Disassembler::Disassembler(const AmdCL2MainGPUBinary& binary, std::ostream& _output,
            Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMDCL2),
-            amdCL2Input(nullptr), output(_output), flags(_flags), sectionCount(0)
+            amdCL2Input(nullptr), output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdCL2Input = getAmdCL2DisasmInputFromBinary(binary);
@@ -269,14 +277,14 @@ Disassembler::Disassembler(const AmdCL2MainGPUBinary& binary, std::ostream& _out
 
 Disassembler::Disassembler(const AmdDisasmInput* disasmInput, std::ostream& _output,
             Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::AMD),
-            amdInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            amdInput(disasmInput), output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
 
 Disassembler::Disassembler(const AmdCL2DisasmInput* disasmInput, std::ostream& _output,
             Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::AMDCL2),
-            amdCL2Input(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            amdCL2Input(disasmInput), output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
@@ -284,7 +292,7 @@ Disassembler::Disassembler(const AmdCL2DisasmInput* disasmInput, std::ostream& _
 Disassembler::Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary,
            std::ostream& _output, Flags _flags) :
            fromBinary(true), binaryFormat(BinaryFormat::GALLIUM),
-           galliumInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+           galliumInput(nullptr), output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     galliumInput = getGalliumDisasmInputFromBinary(deviceType, binary, flags);
@@ -292,7 +300,7 @@ Disassembler::Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary
 
 Disassembler::Disassembler(const GalliumDisasmInput* disasmInput, std::ostream& _output,
              Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::GALLIUM),
-            galliumInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            galliumInput(disasmInput), output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
@@ -300,7 +308,7 @@ Disassembler::Disassembler(const GalliumDisasmInput* disasmInput, std::ostream&
 Disassembler::Disassembler(GPUDeviceType deviceType, size_t rawCodeSize,
            const cxbyte* rawCode, std::ostream& _output, Flags _flags)
        : fromBinary(true), binaryFormat(BinaryFormat::RAWCODE),
-         output(_output), flags(_flags), sectionCount(0)
+         output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     rawInput = new RawCodeInput{ deviceType, rawCodeSize, rawCode };
@@ -485,12 +493,50 @@ void CLRX::printDisasmLongString(size_t size, const char* data, std::ostream& ou
     }
 }
 
+void CLRX::disassembleKernels(std::ostream& output, ISADisassembler* isaDisassembler,
+            size_t kernelsNum, cxuint threadsNum, const DisasmKernelFunc& disasmKernel)
+{
+    if (threadsNum == 0)
+        threadsNum = ThreadPool::getHardwareThreadsNum();
+    if (threadsNum == 1 || kernelsNum < 2)
+    {   // serial mode
+        for (size_t i = 0; i < kernelsNum; i++)
+            disasmKernel(output, isaDisassembler, i);
+        return;
+    }
+    
+    Disassembler& disassembler = isaDisassembler->getDisassembler();
+    std::vector<std::string> kernelOutputs(kernelsNum);
+    std::vector<size_t> kernelInstrsNums(kernelsNum);
+    ThreadPool threadPool(std::min(size_t(threadsNum), kernelsNum));
+    threadPool.run(kernelsNum, [&disassembler, &kernelOutputs, &kernelInstrsNums,
+                &disasmKernel](size_t i)
+    {
+        std::ostringstream kernelOutput;
+        {   // every kernel has own ISA disassembler and output
+            GCNDisassembler kernelIsaDisasm(disassembler, kernelOutput);
+            disasmKernel(kernelOutput, &kernelIsaDisasm, i);
+            kernelInstrsNums[i] = kernelIsaDisasm.getInstrsNum();
+        }
+        kernelOutputs[i] = kernelOutput.str();
+    });
+    for (size_t instrsNum: kernelInstrsNums)
+        isaDisassembler->addInstrsNum(instrsNum);
+    // write outputs in original order
+    for (std::string& kernelOutput: kernelOutputs)
+    {
+        output.write(kernelOutput.c_str(), kernelOutput.size());
+        std::string().swap(kernelOutput); // free memory
+    }
+}
+
 static void disassembleRawCode(std::ostream& output, const RawCodeInput* rawInput,
        ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
 {
     if ((flags & DISASM_DUMPCODE) != 0)
     {
         output.write(".text\n", 6);
+        isaDisassembler->setSectionCount(sectionCount);
         isaDisassembler->setInput(rawInput->codeSize, rawInput->code);
         isaDisassembler->beforeDisassemble();
         isaDisassembler->disassemble();
@@ -519,9 +565,11 @@ void Disassembler::disassemble()
     output.put('\n');
     
     if (binaryFormat == BinaryFormat::AMD)
-        disassembleAmd(output, amdInput, isaDisassembler.get(), sectionCount, flags);
+        disassembleAmd(output, amdInput, isaDisassembler.get(), sectionCount, flags,
+                   threadsNum);
     else if (binaryFormat == BinaryFormat::AMDCL2)
-        disassembleAmdCL2(output, amdCL2Input, isaDisassembler.get(), sectionCount, flags);
+        disassembleAmdCL2(output, amdCL2Input, isaDisassembler.get(), sectionCount, flags,
+                   threadsNum);
     else if (binaryFormat == BinaryFormat::GALLIUM) // Gallium
         disassembleGallium(output, galliumInput, isaDisassembler.get(),
                    sectionCount, flags);
@@ -0,0 +1,258 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/utils/MemAccess.h>
+#include <CLRX/amdasm/Disassembler.h>
+#include <CLRX/amdasm/GCNAnalyzer.h>
+#include "DisasmInternals.h"
+#include "GCNInternals.h"
+
+using namespace CLRX;
+
+namespace CLRX
+{
+
+/* collects register usage from operands of instructions */
+class CLRX_INTERNAL GCNRegUsage
+{
+private:
+    GCNCodeStats& stats;
+    bool isGCN11;
+    bool isGCN12;
+    cxuint sgprsLimit;  // first operand code that is not SGPR
+public:
+    GCNRegUsage(GCNCodeStats& _stats) : stats(_stats),
+            isGCN11(_stats.arch == GPUArchitecture::GCN1_1),
+            isGCN12(_stats.arch == GPUArchitecture::GCN1_2),
+            sgprsLimit(isGCN12 ? 102 : 104)
+    { }
+
+    void useOperand(const GCNOperand& operand)
+    {
+        switch(operand.type)
+        {
+            case GCNOperandType::SGPR:
+                stats.usedSGPRsNum = std::max(stats.usedSGPRsNum,
+                        std::min(operand.value+operand.regsNum, sgprsLimit));
+                break;
+            case GCNOperandType::VGPR:
+                stats.usedVGPRsNum = std::max(stats.usedVGPRsNum,
+                        std::min(operand.value+operand.regsNum, 256U));
+                break;
+            case GCNOperandType::SREG:
+            {
+                const cxuint op2 = operand.value&~1U;
+                if (op2 == 106)
+                    stats.regFlags |= GCN_VCC;
+                else if ((op2 == 104 && isGCN11) || (op2 == 102 && isGCN12))
+                    stats.regFlags |= GCN_FLAT;
+                else if (op2 == 104 && isGCN12)
+                    stats.regFlags |= GCN_XNACK;
+                break;
+            }
+            default:
+                break;
+        }
+    }
+};
+
+};
+
+GCNCodeStats CLRX::analyzeGCNCode(GPUArchitecture arch, size_t codeSize,
+            const cxbyte* code, size_t localSize)
+{
+    GCNCodeStats stats{};
+    stats.arch = arch;
+    stats.localSize = localSize;
+    GCNRegUsage regUsage(stats);
+    std::vector<GCNInstrRecord> records;
+    decodeGCNCode(arch, codeSize, code, records);
+
+    for (const GCNInstrRecord& record: records)
+    {
+        stats.instrsNum++;
+        stats.encodingInstrsNum[cxuint(record.encoding)]++;
+        const GCNInstruction* gcnInsn = GCNInstrDecoder::getInstruction(record.instrId);
+        if (gcnInsn == nullptr)
+        {
+            stats.illegalInstrsNum++;
+            continue;
+        }
+        for (cxuint i = 0; i < record.operandsNum; i++)
+            regUsage.useOperand(record.operands[i]);
+        switch(record.encoding)
+        {
+            case GCNEncoding::SOPP:
+                if (record.opcode == 12) // S_WAITCNT
+                    stats.waitcntsNum++;
+                break;
+            case GCNEncoding::SMRD:
+            {
+                const uint16_t mode1 = (gcnInsn->mode & GCN_MASK1);
+                if (mode1 != GCN_SMRD_ONLYDST && mode1 != GCN_ARG_NONE)
+                    stats.scalarMemOps++;
+                break;
+            }
+            case GCNEncoding::DS:
+                stats.localMemOps++;
+                break;
+            case GCNEncoding::MUBUF:
+            case GCNEncoding::MTBUF:
+            case GCNEncoding::MIMG:
+            case GCNEncoding::FLAT:
+                stats.vectorMemOps++;
+                break;
+            default:
+                break;
+        }
+    }
+    return stats;
+}
+
+cxuint CLRX::estimateGCNOccupancy(GPUArchitecture arch, cxuint sgprsNum,
+            cxuint vgprsNum, Flags regFlags, size_t localSize, cxuint workGroupSize)
+{
+    const cxuint maxWavesNum = 10;
+    if (sgprsNum > getGPUMaxRegistersNum(arch, REGTYPE_SGPR, regFlags) ||
+        vgprsNum > getGPUMaxRegistersNum(arch, REGTYPE_VGPR, regFlags) ||
+        localSize > getGPUMaxLocalSize(arch))
+        return 0;
+    const bool isGCN12 = (arch == GPUArchitecture::GCN1_2);
+    // VGPRs allocated in 4-register blocks, 256 VGPRs per SIMD lane
+    const cxuint vgprsAlloc = (std::max(vgprsNum, 1U)+3) & ~3U;
+    cxuint wavesNum = std::min(maxWavesNum, 256U/vgprsAlloc);
+    // SGPRs allocated in 8 or 16 (GCN1.2) register blocks
+    const cxuint sgprsGranule = isGCN12 ? 16 : 8;
+    const cxuint sgprsAll = std::max(sgprsNum +
+                getGPUExtraRegsNum(arch, REGTYPE_SGPR, regFlags), 1U);
+    const cxuint sgprsAlloc = (sgprsAll+sgprsGranule-1) & ~(sgprsGranule-1);
+    wavesNum = std::min(wavesNum, (isGCN12 ? 800U : 512U) / sgprsAlloc);
+    if (localSize != 0)
+    {   // 64 KB LDS per compute unit (4 SIMDs)
+        const size_t groupWavesNum = (std::max(workGroupSize, 1U)+63)>>6;
+        const size_t groupsNum = 65536/localSize;
+        wavesNum = std::min(size_t(wavesNum), (groupsNum*groupWavesNum)>>2);
+    }
+    return wavesNum;
+}
+
+cxuint GCNCodeStats::getOccupancy(cxuint workGroupSize) const
+{
+    return estimateGCNOccupancy(arch, usedSGPRsNum, usedVGPRsNum, regFlags, localSize,
+                workGroupSize);
+}
+
+/* kernel binaries */
+
+static size_t getAmdLocalSize(size_t metadataSize, const char* metadata)
+{
+    const char* linePtr = metadata;
+    const char* mtEnd = metadata + metadataSize;
+    while (linePtr != mtEnd)
+    {
+        const char* lineEnd = linePtr;
+        while (lineEnd!=mtEnd && *lineEnd!='\n') lineEnd++;
+        const char* outEnd;
+        if (lineEnd-linePtr >= 16 && ::memcmp(linePtr, ";memory:hwlocal:", 16)==0)
+            return cstrtovCStyle<size_t>(linePtr+16, lineEnd, outEnd);
+        linePtr = (lineEnd!=mtEnd) ? lineEnd+1 : lineEnd;
+    }
+    return 0;
+}
+
+static std::vector<GCNKernelStats> analyzeAmdKernels(const AmdDisasmInput* input)
+{
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(input->deviceType);
+    std::vector<GCNKernelStats> kernelStats(input->kernels.size());
+    for (size_t i = 0; i < input->kernels.size(); i++)
+    {
+        const AmdDisasmKernelInput& kinput = input->kernels[i];
+        kernelStats[i].kernelName = kinput.kernelName;
+        kernelStats[i].stats = analyzeGCNCode(arch, kinput.codeSize, kinput.code,
+                getAmdLocalSize(kinput.metadataSize, kinput.metadata));
+    }
+    return kernelStats;
+}
+
+std::vector<GCNKernelStats> CLRX::analyzeGCNKernels(const AmdMainGPUBinary32& binary)
+{
+    std::unique_ptr<AmdDisasmInput> input(getAmdDisasmInputFromBinary32(binary, 0));
+    return analyzeAmdKernels(input.get());
+}
+
+std::vector<GCNKernelStats> CLRX::analyzeGCNKernels(const AmdMainGPUBinary64& binary)
+{
+    std::unique_ptr<AmdDisasmInput> input(getAmdDisasmInputFromBinary64(binary, 0));
+    return analyzeAmdKernels(input.get());
+}
+
+std::vector<GCNKernelStats> CLRX::analyzeGCNKernels(const AmdCL2MainGPUBinary& binary)
+{
+    std::unique_ptr<AmdCL2DisasmInput> input(getAmdCL2DisasmInputFromBinary(binary));
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(input->deviceType);
+    std::vector<GCNKernelStats> kernelStats(input->kernels.size());
+    for (size_t i = 0; i < input->kernels.size(); i++)
+    {
+        const AmdCL2DisasmKernelInput& kinput = input->kernels[i];
+        // local size is in kernel setup (after 48-byte header)
+        const uint32_t localSize = (kinput.setupSize >= 68) ?
+                ULEV(*reinterpret_cast<const uint32_t*>(kinput.setup + 64)) : 0;
+        kernelStats[i].kernelName = kinput.kernelName;
+        kernelStats[i].stats = analyzeGCNCode(arch, kinput.codeSize, kinput.code,
+                    localSize);
+    }
+    return kernelStats;
+}
+
+std::vector<GCNKernelStats> CLRX::analyzeGCNKernels(GPUDeviceType deviceType,
+            const GalliumBinary& binary)
+{
+    std::unique_ptr<GalliumDisasmInput> input(getGalliumDisasmInputFromBinary(
+                deviceType, binary, 0));
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(deviceType);
+    const cxuint ldsShift = arch<GPUArchitecture::GCN1_1 ? 8 : 9;
+    // kernel code ends at start of next kernel code
+    std::vector<size_t> offsets;
+    for (const GalliumDisasmKernelInput& kinput: input->kernels)
+        offsets.push_back(kinput.offset);
+    offsets.push_back(input->codeSize);
+    std::sort(offsets.begin(), offsets.end());
+
+    std::vector<GCNKernelStats> kernelStats(input->kernels.size());
+    for (size_t i = 0; i < input->kernels.size(); i++)
+    {
+        const GalliumDisasmKernelInput& kinput = input->kernels[i];
+        const size_t offset = std::min(size_t(kinput.offset), input->codeSize);
+        const auto endIt = std::upper_bound(offsets.begin(), offsets.end(), offset);
+        const size_t end = (endIt != offsets.end()) ? *endIt : input->codeSize;
+        // second program info entry is PGM_RSRC2
+        const size_t localSize = ((kinput.progInfo[1].value>>15) & 0x1ff) << ldsShift;
+        kernelStats[i].kernelName = kinput.kernelName;
+        kernelStats[i].stats = analyzeGCNCode(arch, end-offset,
+                    input->code + offset, localSize);
+    }
+    return kernelStats;
+}
@@ -33,6 +33,137 @@ using namespace CLRX;
 static std::once_flag clrxGCNAssemblerOnceFlag;
 static Array<GCNAsmInstruction> gcnInstrSortedTable;
 
+/* perfect hash of the mnemonics (hash and displace method).
+ * first level hash choose bucket, the bucket holds seed which used to compute
+ * final slot in table. every slot holds first entries in gcnInstrSortedTable
+ * for every GPU architecture */
+struct CLRX_INTERNAL GCNMnemonicHashEntry
+{
+    const char* mnemonic;
+    // indices of first entry for every architecture (UINT16_MAX - no instruction)
+    uint16_t archIndices[cxuint(GPUArchitecture::GPUARCH_MAX)+1];
+};
+
+static Array<uint32_t> gcnMnemonicHashSeeds;
+static Array<GCNMnemonicHashEntry> gcnMnemonicHashTable;
+
+static inline uint32_t gcnMnemonicHash(const char* mnemonic, size_t length)
+{   // FNV-1a
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < length; i++)
+        hash = (hash ^ cxbyte(mnemonic[i])) * 16777619U;
+    return hash;
+}
+
+static inline uint32_t gcnMnemonicHashSlot(uint32_t hash, uint32_t seed)
+{   // murmur3 finalizer
+    uint32_t h = hash ^ (seed*0x9e3779b9U);
+    h ^= h>>16;
+    h *= 0x85ebca6bU;
+    h ^= h>>13;
+    h *= 0xc2b2ae35U;
+    h ^= h>>16;
+    return h;
+}
+
+// returns hash table entry or null if mnemonic (first length characters) not found
+static const GCNMnemonicHashEntry* findGCNMnemonic(const char* mnemonic, size_t length)
+{
+    const uint32_t hash = gcnMnemonicHash(mnemonic, length);
+    const uint32_t seed = gcnMnemonicHashSeeds[hash & (gcnMnemonicHashSeeds.size()-1)];
+    const GCNMnemonicHashEntry& entry = gcnMnemonicHashTable[
+            gcnMnemonicHashSlot(hash, seed) & (gcnMnemonicHashTable.size()-1)];
+    if (entry.mnemonic==nullptr || ::strncmp(entry.mnemonic, mnemonic, length)!=0 ||
+        entry.mnemonic[length]!=0)
+        return nullptr;
+    return &entry;
+}
+
+static void initializeGCNMnemonicHash()
+{
+    const size_t tableSize = gcnInstrSortedTable.size();
+    // collect distinct mnemonics (entries are sorted by mnemonic)
+    std::vector<GCNMnemonicHashEntry> mnemonics;
+    for (size_t i = 0; i < tableSize; i++)
+    {
+        if (i == 0 || ::strcmp(gcnInstrSortedTable[i-1].mnemonic,
+                    gcnInstrSortedTable[i].mnemonic)!=0)
+        {
+            GCNMnemonicHashEntry entry{ gcnInstrSortedTable[i].mnemonic };
+            std::fill(entry.archIndices, entry.archIndices +
+                    cxuint(GPUArchitecture::GPUARCH_MAX)+1, UINT16_MAX);
+            mnemonics.push_back(entry);
+        }
+        GCNMnemonicHashEntry& entry = mnemonics.back();
+        for (cxuint arch = 0; arch <= cxuint(GPUArchitecture::GPUARCH_MAX); arch++)
+            if (entry.archIndices[arch]==UINT16_MAX &&
+                (gcnInstrSortedTable[i].archMask & (1U<<arch))!=0)
+                entry.archIndices[arch] = i;
+    }
+    
+    // table size and buckets number must be power of two
+    size_t hashTableSize = 1;
+    while (hashTableSize < mnemonics.size())
+        hashTableSize <<= 1;
+    const size_t bucketsNum = std::max(size_t(1), hashTableSize>>1);
+    
+    std::vector<uint32_t> hashes(mnemonics.size());
+    std::vector<std::vector<cxuint> > buckets(bucketsNum);
+    for (cxuint i = 0; i < mnemonics.size(); i++)
+    {
+        hashes[i] = gcnMnemonicHash(mnemonics[i].mnemonic,
+                    ::strlen(mnemonics[i].mnemonic));
+        buckets[hashes[i] & (bucketsNum-1)].push_back(i);
+    }
+    // place biggest buckets first
+    std::vector<cxuint> bucketOrder(bucketsNum);
+    for (cxuint i = 0; i < bucketsNum; i++)
+        bucketOrder[i] = i;
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(),
+            [&buckets](cxuint b1, cxuint b2)
+            { return buckets[b1].size() > buckets[b2].size(); });
+    
+    gcnMnemonicHashSeeds.resize(bucketsNum);
+    std::fill(gcnMnemonicHashSeeds.begin(), gcnMnemonicHashSeeds.end(), 0);
+    gcnMnemonicHashTable.resize(hashTableSize);
+    std::fill(gcnMnemonicHashTable.begin(), gcnMnemonicHashTable.end(),
+              GCNMnemonicHashEntry{ nullptr });
+    std::vector<bool> usedSlots(hashTableSize, false);
+    std::vector<size_t> bucketSlots;
+    for (cxuint bucket: bucketOrder)
+    {
+        const std::vector<cxuint>& keys = buckets[bucket];
+        if (keys.empty())
+            break;
+        for (uint32_t seed = 1; ; seed++)
+        {   // find seed that puts all keys from bucket to free slots
+            bucketSlots.clear();
+            bool good = true;
+            for (cxuint key: keys)
+            {
+                const size_t slot = gcnMnemonicHashSlot(hashes[key], seed) &
+                        (hashTableSize-1);
+                if (usedSlots[slot] || std::find(bucketSlots.begin(),
+                            bucketSlots.end(), slot) != bucketSlots.end())
+                {
+                    good = false;
+                    break;
+                }
+                bucketSlots.push_back(slot);
+            }
+            if (!good)
+                continue;
+            gcnMnemonicHashSeeds[bucket] = seed;
+            for (size_t k = 0; k < keys.size(); k++)
+            {
+                usedSlots[bucketSlots[k]] = true;
+                gcnMnemonicHashTable[bucketSlots[k]] = mnemonics[keys[k]];
+            }
+            break;
+        }
+    }
+}
+
 static void initializeGCNAssembler()
 {
     size_t tableSize = 0;
@@ -112,6 +243,7 @@ static void initializeGCNAssembler()
         std::cout << "{ " << instr.mnemonic << ", " << cxuint(instr.encoding) <<
                 std::hex << ", 0x" << instr.mode << ", 0x" << instr.code1 << ", 0x" <<
                 instr.code2 << std::dec << ", " << instr.archMask << " }" << std::endl;*/
+    initializeGCNMnemonicHash();
 }
 
 GCNAssembler::GCNAssembler(Assembler& assembler): ISAAssembler(assembler),
@@ -2725,53 +2857,47 @@ void GCNAsmUtils::parseFLATEncoding(Assembler& asmr, const GCNAsmInstruction& gc
 void GCNAssembler::assemble(const CString& inMnemonic, const char* mnemPlace,
             const char* linePtr, const char* lineEnd, std::vector<cxbyte>& output)
 {
-    CString mnemonic;
+    size_t mnemLen;
     size_t inMnemLen = inMnemonic.size();
     GCNEncSize gcnEncSize = GCNEncSize::UNKNOWN;
     GCNVOPEnc vopEnc = GCNVOPEnc::NORMAL;
     if (inMnemLen>4 && ::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_e64")==0)
     {
         gcnEncSize = GCNEncSize::BIT64;
-        mnemonic = inMnemonic.substr(0, inMnemLen-4);
+        mnemLen = inMnemLen-4;
     }
     else if (inMnemLen>4 && ::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_e32")==0)
     {
         gcnEncSize = GCNEncSize::BIT32;
-        mnemonic = inMnemonic.substr(0, inMnemLen-4);
+        mnemLen = inMnemLen-4;
     }
     else if (inMnemLen>6 && toLower(inMnemonic[0])=='v' && inMnemonic[1]=='_' &&
         ::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_dpp")==0)
     {
         vopEnc = GCNVOPEnc::DPP;
-        mnemonic = inMnemonic.substr(0, inMnemLen-4);
+        mnemLen = inMnemLen-4;
     }
     else if (inMnemLen>7 && toLower(inMnemonic[0])=='v' && inMnemonic[1]=='_' &&
         ::strcasecmp(inMnemonic.c_str()+inMnemLen-5, "_sdwa")==0)
     {
         vopEnc = GCNVOPEnc::SDWA;
-        mnemonic = inMnemonic.substr(0, inMnemLen-5);
+        mnemLen = inMnemLen-5;
     }
     else
-        mnemonic = inMnemonic;
-    
-    auto it = binaryFind(gcnInstrSortedTable.begin(), gcnInstrSortedTable.end(),
-               GCNAsmInstruction{mnemonic.c_str()},
-               [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
-               { return ::strcmp(instr1.mnemonic, instr2.mnemonic)<0; });
-    
-    // find matched entry
-    if (it != gcnInstrSortedTable.end() && (it->archMask & curArchMask)==0)
-        // if not match current arch mask
-        for (++it ;it != gcnInstrSortedTable.end() &&
-               ::strcmp(it->mnemonic, mnemonic.c_str())==0 &&
-               (it->archMask & curArchMask)==0; ++it);
-
-    if (it == gcnInstrSortedTable.end() || ::strcmp(it->mnemonic, mnemonic.c_str())!=0)
+        mnemLen = inMnemLen;
+    
+    const GCNMnemonicHashEntry* hashEntry = findGCNMnemonic(inMnemonic.c_str(),
+                    mnemLen);
+    const cxuint curArch = 31-CLZ32(curArchMask);
+    if (hashEntry == nullptr || hashEntry->archIndices[curArch]==UINT16_MAX)
     {   // unrecognized mnemonic
         printError(mnemPlace, "Unknown instruction");
         return;
     }
+    const GCNAsmInstruction* it = gcnInstrSortedTable.data() +
+                hashEntry->archIndices[curArch];
     
+    AsmStatsTimer timer(getEncodingStats(it->encoding));
     /* decode instruction line */
     switch(it->encoding)
     {
@@ -2966,25 +3092,22 @@ bool GCNAssembler::resolveCode(const AsmSourcePos& sourcePos, cxuint targetSecti
 
 bool GCNAssembler::checkMnemonic(const CString& inMnemonic) const
 {
-    CString mnemonic;
+    size_t mnemLen;
     size_t inMnemLen = inMnemonic.size();
     if (inMnemLen>4 &&
         (::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_e64")==0 ||
             ::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_e32")==0))
-        mnemonic = inMnemonic.substr(0, inMnemLen-4);
+        mnemLen = inMnemLen-4;
     else if (inMnemLen>6 && toLower(inMnemonic[0])=='v' && inMnemonic[1]=='_' &&
         ::strcasecmp(inMnemonic.c_str()+inMnemLen-4, "_dpp")==0)
-        mnemonic = inMnemonic.substr(0, inMnemLen-4);
+        mnemLen = inMnemLen-4;
     else if (inMnemLen>7 && toLower(inMnemonic[0])=='v' && inMnemonic[1]=='_' &&
         ::strcasecmp(inMnemonic.c_str()+inMnemLen-5, "_sdwa")==0)
-        mnemonic = inMnemonic.substr(0, inMnemLen-5);
+        mnemLen = inMnemLen-5;
     else
-        mnemonic = inMnemonic;
+        mnemLen = inMnemLen;
     
-    return std::binary_search(gcnInstrSortedTable.begin(), gcnInstrSortedTable.end(),
-               GCNAsmInstruction{mnemonic.c_str()},
-               [](const GCNAsmInstruction& instr1, const GCNAsmInstruction& instr2)
-               { return ::strcmp(instr1.mnemonic, instr2.mnemonic)<0; });
+    return findGCNMnemonic(inMnemonic.c_str(), mnemLen) != nullptr;
 }
 
 void GCNAssembler::setAllocatedRegisters(const cxuint* inRegs, Flags inRegFlags)
@@ -3034,3 +3157,23 @@ bool GCNAssembler::relocationIsFit(cxuint bits, AsmExprTargetType tgtType)
         return tgtType==GCNTGT_SOPJMP || tgtType==GCNTGT_LITIMM;
     return false;
 }
+
+// names of encodings (indexed by GCNENC_*)
+static const char* gcnEncodingNamesTbl[GCNENC_MAXVAL+1] =
+{
+    "NONE", "SOPC", "SOPP", "SOP1", "SOP2", "SOPK", "SMRD", "VOPC", "VOP1", "VOP2",
+    "VOP3A", "VOP3B", "VINTRP", "DS", "MUBUF", "MTBUF", "MIMG", "EXP", "FLAT"
+};
+
+static const char* gcn12EncodingNamesTbl[GCNENC_MAXVAL+1] =
+{
+    "NONE", "SOPC", "SOPP", "SOP1", "SOP2", "SOPK", "SMEM", "VOPC", "VOP1", "VOP2",
+    "VOP3A", "VOP3B", "VINTRP", "DS", "MUBUF", "MTBUF", "MIMG", "EXP", "FLAT"
+};
+
+const char* const* GCNAssembler::getEncodingNames(cxuint& encodingsNum) const
+{
+    encodingsNum = GCNENC_MAXVAL+1;
+    return ((curArchMask & ARCH_RX3X0) != 0) ? gcn12EncodingNamesTbl :
+            gcnEncodingNamesTbl;
+}
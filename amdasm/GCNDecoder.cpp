@@ -0,0 +1,390 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/utils/MemAccess.h>
+#include <CLRX/amdasm/GCNDecoder.h>
+#include "GCNInternals.h"
+
+using namespace CLRX;
+
+static_assert(cxuint(GCNEncoding::MAXVAL) == GCNENC_MAXVAL,
+              "GCNEncoding doesn't match to internal GCN encodings");
+
+namespace CLRX
+{
+
+/* puts operands to instruction record */
+class CLRX_INTERNAL GCNOperandsBuilder
+{
+private:
+    GCNInstrRecord& record;
+    cxuint sgprsLimit;  // first operand code that is not SGPR
+    bool literalAllowed;
+
+    void add(GCNOperandType type, cxuint regsNum, uint32_t value)
+    {
+        if (record.operandsNum >= GCN_MAX_OPERANDS)
+            return;
+        GCNOperand& operand = record.operands[record.operandsNum++];
+        operand.type = type;
+        operand.regsNum = regsNum;
+        operand.value = value;
+    }
+public:
+    GCNOperandsBuilder(GCNInstrRecord& _record, bool isGCN12, bool _literalAllowed)
+            : record(_record), sgprsLimit(isGCN12 ? 102 : 104),
+              literalAllowed(_literalAllowed)
+    { }
+
+    // operand: 0-127 scalar registers, 128-255 constants, 256-511 - VGPRs
+    void addOperand(cxuint op, cxuint regsNum)
+    {
+        if (op < sgprsLimit)
+            add(GCNOperandType::SGPR, regsNum, op);
+        else if (op >= 256)
+            add(GCNOperandType::VGPR, regsNum, op-256);
+        else if (op == 255 && literalAllowed)
+            add(GCNOperandType::LITERAL, 1, record.words[1]);
+        else if ((op >= 128 && op <= 208) || (op >= 240 && op <= 248))
+            add(GCNOperandType::CONSTANT, regsNum, op);
+        else
+            add(GCNOperandType::SREG, regsNum, op);
+    }
+
+    void addVRegs(cxuint reg, cxuint regsNum)
+    { add(GCNOperandType::VGPR, regsNum, reg); }
+
+    void addVCC()
+    { add(GCNOperandType::SREG, 2, 106); }
+
+    void addLiteral()
+    { add(GCNOperandType::LITERAL, 1, record.words[1]); }
+
+    void addImmediate(uint32_t value)
+    { add(GCNOperandType::IMMEDIATE, 0, value); }
+};
+
+};
+
+/* source operand of VOP instruction (with SDWA/DPP extra word) */
+static inline cxuint getVOPSrc0(bool isGCN12, uint32_t insnCode, uint32_t literal)
+{
+    const cxuint src0 = insnCode&0x1ff;
+    if (isGCN12 && (src0 == 0xf9 || src0 == 0xfa))
+        return 256 + (literal&0xff); // SDWA or DPP, src0 is VGPR
+    return src0;
+}
+
+/* fill operands in order of assembler syntax, register counts follows disassembler */
+static void decodeGCNOperands(GCNInstrRecord& record, const GCNInstruction& gcnInsn,
+            bool isGCN12)
+{
+    const cxbyte encoding = cxbyte(record.encoding);
+    const uint32_t insnCode = record.words[0];
+    const uint32_t insnCode2 = record.words[1];
+    const uint16_t mode1 = (gcnInsn.mode & GCN_MASK1);
+    // second word is literal only in SOP*/VOP* and SMRD (GCN1.1)
+    const bool literalAllowed = encoding <= GCNENC_VOP2 &&
+            (encoding != GCNENC_SMRD || !isGCN12);
+    GCNOperandsBuilder builder(record, isGCN12, literalAllowed);
+    switch(encoding)
+    {
+        case GCNENC_SOPC:
+            builder.addOperand(insnCode&0xff, (gcnInsn.mode&GCN_REG_SRC0_64)?2:1);
+            if (mode1 != GCN_SRC1_IMM)
+                builder.addOperand((insnCode>>8)&0xff, (gcnInsn.mode&GCN_REG_SRC1_64)?2:1);
+            else
+                builder.addImmediate((insnCode>>8)&0xff);
+            break;
+        case GCNENC_SOPP:
+            if (mode1 != GCN_IMM_NONE)
+                builder.addImmediate(insnCode&0xffff);
+            if (record.opcode == 6 || record.opcode == 7)
+                builder.addVCC(); // S_CBRANCH_VCCZ, S_CBRANCH_VCCNZ
+            break;
+        case GCNENC_SOP1:
+            if (mode1 != GCN_DST_NONE)
+                builder.addOperand((insnCode>>16)&0x7f, (gcnInsn.mode&GCN_REG_DST_64)?2:1);
+            if (mode1 != GCN_SRC_NONE)
+                builder.addOperand(insnCode&0xff, (gcnInsn.mode&GCN_REG_SRC0_64)?2:1);
+            break;
+        case GCNENC_SOP2:
+            if (mode1 != GCN_DST_NONE)
+                builder.addOperand((insnCode>>16)&0x7f, (gcnInsn.mode&GCN_REG_DST_64)?2:1);
+            builder.addOperand(insnCode&0xff, (gcnInsn.mode&GCN_REG_SRC0_64)?2:1);
+            builder.addOperand((insnCode>>8)&0xff, (gcnInsn.mode&GCN_REG_SRC1_64)?2:1);
+            break;
+        case GCNENC_SOPK:
+            if ((gcnInsn.mode & GCN_IMM_DST) == 0)
+                builder.addOperand((insnCode>>16)&0x7f, (gcnInsn.mode&GCN_REG_DST_64)?2:1);
+            builder.addImmediate(insnCode&0xffff);
+            if ((gcnInsn.mode & GCN_SOPK_SRIMM32) == GCN_SOPK_SRIMM32)
+                builder.addLiteral();
+            else if ((gcnInsn.mode & GCN_IMM_DST) != 0)
+                builder.addOperand((insnCode>>16)&0x7f, (gcnInsn.mode&GCN_REG_DST_64)?2:1);
+            break;
+        case GCNENC_SMRD:
+        {
+            const cxuint dstField = isGCN12 ? ((insnCode>>6)&0x7f) : ((insnCode>>15)&0x7f);
+            if (mode1 == GCN_SMRD_ONLYDST)
+                builder.addOperand(dstField, (gcnInsn.mode&GCN_REG_DST_64)?2:1);
+            else if (mode1 != GCN_ARG_NONE)
+            {
+                const cxuint dregsNum = 1<<((gcnInsn.mode & GCN_DSIZE_MASK)>>GCN_SHIFT2);
+                if (isGCN12 && (mode1 & GCN_SMEM_SDATA_IMM) != 0)
+                    builder.addImmediate(dstField);
+                else
+                    builder.addOperand(dstField, dregsNum);
+                builder.addOperand(isGCN12 ? ((insnCode<<1)&0x7e) : ((insnCode>>8)&0x7e),
+                            (gcnInsn.mode&GCN_SBASE4)?4:2);
+                if (!isGCN12)
+                {
+                    if ((insnCode&0x100) == 0)
+                        builder.addOperand(insnCode&0xff, 1);
+                    else
+                        builder.addImmediate(insnCode&0xff);
+                }
+                else if ((insnCode&0x20000) == 0)
+                    builder.addOperand(insnCode2&0xff, 1);
+                else
+                    builder.addImmediate(insnCode2&0xfffff);
+            }
+            break;
+        }
+        case GCNENC_VOPC:
+            builder.addVCC();
+            builder.addOperand(getVOPSrc0(isGCN12, insnCode, insnCode2),
+                        (gcnInsn.mode&GCN_REG_SRC0_64)?2:1);
+            builder.addVRegs((insnCode>>9)&0xff, (gcnInsn.mode&GCN_REG_SRC1_64)?2:1);
+            break;
+        case GCNENC_VOP1:
+            if (mode1 == GCN_VOP_ARG_NONE)
+                break;
+            if (mode1 == GCN_DST_SGPR)
+                builder.addOperand((insnCode>>17)&0xff, 1);
+            else
+                builder.addVRegs((insnCode>>17)&0xff, (gcnInsn.mode&GCN_REG_DST_64)?2:1);
+            builder.addOperand(getVOPSrc0(isGCN12, insnCode, insnCode2),
+                        (gcnInsn.mode&GCN_REG_SRC0_64)?2:1);
+            break;
+        case GCNENC_VOP2:
+            if (mode1 == GCN_DS1_SGPR)
+                builder.addOperand((insnCode>>17)&0xff, (gcnInsn.mode&GCN_REG_DST_64)?2:1);
+            else
+                builder.addVRegs((insnCode>>17)&0xff, (gcnInsn.mode&GCN_REG_DST_64)?2:1);
+            if (mode1 == GCN_DS2_VCC || mode1 == GCN_DST_VCC)
+                builder.addVCC();
+            builder.addOperand(getVOPSrc0(isGCN12, insnCode, insnCode2),
+                        (gcnInsn.mode&GCN_REG_SRC0_64)?2:1);
+            if (mode1 == GCN_ARG1_IMM)
+                builder.addLiteral();
+            if (mode1 == GCN_DS1_SGPR || mode1 == GCN_SRC1_SGPR)
+                builder.addOperand((insnCode>>9)&0xff, (gcnInsn.mode&GCN_REG_SRC1_64)?2:1);
+            else
+                builder.addVRegs((insnCode>>9)&0xff, (gcnInsn.mode&GCN_REG_SRC1_64)?2:1);
+            if (mode1 == GCN_ARG2_IMM)
+                builder.addLiteral();
+            else if (mode1 == GCN_DS2_VCC || mode1 == GCN_SRC2_VCC)
+                builder.addVCC();
+            break;
+        case GCNENC_VOP3A:
+        {
+            if (mode1 == GCN_VOP_ARG_NONE)
+                break;
+            const uint16_t vop3Mode = (gcnInsn.mode&GCN_VOP3_MASK2);
+            const bool is128Ops = (gcnInsn.mode&0xf000)==GCN_VOP3_DS2_128;
+            const cxuint vdst = insnCode&0xff;
+            if (record.opcode < 256 || (gcnInsn.mode&GCN_VOP3_DST_SGPR)!=0) /* if compares */
+                builder.addOperand(vdst, ((gcnInsn.mode&GCN_VOP3_DST_SGPR)==0)?2:1);
+            else
+                builder.addVRegs(vdst, (is128Ops) ? 4 : ((gcnInsn.mode&GCN_REG_DST_64)?2:1));
+            if (gcnInsn.encoding == GCNENC_VOP3B &&
+                (mode1 == GCN_DS2_VCC || mode1 == GCN_DST_VCC ||
+                 mode1 == GCN_DST_VCC_VSRC2 || mode1 == GCN_S0EQS12))
+                builder.addOperand((insnCode>>8)&0x7f, 2);
+            if (vop3Mode == GCN_VOP3_VINTRP)
+            {
+                if (mode1 != GCN_P0_P10_P20)
+                    builder.addOperand((insnCode2>>9)&0x1ff, 1);
+                if ((gcnInsn.mode & GCN_VOP3_MASK3) == GCN_VINTRP_SRC2)
+                    builder.addOperand((insnCode2>>18)&0x1ff, 1);
+                break;
+            }
+            builder.addOperand(insnCode2&0x1ff, (gcnInsn.mode&GCN_REG_SRC0_64)?2:1);
+            if (mode1 == GCN_SRC12_NONE)
+                break;
+            builder.addOperand((insnCode2>>9)&0x1ff, (gcnInsn.mode&GCN_REG_SRC1_64)?2:1);
+            if (mode1 != GCN_SRC2_NONE && mode1 != GCN_DST_VCC && record.opcode >= 256)
+            {
+                if (mode1 == GCN_DS2_VCC || mode1 == GCN_SRC2_VCC)
+                    builder.addOperand((insnCode2>>18)&0x1ff, 2);
+                else
+                    builder.addOperand((insnCode2>>18)&0x1ff, is128Ops ? 4 :
+                                (gcnInsn.mode&GCN_REG_SRC2_64)?2:1);
+            }
+            break;
+        }
+        case GCNENC_VINTRP:
+            builder.addVRegs((insnCode>>18)&0xff, 1);
+            if (mode1 != GCN_P0_P10_P20)
+                builder.addVRegs(insnCode&0xff, 1);
+            else
+                builder.addImmediate(insnCode&3); // P0, P10 or P20
+            break;
+        case GCNENC_DS:
+        {
+            if ((gcnInsn.mode & GCN_ADDR_SRC) != 0 || (gcnInsn.mode & GCN_ONLYDST) != 0)
+            {
+                cxuint regsNum = (gcnInsn.mode&GCN_REG_DST_64)?2:1;
+                if ((gcnInsn.mode&GCN_DS_96) != 0)
+                    regsNum = 3;
+                if ((gcnInsn.mode&GCN_DS_128) != 0 || (gcnInsn.mode&GCN_DST128) != 0)
+                    regsNum = 4;
+                builder.addVRegs(insnCode2>>24, regsNum);
+            }
+            if ((gcnInsn.mode & GCN_ONLYDST) != 0)
+                break;
+            builder.addVRegs(insnCode2&0xff, 1);
+            const uint16_t srcMode = (gcnInsn.mode & GCN_SRCS_MASK);
+            if ((gcnInsn.mode & (GCN_ADDR_DST|GCN_ADDR_SRC)) != 0 && srcMode != GCN_NOSRC)
+            {
+                cxuint regsNum = (gcnInsn.mode&GCN_REG_SRC0_64)?2:1;
+                if ((gcnInsn.mode&GCN_DS_96) != 0)
+                    regsNum = 3;
+                if ((gcnInsn.mode&GCN_DS_128) != 0)
+                    regsNum = 4;
+                builder.addVRegs((insnCode2>>8)&0xff, regsNum);
+                if (srcMode == GCN_2SRCS)
+                    builder.addVRegs((insnCode2>>16)&0xff,
+                                (gcnInsn.mode&GCN_REG_SRC1_64)?2:1);
+            }
+            builder.addImmediate(insnCode&0xffff); // offset0 and offset1
+            break;
+        }
+        case GCNENC_MUBUF:
+        case GCNENC_MTBUF:
+            if (mode1 == GCN_ARG_NONE)
+                break;
+            if (mode1 != GCN_MUBUF_NOVAD)
+            {
+                cxuint dregsNum = ((gcnInsn.mode&GCN_DSIZE_MASK)>>GCN_SHIFT2)+1;
+                if (insnCode2 & 0x800000U)
+                    dregsNum++; // tfe
+                builder.addVRegs((insnCode2>>8)&0xff, dregsNum);
+                // for addr32 - idxen+offen or 1, for addr64 - 2
+                builder.addVRegs(insnCode2&0xff, ((insnCode & 0x3000U)==0x3000U ||
+                        (!isGCN12 && (insnCode & 0x8000U)))? 2 : 1);
+            }
+            builder.addOperand(((insnCode2>>16)&0x1f)<<2, 4);
+            builder.addOperand(insnCode2>>24, 1);
+            builder.addImmediate(insnCode&0xfff);
+            break;
+        case GCNENC_MIMG:
+        {
+            cxuint dregsNum = 4;
+            if ((gcnInsn.mode & GCN_MIMG_VDATA4) == 0)
+            {
+                const cxuint dmask = (insnCode>>8)&15;
+                dregsNum = ((dmask & 1)?1:0) + ((dmask & 2)?1:0) + ((dmask & 4)?1:0) +
+                        ((dmask & 8)?1:0);
+                dregsNum = (dregsNum == 0) ? 1 : dregsNum;
+            }
+            if (insnCode & 0x10000)
+                dregsNum++; // tfe
+            builder.addVRegs((insnCode2>>8)&0xff, dregsNum);
+            builder.addVRegs(insnCode2&0xff, std::max(4, (gcnInsn.mode&GCN_MIMG_VA_MASK)+1));
+            builder.addOperand((insnCode2>>14)&0x7c, (insnCode & 0x8000)?4:8);
+            if ((gcnInsn.mode & GCN_MIMG_SAMPLE) != 0)
+                builder.addOperand(((insnCode2>>21)&0x1f)<<2, 4);
+            break;
+        }
+        case GCNENC_EXP:
+            for (cxuint i = 0; i < 4; i++)
+                if ((insnCode & (1U<<i)) != 0)
+                    builder.addVRegs((insnCode2>>(i<<3))&0xff, 1);
+            break;
+        case GCNENC_FLAT:
+        {
+            const cxuint dregsNum = ((gcnInsn.mode&GCN_DSIZE_MASK)>>GCN_SHIFT2)+1;
+            // cmpswap store only to half of number of data registers
+            cxuint dstRegsNum = ((gcnInsn.mode & GCN_CMPSWAP)!=0) ?
+                        (dregsNum>>1) : dregsNum;
+            dstRegsNum = (insnCode2 & 0x800000U)?dstRegsNum+1:dstRegsNum;
+            if ((gcnInsn.mode & GCN_FLAT_ADST) == 0)
+            {
+                builder.addVRegs(insnCode2>>24, dstRegsNum);
+                builder.addVRegs(insnCode2&0xff, 2); // addr
+            }
+            else
+            {
+                builder.addVRegs(insnCode2&0xff, 2); // addr
+                if ((gcnInsn.mode & GCN_FLAT_NODST) == 0)
+                    builder.addVRegs(insnCode2>>24, dstRegsNum);
+            }
+            if ((gcnInsn.mode & GCN_FLAT_NODATA) == 0)
+                builder.addVRegs((insnCode2>>8)&0xff, dregsNum);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void GCNInstrDecoder::decodeOperands(GCNInstrRecord& record,
+            const GCNInstruction& gcnInsn) const
+{
+    decodeGCNOperands(record, gcnInsn, arch == GPUArchitecture::GCN1_2);
+}
+
+void CLRX::decodeGCNCode(GPUArchitecture arch, size_t codeSize, const cxbyte* code,
+            std::vector<GCNInstrRecord>& records, size_t relocOffsetsNum,
+            const size_t* relocOffsets)
+{
+    records.clear();
+    const GCNInstrDecoder decoder(arch);
+    const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(code);
+    const size_t codeWordsNum = codeSize>>2;
+    size_t relocIndex = 0;
+
+    for (size_t pos = 0; pos < codeWordsNum; )
+    {
+        GCNInstrRecord record{};
+        decoder.decodeRecord(codeWords, codeWordsNum, pos, record);
+        pos += record.length;
+
+        // find relocation placed in instruction words
+        while (relocIndex < relocOffsetsNum && relocOffsets[relocIndex] < record.offset)
+            relocIndex++;
+        if (relocIndex < relocOffsetsNum && relocOffsets[relocIndex] < (pos<<2))
+            record.relocIndex = relocIndex;
+        records.push_back(record);
+    }
+}
+
+const char* CLRX::getGCNInstrMnemonic(uint16_t instrId)
+{
+    const GCNInstruction* gcnInsn = GCNInstrDecoder::getInstruction(instrId);
+    return (gcnInsn != nullptr) ? gcnInsn->mnemonic : nullptr;
+}
@@ -19,12 +19,18 @@
 
 #include <CLRX/Config.h>
 #include <algorithm>
+#include <climits>
 #include <cstring>
 #include <mutex>
 #include <memory>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GCNDISASM_USE_SSE2 1
+#endif
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/GPUId.h>
 #include <CLRX/amdasm/Disassembler.h>
+#include <CLRX/amdasm/GCNDecoder.h>
 #include <CLRX/utils/MemAccess.h>
 #include "GCNInternals.h"
 
@@ -112,6 +118,10 @@ struct CLRX_INTERNAL GCNDisasmUtils
     
     static void decodeFLATEncoding(GCNDisassembler& dasm, cxuint spacesToAdd, uint16_t arch,
              const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t insnCode2);
+    
+    static void printInstruction(GCNDisassembler& dasm, const GCNInstrDecoder& decoder,
+             uint16_t curArchMask, const GCNInstrRecord& record, size_t pos,
+             RelocIter& curReloc);
 };
 
 };
@@ -179,53 +189,6 @@ static const GCNEncodingSpace gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2] =
 
 static const size_t gcnInstrTableByCodeLength = 0x1922;
 
-static void initializeGCNDisassembler()
-{
-    gcnInstrTableByCode.reset(new GCNInstruction[gcnInstrTableByCodeLength]);
-    for (cxuint i = 0; i < gcnInstrTableByCodeLength; i++)
-    {
-        gcnInstrTableByCode[i].mnemonic = nullptr;
-        gcnInstrTableByCode[i].mode = GCN_STDMODE;
-        // except VOP3 decoding routines ignores encoding (we can set None for encoding)
-        gcnInstrTableByCode[i].encoding = GCNENC_NONE;
-    }
-    
-    for (cxuint i = 0; gcnInstrsTable[i].mnemonic != nullptr; i++)
-    {
-        const GCNInstruction& instr = gcnInstrsTable[i];
-        const GCNEncodingSpace& encSpace = gcnInstrTableByCodeSpaces[instr.encoding];
-        if ((instr.archMask & ARCH_GCN_1_0_1) != 0)
-        {
-            if (gcnInstrTableByCode[encSpace.offset + instr.code].mnemonic == nullptr)
-                gcnInstrTableByCode[encSpace.offset + instr.code] = instr;
-            else if((instr.archMask & ARCH_RX2X0) != 0) /* otherwise we for GCN1.1 */
-            {
-                const GCNEncodingSpace& encSpace2 =
-                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
-                gcnInstrTableByCode[encSpace2.offset + instr.code] = instr;
-            }
-            // otherwise we ignore this entry
-        }
-        if ((instr.archMask & ARCH_RX3X0) != 0)
-        {
-            const GCNEncodingSpace& encSpace3 = gcnInstrTableByCodeSpaces[
-                        GCNENC_MAXVAL+3+instr.encoding];
-            if (gcnInstrTableByCode[encSpace3.offset + instr.code].mnemonic == nullptr)
-                gcnInstrTableByCode[encSpace3.offset + instr.code] = instr;
-            // otherwise we ignore this entry
-        }
-    }
-}
-
-GCNDisassembler::GCNDisassembler(Disassembler& disassembler)
-        : ISADisassembler(disassembler), instrOutOfCode(false)
-{
-    std::call_once(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
-}
-
-GCNDisassembler::~GCNDisassembler()
-{ }
-
 static const bool gcnSize11Table[16] =
 {
     false, // GCNENC_SMRD, // 0000
@@ -266,23 +229,91 @@ static const bool gcnSize12Table[16] =
     false // GCNENC_NONE   // 1111 - illegal
 };
 
-void GCNDisassembler::beforeDisassemble()
+static const cxbyte gcnEncoding11Table[16] =
 {
-    labels.clear();
-    
-    const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(input);
-    const size_t codeWordsNum = (inputSize>>2);
+    GCNENC_SMRD, // 0000
+    GCNENC_SMRD, // 0001
+    GCNENC_VINTRP, // 0010
+    GCNENC_NONE, // 0011 - illegal
+    GCNENC_VOP3A, // 0100
+    GCNENC_NONE, // 0101 - illegal
+    GCNENC_DS,   // 0110
+    GCNENC_FLAT, // 0111
+    GCNENC_MUBUF, // 1000
+    GCNENC_NONE,  // 1001 - illegal
+    GCNENC_MTBUF, // 1010
+    GCNENC_NONE,  // 1011 - illegal
+    GCNENC_MIMG,  // 1100
+    GCNENC_NONE,  // 1101 - illegal
+    GCNENC_EXP,   // 1110
+    GCNENC_NONE   // 1111 - illegal
+};
 
-    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
-                disassembler.getDeviceType());
+static const cxbyte gcnEncoding12Table[16] =
+{
+    GCNENC_SMEM, // 0000
+    GCNENC_EXP, // 0001
+    GCNENC_NONE, // 0010 - illegal
+    GCNENC_NONE, // 0011 - illegal
+    GCNENC_VOP3A, // 0100
+    GCNENC_VINTRP, // 0101
+    GCNENC_DS,   // 0110
+    GCNENC_FLAT, // 0111
+    GCNENC_MUBUF, // 1000
+    GCNENC_NONE,  // 1001 - illegal
+    GCNENC_MTBUF, // 1010
+    GCNENC_NONE,  // 1011 - illegal
+    GCNENC_MIMG,  // 1100
+    GCNENC_NONE,  // 1101 - illegal
+    GCNENC_NONE,  // 1110 - illegal
+    GCNENC_NONE   // 1111 - illegal
+};
+
+/* decode table flags (literal rule in two lowest bits) */
+enum : cxbyte
+{
+    GCNDEC_LIT_NONE = 0,    // no literal
+    GCNDEC_LIT_SOP1,    // literal if SSRC0 is constant (0xff)
+    GCNDEC_LIT_SOP2,    // literal if SSRC0 or SSRC1 is constant (0xff)
+    GCNDEC_LIT_VOP,     // literal if SRC0 is constant (0xff) or SDWA/DPP (GCN1.2)
+    GCNDEC_LIT_MASK = 3,
+    GCNDEC_JUMP_SOPK = 4,   // SOPK branch fork
+    GCNDEC_JUMP_SOPP = 8    // SOPP instruction (jump if opcode is branch)
+};
+
+/* instruction index entry: encoding (5 lowest bits) and two-word flag */
+static const cxbyte GCNINDEX_ENCMASK = 0x1f;
+static const cxbyte GCNINDEX_TWOWORD = 0x80;
+
+struct CLRX_INTERNAL GCNDecodeEntry
+{
+    cxbyte encoding;
+    cxbyte length;  // length in words without literal
+    cxbyte flags;
+};
+
+struct CLRX::GCNDecodeTable
+{
+    GCNDecodeEntry entries[512];  // indexed by 9 highest bits of instruction word
+    cxbyte literals[4][512];  // literal flag for literal rule and 9 lowest bits
+    uint32_t soppJumpMask[4];   // bitmask of SOPP opcodes that are jumps
+};
+
+// decode tables for GCN1.0, GCN1.1 and GCN1.2
+static GCNDecodeTable gcnDecodeTables[cxuint(GPUArchitecture::GPUARCH_MAX)+1];
+
+static void initializeGCNDecodeTable(GCNDecodeTable& table, GPUArchitecture arch)
+{
     const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
     const bool isGCN12 = (arch == GPUArchitecture::GCN1_2);
-    size_t pos;
-    for (pos = 0; pos < codeWordsNum; pos++)
-    {   /* scan all instructions and get jump addresses */
-        const uint32_t insnCode = ULEV(codeWords[pos]);
+    for (cxuint i = 0; i < 512; i++)
+    {
+        const uint32_t insnCode = uint32_t(i)<<23;
+        GCNDecodeEntry& entry = table.entries[i];
+        entry.length = 1;
+        entry.flags = GCNDEC_LIT_NONE;
         if ((insnCode & 0x80000000U) != 0)
-        {   
+        {
             if ((insnCode & 0x40000000U) == 0)
             {   // SOP???
                 if  ((insnCode & 0x30000000U) == 0x30000000U)
@@ -290,39 +321,35 @@ void GCNDisassembler::beforeDisassemble()
                     const uint32_t encPart = (insnCode & 0x0f800000U);
                     if (encPart == 0x0e800000U)
                     {   // SOP1
-                        if ((insnCode&0xff) == 0xff) // literal
-                            pos++;
+                        entry.encoding = GCNENC_SOP1;
+                        entry.flags = GCNDEC_LIT_SOP1;
                     }
                     else if (encPart == 0x0f000000U)
                     {   // SOPC
-                        if ((insnCode&0xff) == 0xff ||
-                            (insnCode&0xff00) == 0xff00) // literal
-                            pos++;
+                        entry.encoding = GCNENC_SOPC;
+                        entry.flags = GCNDEC_LIT_SOP2;
                     }
                     else if (encPart == 0x0f800000U)
                     {   // SOPP
-                        const cxuint opcode = (insnCode>>16)&0x7f;
-                        if (opcode == 2 || (opcode >= 4 && opcode <= 9) ||
-                            // GCN1.1 and GCN1.2 opcodes
-                            ((isGCN11 || isGCN12) &&
-                                    (opcode >= 23 && opcode <= 26))) // if jump
-                            labels.push_back((pos+int16_t(insnCode&0xffff)+1)<<2);
+                        entry.encoding = GCNENC_SOPP;
+                        entry.flags = GCNDEC_JUMP_SOPP;
                     }
                     else
                     {   // SOPK
+                        entry.encoding = GCNENC_SOPK;
                         const cxuint opcode = (insnCode>>23)&0x1f;
                         if ((!isGCN12 && opcode == 17) ||
                             (isGCN12 && opcode == 16)) // if branch fork
-                            labels.push_back((pos+int16_t(insnCode&0xffff)+1)<<2);
+                            entry.flags = GCNDEC_JUMP_SOPK;
                         else if ((!isGCN12 && opcode == 21) ||
                             (isGCN12 && opcode == 20))
-                            pos++; // additional literal
+                            entry.length = 2; // additional literal
                     }
                 }
                 else
                 {   // SOP2
-                    if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                        pos++;  // literal
+                    entry.encoding = GCNENC_SOP2;
+                    entry.flags = GCNDEC_LIT_SOP2;
                 }
             }
             else
@@ -330,41 +357,214 @@ void GCNDisassembler::beforeDisassemble()
                 const uint32_t encPart = (insnCode&0x3c000000U)>>26;
                 if ((!isGCN12 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
                     (isGCN12 && gcnSize12Table[encPart]))
-                    pos++;
+                    entry.length = 2;
+                if (isGCN12)
+                    entry.encoding = gcnEncoding12Table[encPart];
+                else
+                    entry.encoding = gcnEncoding11Table[encPart];
+                if (entry.encoding == GCNENC_FLAT && !isGCN11 && !isGCN12)
+                    entry.encoding = GCNENC_NONE; // illegal if not GCN1.1
             }
         }
         else
         {   // some vector instructions
             if ((insnCode & 0x7e000000U) == 0x7c000000U)
             {   // VOPC
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;
+                entry.encoding = GCNENC_VOPC;
+                entry.flags = GCNDEC_LIT_VOP;
             }
             else if ((insnCode & 0x7e000000U) == 0x7e000000U)
             {   // VOP1
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;
+                entry.encoding = GCNENC_VOP1;
+                entry.flags = GCNDEC_LIT_VOP;
             }
             else
             {   // VOP2
+                entry.encoding = GCNENC_VOP2;
                 const cxuint opcode = (insnCode >> 25)&0x3f;
                 if ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
                     (isGCN12 && (opcode == 23 || opcode == 24 ||
                     opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                    pos++;  // inline 32-bit constant
-                else if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;  // literal
+                    entry.length = 2;  // inline 32-bit constant
+                else
+                    entry.flags = GCNDEC_LIT_VOP;
             }
         }
     }
     
-    instrOutOfCode = (pos != codeWordsNum);
+    // literal flags for 9 lowest bits (SSRC0 or SRC0)
+    for (cxuint v = 0; v < 512; v++)
+    {
+        table.literals[GCNDEC_LIT_NONE][v] = 0;
+        table.literals[GCNDEC_LIT_SOP1][v] = table.literals[GCNDEC_LIT_SOP2][v] =
+                ((v&0xff) == 0xff);
+        // SDWA, DPP
+        table.literals[GCNDEC_LIT_VOP][v] = (v == 0xff ||
+                    (isGCN12 && (v == 0xf9 || v == 0xfa)));
+    }
+    
+    std::fill(table.soppJumpMask, table.soppJumpMask+4, 0U);
+    for (cxuint opcode = 0; opcode < 128; opcode++)
+        if (opcode == 2 || (opcode >= 4 && opcode <= 9) ||
+            // GCN1.1 and GCN1.2 opcodes
+            ((isGCN11 || isGCN12) && (opcode >= 23 && opcode <= 26))) // if jump
+            table.soppJumpMask[opcode>>5] |= 1U<<(opcode&31);
+}
+
+static void initializeGCNDisassembler()
+{
+    gcnInstrTableByCode.reset(new GCNInstruction[gcnInstrTableByCodeLength]);
+    for (cxuint i = 0; i < gcnInstrTableByCodeLength; i++)
+    {
+        gcnInstrTableByCode[i].mnemonic = nullptr;
+        gcnInstrTableByCode[i].mode = GCN_STDMODE;
+        // except VOP3 decoding routines ignores encoding (we can set None for encoding)
+        gcnInstrTableByCode[i].encoding = GCNENC_NONE;
+    }
+    
+    for (cxuint i = 0; gcnInstrsTable[i].mnemonic != nullptr; i++)
+    {
+        const GCNInstruction& instr = gcnInstrsTable[i];
+        const GCNEncodingSpace& encSpace = gcnInstrTableByCodeSpaces[instr.encoding];
+        if ((instr.archMask & ARCH_GCN_1_0_1) != 0)
+        {
+            if (gcnInstrTableByCode[encSpace.offset + instr.code].mnemonic == nullptr)
+                gcnInstrTableByCode[encSpace.offset + instr.code] = instr;
+            else if((instr.archMask & ARCH_RX2X0) != 0) /* otherwise we for GCN1.1 */
+            {
+                const GCNEncodingSpace& encSpace2 =
+                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
+                gcnInstrTableByCode[encSpace2.offset + instr.code] = instr;
+            }
+            // otherwise we ignore this entry
+        }
+        if ((instr.archMask & ARCH_RX3X0) != 0)
+        {
+            const GCNEncodingSpace& encSpace3 = gcnInstrTableByCodeSpaces[
+                        GCNENC_MAXVAL+3+instr.encoding];
+            if (gcnInstrTableByCode[encSpace3.offset + instr.code].mnemonic == nullptr)
+                gcnInstrTableByCode[encSpace3.offset + instr.code] = instr;
+            // otherwise we ignore this entry
+        }
+    }
+    
+    for (cxuint arch = 0; arch <= cxuint(GPUArchitecture::GPUARCH_MAX); arch++)
+        initializeGCNDecodeTable(gcnDecodeTables[arch], GPUArchitecture(arch));
+}
+
+GCNDisassembler::GCNDisassembler(Disassembler& disassembler)
+        : ISADisassembler(disassembler), instrOutOfCode(false)
+{
+    std::call_once(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
+}
+
+GCNDisassembler::GCNDisassembler(Disassembler& disassembler, std::ostream& output)
+        : ISADisassembler(disassembler, output), instrOutOfCode(false)
+{
+    std::call_once(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
+}
+
+GCNDisassembler::~GCNDisassembler()
+{ }
+
+/* find first non-zero word in code (used to find zero-filled regions) */
+static inline size_t findNonZeroWord(const uint32_t* codeWords, size_t pos, size_t end)
+{
+#ifdef GCNDISASM_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; pos + 8 <= end; pos += 8)
+    {
+        const __m128i w0 = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(codeWords + pos));
+        const __m128i w1 = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(codeWords + pos + 4));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_or_si128(w0, w1), zero)) != 0xffff)
+            break;
+    }
+#endif
+    while (pos < end && codeWords[pos] == 0)
+        pos++;
+    return pos;
+}
+
+static inline cxuint getGCNInstrLength(const GCNDecodeTable& table,
+            const GCNDecodeEntry& entry, uint32_t insnCode)
+{
+    const cxuint litRule = entry.flags & GCNDEC_LIT_MASK;
+    // SSRC1 literal is checked only for SOP2 and SOPC
+    return entry.length + (table.literals[litRule][insnCode & 0x1ff] |
+            (cxuint(litRule == GCNDEC_LIT_SOP2) & cxuint((insnCode&0xff00) == 0xff00)));
+}
+
+/* find literal words in 64-word block from two-word flags of words
+ * (flag of word is ignored if word is literal). prevLiteral - first word is literal,
+ * it will be set if first word of next block is literal */
+static inline uint64_t findGCNLiteralWords(uint64_t twoWordMask, uint64_t& prevLiteral)
+{
+    const uint64_t evenBits = 0x5555555555555555ULL;
+    twoWordMask &= ~prevLiteral;
+    const uint64_t followsTwoWord = (twoWordMask<<1) | prevLiteral;
+    // series of two-word flags that starts at odd position
+    const uint64_t oddStarts = twoWordMask & ~evenBits & ~followsTwoWord;
+    // carry clears series and puts bit after end of series
+    const uint64_t evenStarts = oddStarts + twoWordMask;
+    prevLiteral = (evenStarts < oddStarts);
+    return (evenBits ^ (evenStarts<<1)) & followsTwoWord;
+}
+
+/* decode every code word as if it is start of instruction (words are decoded
+ * independently) and find instruction boundaries in 64-word blocks without
+ * walking through instructions. returns true if last instruction is unfinished */
+bool GCNDisassembler::buildInstrIndex(bool collectLabels)
+{
+    const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(input);
+    const size_t codeWordsNum = (inputSize>>2);
+    const GCNDecodeTable& table = gcnDecodeTables[cxuint(
+                getGPUArchitectureFromDeviceType(disassembler.getDeviceType()))];
+    
+    instrIndex.resize(codeWordsNum);
+    cxbyte* index = instrIndex.data();
+    uint64_t prevLiteral = 0;
+    uint64_t literalMask = 0;
+    for (size_t blockPos = 0; blockPos < codeWordsNum; blockPos += 64)
+    {
+        const size_t blockEnd = std::min(blockPos+64, codeWordsNum);
+        uint64_t twoWordMask = 0;
+        uint64_t jumpMask = 0;
+        for (size_t pos = blockPos; pos < blockEnd; pos++)
+        {
+            const uint32_t insnCode = ULEV(codeWords[pos]);
+            const GCNDecodeEntry& entry = table.entries[insnCode>>23];
+            const cxuint length = getGCNInstrLength(table, entry, insnCode);
+            // SOPP jump if opcode in jump mask
+            const cxuint soppJump = (table.soppJumpMask[(insnCode>>21)&3] >>
+                        ((insnCode>>16)&31)) & 1;
+            const cxuint isJump = cxuint((entry.flags & GCNDEC_JUMP_SOPK) != 0) |
+                        (cxuint((entry.flags & GCNDEC_JUMP_SOPP) != 0) & soppJump);
+            index[pos] = entry.encoding | ((length-1)<<7);
+            twoWordMask |= uint64_t(length-1) << (pos-blockPos);
+            jumpMask |= uint64_t(isJump) << (pos-blockPos);
+        }
+        literalMask = findGCNLiteralWords(twoWordMask, prevLiteral);
+        if (!collectLabels)
+            continue;
+        /* get jump addresses (skip literals) */
+        for (jumpMask &= ~literalMask; jumpMask != 0; )
+        {
+            const cxuint bit = 63-CLZ64(jumpMask);
+            jumpMask &= ~(uint64_t(1)<<bit);
+            const size_t pos = blockPos + bit;
+            labels.push_back((pos+int16_t(ULEV(codeWords[pos])&0xffff)+1)<<2);
+        }
+    }
+    const cxuint lastBits = codeWordsNum & 63;
+    return (lastBits != 0) ? ((literalMask>>lastBits) & 1) != 0 : prevLiteral != 0;
+}
+
+void GCNDisassembler::beforeDisassemble()
+{
+    labels.clear();
+    instrOutOfCode = buildInstrIndex(true);
     
     std::sort(labels.begin(), labels.end());
     const auto newEnd = std::unique(labels.begin(), labels.end());
@@ -373,46 +573,6 @@ void GCNDisassembler::beforeDisassemble()
     mapSort(relocations.begin(), relocations.end());
 }
 
-static const cxbyte gcnEncoding11Table[16] =
-{
-    GCNENC_SMRD, // 0000
-    GCNENC_SMRD, // 0001
-    GCNENC_VINTRP, // 0010
-    GCNENC_NONE, // 0011 - illegal
-    GCNENC_VOP3A, // 0100
-    GCNENC_NONE, // 0101 - illegal
-    GCNENC_DS,   // 0110
-    GCNENC_FLAT, // 0111
-    GCNENC_MUBUF, // 1000
-    GCNENC_NONE,  // 1001 - illegal
-    GCNENC_MTBUF, // 1010
-    GCNENC_NONE,  // 1011 - illegal
-    GCNENC_MIMG,  // 1100
-    GCNENC_NONE,  // 1101 - illegal
-    GCNENC_EXP,   // 1110
-    GCNENC_NONE   // 1111 - illegal
-};
-
-static const cxbyte gcnEncoding12Table[16] =
-{
-    GCNENC_SMEM, // 0000
-    GCNENC_EXP, // 0001
-    GCNENC_NONE, // 0010 - illegal
-    GCNENC_NONE, // 0011 - illegal
-    GCNENC_VOP3A, // 0100
-    GCNENC_VINTRP, // 0101
-    GCNENC_DS,   // 0110
-    GCNENC_FLAT, // 0111
-    GCNENC_MUBUF, // 1000
-    GCNENC_NONE,  // 1001 - illegal
-    GCNENC_MTBUF, // 1010
-    GCNENC_NONE,  // 1011 - illegal
-    GCNENC_MIMG,  // 1100
-    GCNENC_NONE,  // 1101 - illegal
-    GCNENC_NONE,  // 1110 - illegal
-    GCNENC_NONE   // 1111 - illegal
-};
-
 
 struct CLRX_INTERNAL GCNEncodingOpcodeBits
 {
@@ -2430,6 +2590,275 @@ void GCNDisasmUtils::decodeFLATEncoding(GCNDisassembler& dasm ,cxuint spacesToAd
     output.forward(bufPtr-bufStart);
 }
 
+/* returns instruction for opcode or null if instruction is illegal for architecture.
+ * gcnInsn is entry from instruction table for encoding and opcode */
+static inline const GCNInstruction* findGCNInstruction(const GCNInstruction* gcnInsn,
+            bool isGCN12, uint16_t curArchMask, cxbyte gcnEncoding, cxuint opcode)
+{
+    if (!isGCN12 && gcnInsn->mnemonic != nullptr &&
+        (curArchMask & gcnInsn->archMask) == 0 &&
+        gcnEncoding == GCNENC_VOP3A)
+    {    /* new overrides */
+        const GCNEncodingSpace& encSpace2 =
+                gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
+        gcnInsn = gcnInstrTableByCode.get() + encSpace2.offset + opcode;
+    }
+    if (gcnInsn->mnemonic == nullptr || (curArchMask & gcnInsn->archMask) == 0)
+        return nullptr; // illegal
+    return gcnInsn;
+}
+
+GCNInstrDecoder::GCNInstrDecoder(GPUArchitecture _arch)
+        : arch(_arch), table(nullptr)
+{
+    std::call_once(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
+    table = gcnDecodeTables + cxuint(arch);
+}
+
+cxuint GCNInstrDecoder::decode(uint32_t insnCode, cxbyte& encoding) const
+{
+    const GCNDecodeEntry& entry = table->entries[insnCode>>23];
+    encoding = entry.encoding;
+    return getGCNInstrLength(*table, entry, insnCode);
+}
+
+cxuint GCNInstrDecoder::getOpcode(cxbyte gcnEncoding, uint32_t insnCode) const
+{
+    if (gcnEncoding == GCNENC_NONE)
+        return 0;
+    const GCNEncodingOpcodeBits* encodingOpcodeTable = 
+            (arch == GPUArchitecture::GCN1_2) ? gcnEncodingOpcode12Table :
+            gcnEncodingOpcodeTable;
+    return (insnCode>>encodingOpcodeTable[gcnEncoding].bitPos) & 
+            ((1U<<encodingOpcodeTable[gcnEncoding].bits)-1U);
+}
+
+const GCNInstruction* GCNInstrDecoder::getTableEntry(cxbyte gcnEncoding,
+            cxuint opcode) const
+{
+    const GCNEncodingSpace& encSpace = (arch == GPUArchitecture::GCN1_2) ?
+          gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+3 + gcnEncoding] :
+          gcnInstrTableByCodeSpaces[gcnEncoding];
+    return gcnInstrTableByCode.get() + encSpace.offset + opcode;
+}
+
+const GCNInstruction* GCNInstrDecoder::findInstructionByOpcode(cxbyte gcnEncoding,
+            cxuint opcode) const
+{
+    if (gcnEncoding == GCNENC_NONE)
+        return nullptr;
+    return findGCNInstruction(getTableEntry(gcnEncoding, opcode),
+                arch == GPUArchitecture::GCN1_2, 1U<<int(arch), gcnEncoding, opcode);
+}
+
+uint16_t GCNInstrDecoder::getInstrId(const GCNInstruction* gcnInsn)
+{
+    if (gcnInsn == nullptr)
+        return UINT16_MAX;
+    return gcnInsn - gcnInstrTableByCode.get();
+}
+
+const GCNInstruction* GCNInstrDecoder::getInstruction(uint16_t instrId)
+{
+    std::call_once(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
+    if (instrId >= gcnInstrTableByCodeLength ||
+        gcnInstrTableByCode[instrId].mnemonic == nullptr)
+        return nullptr;
+    return gcnInstrTableByCode.get() + instrId;
+}
+
+void GCNInstrDecoder::decodeRecord(const uint32_t* codeWords, size_t codeWordsNum,
+            size_t pos, GCNInstrRecord& record, bool withOperands) const
+{
+    cxbyte encoding;
+    const cxuint length = decode(ULEV(codeWords[pos]), encoding);
+    fillRecord(codeWords, codeWordsNum, pos, encoding, length, record, withOperands);
+}
+
+void GCNInstrDecoder::fillRecord(const uint32_t* codeWords, size_t codeWordsNum,
+            size_t pos, cxbyte encoding, cxuint length, GCNInstrRecord& record,
+            bool withOperands) const
+{
+    record.offset = pos<<2;
+    record.words[0] = ULEV(codeWords[pos]);
+    record.length = length;
+    record.encoding = GCNEncoding(encoding);
+    record.words[1] = (record.length == 2 && pos+1 < codeWordsNum) ?
+                ULEV(codeWords[pos+1]) : 0;
+    record.opcode = getOpcode(encoding, record.words[0]);
+    record.relocIndex = UINT_MAX;
+    record.operandsNum = 0;
+    
+    const GCNInstruction* gcnInsn = findInstructionByOpcode(encoding, record.opcode);
+    record.instrId = getInstrId(gcnInsn);
+    if (gcnInsn != nullptr && withOperands)
+        decodeOperands(record, *gcnInsn);
+}
+
+/* print instruction from record. pos - position after instruction (in words) */
+void GCNDisasmUtils::printInstruction(GCNDisassembler& dasm, const GCNInstrDecoder& decoder,
+            uint16_t curArchMask, const GCNInstrRecord& record, size_t pos,
+            RelocIter& curReloc)
+{
+    FastOutputBuffer& output = dasm.output;
+    const uint32_t insnCode = record.words[0];
+    const uint32_t insnCode2 = record.words[1];
+    const cxbyte gcnEncoding = cxbyte(record.encoding);
+    const bool isGCN12 = ((curArchMask&ARCH_RX3X0) != 0);
+    
+    if (dasm.disassembler.getFlags() & DISASM_HEXCODE)
+    {
+        char* buf = output.reserve(50);
+        size_t bufPos = 0;
+        buf[bufPos++] = '/';
+        buf[bufPos++] = '*';
+        bufPos += itocstrCStyle(insnCode, buf+bufPos, 12, 16, 8, false);
+        buf[bufPos++] = ' ';
+        if ((record.offset>>2)+2 == pos) // if second word has been read
+            bufPos += itocstrCStyle(insnCode2, buf+bufPos, 12, 16, 8, false);
+        else
+            bufPos += addSpacesOld(buf+bufPos, 8);
+        buf[bufPos++] = '*';
+        buf[bufPos++] = '/';
+        buf[bufPos++] = ' ';
+        output.forward(bufPos);
+    }
+    else // add spaces
+    {
+        char* buf = output.reserve(8);
+        output.forward(addSpacesOld(buf, 8));
+    }
+    
+    if (gcnEncoding == GCNENC_NONE)
+    {   // invalid encoding
+        char* buf = output.reserve(24);
+        size_t bufPos = 0;
+        buf[bufPos++] = '.';
+        buf[bufPos++] = 'i';
+        buf[bufPos++] = 'n';
+        buf[bufPos++] = 't';
+        buf[bufPos++] = ' '; 
+        bufPos += itocstrCStyle(insnCode, buf+bufPos, 11, 16);
+        output.forward(bufPos);
+        return;
+    }
+    
+    cxuint spacesToAdd = 16;
+    // instruction table is already initialized by disassembler
+    const GCNInstruction* gcnInsn = (record.instrId != GCNINSTR_ILLEGAL) ?
+            gcnInstrTableByCode.get() + record.instrId : nullptr;
+    GCNInstruction defaultInsn;
+    if (gcnInsn != nullptr)
+    {
+        size_t k = ::strlen(gcnInsn->mnemonic);
+        output.writeString(gcnInsn->mnemonic);
+        spacesToAdd = spacesToAdd>=k+1?spacesToAdd-k:1;
+    }
+    else
+    {   // illegal instruction
+        char* bufStart = output.reserve(40);
+        char* bufPtr = bufStart;
+        if (!isGCN12 || gcnEncoding != GCNENC_SMEM)
+            putChars(bufPtr, gcnEncodingNames[gcnEncoding],
+                    ::strlen(gcnEncodingNames[gcnEncoding]));
+        else /* SMEM encoding */
+            putChars(bufPtr, "SMEM", 4);
+        putChars(bufPtr, "_ill_", 5);
+        bufPtr += itocstrCStyle(record.opcode, bufPtr , 6);
+        const size_t linePos = bufPtr-bufStart;
+        spacesToAdd = spacesToAdd >= (linePos+1)? spacesToAdd - linePos : 1;
+        // encoding from instruction table (VOP3 decoding routine checks VOP3B)
+        defaultInsn = { nullptr, decoder.getTableEntry(gcnEncoding,
+                    record.opcode)->encoding, GCN_STDMODE, 0, 0 };
+        gcnInsn = &defaultInsn;
+        output.forward(bufPtr-bufStart);
+    }
+    
+    const FloatLitType displayFloatLits = 
+            ((dasm.disassembler.getFlags()&DISASM_FLOATLITS) != 0) ?
+            (((gcnInsn->mode & GCN_MASK2) == GCN_FLOATLIT) ? FLTLIT_F32 : 
+            ((gcnInsn->mode & GCN_MASK2) == GCN_F16LIT) ? FLTLIT_F16 :
+             FLTLIT_NONE) : FLTLIT_NONE;
+    
+    switch(gcnEncoding)
+    {
+        case GCNENC_SOPC:
+            GCNDisasmUtils::decodeSOPCEncoding(dasm, pos, curReloc,
+                       spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
+            break;
+        case GCNENC_SOPP:
+            GCNDisasmUtils::decodeSOPPEncoding(dasm, spacesToAdd, curArchMask, 
+                         *gcnInsn, insnCode, insnCode2, pos);
+            break;
+        case GCNENC_SOP1:
+            GCNDisasmUtils::decodeSOP1Encoding(dasm, pos, curReloc,
+                       spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
+            break;
+        case GCNENC_SOP2:
+            GCNDisasmUtils::decodeSOP2Encoding(dasm, pos, curReloc,
+                       spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
+            break;
+        case GCNENC_SOPK:
+            GCNDisasmUtils::decodeSOPKEncoding(dasm, pos, curReloc,
+                       spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
+            break;
+        case GCNENC_SMRD:
+            if (isGCN12)
+                GCNDisasmUtils::decodeSMEMEncoding(dasm, spacesToAdd, curArchMask,
+                          *gcnInsn, insnCode, insnCode2);
+            else
+                GCNDisasmUtils::decodeSMRDEncoding(dasm, spacesToAdd, curArchMask,
+                          *gcnInsn, insnCode);
+            break;
+        case GCNENC_VOPC:
+            GCNDisasmUtils::decodeVOPCEncoding(dasm, pos, curReloc, spacesToAdd,
+                   curArchMask, *gcnInsn, insnCode, insnCode2, displayFloatLits);
+            break;
+        case GCNENC_VOP1:
+            GCNDisasmUtils::decodeVOP1Encoding(dasm, pos, curReloc, spacesToAdd,
+                   curArchMask, *gcnInsn, insnCode, insnCode2, displayFloatLits);
+            break;
+        case GCNENC_VOP2:
+            GCNDisasmUtils::decodeVOP2Encoding(dasm, pos, curReloc, spacesToAdd,
+                   curArchMask, *gcnInsn, insnCode, insnCode2, displayFloatLits);
+            break;
+        case GCNENC_VOP3A:
+            GCNDisasmUtils::decodeVOP3Encoding(dasm, spacesToAdd, curArchMask,
+                         *gcnInsn, insnCode, insnCode2, displayFloatLits);
+            break;
+        case GCNENC_VINTRP:
+            GCNDisasmUtils::decodeVINTRPEncoding(dasm, spacesToAdd, curArchMask,
+                         *gcnInsn, insnCode);
+            break;
+        case GCNENC_DS:
+            GCNDisasmUtils::decodeDSEncoding(dasm, spacesToAdd, curArchMask,
+                         *gcnInsn, insnCode, insnCode2);
+            break;
+        case GCNENC_MUBUF:
+            GCNDisasmUtils::decodeMUBUFEncoding(dasm, spacesToAdd, curArchMask,
+                         *gcnInsn, insnCode, insnCode2);
+            break;
+        case GCNENC_MTBUF:
+            GCNDisasmUtils::decodeMUBUFEncoding(dasm, spacesToAdd, curArchMask,
+                         *gcnInsn, insnCode, insnCode2);
+            break;
+        case GCNENC_MIMG:
+            GCNDisasmUtils::decodeMIMGEncoding(dasm, spacesToAdd, curArchMask,
+                         *gcnInsn, insnCode, insnCode2);
+            break;
+        case GCNENC_EXP:
+            GCNDisasmUtils::decodeEXPEncoding(dasm, spacesToAdd, curArchMask,
+                         *gcnInsn, insnCode, insnCode2);
+            break;
+        case GCNENC_FLAT:
+            GCNDisasmUtils::decodeFLATEncoding(dasm, spacesToAdd, curArchMask,
+                         *gcnInsn, insnCode, insnCode2);
+            break;
+        default:
+            break;
+    }
+}
+
 /* main routine */
 
 void GCNDisassembler::disassemble()
@@ -2438,13 +2867,11 @@ void GCNDisassembler::disassemble()
     RelocIter curReloc = relocations.begin();
     NamedLabelIter curNamedLabel = namedLabels.begin();
     const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(input);
-
+    
     const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
                 disassembler.getDeviceType());
-    const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
-    const bool isGCN12 = (arch == GPUArchitecture::GCN1_2);
-    const uint16_t curArchMask = 
-            1U<<int(getGPUArchitectureFromDeviceType(disassembler.getDeviceType()));
+    const GCNInstrDecoder decoder(arch);
+    const uint16_t curArchMask = 1U<<int(arch);
     const size_t codeWordsNum = (inputSize>>2);
     
     if ((inputSize&3) != 0)
@@ -2453,8 +2880,11 @@ void GCNDisassembler::disassemble()
     if (instrOutOfCode)
         output.write(54, "        /* WARNING: Unfinished instruction at end! */\n");
     
-    bool prevIsTwoWord = false;
+    if (instrIndex.size() != codeWordsNum)
+        buildInstrIndex(false); // if beforeDisassemble was not called
+    const cxbyte* index = instrIndex.data();
     
+    GCNInstrRecord record;
     size_t pos = 0;
     while (true)
     {
@@ -2462,14 +2892,12 @@ void GCNDisassembler::disassemble()
         if (pos >= codeWordsNum)
             break;
         
-        const size_t oldPos = pos;
-        cxbyte gcnEncoding = GCNENC_NONE;
-        const uint32_t insnCode = ULEV(codeWords[pos++]);
-        if (insnCode == 0)
+        if (codeWords[pos] == 0)
         {   /* fix for GalliumCOmpute disassemblying (assembler doesn't accep 
              * with two scalar operands */
-            size_t count;
-            for (count = 1; pos < codeWordsNum && codeWords[pos]==0; count++, pos++);
+            const size_t end = findNonZeroWord(codeWords, pos+1, codeWordsNum);
+            const size_t count = end-pos;
+            pos = end;
             // put to output
             char* buf = output.reserve(40);
             size_t bufPos = 0;
@@ -2481,304 +2909,21 @@ void GCNDisassembler::disassemble()
             output.forward(bufPos);
             continue;
         }
-        uint32_t insnCode2 = 0;
-        
-        
-        /* determine GCN encoding */
-        if ((insnCode & 0x80000000U) != 0)
-        {
-            if ((insnCode & 0x40000000U) == 0)
-            {   // SOP???
-                if  ((insnCode & 0x30000000U) == 0x30000000U)
-                {   // SOP1/SOPK/SOPC/SOPP
-                    const uint32_t encPart = (insnCode & 0x0f800000U);
-                    if (encPart == 0x0e800000U)
-                    {   // SOP1
-                        if ((insnCode&0xff) == 0xff) // literal
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
-                        gcnEncoding = GCNENC_SOP1;
-                    }
-                    else if (encPart == 0x0f000000U)
-                    {   // SOPC
-                        if ((insnCode&0xff) == 0xff ||
-                            (insnCode&0xff00) == 0xff00) // literal
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
-                        gcnEncoding = GCNENC_SOPC;
-                    }
-                    else if (encPart == 0x0f800000U) // SOPP
-                        gcnEncoding = GCNENC_SOPP;
-                    else // SOPK
-                    {
-                        gcnEncoding = GCNENC_SOPK;
-                        const uint32_t opcode = ((insnCode>>23)&0x1f);
-                        if ((!isGCN12 && opcode == 21) ||
-                            (isGCN12 && opcode == 20))
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
-                    }
-                }
-                else
-                {   // SOP2
-                    if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                    {   // literal
-                        if (pos < codeWordsNum)
-                            insnCode2 = ULEV(codeWords[pos++]);
-                    }
-                    gcnEncoding = GCNENC_SOP2;
-                }
-            }
-            else
-            {   // SMRD and others
-                const uint32_t encPart = (insnCode&0x3c000000U)>>26;
-                if ((!isGCN12 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
-                    (isGCN12 && gcnSize12Table[encPart]))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                if (isGCN12)
-                    gcnEncoding = gcnEncoding12Table[encPart];
-                else
-                    gcnEncoding = gcnEncoding11Table[encPart];
-                if (gcnEncoding == GCNENC_FLAT && !isGCN11 && !isGCN12)
-                    gcnEncoding = GCNENC_NONE; // illegal if not GCN1.1
-            }
-        }
-        else
-        {   // some vector instructions
-            if ((insnCode & 0x7e000000U) == 0x7c000000U)
-            {   // VOPC
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                gcnEncoding = GCNENC_VOPC;
-            }
-            else if ((insnCode & 0x7e000000U) == 0x7e000000U)
-            {   // VOP1
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                gcnEncoding = GCNENC_VOP1;
-            }
-            else
-            {   // VOP2
-                const cxuint opcode = (insnCode >> 25)&0x3f;
-                if ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
-                    (isGCN12 && (opcode == 23 || opcode == 24 ||
-                    opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                else if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                gcnEncoding = GCNENC_VOP2;
-            }
-        }
-        
-        prevIsTwoWord = (oldPos+2 == pos);
         
-        if (disassembler.getFlags() & DISASM_HEXCODE)
-        {
-            char* buf = output.reserve(50);
-            size_t bufPos = 0;
-            buf[bufPos++] = '/';
-            buf[bufPos++] = '*';
-            bufPos += itocstrCStyle(insnCode, buf+bufPos, 12, 16, 8, false);
-            buf[bufPos++] = ' ';
-            if (prevIsTwoWord)
-                bufPos += itocstrCStyle(insnCode2, buf+bufPos, 12, 16, 8, false);
-            else
-                bufPos += addSpacesOld(buf+bufPos, 8);
-            buf[bufPos++] = '*';
-            buf[bufPos++] = '/';
-            buf[bufPos++] = ' ';
-            output.forward(bufPos);
-        }
-        else // add spaces
-        {
-            char* buf = output.reserve(8);
-            output.forward(addSpacesOld(buf, 8));
-        }
-        
-        if (gcnEncoding == GCNENC_NONE)
-        {   // invalid encoding
-            char* buf = output.reserve(24);
-            size_t bufPos = 0;
-            buf[bufPos++] = '.';
-            buf[bufPos++] = 'i';
-            buf[bufPos++] = 'n';
-            buf[bufPos++] = 't';
-            buf[bufPos++] = ' '; 
-            bufPos += itocstrCStyle(insnCode, buf+bufPos, 11, 16);
-            output.forward(bufPos);
-        }
-        else
-        {
-            const GCNEncodingOpcodeBits* encodingOpcodeTable = 
-                    (isGCN12) ? gcnEncodingOpcode12Table : gcnEncodingOpcodeTable;
-            const cxuint opcode =
-                    (insnCode>>encodingOpcodeTable[gcnEncoding].bitPos) & 
-                    ((1U<<encodingOpcodeTable[gcnEncoding].bits)-1U);
-            
-            /* decode instruction and put to output */
-            const GCNEncodingSpace& encSpace = 
-                (isGCN12) ? gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+3 + gcnEncoding] :
-                  gcnInstrTableByCodeSpaces[gcnEncoding];
-            const GCNInstruction* gcnInsn = gcnInstrTableByCode.get() +
-                    encSpace.offset + opcode;
-            
-            const GCNInstruction defaultInsn = { nullptr, gcnInsn->encoding, GCN_STDMODE,
-                        0, 0 };
-            cxuint spacesToAdd = 16;
-            bool isIllegal = false;
-            if (!isGCN12 && gcnInsn->mnemonic != nullptr &&
-                (curArchMask & gcnInsn->archMask) == 0 &&
-                gcnEncoding == GCNENC_VOP3A)
-            {    /* new overrides */
-                const GCNEncodingSpace& encSpace2 =
-                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
-                gcnInsn = gcnInstrTableByCode.get() + encSpace2.offset + opcode;
-                if (gcnInsn->mnemonic == nullptr ||
-                        (curArchMask & gcnInsn->archMask) == 0)
-                    isIllegal = true; // illegal
-            }
-            else if (gcnInsn->mnemonic == nullptr ||
-                (curArchMask & gcnInsn->archMask) == 0)
-                isIllegal = true;
-            
-            if (!isIllegal)
-            {
-                size_t k = ::strlen(gcnInsn->mnemonic);
-                output.writeString(gcnInsn->mnemonic);
-                spacesToAdd = spacesToAdd>=k+1?spacesToAdd-k:1;
-            }
-            else
-            {
-                char* bufStart = output.reserve(40);
-                char* bufPtr = bufStart;
-                if (!isGCN12 || gcnEncoding != GCNENC_SMEM)
-                    putChars(bufPtr, gcnEncodingNames[gcnEncoding],
-                            ::strlen(gcnEncodingNames[gcnEncoding]));
-                else /* SMEM encoding */
-                    putChars(bufPtr, "SMEM", 4);
-                putChars(bufPtr, "_ill_", 5);
-                bufPtr += itocstrCStyle(opcode, bufPtr , 6);
-                const size_t linePos = bufPtr-bufStart;
-                spacesToAdd = spacesToAdd >= (linePos+1)? spacesToAdd - linePos : 1;
-                gcnInsn = &defaultInsn;
-                output.forward(bufPtr-bufStart);
-            }
-            
-            const FloatLitType displayFloatLits = 
-                    ((disassembler.getFlags()&DISASM_FLOATLITS) != 0) ?
-                    (((gcnInsn->mode & GCN_MASK2) == GCN_FLOATLIT) ? FLTLIT_F32 : 
-                    ((gcnInsn->mode & GCN_MASK2) == GCN_F16LIT) ? FLTLIT_F16 :
-                     FLTLIT_NONE) : FLTLIT_NONE;
-            
-            switch(gcnEncoding)
-            {
-                case GCNENC_SOPC:
-                    GCNDisasmUtils::decodeSOPCEncoding(*this, pos, curReloc,
-                               spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
-                    break;
-                case GCNENC_SOPP:
-                    GCNDisasmUtils::decodeSOPPEncoding(*this, spacesToAdd, curArchMask, 
-                                 *gcnInsn, insnCode, insnCode2, pos);
-                    break;
-                case GCNENC_SOP1:
-                    GCNDisasmUtils::decodeSOP1Encoding(*this, pos, curReloc,
-                               spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
-                    break;
-                case GCNENC_SOP2:
-                    GCNDisasmUtils::decodeSOP2Encoding(*this, pos, curReloc,
-                               spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
-                    break;
-                case GCNENC_SOPK:
-                    GCNDisasmUtils::decodeSOPKEncoding(*this, pos, curReloc,
-                               spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
-                    break;
-                case GCNENC_SMRD:
-                    if (isGCN12)
-                        GCNDisasmUtils::decodeSMEMEncoding(*this, spacesToAdd, curArchMask,
-                                  *gcnInsn, insnCode, insnCode2);
-                    else
-                        GCNDisasmUtils::decodeSMRDEncoding(*this, spacesToAdd, curArchMask,
-                                  *gcnInsn, insnCode);
-                    break;
-                case GCNENC_VOPC:
-                    GCNDisasmUtils::decodeVOPCEncoding(*this, pos, curReloc, spacesToAdd,
-                           curArchMask, *gcnInsn, insnCode, insnCode2, displayFloatLits);
-                    break;
-                case GCNENC_VOP1:
-                    GCNDisasmUtils::decodeVOP1Encoding(*this, pos, curReloc, spacesToAdd,
-                           curArchMask, *gcnInsn, insnCode, insnCode2, displayFloatLits);
-                    break;
-                case GCNENC_VOP2:
-                    GCNDisasmUtils::decodeVOP2Encoding(*this, pos, curReloc, spacesToAdd,
-                           curArchMask, *gcnInsn, insnCode, insnCode2, displayFloatLits);
-                    break;
-                case GCNENC_VOP3A:
-                    GCNDisasmUtils::decodeVOP3Encoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2, displayFloatLits);
-                    break;
-                case GCNENC_VINTRP:
-                    GCNDisasmUtils::decodeVINTRPEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode);
-                    break;
-                case GCNENC_DS:
-                    GCNDisasmUtils::decodeDSEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
-                    break;
-                case GCNENC_MUBUF:
-                    GCNDisasmUtils::decodeMUBUFEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
-                    break;
-                case GCNENC_MTBUF:
-                    GCNDisasmUtils::decodeMUBUFEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
-                    break;
-                case GCNENC_MIMG:
-                    GCNDisasmUtils::decodeMIMGEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
-                    break;
-                case GCNENC_EXP:
-                    GCNDisasmUtils::decodeEXPEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
-                    break;
-                case GCNENC_FLAT:
-                    GCNDisasmUtils::decodeFLATEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
-                    break;
-                default:
-                    break;
-            }
-        }
+        // encoding and length from instruction index. operands are not needed,
+        // because they are printed from instruction words
+        const cxbyte instrInfo = index[pos];
+        decoder.fillRecord(codeWords, codeWordsNum, pos, instrInfo & GCNINDEX_ENCMASK,
+                    ((instrInfo & GCNINDEX_TWOWORD) != 0) ? 2 : 1, record, false);
+        pos = std::min(pos + record.length, codeWordsNum);
+        instrsNum++;
+        GCNDisasmUtils::printInstruction(*this, decoder, curArchMask, record, pos,
+                    curReloc);
         output.put('\n');
     }
     writeLabelsToEnd(codeWordsNum<<2, curLabel, curNamedLabel);
     output.flush();
-    disassembler.getOutput().flush();
+    output.getOStream().flush();
+    instrIndex.clear(); // free instruction index
     labels.clear(); // free labels
 }
@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <string>
 #include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
 
 namespace CLRX
 {
@@ -213,6 +214,49 @@ struct CLRX_INTERNAL GCNAsmInstruction
 
 CLRX_INTERNAL extern const GCNInstruction gcnInstrsTable[];
 
+struct CLRX_INTERNAL GCNDecodeTable;
+struct GCNInstrRecord;
+
+/* instruction decoder (uses disassembler decoding tables) */
+class CLRX_INTERNAL GCNInstrDecoder
+{
+private:
+    GPUArchitecture arch;
+    const GCNDecodeTable* table;
+public:
+    explicit GCNInstrDecoder(GPUArchitecture arch);
+    
+    /* returns length of instruction in words (with literal) and its encoding */
+    cxuint decode(uint32_t insnCode, cxbyte& encoding) const;
+    /* returns opcode of instruction for encoding */
+    cxuint getOpcode(cxbyte encoding, uint32_t insnCode) const;
+    /* returns instruction or null if instruction is illegal */
+    const GCNInstruction* findInstruction(cxbyte encoding, uint32_t insnCode) const
+    { return findInstructionByOpcode(encoding, getOpcode(encoding, insnCode)); }
+    /* returns instruction for opcode or null if instruction is illegal */
+    const GCNInstruction* findInstructionByOpcode(cxbyte encoding, cxuint opcode) const;
+    /* returns entry of instruction table for encoding and opcode
+     * (without checking architecture) */
+    const GCNInstruction* getTableEntry(cxbyte encoding, cxuint opcode) const;
+    
+    /* decode instruction at pos (in words) to record. operands are filled only
+     * if withOperands is true. relocation index is not set */
+    void decodeRecord(const uint32_t* codeWords, size_t codeWordsNum, size_t pos,
+                GCNInstrRecord& record, bool withOperands = true) const;
+    /* fill record of instruction at pos whose encoding and length are already
+     * known (for example from instruction index of disassembler) */
+    void fillRecord(const uint32_t* codeWords, size_t codeWordsNum, size_t pos,
+                cxbyte encoding, cxuint length, GCNInstrRecord& record,
+                bool withOperands) const;
+    /* fill operands of record (defined in GCNDecoder.cpp) */
+    void decodeOperands(GCNInstrRecord& record, const GCNInstruction& gcnInsn) const;
+    
+    /* instruction identifier is index in instruction table by code */
+    static uint16_t getInstrId(const GCNInstruction* gcnInsn);
+    /* returns instruction by identifier or null if identifier is wrong */
+    static const GCNInstruction* getInstruction(uint16_t instrId);
+};
+
 };
 
 #endif
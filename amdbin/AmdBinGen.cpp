@@ -33,6 +33,7 @@
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/MemAccess.h>
 #include <CLRX/utils/InputOutput.h>
+#include <CLRX/utils/ThreadPool.h>
 #include <CLRX/amdbin/AmdBinGen.h>
 
 using namespace CLRX;
@@ -163,17 +164,18 @@ void AmdInput::addEmptyKernel(const char* kernelName)
     kernels.push_back(std::move(kernel));
 }
 
-AmdGPUBinGenerator::AmdGPUBinGenerator() : manageable(false), input(nullptr)
+AmdGPUBinGenerator::AmdGPUBinGenerator() : manageable(false), input(nullptr),
+        threadsNum(1)
 { }
 
 AmdGPUBinGenerator::AmdGPUBinGenerator(const AmdInput* amdInput)
-        : manageable(false), input(amdInput)
+        : manageable(false), input(amdInput), threadsNum(1)
 { }
 
 AmdGPUBinGenerator::AmdGPUBinGenerator(bool _64bitMode, GPUDeviceType deviceType,
        uint32_t driverVersion, size_t globalDataSize, const cxbyte* globalData,
        const std::vector<AmdKernelInput>& kernelInputs)
-        : manageable(true), input(nullptr)
+        : manageable(true), input(nullptr), threadsNum(1)
 {
     input = new AmdInput{_64bitMode, deviceType, globalDataSize, globalData,
                 driverVersion, "", "", kernelInputs };
@@ -182,7 +184,7 @@ AmdGPUBinGenerator::AmdGPUBinGenerator(bool _64bitMode, GPUDeviceType deviceType
 AmdGPUBinGenerator::AmdGPUBinGenerator(bool _64bitMode, GPUDeviceType deviceType,
        uint32_t driverVersion, size_t globalDataSize, const cxbyte* globalData,
        std::vector<AmdKernelInput>&& kernelInputs)
-        : manageable(true), input(nullptr)
+        : manageable(true), input(nullptr), threadsNum(1)
 {
     input = new AmdInput{_64bitMode, deviceType, globalDataSize, globalData,
                 driverVersion, "", "", std::move(kernelInputs) };
@@ -373,6 +375,7 @@ public:
 struct CLRX_INTERNAL TempAmdKernelData
 {
     uint32_t innerBinSize;
+    size_t metadataSize;
     std::string metadata;
     CALNoteGen calNoteGen;
     KernelDataGen kernelDataGen;
@@ -1553,12 +1556,25 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
             gpuDeviceCodeTable[cxuint(input->deviceType)], EV_CURRENT, UINT_MAX, 0, 0 }));
     
     Array<TempAmdKernelData> tempAmdKernelDatas(kernelsNum);
-    cxuint uniqueId = 1024;
-    std::vector<cxuint> uniqueIds = collectUniqueIdsAndFunctionIds(input);
+    /* assign unique ids in kernel order before preparing kernels */
+    Array<cxuint> kernelUniqueIds(kernelsNum);
+    {
+        cxuint uniqueId = 1024;
+        std::vector<cxuint> uniqueIds = collectUniqueIdsAndFunctionIds(input);
+        for (size_t i = 0; i < kernelsNum; i++)
+            if (input->kernels[i].useConfig)
+            {   // get new free uniqueId
+                while (std::binary_search(uniqueIds.begin(), uniqueIds.end(), uniqueId))
+                    uniqueId++;
+                kernelUniqueIds[i] = uniqueId++;
+            }
+    }
     
-    uint64_t allInnerBinSize = 0;
-    size_t rodataSize = 0;
-    for (size_t i = 0; i < kernelsNum; i++)
+    /* prepare metadatas, CALNotes and inner binaries of kernels.
+     * kernels are independent, hence they can be prepared in parallel */
+    ThreadPool::runTasks(threadsNum, kernelsNum, [this, driverVersion, isOlderThan1124,
+            isOlderThan1348, &tempAmdKernelConfigs, &tempAmdKernelDatas,
+            &kernelUniqueIds](size_t i)
     {
         size_t calNotesSize = 0;
         size_t metadataSize = 0;
@@ -1566,10 +1582,7 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
         TempAmdKernelData& tempData = tempAmdKernelDatas[i];
         tempData.kernelDataGen = KernelDataGen(&kinput);
         if (kinput.useConfig)
-        {   // get new free uniqueId
-            while (std::binary_search(uniqueIds.begin(), uniqueIds.end(), uniqueId))
-                uniqueId++;
-            
+        {
             const AmdKernelConfig& config = kinput.config;
             cxuint readOnlyImages = 0;
             cxuint writeOnlyImages = 0;
@@ -1612,7 +1625,7 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
             tempConfig.uavsNum = uavsNum;
             
             tempAmdKernelDatas[i].metadata = generateMetadata(driverVersion, input, kinput,
-                     tempConfig, argSamplersNum, uniqueId);
+                     tempConfig, argSamplersNum, kernelUniqueIds[i]);
             
             calNotesSize = uint64_t(20*17) /*calNoteHeaders*/ + 16 + 128 + (18+32 +
                 4*((isOlderThan1124)?16:config.userDatas.size()))*8 /* proginfo */ +
@@ -1630,8 +1643,6 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
             tempData.header[5] = LEV(1U);
             tempData.header[6] = 0U;
             tempData.header[7] = 0U;
-            
-            uniqueId++;
         }
         else
         {
@@ -1641,7 +1652,7 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
             metadataSize = kinput.metadataSize + kinput.headerSize;
         }
         
-        rodataSize += metadataSize;
+        tempData.metadataSize = metadataSize;
         /* kernel elf bin generator */
         ElfBinaryGen32& kelfBinGen = tempAmdKernelDatas[i].elfBinGen;
         
@@ -1691,11 +1702,19 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
         const uint64_t innerBinSize = kelfBinGen.countSize();
         if (innerBinSize > UINT32_MAX)
             throw Exception("Inner binary size is too big!");
-        allInnerBinSize += tempAmdKernelDatas[i].innerBinSize = innerBinSize;
+        tempAmdKernelDatas[i].innerBinSize = innerBinSize;
         
         tempAmdKernelDatas[i].calEncEntry =
             { LEV(uint32_t(gpuDeviceInnerCodeTable[cxuint(input->deviceType)])), LEV(4U), 
                 LEV(0x1c0U), LEV(uint32_t(tempAmdKernelDatas[i].innerBinSize - 0x1c0U)) };
+    });
+    
+    uint64_t allInnerBinSize = 0;
+    size_t rodataSize = 0;
+    for (const TempAmdKernelData& tempData: tempAmdKernelDatas)
+    {
+        rodataSize += tempData.metadataSize;
+        allInnerBinSize += tempData.innerBinSize;
     }
     if (input->globalData!=nullptr)
         rodataSize += input->globalDataSize;
@@ -1728,24 +1747,29 @@ void AmdGPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>
     /****
      * prepare for write binary to output
      ****/
-    std::unique_ptr<std::ostream> outStreamHolder;
-    std::ostream* os = nullptr;
+    cxbyte* outData = nullptr;
     if (aPtr != nullptr)
     {
         aPtr->resize(binarySize);
-        outStreamHolder.reset(
-            new ArrayOStream(binarySize, reinterpret_cast<char*>(aPtr->data())));
-        os = outStreamHolder.get();
+        outData = aPtr->data();
     }
     else if (vPtr != nullptr)
     {
         vPtr->resize(binarySize);
-        outStreamHolder.reset(new VectorOStream(*vPtr));
-        os = outStreamHolder.get();
+        outData = reinterpret_cast<cxbyte*>(vPtr->data());
+    }
+    if (outData != nullptr)
+    {   // write directly to memory
+        FastOutputBuffer fob(binarySize, outData);
+        if (input->is64Bit)
+            elfBinGen64->generate(fob);
+        else
+            elfBinGen32->generate(fob);
+        assert(fob.getWritten() == binarySize);
+        return;
     }
-    else // from argument
-        os = osPtr;
     
+    std::ostream* os = osPtr;
     const std::ios::iostate oldExceptions = os->exceptions();
     FastOutputBuffer fob(256, *os);
     try
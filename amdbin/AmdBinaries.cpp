@@ -544,19 +544,31 @@ void AmdInnerX86Binary64::getKernelInfos(Array<KernelInfo>& kernelInfos) const
 
 /* AmdMainBinaryBase */
 
-AmdMainBinaryBase::AmdMainBinaryBase(AmdMainType _type) : type(_type)
+AmdMainBinaryBase::AmdMainBinaryBase(AmdMainType _type) : type(_type),
+        lazyKernelInfos(false)
 { }
 
 AmdMainBinaryBase::~AmdMainBinaryBase()
 { }
 
+void AmdMainBinaryBase::createKernelInfo(size_t index) const
+{ }
+
+const KernelInfo* AmdMainBinaryBase::getKernelInfos() const
+{
+    if (lazyKernelInfos)
+        for (size_t i = 0; i < kernelInfos.size(); i++)
+            createKernelInfo(i);
+    return kernelInfos.data();
+}
+
 const KernelInfo& AmdMainBinaryBase::getKernelInfo(const char* name) const
 {
     KernelInfoMap::const_iterator it = binaryMapFind(
         kernelInfosMap.begin(), kernelInfosMap.end(), name);
     if (it == kernelInfosMap.end())
         throw Exception("Can't find kernel name");
-    return kernelInfos[it->second];
+    return getKernelInfo(it->second);
 }
 
 static const cxuint vectorIdTable[17] =
@@ -617,8 +629,8 @@ static inline CString stringFromCStringDelim(const char* c1, size_t maxSize, cha
 
 /* metadata string that stored in rodata section in main GPU binary holds needed kernel
  * argument info (arg type and arg name). this function just retrieve that data */
-static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
-          const char* kernelDesc, KernelInfo& kernelInfo)
+static void parseAmdGpuKernelMetadata(size_t metadataSize, const char* kernelDesc,
+          KernelInfo& kernelInfo)
 {
     struct InitKernelArgMapEntry
     {
@@ -940,7 +952,6 @@ static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
         kptr++; // skip newline
     }
     
-    kernelInfo.kernelName.assign(symName+9, ::strlen(symName)-18);
     kernelInfo.argInfos.resize(argIndex);
     
     for (const auto& e: initKernelArgs)
@@ -1023,7 +1034,8 @@ struct CLRX_INTERNAL AmdGPU64Types: Elf64Types
 };
 
 AmdMainGPUBinaryBase::AmdMainGPUBinaryBase(AmdMainType type)
-        : AmdMainBinaryBase(type), metadatas(nullptr), globalDataSize(0), globalData(0)
+        : AmdMainBinaryBase(type), innerBinaryFlags(0), metadatas(nullptr),
+          globalDataSize(0), globalData(0)
 { }
 
 template<typename Types>
@@ -1044,6 +1056,7 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     const bool doKernelHeaders = (creationFlags & AMDBIN_CREATE_KERNELHEADERS) != 0;
     const bool doKernelInfo = (creationFlags & AMDBIN_CREATE_KERNELINFO) != 0;
     const bool doInfoStrings = (creationFlags & AMDBIN_CREATE_INFOSTRINGS) != 0;
+    const bool lazy = (creationFlags & AMDBIN_CREATE_LAZY) != 0;
     size_t compileOptionsEnd = 0;
     uint16_t compileOptionShIndex = SHN_UNDEF;
     
@@ -1114,12 +1127,18 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     }
     
     innerBinaries.resize(choosenSyms.size());
+    innerBinaryFlags = (creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL;
     
     if (textIndex != SHN_UNDEF) /* if have ".text" */
     {
         const typename Types::Shdr& textHdr = mainElf.getSectionHeader(textIndex);
         cxbyte* textContent = mainElf.getBinaryCode() + ULEV(textHdr.sh_offset);
         
+        if (lazy)
+        {   // inner binaries will be created later
+            innerBinaryCodes.resize(choosenSyms.size());
+            innerBinaryOnceFlags.reset(new std::once_flag[choosenSyms.size()]);
+        }
         /* create table of innerBinaries */
         size_t ki = 0;
         for (auto it: choosenSyms)
@@ -1135,15 +1154,20 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
             if (usumGt(symvalue, symsize, ULEV(textHdr.sh_size)))
                 throw Exception("Inner binary offset+size out of range!");
             
-            innerBinaries[ki++] = AmdInnerGPUBinary32(CString(symName+9, len-16),
-                symsize, textContent+symvalue,
-                (creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL);
+            if (lazy)
+                innerBinaryCodes[ki++] = { CString(symName+9, len-16), symsize,
+                            textContent+symvalue };
+            else
+                innerBinaries[ki++] = AmdInnerGPUBinary32(CString(symName+9, len-16),
+                    symsize, textContent+symvalue, innerBinaryFlags);
         }
         if ((creationFlags & AMDBIN_CREATE_INNERBINMAP) != 0)
         {
             innerBinaryMap.resize(innerBinaries.size());
             for (size_t i = 0; i < innerBinaries.size(); i++)
-                innerBinaryMap[i] = std::make_pair(innerBinaries[i].getKernelName(), i);
+                innerBinaryMap[i] = std::make_pair((lazy) ?
+                        innerBinaryCodes[i].kernelName :
+                        innerBinaries[i].getKernelName(), i);
             mapSort(innerBinaryMap.begin(), innerBinaryMap.end());
         }
     }
@@ -1152,6 +1176,11 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     {
         kernelInfos.resize(choosenSymsMetadata.size());
         metadatas.reset(new AmdGPUKernelMetadata[kernelInfos.size()]);
+        if (lazy)
+        {   // kernel infos will be parsed later
+            lazyKernelInfos = true;
+            kernelInfoOnceFlags.reset(new std::once_flag[kernelInfos.size()]);
+        }
         
         typename Types::Size ki = 0;
         for (typename Types::Size it: choosenSymsMetadata)
@@ -1172,9 +1201,11 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
             if (usumGt(symvalue, symsize, ULEV(rodataHdr.sh_size)))
                 throw Exception("Metadata offset+size out of range");
             
-            parseAmdGpuKernelMetadata(symName, symsize,
-                  reinterpret_cast<const char*>(secContent + symvalue),
-                  kernelInfos[ki]);
+            kernelInfos[ki].kernelName.assign(symName+9, ::strlen(symName)-18);
+            if (!lazy)
+                parseAmdGpuKernelMetadata(symsize,
+                      reinterpret_cast<const char*>(secContent + symvalue),
+                      kernelInfos[ki]);
             metadatas[ki].size = symsize;
             metadatas[ki].data = reinterpret_cast<char*>(secContent + symvalue);
             ki++;
@@ -1229,13 +1260,35 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     }
 }
 
+void AmdMainGPUBinaryBase::createInnerBinary(size_t index) const
+{
+    std::call_once(innerBinaryOnceFlags[index], [this, index]()
+    {
+        const InnerBinaryCode& innerCode = innerBinaryCodes[index];
+        innerBinaries[index] = AmdInnerGPUBinary32(innerCode.kernelName,
+                    innerCode.size, innerCode.code, innerBinaryFlags);
+    });
+}
+
+void AmdMainGPUBinaryBase::createKernelInfo(size_t index) const
+{
+    std::call_once(kernelInfoOnceFlags[index], [this, index]()
+    {
+        KernelInfo kernelInfo;
+        kernelInfo.kernelName = kernelInfos[index].kernelName;
+        parseAmdGpuKernelMetadata(metadatas[index].size, metadatas[index].data,
+                    kernelInfo);
+        kernelInfos[index] = std::move(kernelInfo);
+    });
+}
+
 const AmdInnerGPUBinary32& AmdMainGPUBinaryBase::getInnerBinary(const char* name) const
 {
     InnerBinaryMap::const_iterator it = binaryMapFind(innerBinaryMap.begin(),
                   innerBinaryMap.end(), name);
     if (it == innerBinaryMap.end())
         throw Exception("Can't find inner binary");
-    return innerBinaries[it->second];
+    return getInnerBinary(it->second);
 }
 
 const AmdGPUKernelHeader& AmdMainGPUBinaryBase::getKernelHeaderEntry(
@@ -29,6 +29,7 @@
 #include <memory>
 #include <CLRX/utils/Containers.h>
 #include <CLRX/utils/InputOutput.h>
+#include <CLRX/utils/ThreadPool.h>
 #include <CLRX/amdbin/AmdCL2Binaries.h>
 #include <CLRX/amdbin/AmdCL2BinGen.h>
 
@@ -47,18 +48,19 @@ void AmdCL2Input::addEmptyKernel(const char* kernelName)
     kernels.push_back(std::move(kernel));
 }
 
-AmdCL2GPUBinGenerator::AmdCL2GPUBinGenerator() : manageable(false), input(nullptr)
+AmdCL2GPUBinGenerator::AmdCL2GPUBinGenerator() : manageable(false), input(nullptr),
+        threadsNum(1)
 { }
 
 AmdCL2GPUBinGenerator::AmdCL2GPUBinGenerator(const AmdCL2Input* amdInput)
-        : manageable(false), input(amdInput)
+        : manageable(false), input(amdInput), threadsNum(1)
 { }
 
 AmdCL2GPUBinGenerator::AmdCL2GPUBinGenerator(GPUDeviceType deviceType,
        uint32_t driverVersion, size_t globalDataSize, const cxbyte* globalData,
        size_t rwDataSize, const cxbyte* rwData, 
        const std::vector<AmdCL2KernelInput>& kernelInputs)
-        : manageable(true), input(nullptr)
+        : manageable(true), input(nullptr), threadsNum(1)
 {
     input = new AmdCL2Input{deviceType, globalDataSize, globalData,
                 rwDataSize, rwData, 0, 0, 0, nullptr, false, { }, { },
@@ -69,7 +71,7 @@ AmdCL2GPUBinGenerator::AmdCL2GPUBinGenerator(GPUDeviceType deviceType,
        uint32_t driverVersion, size_t globalDataSize, const cxbyte* globalData,
        size_t rwDataSize, const cxbyte* rwData,
        std::vector<AmdCL2KernelInput>&& kernelInputs)
-        : manageable(true), input(nullptr)
+        : manageable(true), input(nullptr), threadsNum(1)
 {
     input = new AmdCL2Input{deviceType, globalDataSize, globalData,
                 rwDataSize, rwData, 0, 0, 0, nullptr, false, { }, { },
@@ -268,7 +270,7 @@ static const cxbyte kernelIsaMetadata[] =
 };
 
 static void prepareKernelTempData(const AmdCL2Input* input,
-          Array<TempAmdCL2KernelData>& tempDatas)
+          Array<TempAmdCL2KernelData>& tempDatas, cxuint threadsNum)
 {
     const bool newBinaries = input->driverVersion >= 191205;
     const bool is16_3Ver = input->driverVersion >= 200406;
@@ -277,7 +279,9 @@ static void prepareKernelTempData(const AmdCL2Input* input,
     const size_t samplersNum = (input->samplerConfig) ?
                 input->samplers.size() : (input->samplerInitSize>>3);
     
-    for (size_t i = 0; i < kernelsNum; i++)
+    // kernels are independent, hence they can be prepared in parallel
+    ThreadPool::runTasks(threadsNum, kernelsNum, [input, newBinaries, is16_3Ver,
+            samplersNum, &tempDatas](size_t i)
     {
         const AmdCL2KernelInput& kernel = input->kernels[i];
         TempAmdCL2KernelData& tempData = tempDatas[i];
@@ -442,7 +446,7 @@ static void prepareKernelTempData(const AmdCL2Input* input,
             }
         }
         tempData.codeSize = kernel.codeSize;
-    }
+    });
 }
 
 // fast and memory efficient String table generator for main binary
@@ -1851,7 +1855,7 @@ void AmdCL2GPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<ch
     }
     
     Array<TempAmdCL2KernelData> tempDatas(kernelsNum);
-    prepareKernelTempData(input, tempDatas);
+    prepareKernelTempData(input, tempDatas, threadsNum);
     
     const size_t dataSymbolsNum = std::count_if(input->innerExtraSymbols.begin(),
         input->innerExtraSymbols.end(), [](const BinSymbol& symbol)
@@ -2078,24 +2082,26 @@ void AmdCL2GPUBinGenerator::generateInternal(std::ostream* osPtr, std::vector<ch
     /****
      * prepare for write binary to output
      ****/
-    std::unique_ptr<std::ostream> outStreamHolder;
-    std::ostream* os = nullptr;
+    cxbyte* outData = nullptr;
     if (aPtr != nullptr)
     {
         aPtr->resize(binarySize);
-        outStreamHolder.reset(
-            new ArrayOStream(binarySize, reinterpret_cast<char*>(aPtr->data())));
-        os = outStreamHolder.get();
+        outData = aPtr->data();
     }
     else if (vPtr != nullptr)
     {
         vPtr->resize(binarySize);
-        outStreamHolder.reset(new VectorOStream(*vPtr));
-        os = outStreamHolder.get();
+        outData = reinterpret_cast<cxbyte*>(vPtr->data());
+    }
+    if (outData != nullptr)
+    {   // write directly to memory
+        FastOutputBuffer fob(binarySize, outData);
+        elfBinGen.generate(fob);
+        assert(fob.getWritten() == binarySize);
+        return;
     }
-    else // from argument
-        os = osPtr;
     
+    std::ostream* os = osPtr;
     const std::ios::iostate oldExceptions = os->exceptions();
     FastOutputBuffer fob(256, *os);
     try
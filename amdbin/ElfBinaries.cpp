@@ -827,7 +827,8 @@ void ElfBinaryGenTemplate<Types>::generate(FastOutputBuffer& fob)
         }
     }
     fob.flush();
-    fob.getOStream().flush();
+    if (!fob.isMemoryBuffer())
+        fob.getOStream().flush();
     assert(size == fob.getWritten()-startOffset);
 }
 
@@ -577,6 +577,44 @@ static void putSectionsAndSymbols(ElfBinaryGenTemplate<Types>& elfBinGen,
                          GALLIUMSECTID_MAX, startSectionIndex));
 }
 
+/* write Gallium binary (kernel infos, section header and inner ELF binary) */
+static void writeGalliumBinary(FastOutputBuffer& bos, const GalliumInput* input,
+            const Array<uint32_t>& kernelsOrder, uint64_t elfSize,
+            ElfBinaryGen32* elfBinGen32, ElfBinaryGen64* elfBinGen64)
+{
+    bos.writeObject<uint32_t>(LEV(uint32_t(kernelsOrder.size())));
+    for (uint32_t korder: kernelsOrder)
+    {
+        const GalliumKernelInput& kernel = input->kernels[korder];
+        if (kernel.offset >= input->codeSize)
+            throw Exception("Kernel offset out of range");
+        
+        bos.writeObject<uint32_t>(LEV(uint32_t(kernel.kernelName.size())));
+        bos.writeArray(kernel.kernelName.size(), kernel.kernelName.c_str());
+        const uint32_t other[3] = { 0, LEV(kernel.offset),
+            LEV(cxuint(kernel.argInfos.size())) };
+        bos.writeArray(3, other);
+        
+        for (const GalliumArgInfo arg: kernel.argInfos)
+        {
+            const uint32_t argData[6] = { LEV(cxuint(arg.type)),
+                LEV(arg.size), LEV(arg.targetSize), LEV(arg.targetAlign),
+                LEV(arg.signExtended?1U:0U), LEV(cxuint(arg.semantic)) };
+            bos.writeArray(6, argData);
+        }
+    }
+    /* section */
+    {
+        const uint32_t section[6] = { LEV(1U), LEV(0U), LEV(0U), LEV(uint32_t(elfSize)),
+            LEV(uint32_t(elfSize+4)), LEV(uint32_t(elfSize)) };
+        bos.writeArray(6, section);
+    }
+    if (!input->is64BitElf)
+        elfBinGen32->generate(bos);
+    else // 64-bit
+        elfBinGen64->generate(bos);
+}
+
 void GalliumBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char>* vPtr,
              Array<cxbyte>* aPtr) const
 {
@@ -649,64 +687,35 @@ void GalliumBinGenerator::generateInternal(std::ostream* osPtr, std::vector<char
     /****
      * prepare for write binary to output
      ****/
-    std::unique_ptr<std::ostream> outStreamHolder;
-    std::ostream* os = nullptr;
+    cxbyte* outData = nullptr;
     if (aPtr != nullptr)
     {
         aPtr->resize(binarySize);
-        outStreamHolder.reset(
-                new ArrayOStream(binarySize, reinterpret_cast<char*>(aPtr->data())));
-        os = outStreamHolder.get();
+        outData = aPtr->data();
     }
     else if (vPtr != nullptr)
     {
         vPtr->resize(binarySize);
-        outStreamHolder.reset(new VectorOStream(*vPtr));
-        os = outStreamHolder.get();
+        outData = reinterpret_cast<cxbyte*>(vPtr->data());
+    }
+    if (outData != nullptr)
+    {   // write directly to memory
+        FastOutputBuffer bos(binarySize, outData);
+        writeGalliumBinary(bos, input, kernelsOrder, elfSize,
+                    elfBinGen32.get(), elfBinGen64.get());
+        assert(bos.getWritten() == binarySize);
+        return;
     }
-    else // from argument
-        os = osPtr;
     
+    std::ostream* os = osPtr;
     const std::ios::iostate oldExceptions = os->exceptions();
     try
     {
-    os->exceptions(std::ios::failbit | std::ios::badbit);
-    /****
-     * write binary to output
-     ****/
-    FastOutputBuffer bos(256, *os);
-    bos.writeObject<uint32_t>(LEV(kernelsNum));
-    for (uint32_t korder: kernelsOrder)
-    {
-        const GalliumKernelInput& kernel = input->kernels[korder];
-        if (kernel.offset >= input->codeSize)
-            throw Exception("Kernel offset out of range");
-        
-        bos.writeObject<uint32_t>(LEV(uint32_t(kernel.kernelName.size())));
-        bos.writeArray(kernel.kernelName.size(), kernel.kernelName.c_str());
-        const uint32_t other[3] = { 0, LEV(kernel.offset),
-            LEV(cxuint(kernel.argInfos.size())) };
-        bos.writeArray(3, other);
-        
-        for (const GalliumArgInfo arg: kernel.argInfos)
-        {
-            const uint32_t argData[6] = { LEV(cxuint(arg.type)),
-                LEV(arg.size), LEV(arg.targetSize), LEV(arg.targetAlign),
-                LEV(arg.signExtended?1U:0U), LEV(cxuint(arg.semantic)) };
-            bos.writeArray(6, argData);
-        }
-    }
-    /* section */
-    {
-        const uint32_t section[6] = { LEV(1U), LEV(0U), LEV(0U), LEV(uint32_t(elfSize)),
-            LEV(uint32_t(elfSize+4)), LEV(uint32_t(elfSize)) };
-        bos.writeArray(6, section);
-    }
-    if (!input->is64BitElf)
-        elfBinGen32->generate(bos);
-    else // 64-bit
-        elfBinGen64->generate(bos);
-    assert(bos.getWritten() == binarySize);
+        os->exceptions(std::ios::failbit | std::ios::badbit);
+        FastOutputBuffer bos(256, *os);
+        writeGalliumBinary(bos, input, kernelsOrder, elfSize,
+                    elfBinGen32.get(), elfBinGen64.get());
+        assert(bos.getWritten() == binarySize);
     }
     catch(...)
     {
@@ -173,6 +173,7 @@ clrxclGetPlatformIDs(cl_uint          num_entries,
                  cl_platform_id * platforms,
                  cl_uint *        num_platforms) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetPlatformIDs)
     CLRX_INITIALIZE
     
     if (num_entries == 0 && platforms != nullptr)
@@ -225,6 +226,7 @@ clrxclGetPlatformInfo(cl_platform_id   platform,
                   void *           param_value,
                   size_t *         param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetPlatformInfo)
     CLRX_INITIALIZE
     
     if (platform == nullptr)
@@ -273,6 +275,7 @@ clrxclGetDeviceIDs(cl_platform_id   platform,
                cl_device_id *   devices,
                cl_uint *        num_devices) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetDeviceIDs)
     CLRX_INITIALIZE
     
     if (platform == nullptr)
@@ -325,6 +328,7 @@ clrxclGetDeviceInfo(cl_device_id    device,
                 void *          param_value,
                 size_t *        param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetDeviceInfo)
     if (device == nullptr)
         return CL_INVALID_DEVICE;
     
@@ -415,6 +419,7 @@ clrxclCreateContext(const cl_context_properties * properties,
                 void *                  user_data,
                 cl_int *                errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateContext)
     CLRX_INITIALIZE_OBJ
     
     if (devices == nullptr || num_devices == 0)
@@ -544,6 +549,7 @@ clrxclCreateContextFromType(const cl_context_properties * properties,
                     void *                  user_data,
                     cl_int *                errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateContextFromType)
     CLRX_INITIALIZE_OBJ
     
     CLRXPlatform* platform = clrxPlatforms; // choose first AMD platform
@@ -657,6 +663,7 @@ clrxclCreateContextFromType(const cl_context_properties * properties,
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclRetainContext(cl_context context) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clRetainContext)
     if (context == nullptr)
         return CL_INVALID_CONTEXT;
     
@@ -670,6 +677,7 @@ clrxclRetainContext(cl_context context) CL_API_SUFFIX__VERSION_1_0
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclReleaseContext(cl_context context) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clReleaseContext)
     if (context == nullptr)
         return CL_INVALID_CONTEXT;
     CLRXContext* c = static_cast<CLRXContext*>(context);
@@ -686,6 +694,7 @@ clrxclGetContextInfo(cl_context         context,
                  void *             param_value, 
                  size_t *           param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetContextInfo)
     if (context == nullptr)
         return CL_INVALID_CONTEXT;
     
@@ -751,6 +760,7 @@ clrxclCreateCommandQueue(cl_context                     context,
                      cl_command_queue_properties    properties,
                      cl_int *                       errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateCommandQueue)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -784,6 +794,7 @@ clrxclCreateCommandQueue(cl_context                     context,
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclRetainCommandQueue(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clRetainCommandQueue)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -798,6 +809,7 @@ clrxclRetainCommandQueue(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclReleaseCommandQueue(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clReleaseCommandQueue)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     CLRXCommandQueue* q = static_cast<CLRXCommandQueue*>(command_queue);
@@ -815,6 +827,7 @@ clrxclGetCommandQueueInfo(cl_command_queue      command_queue,
               void *                param_value,
               size_t *              param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetCommandQueueInfo)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -870,6 +883,7 @@ clrxclCreateBuffer(cl_context   context,
                void *       host_ptr,
                cl_int *     errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateBuffer)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -901,6 +915,7 @@ clrxclCreateImage2D(cl_context              context,
             void *                  host_ptr,
             cl_int *                errcode_ret) CL_EXT_SUFFIX__VERSION_1_1_DEPRECATED
 {
+    CLRX_TRACE_CALL(clCreateImage2D)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -935,6 +950,7 @@ clrxclCreateImage3D(cl_context              context,
             void *                  host_ptr,
             cl_int *                errcode_ret) CL_EXT_SUFFIX__VERSION_1_1_DEPRECATED
 {
+    CLRX_TRACE_CALL(clCreateImage3D)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -960,6 +976,7 @@ clrxclCreateImage3D(cl_context              context,
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclRetainMemObject(cl_mem memobj) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clRetainMemObject)
     if (memobj == nullptr)
         return CL_INVALID_MEM_OBJECT;
     
@@ -974,6 +991,7 @@ clrxclRetainMemObject(cl_mem memobj) CL_API_SUFFIX__VERSION_1_0
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclReleaseMemObject(cl_mem memobj) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clReleaseMemObject)
     if (memobj == nullptr)
         return CL_INVALID_MEM_OBJECT;
     CLRXMemObject* m = static_cast<CLRXMemObject*>(memobj);
@@ -993,6 +1011,7 @@ clrxclGetSupportedImageFormats(cl_context           context,
                    cl_uint *            num_image_formats) CL_API_SUFFIX__VERSION_1_0
 
 {
+    CLRX_TRACE_CALL(clGetSupportedImageFormats)
     if (context == nullptr)
         return CL_INVALID_CONTEXT;
     const CLRXContext* c = static_cast<const CLRXContext*>(context);
@@ -1007,6 +1026,7 @@ clrxclGetMemObjectInfo(cl_mem           memobj,
                    void *           param_value,
                    size_t *         param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetMemObjectInfo)
     if (memobj == nullptr)
         return CL_INVALID_MEM_OBJECT;
     
@@ -1064,6 +1084,7 @@ clrxclGetImageInfo(cl_mem           image,
                void *           param_value,
                size_t *         param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetImageInfo)
     if (image == nullptr)
         return CL_INVALID_MEM_OBJECT;
     
@@ -1098,6 +1119,7 @@ clrxclCreateSampler(cl_context          context,
                 cl_filter_mode      filter_mode,
                 cl_int *            errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateSampler)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1122,6 +1144,7 @@ clrxclCreateSampler(cl_context          context,
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclRetainSampler(cl_sampler sampler) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clRetainSampler)
     if (sampler == nullptr)
         return CL_INVALID_SAMPLER;
     
@@ -1135,6 +1158,7 @@ clrxclRetainSampler(cl_sampler sampler) CL_API_SUFFIX__VERSION_1_0
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclReleaseSampler(cl_sampler sampler) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clReleaseSampler)
     if (sampler == nullptr)
         return CL_INVALID_SAMPLER;
     CLRXSampler* s = static_cast<CLRXSampler*>(sampler);
@@ -1155,6 +1179,7 @@ clrxclGetSamplerInfo(cl_sampler         sampler,
                  void *             param_value,
                  size_t *           param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetSamplerInfo)
     if (sampler == nullptr)
         return CL_INVALID_SAMPLER;
     const CLRXSampler* s = static_cast<const CLRXSampler*>(sampler);
@@ -1184,6 +1209,7 @@ clrxclCreateProgramWithSource(cl_context        context,
                           const size_t *    lengths,
                           cl_int *          errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateProgramWithSource)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1210,6 +1236,7 @@ clrxclCreateProgramWithBinary(cl_context                     context,
               cl_int *                       binary_status,
               cl_int *                       errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateProgramWithBinary)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1261,6 +1288,7 @@ clrxclCreateProgramWithBinary(cl_context                     context,
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclRetainProgram(cl_program program) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clRetainProgram)
     if (program == nullptr)
         return CL_INVALID_PROGRAM;
     
@@ -1274,6 +1302,7 @@ clrxclRetainProgram(cl_program program) CL_API_SUFFIX__VERSION_1_0
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclReleaseProgram(cl_program program) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clReleaseProgram)
     if (program == nullptr)
         return CL_INVALID_PROGRAM;
     CLRXProgram * p = static_cast<CLRXProgram*>(program);
@@ -1305,6 +1334,7 @@ clrxclBuildProgram(cl_program           program,
        void (CL_CALLBACK *  pfn_notify)(cl_program /* program */, void * /* user_data */),
                void *               user_data) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clBuildProgram)
     if (program == nullptr)
         return CL_INVALID_PROGRAM;
     
@@ -1458,6 +1488,7 @@ clrxclBuildProgram(cl_program           program,
 CL_API_ENTRY CL_EXT_PREFIX__VERSION_1_1_DEPRECATED cl_int CL_API_CALL
 clrxclUnloadCompiler(void) CL_EXT_SUFFIX__VERSION_1_1_DEPRECATED
 {
+    CLRX_TRACE_CALL(clUnloadCompiler)
     CLRX_INITIALIZE
     
     if (amdOclUnloadCompiler != nullptr)
@@ -1472,6 +1503,7 @@ clrxclGetProgramInfo(cl_program         program,
                  void *             param_value,
                  size_t *           param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetProgramInfo)
     if (program == nullptr)
         return CL_INVALID_PROGRAM;
     CLRXProgram* p = static_cast<CLRXProgram*>(program);
@@ -1645,6 +1677,7 @@ clrxclGetProgramBuildInfo(cl_program            program,
               void *                param_value,
               size_t *              param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetProgramBuildInfo)
     if (program == nullptr)
         return CL_INVALID_PROGRAM;
     if (device == nullptr)
@@ -1745,6 +1778,7 @@ clrxclCreateKernel(cl_program      program,
                const char *    kernel_name,
                cl_int *        errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateKernel)
     if (program == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1826,6 +1860,7 @@ clrxclCreateKernelsInProgram(cl_program     program,
                          cl_kernel *    kernels,
                          cl_uint *      num_kernels_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateKernelsInProgram)
     if (program == nullptr)
         return CL_INVALID_PROGRAM;
 
@@ -1950,6 +1985,7 @@ clrxclCreateKernelsInProgram(cl_program     program,
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclRetainKernel(cl_kernel    kernel) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clRetainKernel)
     if (kernel == nullptr)
         return CL_INVALID_KERNEL;
     
@@ -1963,6 +1999,7 @@ clrxclRetainKernel(cl_kernel    kernel) CL_API_SUFFIX__VERSION_1_0
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclReleaseKernel(cl_kernel   kernel) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clReleaseKernel)
     if (kernel == nullptr)
         return CL_INVALID_KERNEL;
     CLRXKernel* k = static_cast<CLRXKernel*>(kernel);
@@ -2000,6 +2037,7 @@ clrxclSetKernelArg(cl_kernel    kernel,
                size_t       arg_size,
                const void * arg_value) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clSetKernelArg)
     if (kernel == nullptr)
         return CL_INVALID_KERNEL;
     
@@ -2056,6 +2094,7 @@ clrxclGetKernelInfo(cl_kernel       kernel,
                 void *          param_value,
                 size_t *        param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetKernelInfo)
     if (kernel == nullptr)
         return CL_INVALID_KERNEL;
     const CLRXKernel* k = static_cast<const CLRXKernel*>(kernel);
@@ -2099,6 +2138,7 @@ clrxclGetKernelWorkGroupInfo(cl_kernel                  kernel,
          void *                     param_value,
          size_t *                   param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetKernelWorkGroupInfo)
     if (kernel == nullptr)
         return CL_INVALID_KERNEL;
     
@@ -151,6 +151,7 @@ CL_API_ENTRY cl_int CL_API_CALL
 clrxclWaitForEvents(cl_uint             num_events,
                 const cl_event *    event_list) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clWaitForEvents)
     if (num_events == 0 || event_list == nullptr)
         return CL_INVALID_VALUE;
     
@@ -189,6 +190,7 @@ clrxclGetEventInfo(cl_event         event,
                void *           param_value,
                size_t *         param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetEventInfo)
     if (event == nullptr)
         return CL_INVALID_EVENT;
     const CLRXEvent* e = static_cast<const CLRXEvent*>(event);
@@ -230,6 +232,7 @@ clrxclGetEventInfo(cl_event         event,
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclRetainEvent(cl_event event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clRetainEvent)
     if (event == nullptr)
         return CL_INVALID_EVENT;
     
@@ -243,6 +246,7 @@ clrxclRetainEvent(cl_event event) CL_API_SUFFIX__VERSION_1_0
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclReleaseEvent(cl_event event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clReleaseEvent)
     if (event == nullptr)
         return CL_INVALID_EVENT;
     CLRXEvent* e = static_cast<CLRXEvent*>(event);
@@ -266,6 +270,7 @@ clrxclGetEventProfilingInfo(cl_event            event,
                 void *              param_value,
                 size_t *            param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetEventProfilingInfo)
     if (event == nullptr)
         return CL_INVALID_EVENT;
     
@@ -277,6 +282,7 @@ clrxclGetEventProfilingInfo(cl_event            event,
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclFlush(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clFlush)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -287,6 +293,7 @@ clrxclFlush(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_0
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclFinish(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clFinish)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -305,6 +312,7 @@ clrxclEnqueueReadBuffer(cl_command_queue    command_queue,
                     const cl_event *    event_wait_list,
                     cl_event *          event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueReadBuffer)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (buffer == nullptr)
@@ -337,6 +345,7 @@ clrxclEnqueueWriteBuffer(cl_command_queue   command_queue,
                      const cl_event *   event_wait_list,
                      cl_event *         event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueWriteBuffer)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (buffer == nullptr)
@@ -369,6 +378,7 @@ clrxclEnqueueCopyBuffer(cl_command_queue    command_queue,
                     const cl_event *    event_wait_list,
                     cl_event *          event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueCopyBuffer)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (src_buffer == nullptr || dst_buffer == nullptr)
@@ -404,6 +414,7 @@ clrxclEnqueueReadImage(cl_command_queue     command_queue,
                    const cl_event *     event_wait_list,
                    cl_event *           event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueReadImage)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (image == nullptr)
@@ -440,6 +451,7 @@ clrxclEnqueueWriteImage(cl_command_queue    command_queue,
                     const cl_event *    event_wait_list,
                     cl_event *          event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueWriteImage)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (image == nullptr)
@@ -474,6 +486,7 @@ clrxclEnqueueCopyImage(cl_command_queue     command_queue,
                    const cl_event *     event_wait_list,
                    cl_event *           event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueCopyImage)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (src_image == nullptr || dst_image == nullptr)
@@ -507,6 +520,7 @@ clrxclEnqueueCopyImageToBuffer(cl_command_queue command_queue,
                            const cl_event * event_wait_list,
                            cl_event *       event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueCopyImageToBuffer)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (src_image == nullptr || dst_buffer == nullptr)
@@ -540,6 +554,7 @@ clrxclEnqueueCopyBufferToImage(cl_command_queue command_queue,
                            const cl_event * event_wait_list,
                            cl_event *       event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueCopyBufferToImage)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (src_buffer == nullptr || dst_image == nullptr)
@@ -574,6 +589,7 @@ clrxclEnqueueMapBuffer(cl_command_queue command_queue,
                    cl_event *       event,
                    cl_int *         errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueMapBuffer)
     if (command_queue == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -679,6 +695,8 @@ clrxclEnqueueMapBuffer(cl_command_queue command_queue,
         *event = outEvent.release();
         clrxRetainOnlyCLRXContext(q->context);
         clrxRetainOnlyCLRXCommandQueue(q);
+        if (clrxTraceEnabled.load(std::memory_order_relaxed))
+            clrxTraceCommandCompletion(q, amdEvent);
     }
     return output;
 }
@@ -697,6 +715,7 @@ clrxclEnqueueMapImage(cl_command_queue  command_queue,
                   cl_event *        event,
                   cl_int *          errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueMapImage)
     if (command_queue == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -803,6 +822,8 @@ clrxclEnqueueMapImage(cl_command_queue  command_queue,
         *event = outEvent.release();
         clrxRetainOnlyCLRXContext(q->context);
         clrxRetainOnlyCLRXCommandQueue(q);
+        if (clrxTraceEnabled.load(std::memory_order_relaxed))
+            clrxTraceCommandCompletion(q, amdEvent);
     }
     return output;
 }
@@ -815,6 +836,7 @@ clrxclEnqueueUnmapMemObject(cl_command_queue command_queue,
                         const cl_event *  event_wait_list,
                         cl_event *        event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueUnmapMemObject)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (memobj == nullptr)
@@ -847,6 +869,7 @@ clrxclEnqueueNDRangeKernel(cl_command_queue command_queue,
                        const cl_event * event_wait_list,
                        cl_event *       event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueNDRangeKernel)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (kernel == nullptr)
@@ -876,6 +899,7 @@ clrxclEnqueueTask(cl_command_queue  command_queue,
               const cl_event *  event_wait_list,
               cl_event *        event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueTask)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (kernel == nullptr)
@@ -909,6 +933,7 @@ clrxclEnqueueNativeKernel(cl_command_queue  command_queue,
                       const cl_event *  event_wait_list,
                       cl_event *        event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueNativeKernel)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -991,6 +1016,7 @@ CL_API_ENTRY CL_EXT_PREFIX__VERSION_1_1_DEPRECATED cl_int CL_API_CALL
 clrxclEnqueueMarker(cl_command_queue    command_queue,
                 cl_event *          event) CL_EXT_SUFFIX__VERSION_1_1_DEPRECATED
 {
+    CLRX_TRACE_CALL(clEnqueueMarker)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -1011,6 +1037,7 @@ clrxclEnqueueWaitForEvents(cl_command_queue command_queue,
             cl_uint          num_events,
             const cl_event * event_list) CL_EXT_SUFFIX__VERSION_1_1_DEPRECATED
 {
+    CLRX_TRACE_CALL(clEnqueueWaitForEvents)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -1050,6 +1077,7 @@ clrxclEnqueueWaitForEvents(cl_command_queue command_queue,
 CL_API_ENTRY CL_EXT_PREFIX__VERSION_1_1_DEPRECATED cl_int CL_API_CALL
 clrxclEnqueueBarrier(cl_command_queue command_queue) CL_EXT_SUFFIX__VERSION_1_1_DEPRECATED
 {
+    CLRX_TRACE_CALL(clEnqueueBarrier)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -1061,6 +1089,7 @@ CL_API_ENTRY CL_EXT_PREFIX__VERSION_1_1_DEPRECATED void * CL_API_CALL
 clrxclGetExtensionFunctionAddress(const char * func_name)
         CL_EXT_SUFFIX__VERSION_1_1_DEPRECATED
 {
+    CLRX_TRACE_CALL(clGetExtensionFunctionAddress)
     CLRX_INITIALIZE_VOIDPTR
     
     if (!useCLRXWrapper) // call original amdocl function
@@ -1084,6 +1113,7 @@ clrxclCreateFromGLBuffer(cl_context     context,
                      cl_GLuint      bufobj,
                      int *          errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateFromGLBuffer)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1113,6 +1143,7 @@ clrxclCreateFromGLTexture2D(cl_context      context,
                 cl_GLuint       texture,
                 cl_int *        errcode_ret) CL_EXT_SUFFIX__VERSION_1_1_DEPRECATED
 {
+    CLRX_TRACE_CALL(clCreateFromGLTexture2D)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1142,6 +1173,7 @@ clrxclCreateFromGLTexture3D(cl_context      context,
                 cl_GLuint       texture,
                 cl_int *        errcode_ret) CL_EXT_SUFFIX__VERSION_1_1_DEPRECATED
 {
+    CLRX_TRACE_CALL(clCreateFromGLTexture3D)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1169,6 +1201,7 @@ clrxclCreateFromGLRenderbuffer(cl_context   context,
                            cl_GLuint    renderbuffer,
                            cl_int *     errcode_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clCreateFromGLRenderbuffer)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1195,6 +1228,7 @@ clrxclGetGLObjectInfo(cl_mem                memobj,
                   cl_gl_object_type *   gl_object_type,
                   cl_GLuint *           gl_object_name) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetGLObjectInfo)
     if (memobj == nullptr)
         return CL_INVALID_MEM_OBJECT;
     
@@ -1210,6 +1244,7 @@ clrxclGetGLTextureInfo(cl_mem               memobj,
                void *               param_value,
                size_t *             param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetGLTextureInfo)
     if (memobj == nullptr)
         return CL_INVALID_MEM_OBJECT;
     
@@ -1226,6 +1261,7 @@ clrxclEnqueueAcquireGLObjects(cl_command_queue      command_queue,
                           const cl_event *      event_wait_list,
                           cl_event *            event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueAcquireGLObjects)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -1269,6 +1305,7 @@ clrxclEnqueueReleaseGLObjects(cl_command_queue      command_queue,
                           const cl_event *      event_wait_list,
                           cl_event *            event) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clEnqueueReleaseGLObjects)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -1311,6 +1348,7 @@ clrxclGetGLContextInfoKHR(const cl_context_properties * properties,
       void *                        param_value,
       size_t *                      param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetGLContextInfoKHR)
     CLRX_INITIALIZE
     
     CLRXPlatform* platform = clrxPlatforms; // choose first AMD platform
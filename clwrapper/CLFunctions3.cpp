@@ -195,6 +195,7 @@ clrxclSetEventCallback( cl_event    event,
                     void (CL_CALLBACK * pfn_notify)(cl_event, cl_int, void *),
                     void *      user_data) CL_API_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clSetEventCallback)
     if (event == nullptr)
         return CL_INVALID_EVENT;
     if (pfn_notify == nullptr)
@@ -224,6 +225,7 @@ clrxclCreateSubBuffer(cl_mem                   buffer,
                   const void *             buffer_create_info,
                   cl_int *                 errcode_ret) CL_API_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clCreateSubBuffer)
     if (buffer == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -255,6 +257,7 @@ clrxclSetMemObjectDestructorCallback(  cl_mem memobj,
                 void (CL_CALLBACK * pfn_notify)( cl_mem, void* ), 
                 void * user_data)             CL_API_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clSetMemObjectDestructorCallback)
     if (memobj == nullptr)
         return CL_INVALID_MEM_OBJECT;
     if (pfn_notify == nullptr)
@@ -281,6 +284,7 @@ CL_API_ENTRY cl_event CL_API_CALL
 clrxclCreateUserEvent(cl_context    context,
                   cl_int *      errcode_ret) CL_API_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clCreateUserEvent)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -306,6 +310,7 @@ CL_API_ENTRY cl_int CL_API_CALL
 clrxclSetUserEventStatus(cl_event   event,
                      cl_int     execution_status) CL_API_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clSetUserEventStatus)
     if (event == nullptr)
         return CL_INVALID_EVENT;
     
@@ -330,6 +335,7 @@ clrxclEnqueueReadBufferRect(cl_command_queue    command_queue,
                         const cl_event *    event_wait_list,
                         cl_event *          event) CL_API_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clEnqueueReadBufferRect)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (buffer == nullptr)
@@ -369,6 +375,7 @@ clrxclEnqueueWriteBufferRect(cl_command_queue    command_queue,
                          const cl_event *    event_wait_list,
                          cl_event *          event) CL_API_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clEnqueueWriteBufferRect)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (buffer == nullptr)
@@ -407,6 +414,7 @@ clrxclEnqueueCopyBufferRect(cl_command_queue    command_queue,
                         const cl_event *    event_wait_list,
                         cl_event *          event) CL_API_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clEnqueueCopyBufferRect)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (src_buffer == nullptr || dst_buffer == nullptr)
@@ -468,6 +476,7 @@ CL_API_ENTRY cl_int CL_API_CALL clrxclCreateSubDevicesEXT(cl_device_id in_device
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclRetainDeviceEXT(cl_device_id device) CL_EXT_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clRetainDeviceEXT)
     if (device == nullptr)
         return CL_INVALID_DEVICE;
     
@@ -482,6 +491,7 @@ clrxclRetainDeviceEXT(cl_device_id device) CL_EXT_SUFFIX__VERSION_1_1
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclReleaseDeviceEXT(cl_device_id device) CL_EXT_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clReleaseDeviceEXT)
     if (device == nullptr)
         return CL_INVALID_DEVICE;
     
@@ -497,6 +507,7 @@ clrxclCreateEventFromGLsyncKHR(cl_context           context,
                    cl_GLsync            cl_GLsync,
                    cl_int *             errcode_ret) CL_EXT_SUFFIX__VERSION_1_1
 {
+    CLRX_TRACE_CALL(clCreateEventFromGLsyncKHR)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -526,6 +537,7 @@ clrxclCreateSubDevices(cl_device_id  in_device,
                cl_device_id *    out_devices,
                cl_uint *         num_devices_ret) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clCreateSubDevices)
     if (in_device == nullptr)
         return CL_INVALID_DEVICE;
     if (num_devices == 0 && out_devices != nullptr)
@@ -556,6 +568,7 @@ clrxclCreateSubDevices(cl_device_id  in_device,
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclRetainDevice(cl_device_id device) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clRetainDevice)
     if (device == nullptr)
         return CL_INVALID_DEVICE;
     
@@ -570,6 +583,7 @@ clrxclRetainDevice(cl_device_id device) CL_API_SUFFIX__VERSION_1_2
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclReleaseDevice(cl_device_id device) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clReleaseDevice)
     if (device == nullptr)
         return CL_INVALID_DEVICE;
     
@@ -588,6 +602,7 @@ clrxclCreateImage(cl_context              context,
               void *                  host_ptr,
               cl_int *                errcode_ret) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clCreateImage)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -640,6 +655,7 @@ clrxclCreateProgramWithBuiltInKernels(cl_context            context,
                   const char *          kernel_names,
                   cl_int *              errcode_ret) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clCreateProgramWithBuiltInKernels)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -699,6 +715,7 @@ clrxclCompileProgram(cl_program           program,
                  void (CL_CALLBACK *  pfn_notify)(cl_program program, void * user_data),
                  void *               user_data) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clCompileProgram)
     if (program == nullptr)
         return CL_INVALID_PROGRAM;
     
@@ -856,6 +873,7 @@ clrxclLinkProgram(cl_context           context,
               void *               user_data,
               cl_int *             errcode_ret) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clLinkProgram)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1025,6 +1043,7 @@ clrxclLinkProgram(cl_context           context,
 CL_API_ENTRY cl_int CL_API_CALL
 clrxclUnloadPlatformCompiler(cl_platform_id platform) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clUnloadPlatformCompiler)
     if (platform == nullptr)
         return CL_INVALID_PLATFORM;
     const CLRXPlatform* p = static_cast<const CLRXPlatform*>(platform);
@@ -1039,6 +1058,7 @@ clrxclGetKernelArgInfo(cl_kernel       kernel,
                    void *          param_value,
                    size_t *        param_value_size_ret) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clGetKernelArgInfo)
     if (kernel == nullptr)
         return CL_INVALID_KERNEL;
     
@@ -1058,6 +1078,7 @@ clrxclEnqueueFillBuffer(cl_command_queue    command_queue,
                     const cl_event *   event_wait_list,
                     cl_event *         event) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clEnqueueFillBuffer)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (buffer == nullptr)
@@ -1089,6 +1110,7 @@ clrxclEnqueueFillImage(cl_command_queue   command_queue,
                    const cl_event *   event_wait_list,
                    cl_event *         event) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clEnqueueFillImage)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (image == nullptr)
@@ -1119,6 +1141,7 @@ clrxclEnqueueMigrateMemObjects(cl_command_queue       command_queue,
                            const cl_event *       event_wait_list,
                            cl_event *             event) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clEnqueueMigrateMemObjects)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if (num_mem_objects == 0 || mem_objects == nullptr)
@@ -1158,6 +1181,7 @@ clrxclEnqueueMarkerWithWaitList(cl_command_queue command_queue,
                             const cl_event *  event_wait_list,
                             cl_event *        event) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clEnqueueMarkerWithWaitList)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -1181,6 +1205,7 @@ clrxclEnqueueBarrierWithWaitList(cl_command_queue command_queue,
                              const cl_event *  event_wait_list,
                              cl_event *        event) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clEnqueueBarrierWithWaitList)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -1202,6 +1227,7 @@ CL_API_ENTRY void * CL_API_CALL
 clrxclGetExtensionFunctionAddressForPlatform(cl_platform_id platform,
              const char *   func_name) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clGetExtensionFunctionAddressForPlatform)
     CLRX_INITIALIZE_VOIDPTR
     
     if (platform == nullptr)
@@ -1228,6 +1254,7 @@ clrxclCreateFromGLTexture(cl_context      context,
                       cl_GLuint       texture,
                       cl_int *        errcode_ret) CL_API_SUFFIX__VERSION_1_2
 {
+    CLRX_TRACE_CALL(clCreateFromGLTexture)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1368,6 +1395,7 @@ clrxclCreateCommandQueueWithProperties(
                 const cl_queue_properties * properties,
                 cl_int * errcode_ret) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clCreateCommandQueueWithProperties)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1407,6 +1435,7 @@ clrxclCreatePipe(cl_context                 context,
              const cl_pipe_properties * properties,
              cl_int *                   errcode_ret) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clCreatePipe)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1435,6 +1464,7 @@ clrxclGetPipeInfo(cl_mem           pipe,
                void *           param_value,
                size_t *         param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
 {
+    CLRX_TRACE_CALL(clGetPipeInfo)
     if (pipe == nullptr)
         return CL_INVALID_MEM_OBJECT;
     
@@ -1449,6 +1479,7 @@ clrxclSVMAlloc(cl_context       context,
            size_t           size,
            cl_uint          alignment) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clSVMAlloc)
     if (context == nullptr)
         return nullptr;
     
@@ -1461,6 +1492,7 @@ CL_API_ENTRY void CL_API_CALL
 clrxclSVMFree(cl_context        context,
           void *            svm_pointer) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clSVMFree)
     if (context == nullptr)
         return;
     
@@ -1478,6 +1510,7 @@ clrxclEnqueueSVMFree(cl_command_queue  command_queue,
                  const cl_event *  event_wait_list,
                  cl_event *        event) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clEnqueueSVMFree)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     
@@ -1570,6 +1603,7 @@ clrxclEnqueueSVMMemcpy(cl_command_queue  command_queue,
                    const cl_event *  event_wait_list,
                    cl_event *        event) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clEnqueueSVMMemcpy)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if ((num_events_in_wait_list == 0 && event_wait_list != nullptr) ||
@@ -1597,6 +1631,7 @@ clrxclEnqueueSVMMemFill(cl_command_queue  command_queue,
                     const cl_event *  event_wait_list,
                     cl_event *        event) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clEnqueueSVMMemFill)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if ((num_events_in_wait_list == 0 && event_wait_list != nullptr) ||
@@ -1624,6 +1659,7 @@ clrxclEnqueueSVMMap(cl_command_queue  command_queue,
                 const cl_event *  event_wait_list,
                 cl_event *        event) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clEnqueueSVMMap)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if ((num_events_in_wait_list == 0 && event_wait_list != nullptr) ||
@@ -1648,6 +1684,7 @@ clrxclEnqueueSVMUnmap(cl_command_queue  command_queue,
                   const cl_event *   event_wait_list,
                   cl_event *        event) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clEnqueueSVMUnmap)
     if (command_queue == nullptr)
         return CL_INVALID_COMMAND_QUEUE;
     if ((num_events_in_wait_list == 0 && event_wait_list != nullptr) ||
@@ -1669,6 +1706,7 @@ clrxclCreateSamplerWithProperties(cl_context                     context,
               const cl_sampler_properties *  properties,
               cl_int *                       errcode_ret) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clCreateSamplerWithProperties)
     if (context == nullptr)
     {
         if (errcode_ret != nullptr)
@@ -1695,6 +1733,7 @@ clrxclSetKernelArgSVMPointer(cl_kernel    kernel,
                          cl_uint      arg_index,
                          const void * arg_value) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clSetKernelArgSVMPointer)
     if (kernel == nullptr)
         return CL_INVALID_KERNEL;
     
@@ -1711,6 +1750,7 @@ clrxclSetKernelExecInfo(cl_kernel            kernel,
                     size_t               param_value_size,
                     const void *         param_value) CL_API_SUFFIX__VERSION_2_0
 {
+    CLRX_TRACE_CALL(clSetKernelExecInfo)
     if (kernel == nullptr)
         return CL_INVALID_KERNEL;
     
@@ -23,6 +23,7 @@
 #include <exception>
 #include <vector>
 #include <utility>
+#include <functional>
 #include <thread>
 #include <mutex>
 #include <cstring>
@@ -33,10 +34,12 @@
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/Containers.h>
 #include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/AsmCache.h>
 #include <CLRX/amdbin/AmdBinaries.h>
 #include <CLRX/amdbin/AmdCL2Binaries.h>
 #include <CLRX/utils/InputOutput.h>
 #include <CLRX/utils/GPUId.h>
+#include <CLRX/utils/ThreadPool.h>
 #include "CLWrapper.h"
 
 using namespace CLRX;
@@ -303,6 +306,8 @@ void clrxWrapperInitialize()
     try
     {
         useCLRXWrapper = !parseEnvVariable<bool>("CLRX_FORCE_ORIGINAL_AMDOCL", false);
+        if (useCLRXWrapper)
+            clrxTraceInitialize();
         std::string amdOclPath = parseEnvVariable<std::string>("CLRX_AMDOCL_PATH",
                            DEFAULT_AMDOCLPATH);
         /// set temporary amd ocl library
@@ -1086,6 +1091,8 @@ cl_int clrxApplyCLRXEvent(CLRXCommandQueue* q, cl_event* event,
         }
         clrxRetainOnlyCLRXContext(q->context);
         clrxRetainOnlyCLRXCommandQueue(q);
+        if (clrxTraceEnabled.load(std::memory_order_relaxed))
+            clrxTraceCommandCompletion(q, amdEvent);
     }
     
     return status;
@@ -1385,6 +1392,34 @@ bool detectCLRXCompilerCall(const char* compilerOptions)
     return isAsm;
 }
 
+static std::once_flag clrxAsmCacheOnceFlag;
+static std::unique_ptr<AsmBinaryCache> clrxAsmCache = nullptr;
+static bool clrxAsmCacheStats = false;
+
+/* initialize cache of assembled binaries
+ * (disabled by default, enabled by CLRX_ASMCACHE=1, disabled if max size is zero) */
+static void clrxInitializeAsmCache()
+{
+    if (!parseEnvVariable<bool>("CLRX_ASMCACHE", false))
+        return;
+    const cxuint maxSizeMB = parseEnvVariable<cxuint>("CLRX_ASMCACHE_MAXSIZE", 256);
+    clrxAsmCacheStats = parseEnvVariable<bool>("CLRX_ASMCACHE_STATS", false);
+    if (maxSizeMB == 0)
+        return;
+    std::string cacheDir = parseEnvVariable<std::string>("CLRX_ASMCACHE_DIR", "");
+    if (cacheDir.empty())
+    {
+        cacheDir = getHomeDir();
+        if (cacheDir.empty())
+            return;
+        cacheDir = joinPaths(cacheDir, ".clrxasmcache");
+    }
+    try
+    { clrxAsmCache.reset(new AsmBinaryCache(cacheDir, uint64_t(maxSizeMB)<<20)); }
+    catch(const std::exception& ex)
+    { } // cache disabled
+}
+
 static bool verifySymbolName(const CString& symbolName)
 {
     if (symbolName.empty())
@@ -1472,6 +1507,7 @@ cl_int clrxCompilerCall(CLRXProgram* program, const char* compilerOptions,
             cl_uint devicesNum, CLRXDevice* const* devices)
 try
 {
+    CLRX_TRACE_CALL(clrxAssemble)
     std::lock_guard<std::mutex> lock(program->asmMutex);
     if (devices==nullptr)
     {
@@ -1514,7 +1550,8 @@ try
     bool nextIsLang = false;
     bool useCL20Std = false;
     // drivers since 200406 version uses AmdCL2 binary format by default for >=GCN1.1
-    bool useCL2StdForGCN11 = detectAmdDriverVersion() >= 200406;
+    const uint32_t amdDriverVersion = detectAmdDriverVersion();
+    bool useCL2StdForGCN11 = amdDriverVersion >= 200406;
     
     try
     {
@@ -1644,31 +1681,56 @@ try
     for (cxuint i = 0; i < devicesNum; i++)
         progDeviceEntries[i].status = CL_BUILD_IN_PROGRESS;
     
-    bool asmFailure = false;
     bool asmNotAvailable = false;
+    /* determine device types and choose devices to assemble
+     * (only first device for each device type) */
+    std::unique_ptr<cxuint[]> devTypes(new cxuint[devicesNum]);
+    std::unique_ptr<bool[]> devIs64Bit(new bool[devicesNum]);
+    std::vector<cxuint> asmDevIndices;
     cxuint prevDeviceType = -1;
     for (cxuint i = 0; i < devicesNum; i++)
     {
         const auto& entry = outDeviceIndexMap[i];
-        ProgDeviceEntry& progDevEntry = progDeviceEntries[i];
         cxuint devType = -1;
         try
         { devType = cxuint(getGPUDeviceTypeFromName(entry.devName.c_str())); }
         catch(const Exception& ex)
         {   // if assembler not available for this device
-            progDevEntry.status = CL_BUILD_ERROR;
+            progDeviceEntries[i].status = CL_BUILD_ERROR;
             asmNotAvailable = true;
-            prevDeviceType = devType;
+            devTypes[i] = prevDeviceType = devType;
             continue;
         }
+        devTypes[i] = devType;
         // make duplicate only if not first entry
         if (i!=0 && devType == prevDeviceType)
-        {   // copy from previous device (if this same device type)
-            compiledProgBins[i] = compiledProgBins[i-1];
-            progDevEntry = progDeviceEntries[i-1];
             continue; // skip if this same architecture
-        }
         prevDeviceType = devType;
+        
+        cl_uint addressBits;
+        error = amdp->dispatch->clGetDeviceInfo(entry.second,
+                    CL_DEVICE_ADDRESS_BITS, sizeof(cl_uint), &addressBits, nullptr);
+        if (error != CL_SUCCESS)
+            clrxAbort("Fatal error at clCompilerCall (clGetDeviceInfo)");
+        devIs64Bit[i] = (addressBits==64);
+        asmDevIndices.push_back(i);
+    }
+    
+    std::call_once(clrxAsmCacheOnceFlag, clrxInitializeAsmCache);
+    AsmBinaryCache* asmCache = clrxAsmCache.get();
+    
+    /* assemble program for every device type (each task writes only to own entry) */
+    std::unique_ptr<bool[]> asmFailures(new bool[asmDevIndices.size()]);
+    const std::function<void(size_t)> assembleForDevice =
+        [&asmDevIndices, &asmFailures, &progDeviceEntries, &compiledProgBins,
+         &devTypes, &devIs64Bit, &includePaths, &defSyms, &sourceCode,
+         sourceCodeSize, asmFlags, useCL20Std, useCL2StdForGCN11,
+         amdDriverVersion, asmCache](size_t k)
+    {
+        const cxuint i = asmDevIndices[k];
+        const cxuint devType = devTypes[i];
+        ProgDeviceEntry& progDevEntry = progDeviceEntries[i];
+        asmFailures[k] = false;
         // assemble it
         ArrayIStream astream(sourceCodeSize-1, sourceCode.get());
         std::string msgString;
@@ -1680,18 +1742,30 @@ try
         Assembler assembler("", astream, asmFlags,
                     (useCL20StdByDev) ? BinaryFormat::AMDCL2 : BinaryFormat::AMD,
                     GPUDeviceType(devType), msgStream);
-        
-        cl_uint addressBits;
-        error = amdp->dispatch->clGetDeviceInfo(entry.second,
-                    CL_DEVICE_ADDRESS_BITS, sizeof(cl_uint), &addressBits, nullptr);
-        if (error != CL_SUCCESS)
-            clrxAbort("Fatal error at clCompilerCall (clGetDeviceInfo)");
-        assembler.set64Bit(addressBits==64);
+        assembler.set64Bit(devIs64Bit[i]);
+        assembler.setDriverVersion(amdDriverVersion);
         
         for (const CString& incPath: includePaths)
             assembler.addIncludeDir(incPath);
         for (const auto& defSym: defSyms)
             assembler.addInitialDefSym(defSym.first, defSym.second);
+        
+        AsmCacheKey cacheKey;
+        if (asmCache != nullptr)
+        {   // try to get binary from cache
+            cacheKey = AsmBinaryCache::makeKey(assembler, sourceCodeSize-1,
+                        sourceCode.get());
+            Array<cxbyte> output;
+            if (asmCache->load(cacheKey, assembler.getIncludeDirs(), output, msgString))
+            {
+                progDevEntry.log = RefPtr<CLProgLogEntry>(
+                            new CLProgLogEntry(std::move(msgString)));
+                progDevEntry.status = CL_BUILD_SUCCESS;
+                compiledProgBins[i] = RefPtr<CLProgBinEntry>(
+                            new CLProgBinEntry(std::move(output)));
+                return;
+            }
+        }
         /// call main assembler routine
         bool good = false;
         try
@@ -1701,8 +1775,8 @@ try
             progDevEntry.log = RefPtr<CLProgLogEntry>(
                             new CLProgLogEntry(std::move(msgString)));
             progDevEntry.status = CL_BUILD_ERROR;
-            asmFailure = true;
-            continue;
+            asmFailures[k] = true;
+            return;
         }
         /// set up logs
         progDevEntry.log = RefPtr<CLProgLogEntry>(
@@ -1714,6 +1788,10 @@ try
                 progDevEntry.status = CL_BUILD_SUCCESS;
                 Array<cxbyte> output;
                 assembler.writeBinary(output);
+                if (asmCache != nullptr)
+                    asmCache->store(cacheKey, output, progDevEntry.log->log,
+                                assembler.getIncludedFileNames(),
+                                assembler.getIncludedFiles());
                 compiledProgBins[i] = RefPtr<CLProgBinEntry>(
                             new CLProgBinEntry(std::move(output)));
             }
@@ -1724,15 +1802,42 @@ try
                 progDevEntry.log = RefPtr<CLProgLogEntry>(
                             new CLProgLogEntry(std::move(msgString)));
                 progDevEntry.status = CL_BUILD_ERROR;
-                asmFailure = true;
+                asmFailures[k] = true;
             }
         }
         else // error
         {
             progDevEntry.status = CL_BUILD_ERROR;
-            asmFailure = true;
+            asmFailures[k] = true;
         }
+    };
+    
+    cxuint asmThreadsNum = parseEnvVariable<cxuint>("CLRX_ASM_THREADS", 0);
+    if (asmThreadsNum == 0)
+        asmThreadsNum = ThreadPool::getHardwareThreadsNum();
+    asmThreadsNum = std::min(asmThreadsNum, cxuint(asmDevIndices.size()));
+    if (asmThreadsNum <= 1)
+        for (size_t k = 0; k < asmDevIndices.size(); k++)
+            assembleForDevice(k);
+    else
+    {   // assemble device types concurrently
+        ThreadPool threadPool(asmThreadsNum);
+        threadPool.run(asmDevIndices.size(), assembleForDevice);
     }
+    
+    bool asmFailure = false;
+    for (size_t k = 0; k < asmDevIndices.size(); k++)
+        asmFailure |= asmFailures[k];
+    if (asmCache != nullptr && clrxAsmCacheStats)
+        std::cerr << "CLRX assembler cache: hits=" << asmCache->getHitsNum() <<
+                ", misses=" << asmCache->getMissesNum() << std::endl;
+    /* copy results to devices that have same device type as previous device */
+    for (cxuint i = 1; i < devicesNum; i++)
+        if (devTypes[i] != cxuint(-1) && devTypes[i] == devTypes[i-1])
+        {   // copy from previous device (if this same device type)
+            compiledProgBins[i] = compiledProgBins[i-1];
+            progDeviceEntries[i] = progDeviceEntries[i-1];
+        }
     /* set program binaries in order of original devices list */
     std::unique_ptr<size_t[]> programBinSizes(new size_t[devicesNum]);
     std::unique_ptr<cxbyte*[]> programBinaries(new cxbyte*[devicesNum]);
@@ -0,0 +1,401 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include "CLWrapper.h"
+
+using namespace CLRX;
+
+/* tracing layer. every thread has own statistics and ring buffer of last calls,
+ * they are written only by owner thread (without locks and atomic RMW operations),
+ * and they are read while dumping at exit. at thread exit, statistics are folded
+ * into statistics of exited threads and thread data is freed */
+
+std::atomic<bool> clrxTraceEnabled(false);
+
+static const size_t clrxTraceRingSize = 4096;
+// number of kept rings of last calls of exited threads
+static const size_t clrxTraceMaxExitedRings = 4;
+static std::string clrxTraceFile;
+static uint64_t clrxTraceStartTime = 0;
+
+static std::mutex clrxTraceCallsMutex;
+static const char* clrxTraceCallNames[clrxTraceMaxCallsNum];
+static std::atomic<cxuint> clrxTraceCallsNum(0);
+
+struct CLRX_INTERNAL CLRXTraceStats
+{
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> totalTime;
+    std::atomic<uint64_t> maxTime;
+    std::atomic<uint64_t> histogram[clrxTraceHistogramSize];
+};
+
+struct CLRX_INTERNAL CLRXTraceRecord
+{
+    std::atomic<uint32_t> callId;
+    std::atomic<uint64_t> startTime;
+    std::atomic<uint64_t> duration;
+};
+
+struct CLRX_INTERNAL CLRXTraceCallStats
+{
+    CLRXTraceStats calls[clrxTraceMaxCallsNum];
+    CLRXTraceStats completions[clrxTraceMaxCallsNum];
+    
+    CLRXTraceCallStats()
+    {
+        for (cxuint i = 0; i < clrxTraceMaxCallsNum; i++)
+        {
+            clearStats(calls[i]);
+            clearStats(completions[i]);
+        }
+    }
+    
+    static void clearStats(CLRXTraceStats& stats)
+    {
+        stats.count.store(0, std::memory_order_relaxed);
+        stats.totalTime.store(0, std::memory_order_relaxed);
+        stats.maxTime.store(0, std::memory_order_relaxed);
+        for (cxuint i = 0; i < clrxTraceHistogramSize; i++)
+            stats.histogram[i].store(0, std::memory_order_relaxed);
+    }
+};
+
+struct CLRX_INTERNAL CLRXTraceRing
+{
+    CLRXTraceRecord records[clrxTraceRingSize];
+    std::atomic<uint64_t> pos;
+    
+    CLRXTraceRing()
+    { pos.store(0, std::memory_order_relaxed); }
+};
+
+struct CLRX_INTERNAL CLRXTraceThreadData
+{
+    CLRXTraceCallStats stats;
+    std::unique_ptr<CLRXTraceRing> ring;
+    CLRXTraceScope* currentScope;
+    
+    CLRXTraceThreadData() : ring(new CLRXTraceRing), currentScope(nullptr)
+    { }
+};
+
+/* frees thread data at exit of thread */
+struct CLRX_INTERNAL CLRXTraceThreadExit
+{
+    CLRXTraceThreadData* data;
+    
+    CLRXTraceThreadExit() : data(nullptr)
+    { }
+    ~CLRXTraceThreadExit();
+};
+
+/* use pure pointers - data must be available within atexit callback */
+static std::mutex clrxTraceThreadsMutex;
+static std::vector<CLRXTraceThreadData*>* clrxTraceThreadDatas = nullptr;
+// statistics of exited threads and rings of last exited threads
+static CLRXTraceCallStats* clrxTraceExitedStats = nullptr;
+static std::vector<CLRXTraceRing*>* clrxTraceExitedRings = nullptr;
+// pointer has trivial destructor, hence it is accessed without TLS wrapper
+static thread_local CLRXTraceThreadData* clrxTraceThreadData = nullptr;
+static thread_local CLRXTraceThreadExit clrxTraceThreadExit;
+
+static inline uint64_t clrxTraceGetTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static CLRXTraceThreadData* clrxTraceGetThreadData()
+{
+    if (clrxTraceThreadData != nullptr)
+        return clrxTraceThreadData;
+    // first traced call in this thread
+    try
+    {
+        std::unique_ptr<CLRXTraceThreadData> data(new CLRXTraceThreadData);
+        std::lock_guard<std::mutex> lock(clrxTraceThreadsMutex);
+        clrxTraceThreadDatas->push_back(data.get());
+        clrxTraceThreadData = data.release();
+    }
+    catch(const std::bad_alloc& ex)
+    { return nullptr; }
+    // register freeing at thread exit
+    clrxTraceThreadExit.data = clrxTraceThreadData;
+    return clrxTraceThreadData;
+}
+
+/* only owner thread updates statistics */
+static inline void clrxTraceAdd(std::atomic<uint64_t>& value, uint64_t x)
+{ value.store(value.load(std::memory_order_relaxed)+x, std::memory_order_relaxed); }
+
+static void clrxTraceUpdateStats(CLRXTraceStats& stats, uint64_t duration)
+{
+    clrxTraceAdd(stats.count, 1);
+    clrxTraceAdd(stats.totalTime, duration);
+    if (duration > stats.maxTime.load(std::memory_order_relaxed))
+        stats.maxTime.store(duration, std::memory_order_relaxed);
+    cxuint bucket = 0;
+    for (uint64_t d = duration>>1; d != 0 && bucket < clrxTraceHistogramSize-1; d >>= 1)
+        bucket++;
+    clrxTraceAdd(stats.histogram[bucket], 1);
+}
+
+/* fold statistics of exited thread (under threads mutex) */
+static void clrxTraceFoldStats(CLRXTraceStats& dest, const CLRXTraceStats& src)
+{
+    clrxTraceAdd(dest.count, src.count.load(std::memory_order_relaxed));
+    clrxTraceAdd(dest.totalTime, src.totalTime.load(std::memory_order_relaxed));
+    const uint64_t maxTime = src.maxTime.load(std::memory_order_relaxed);
+    if (maxTime > dest.maxTime.load(std::memory_order_relaxed))
+        dest.maxTime.store(maxTime, std::memory_order_relaxed);
+    for (cxuint i = 0; i < clrxTraceHistogramSize; i++)
+        clrxTraceAdd(dest.histogram[i], src.histogram[i].load(std::memory_order_relaxed));
+}
+
+CLRXTraceThreadExit::~CLRXTraceThreadExit()
+{
+    if (data == nullptr)
+        return;
+    clrxTraceThreadData = nullptr;
+    std::unique_ptr<CLRXTraceThreadData> dataPtr(data);
+    data = nullptr;
+    std::lock_guard<std::mutex> lock(clrxTraceThreadsMutex);
+    std::vector<CLRXTraceThreadData*>& datas = *clrxTraceThreadDatas;
+    datas.erase(std::find(datas.begin(), datas.end(), dataPtr.get()));
+    for (cxuint i = 0; i < clrxTraceMaxCallsNum; i++)
+    {
+        clrxTraceFoldStats(clrxTraceExitedStats->calls[i], dataPtr->stats.calls[i]);
+        clrxTraceFoldStats(clrxTraceExitedStats->completions[i],
+                    dataPtr->stats.completions[i]);
+    }
+    if (dataPtr->ring->pos.load(std::memory_order_relaxed) == 0)
+        return; // no calls (only completions in driver thread)
+    // keep last calls of last exited threads (main thread exits before dump)
+    std::vector<CLRXTraceRing*>& rings = *clrxTraceExitedRings;
+    if (rings.size() == clrxTraceMaxExitedRings)
+    {
+        delete rings.front();
+        rings.erase(rings.begin());
+    }
+    rings.push_back(dataPtr->ring.release());
+}
+
+/* register call at first traced call of it */
+static cxuint clrxTraceRegisterCall(std::atomic<cxuint>& callIdVar, const char* callName)
+{
+    std::lock_guard<std::mutex> lock(clrxTraceCallsMutex);
+    cxuint callId = callIdVar.load(std::memory_order_relaxed);
+    if (callId != clrxTraceMaxCallsNum)
+        return callId; // already registered by other thread
+    const cxuint callsNum = clrxTraceCallsNum.load(std::memory_order_relaxed);
+    if (callsNum == clrxTraceMaxCallsNum)
+        callId = clrxTraceMaxCallsNum-1; // too many calls, use last entry
+    else
+    {
+        callId = callsNum;
+        clrxTraceCallNames[callsNum] = callName;
+        clrxTraceCallsNum.store(callsNum+1, std::memory_order_release);
+    }
+    callIdVar.store(callId, std::memory_order_relaxed);
+    return callId;
+}
+
+void CLRXTraceScope::begin(std::atomic<cxuint>& callIdVar, const char* callName)
+{
+    CLRXTraceThreadData* data = clrxTraceGetThreadData();
+    if (data == nullptr)
+        return;
+    callId = callIdVar.load(std::memory_order_relaxed);
+    if (callId == clrxTraceMaxCallsNum)
+        callId = clrxTraceRegisterCall(callIdVar, callName);
+    previous = data->currentScope;
+    data->currentScope = this;
+    startTime = clrxTraceGetTime();
+}
+
+void CLRXTraceScope::end()
+{
+    const uint64_t duration = clrxTraceGetTime() - startTime;
+    CLRXTraceThreadData* data = clrxTraceThreadData;
+    data->currentScope = previous;
+    clrxTraceUpdateStats(data->stats.calls[callId], duration);
+    CLRXTraceRing& ring = *data->ring;
+    const uint64_t pos = ring.pos.load(std::memory_order_relaxed);
+    CLRXTraceRecord& record = ring.records[pos % clrxTraceRingSize];
+    record.callId.store(callId, std::memory_order_relaxed);
+    record.startTime.store(startTime, std::memory_order_relaxed);
+    record.duration.store(duration, std::memory_order_relaxed);
+    ring.pos.store(pos+1, std::memory_order_release);
+}
+
+struct CLRX_INTERNAL CLRXTraceCompletionData
+{
+    cxuint callId;
+    uint64_t enqueueTime;
+};
+
+static void CL_CALLBACK clrxTraceCompletionCallback(cl_event event, cl_int exec_status,
+            void* user_data)
+{
+    CLRXTraceCompletionData* completion =
+            static_cast<CLRXTraceCompletionData*>(user_data);
+    const uint64_t duration = clrxTraceGetTime() - completion->enqueueTime;
+    // callback is called in driver thread, it has own statistics
+    CLRXTraceThreadData* data = clrxTraceGetThreadData();
+    if (data != nullptr)
+        clrxTraceUpdateStats(data->stats.completions[completion->callId], duration);
+    delete completion;
+}
+
+void clrxTraceCommandCompletion(CLRXCommandQueue* q, cl_event amdEvent)
+{
+    CLRXTraceThreadData* data = clrxTraceThreadData;
+    if (data == nullptr || data->currentScope == nullptr)
+        return;
+    CLRXTraceCompletionData* completion = nullptr;
+    try
+    { completion = new CLRXTraceCompletionData; }
+    catch(const std::bad_alloc& ex)
+    { return; }
+    completion->callId = data->currentScope->callId;
+    completion->enqueueTime = data->currentScope->startTime;
+    if (q->amdOclCommandQueue->dispatch->clSetEventCallback(amdEvent, CL_COMPLETE,
+                clrxTraceCompletionCallback, completion) != CL_SUCCESS)
+        delete completion;
+}
+
+static void writeTraceStats(std::ostream& os,
+            const std::vector<const CLRXTraceCallStats*>& statsList, bool completions,
+            cxuint callId)
+{
+    static const char* keyNames[2][4] = {
+        { "count", "totalNs", "maxNs", "histogram" },
+        { "completionCount", "completionTotalNs", "completionMaxNs",
+            "completionHistogram" } };
+    const char** keys = keyNames[completions ? 1 : 0];
+    uint64_t count = 0, totalTime = 0, maxTime = 0;
+    uint64_t histogram[clrxTraceHistogramSize];
+    std::fill(histogram, histogram+clrxTraceHistogramSize, 0);
+    for (const CLRXTraceCallStats* callStats: statsList)
+    {
+        const CLRXTraceStats& stats = completions ? callStats->completions[callId] :
+                    callStats->calls[callId];
+        count += stats.count.load(std::memory_order_relaxed);
+        totalTime += stats.totalTime.load(std::memory_order_relaxed);
+        maxTime = std::max(maxTime, stats.maxTime.load(std::memory_order_relaxed));
+        for (cxuint i = 0; i < clrxTraceHistogramSize; i++)
+            histogram[i] += stats.histogram[i].load(std::memory_order_relaxed);
+    }
+    os << ", \"" << keys[0] << "\": " << count << ", \"" << keys[1] << "\": " <<
+            totalTime << ", \"" << keys[2] << "\": " << maxTime << ", \"" << keys[3] <<
+            "\": [";
+    for (cxuint i = 0; i < clrxTraceHistogramSize; i++)
+        os << ((i != 0) ? ", " : "") << histogram[i];
+    os << "]";
+}
+
+/* dump statistics as JSON */
+static void clrxTraceDump()
+{
+    std::ofstream os(clrxTraceFile.c_str());
+    if (!os)
+    {
+        std::cerr << "CLRX tracing: Can't open trace file '" << clrxTraceFile <<
+                "'" << std::endl;
+        return;
+    }
+    std::lock_guard<std::mutex> lock(clrxTraceThreadsMutex);
+    const std::vector<CLRXTraceThreadData*>& datas = *clrxTraceThreadDatas;
+    // statistics of live threads and exited threads
+    std::vector<const CLRXTraceCallStats*> statsList;
+    for (const CLRXTraceThreadData* data: datas)
+        statsList.push_back(&data->stats);
+    statsList.push_back(clrxTraceExitedStats);
+    std::vector<const CLRXTraceRing*> rings;
+    for (const CLRXTraceThreadData* data: datas)
+        rings.push_back(data->ring.get());
+    rings.insert(rings.end(), clrxTraceExitedRings->begin(),
+                clrxTraceExitedRings->end());
+    const cxuint callsNum = clrxTraceCallsNum.load(std::memory_order_acquire);
+    os << "{\n  \"histogramBuckets\": \"log2(ns)\",\n  \"calls\": [";
+    bool first = true;
+    for (cxuint callId = 0; callId < callsNum; callId++)
+    {
+        uint64_t count = 0;
+        for (const CLRXTraceCallStats* callStats: statsList)
+            count += callStats->calls[callId].count.load(std::memory_order_relaxed);
+        if (count == 0)
+            continue; // skip not called
+        os << (first ? "\n" : ",\n") << "    { \"name\": \"" <<
+                clrxTraceCallNames[callId] << "\"";
+        writeTraceStats(os, statsList, false, callId);
+        writeTraceStats(os, statsList, true, callId);
+        os << " }";
+        first = false;
+    }
+    os << "\n  ],\n  \"threads\": [";
+    for (size_t t = 0; t < rings.size(); t++)
+    {
+        const CLRXTraceRing& ring = *rings[t];
+        const uint64_t ringPos = ring.pos.load(std::memory_order_acquire);
+        const uint64_t firstPos = (ringPos > clrxTraceRingSize) ?
+                    ringPos-clrxTraceRingSize : 0;
+        os << ((t != 0) ? ",\n" : "\n") << "    { \"exited\": " <<
+                ((t >= datas.size()) ? "true" : "false") << ", \"lastCalls\": [";
+        for (uint64_t pos = firstPos; pos < ringPos; pos++)
+        {
+            const CLRXTraceRecord& record = ring.records[pos % clrxTraceRingSize];
+            os << ((pos != firstPos) ? ", " : "") << "[\"" <<
+                clrxTraceCallNames[record.callId.load(std::memory_order_relaxed)] <<
+                "\", " << (record.startTime.load(std::memory_order_relaxed) -
+                            clrxTraceStartTime) <<
+                ", " << record.duration.load(std::memory_order_relaxed) << "]";
+        }
+        os << "] }";
+    }
+    os << "\n  ]\n}\n";
+}
+
+void clrxTraceInitialize()
+{
+    clrxTraceFile = parseEnvVariable<std::string>("CLRX_TRACE_FILE", "");
+    if (clrxTraceFile.empty())
+        return;
+    clrxTraceThreadDatas = new std::vector<CLRXTraceThreadData*>();
+    clrxTraceExitedStats = new CLRXTraceCallStats;
+    clrxTraceExitedRings = new std::vector<CLRXTraceRing*>();
+    clrxTraceStartTime = clrxTraceGetTime();
+    if (::atexit(clrxTraceDump) != 0)
+        return; // can't dump, do not trace
+    clrxTraceEnabled.store(true, std::memory_order_release);
+}
@@ -509,6 +509,58 @@ CLRX_INTERNAL void clrxReleaseOnlyCLRXProgram(CLRXProgram* program);
 
 CLRX_INTERNAL void clrxClearProgramAsmState(CLRXProgram* p);
 
+/* tracing of calls (enabled by CLRX_TRACE_FILE environment variable) */
+
+static const cxuint clrxTraceMaxCallsNum = 256;
+/* bucket i holds durations in range 2^i - 2^(i+1) nanoseconds */
+static const cxuint clrxTraceHistogramSize = 32;
+
+CLRX_INTERNAL extern std::atomic<bool> clrxTraceEnabled;
+
+CLRX_INTERNAL void clrxTraceInitialize();
+
+/* identifier of traced call (clrxTraceMaxCallsNum if not registered yet).
+ * it is a static member of template, so it has static storage with constant
+ * initialization and reading it does not need guard of function-local static */
+template<typename CallTag>
+struct CLRX_INTERNAL CLRXTraceCallId
+{
+    static std::atomic<cxuint> value;
+};
+
+template<typename CallTag>
+std::atomic<cxuint> CLRXTraceCallId<CallTag>::value(clrxTraceMaxCallsNum);
+
+struct CLRX_INTERNAL CLRXTraceScope
+{
+    cxuint callId;
+    uint64_t startTime;
+    CLRXTraceScope* previous;
+    
+    CLRXTraceScope(std::atomic<cxuint>& callIdVar, const char* callName)
+            : callId(0), startTime(0), previous(nullptr)
+    {
+        if (clrxTraceEnabled.load(std::memory_order_relaxed))
+            begin(callIdVar, callName);
+    }
+    ~CLRXTraceScope()
+    {
+        if (startTime != 0)
+            end();
+    }
+    
+    void begin(std::atomic<cxuint>& callIdVar, const char* callName);
+    void end();
+};
+
+/* measure time of completion of command (from enqueue to end of execution) */
+CLRX_INTERNAL void clrxTraceCommandCompletion(CLRXCommandQueue* q, cl_event amdEvent);
+
+#define CLRX_TRACE_CALL(CALLNAME) \
+    struct CLRXTraceTag_##CALLNAME { }; \
+    CLRXTraceScope clrxTraceScope(CLRXTraceCallId<CLRXTraceTag_##CALLNAME>::value, \
+                #CALLNAME);
+
 /* main compiler options */
 CLRX_INTERNAL bool detectCLRXCompilerCall(const char* compilerOptions);
 
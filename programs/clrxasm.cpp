@@ -21,6 +21,8 @@
 #include <iostream>
 #include <memory>
 #include <fstream>
+#include <cstdio>
+#include <string>
 #include <cstring>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/CLIParser.h>
@@ -54,6 +56,10 @@ static const CLIOption programOptions[] =
     { "buggyFPLit", 0, CLIArgType::NONE, false, false,
         "use old and buggy fplit rules", nullptr },
     { "noWarnings", 'w', CLIArgType::NONE, false, false, "disable warnings", nullptr },
+    { "threads", 'j', CLIArgType::UINT, false, false,
+        "set threads number used to assemble kernels", "THREADS" },
+    { "stats", 0, CLIArgType::NONE, false, false,
+        "print statistics of assembling", nullptr },
     CLRX_CLI_AUTOHELP
     { nullptr, 0 }
 };
@@ -68,6 +74,39 @@ static bool verifySymbolName(const CString& symbolName)
     return *c==0;
 }
 
+static void printStatsPhase(const char* name, const AsmStatsPhase& phase)
+{
+    if (phase.count == 0)
+        return;
+    std::fprintf(stderr, "  %-24s %12llu %12.3f\n", name, (unsigned long long)phase.count,
+                 double(phase.time)*1e-6);
+}
+
+static void printStats(const AsmStats& stats)
+{
+    std::fprintf(stderr, "Statistics:\n  %-24s %12s %12s\n", "phase", "count",
+                 "time [ms]");
+    printStatsPhase("read lines (files)", stats.readLines[0]);
+    printStatsPhase("read lines (repeats)", stats.readLines[1]);
+    printStatsPhase("read lines (macros)", stats.readLines[2]);
+    printStatsPhase("pseudo-ops", stats.pseudoOps);
+    printStatsPhase("instructions", stats.instructions);
+    for (size_t i = 0; i < stats.encodings.size(); i++)
+        printStatsPhase((std::string("  encoding ")+stats.encodingNames[i]).c_str(),
+                    stats.encodings[i]);
+    printStatsPhase("expression parsing", stats.exprParse);
+    printStatsPhase("expression evaluation", stats.exprEvaluate);
+    printStatsPhase("symbol setting", stats.setSymbol);
+    printStatsPhase("binary preparation", stats.prepareBinary);
+    printStatsPhase("binary writing", stats.writeBinary);
+    std::fprintf(stderr, "  preassembled instructions: %llu\n"
+            "  macro substitutions: %llu\n  repetitions: %llu\n"
+            "  peak symbols number: %llu\n  peak expressions number: %llu\n",
+            (unsigned long long)stats.preassembledInstrs,
+            (unsigned long long)stats.macroSubsts, (unsigned long long)stats.repetitions,
+            (unsigned long long)stats.maxSymbolsNum, (unsigned long long)stats.maxExprsNum);
+}
+
 int main(int argc, const char** argv)
 try
 {
@@ -126,6 +165,10 @@ try
         assembler.reset(new Assembler(nullptr, std::cin, flags, binFormat, deviceType));
     assembler->set64Bit(is64Bit);
     assembler->setDriverVersion(driverVersion);
+    if (cli.hasShortOption('j'))
+        assembler->setThreadsNum(cli.getShortOptArg<cxuint>('j'));
+    const bool printingStats = cli.hasLongOption("stats");
+    assembler->setStatsEnabled(printingStats);
     
     size_t defSymsNum = 0;
     const char* const* defSyms = nullptr;
@@ -183,12 +226,18 @@ try
         return ret;
     /// run assembling
     if (!assembler->assemble())
+    {
+        if (printingStats)
+            printStats(*assembler->getStats());
         return 1;
+    }
     /// write output to file
     const char* outputName = "a.out";
     if (cli.hasShortOption('o'))
         outputName = cli.getShortOptArg<const char*>('o');
     assembler->writeBinary(outputName);
+    if (printingStats)
+        printStats(*assembler->getStats());
     return 0;
 }
 catch(const Exception& ex)
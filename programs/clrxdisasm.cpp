@@ -19,9 +19,19 @@
 
 #include <CLRX/Config.h>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <memory>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdio>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/CLIParser.h>
+#include <CLRX/utils/ThreadPool.h>
 #include <CLRX/amdbin/AmdBinaries.h>
 #include <CLRX/amdbin/GalliumBinaries.h>
 #include <CLRX/amdasm/Disassembler.h>
@@ -47,10 +57,103 @@ static const CLIOption programOptions[] =
         "set GPU architecture for Gallium/raw binaries", "ARCH" },
     { "buggyFPLit", 0, CLIArgType::NONE, false, false,
         "use old and buggy fplit rules", nullptr },
+    { "threads", 'j', CLIArgType::UINT, false, false,
+        "disassemble kernels (or files in batch mode) in parallel "
+        "(0 - all hardware threads)", "N" },
+    { "batch", 'b', CLIArgType::NONE, false, false,
+        "batch mode (inputs can be directories), print statistics", nullptr },
+    { "fileList", 'l', CLIArgType::TRIMMED_STRING, false, false,
+        "read input files from list (one per line), enables batch mode", "FILE" },
+    { "outputDir", 'o', CLIArgType::TRIMMED_STRING, false, false,
+        "write output for every input to DIR/NAME.s in batch mode", "DIR" },
     CLRX_CLI_AUTOHELP
     { nullptr, 0 }
 };
 
+static void disassembleFile(const char* filename, std::ostream& output,
+            Flags disasmFlags, GPUDeviceType gpuDeviceType, bool fromRawCode,
+            cxuint threadsNum, size_t& instrsNum, size_t& inputSize)
+{
+    MappedFile binaryData(filename);
+    std::unique_ptr<AmdMainBinaryBase> base = nullptr;
+    inputSize = binaryData.size();
+    
+    if (!fromRawCode)
+    {
+        Flags binFlags = AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_KERNELINFOMAP |
+                AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_KERNELHEADERS |
+                AMDBIN_CREATE_KERNELHEADERMAP;
+        if ((disasmFlags & (DISASM_CALNOTES|DISASM_CONFIG)) != 0)
+            binFlags |= AMDBIN_INNER_CREATE_CALNOTES;
+        if ((disasmFlags & (DISASM_METADATA|DISASM_CONFIG)) != 0)
+            binFlags |= AMDBIN_CREATE_INFOSTRINGS;
+        
+        if (isAmdBinary(binaryData.size(), binaryData.data()))
+        {   // if amd binary
+            base.reset(createAmdBinaryFromCode(binaryData.size(),
+                    binaryData.data(), binFlags));
+            if (base->getType() == AmdMainType::GPU_BINARY)
+            {
+                AmdMainGPUBinary32* amdGpuBin =
+                        static_cast<AmdMainGPUBinary32*>(base.get());
+                Disassembler disasm(*amdGpuBin, output, disasmFlags);
+                disasm.setThreadsNum(threadsNum);
+                disasm.disassemble();
+                instrsNum = disasm.getInstrsNum();
+            }
+            else if (base->getType() == AmdMainType::GPU_64_BINARY)
+            {
+                AmdMainGPUBinary64* amdGpuBin =
+                        static_cast<AmdMainGPUBinary64*>(base.get());
+                Disassembler disasm(*amdGpuBin, output, disasmFlags);
+                disasm.setThreadsNum(threadsNum);
+                disasm.disassemble();
+                instrsNum = disasm.getInstrsNum();
+            }
+            else
+                throw Exception("This is not AMDGPU binary file!");
+        }
+        else if (isAmdCL2Binary(binaryData.size(), binaryData.data()))
+        {   // AMD OpenCL 2.0 binary
+            binFlags |= AMDBIN_INNER_CREATE_KERNELDATA |
+                        AMDBIN_INNER_CREATE_KERNELDATAMAP |
+                        AMDBIN_INNER_CREATE_KERNELSTUBS;
+            AmdCL2MainGPUBinary amdBin(binaryData.size(),
+                               binaryData.data(), binFlags);
+            Disassembler disasm(amdBin, output, disasmFlags);
+            disasm.setThreadsNum(threadsNum);
+            disasm.disassemble();
+            instrsNum = disasm.getInstrsNum();
+        }
+        else // if gallium binary
+        {
+            GalliumBinary galliumBin(binaryData.size(),binaryData.data(), 0);
+            Disassembler disasm(gpuDeviceType, galliumBin, output, disasmFlags);
+            disasm.disassemble();
+            instrsNum = disasm.getInstrsNum();
+        }
+    }
+    else
+    {   /* raw binaries */
+        Disassembler disasm(gpuDeviceType, binaryData.size(), binaryData.data(),
+                output, disasmFlags);
+        disasm.disassemble();
+        instrsNum = disasm.getInstrsNum();
+    }
+}
+
+// get filename without directory path
+static std::string getBaseName(const std::string& path)
+{
+    size_t pos = path.find_last_of(CLRX_NATIVE_DIR_SEP);
+#ifdef HAVE_WINDOWS
+    const size_t altPos = path.find_last_of(CLRX_ALT_DIR_SEP);
+    if (altPos != std::string::npos && (pos == std::string::npos || altPos > pos))
+        pos = altPos;
+#endif
+    return (pos != std::string::npos) ? path.substr(pos+1) : path;
+}
+
 int main(int argc, const char** argv)
 try
 {
@@ -59,7 +162,8 @@ try
     if (cli.handleHelpOrUsage())
         return 0;
     
-    if (cli.getArgsNum() == 0)
+    const bool batchMode = cli.hasShortOption('b') || cli.hasShortOption('l');
+    if (cli.getArgsNum() == 0 && !cli.hasShortOption('l'))
     {
         std::cerr << "No input files." << std::endl;
         return 1;
@@ -86,80 +190,184 @@ try
         gpuDeviceType = getLowestGPUDeviceTypeFromArchitecture(
                     getGPUArchitectureFromName(cli.getShortOptArg<const char*>('A')));
     
+    cxuint threadsNum = 1;
+    if (cli.hasShortOption('j'))
+        threadsNum = cli.getShortOptArg<cxuint>('j');
+    
     int ret = 0;
+    if (!batchMode)
+    {
+        if (cli.hasShortOption('o'))
+        {
+            std::cerr << "Option '--outputDir' requires batch mode." << std::endl;
+            return 1;
+        }
+        for (const char* const* args = cli.getArgs();*args != nullptr; args++)
+        {
+            std::cout << "/* Disassembling '" << *args << "\' */" << std::endl;
+            try
+            {
+                size_t instrsNum, inputSize;
+                disassembleFile(*args, std::cout, disasmFlags, gpuDeviceType,
+                        fromRawCode, threadsNum, instrsNum, inputSize);
+            }
+            catch(const std::exception& ex)
+            {
+                ret = 1;
+                std::cout << "/* ERROR for '" << *args << "\' */" << std::endl;
+                std::cerr << "Error during disassemblying '" << *args << "': " <<
+                        ex.what() << std::endl;
+            }
+        }
+        return ret;
+    }
+    
+    /* batch mode */
+    std::vector<std::string> inputs;
+    if (cli.hasShortOption('l'))
+    {   // read file list
+        const char* fileListName = cli.getShortOptArg<const char*>('l');
+        std::ifstream ifs(fileListName);
+        if (!ifs)
+            throw Exception(std::string("Can't open file list '")+fileListName+"'");
+        std::string line;
+        while (std::getline(ifs, line))
+        {
+            const char* lineEnd = skipSpacesAtEnd(line.c_str(), line.size());
+            const char* lineStart = skipSpaces(line.c_str());
+            if (lineStart < lineEnd)
+                inputs.push_back(std::string(lineStart, lineEnd));
+        }
+    }
     for (const char* const* args = cli.getArgs();*args != nullptr; args++)
     {
-        std::cout << "/* Disassembling '" << *args << "\' */" << std::endl;
-        Array<cxbyte> binaryData;
-        std::unique_ptr<AmdMainBinaryBase> base = nullptr;
+        bool isDir = false;
         try
+        { isDir = isDirectory(*args); }
+        catch(const Exception& ex)
+        { } // error will be reported while loading file
+        if (isDir)
+            for (const std::string& name: listDirectory(*args))
+                inputs.push_back(joinPaths(*args, name));
+        else
+            inputs.push_back(*args);
+    }
+    
+    const char* outputDir = nullptr;
+    std::vector<std::string> outputNames;
+    if (cli.hasShortOption('o'))
+    {   // prepare output names, add index to name if base name repeats
+        outputDir = cli.getShortOptArg<const char*>('o');
+        std::unordered_map<std::string, size_t> baseNameCounts;
+        outputNames.resize(inputs.size());
+        for (size_t i = 0; i < inputs.size(); i++)
         {
-            binaryData = loadDataFromFile(*args);
-            
-            if (!fromRawCode)
+            const std::string baseName = getBaseName(inputs[i]);
+            const size_t count = baseNameCounts[baseName]++;
+            std::string outName = baseName;
+            if (count != 0)
+                outName += "." + std::to_string(count);
+            outputNames[i] = joinPaths(outputDir, outName+".s");
+        }
+        // indexed name can be same as other base name
+        std::unordered_set<std::string> outputNameSet(outputNames.begin(),
+                    outputNames.end());
+        if (outputNameSet.size() != outputNames.size())
+            throw Exception("Output file names are not unique");
+    }
+    
+    std::mutex outputMutex;
+    std::vector<std::string> outputs(inputs.size());
+    std::vector<bool> outputsReady(inputs.size(), false);
+    size_t nextOutput = 0;
+    size_t failedNum = 0;
+    size_t totalInstrsNum = 0;
+    uint64_t totalInputSize = 0;
+    
+    const std::chrono::steady_clock::time_point startTime =
+            std::chrono::steady_clock::now();
+    ThreadPool threadPool(threadsNum);
+    threadPool.run(inputs.size(), [&](size_t i)
+    {
+        const std::string& input = inputs[i];
+        std::ostringstream errorStream;
+        size_t instrsNum = 0, inputSize = 0;
+        std::string outputString;
+        bool failed = false;
+        if (outputDir != nullptr)
+        {   // write to own output file
+            const std::string& outName = outputNames[i];
+            bool outputCreated = false;
+            try
             {
-                Flags binFlags = AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_KERNELINFOMAP |
-                        AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_KERNELHEADERS |
-                        AMDBIN_CREATE_KERNELHEADERMAP;
-                if ((disasmFlags & (DISASM_CALNOTES|DISASM_CONFIG)) != 0)
-                    binFlags |= AMDBIN_INNER_CREATE_CALNOTES;
-                if ((disasmFlags & (DISASM_METADATA|DISASM_CONFIG)) != 0)
-                    binFlags |= AMDBIN_CREATE_INFOSTRINGS;
-                
-                if (isAmdBinary(binaryData.size(), binaryData.data()))
-                {   // if amd binary
-                    base.reset(createAmdBinaryFromCode(binaryData.size(),
-                            binaryData.data(), binFlags));
-                    if (base->getType() == AmdMainType::GPU_BINARY)
-                    {
-                        AmdMainGPUBinary32* amdGpuBin =
-                                static_cast<AmdMainGPUBinary32*>(base.get());
-                        Disassembler disasm(*amdGpuBin, std::cout, disasmFlags);
-                        disasm.disassemble();
-                    }
-                    else if (base->getType() == AmdMainType::GPU_64_BINARY)
-                    {
-                        AmdMainGPUBinary64* amdGpuBin =
-                                static_cast<AmdMainGPUBinary64*>(base.get());
-                        Disassembler disasm(*amdGpuBin, std::cout, disasmFlags);
-                        disasm.disassemble();
-                    }
-                    else
-                        throw Exception("This is not AMDGPU binary file!");
-                }
-                else if (isAmdCL2Binary(binaryData.size(), binaryData.data()))
-                {   // AMD OpenCL 2.0 binary
-                    binFlags |= AMDBIN_INNER_CREATE_KERNELDATA |
-                                AMDBIN_INNER_CREATE_KERNELDATAMAP |
-                                AMDBIN_INNER_CREATE_KERNELSTUBS;
-                    AmdCL2MainGPUBinary amdBin(binaryData.size(),
-                                       binaryData.data(), binFlags);
-                    Disassembler disasm(amdBin, std::cout, disasmFlags);
-                    disasm.disassemble();
-                }
-                else // if gallium binary
-                {
-                    GalliumBinary galliumBin(binaryData.size(),binaryData.data(), 0);
-                    Disassembler disasm(gpuDeviceType, galliumBin, std::cout, disasmFlags);
-                    disasm.disassemble();
-                }
+                std::ofstream ofs(outName.c_str(), std::ios::binary);
+                if (!ofs)
+                    throw Exception("Can't open output file '"+outName+"'");
+                outputCreated = true;
+                ofs.exceptions(std::ios::badbit | std::ios::failbit);
+                disassembleFile(input.c_str(), ofs, disasmFlags, gpuDeviceType,
+                        fromRawCode, 1, instrsNum, inputSize);
             }
-            else
-            {   /* raw binaries */
-                Disassembler disasm(gpuDeviceType, binaryData.size(), binaryData.data(),
-                        std::cout, disasmFlags);
-                disasm.disassemble();
+            catch(const std::exception& ex)
+            {
+                failed = true;
+                errorStream << "Error during disassemblying '" << input << "': " <<
+                        ex.what() << std::endl;
+            }
+            if (failed && outputCreated) // remove partial output
+                ::remove(outName.c_str());
+        }
+        else
+        {   // concatenated output (in input order)
+            std::ostringstream output;
+            output << "/* Disassembling '" << input << "\' */" << std::endl;
+            try
+            {
+                disassembleFile(input.c_str(), output, disasmFlags, gpuDeviceType,
+                        fromRawCode, 1, instrsNum, inputSize);
+            }
+            catch(const std::exception& ex)
+            {
+                failed = true;
+                output << "/* ERROR for '" << input << "\' */" << std::endl;
+                errorStream << "Error during disassemblying '" << input << "': " <<
+                        ex.what() << std::endl;
             }
+            outputString = output.str();
         }
-        catch(const std::exception& ex)
+        
+        std::lock_guard<std::mutex> lock(outputMutex);
+        if (failed)
         {
             ret = 1;
-            std::cout << "/* ERROR for '" << *args << "\' */" << std::endl;
-            std::cerr << "Error during disassemblying '" << *args << "': " <<
-                    ex.what() << std::endl;
+            failedNum++;
+            std::cerr << errorStream.str();
         }
-    }
+        totalInstrsNum += instrsNum;
+        totalInputSize += inputSize;
+        outputs[i].swap(outputString);
+        outputsReady[i] = true;
+        // write all ready outputs in input order
+        for (; nextOutput < inputs.size() && outputsReady[nextOutput]; nextOutput++)
+        {
+            std::cout.write(outputs[nextOutput].c_str(), outputs[nextOutput].size());
+            std::string().swap(outputs[nextOutput]);
+        }
+    });
+    std::cout.flush();
+    const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now()-startTime).count();
     
+    // print statistics
+    std::cerr << "Disassembled " << (inputs.size()-failedNum) << " files (failed " <<
+        failedNum << ", " << totalInputSize << " bytes, " << totalInstrsNum << " instructions) in " <<
+        seconds << " s: ";
+    if (seconds > 0.0)
+        std::cerr << ((inputs.size()-failedNum)/seconds) << " files/s, " <<
+            (totalInputSize/seconds/1048576.0) << " MB/s, " <<
+            (totalInstrsNum/seconds) << " instrs/s" << std::endl;
+    else
+        std::cerr << "too fast to measure" << std::endl;
     return ret;
 }
 catch(const Exception& ex)
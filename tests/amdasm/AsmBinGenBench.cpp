@@ -0,0 +1,156 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/utils/InputOutput.h>
+#include <CLRX/utils/ThreadPool.h>
+#include <CLRX/amdbin/AmdBinGen.h>
+#include <CLRX/amdbin/AmdCL2BinGen.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/AsmFormats.h>
+
+using namespace CLRX;
+
+/* benchmark of binary generation (AMD, AMD OpenCL 2.0 and GalliumCompute binaries).
+ * assembles source with many kernels once and generates binary many times
+ * to memory (Array) and to output stream. AMD and AMD OpenCL 2.0 binaries are
+ * also generated with kernels prepared in parallel.
+ * usage: AsmBinGenBench [KERNELS] [REPEATS] */
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static double elapsedMs(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(BenchClock::now()-start).count();
+}
+
+static std::string generateSource(const char* formatHeader, size_t kernelsNum)
+{
+    std::ostringstream oss;
+    oss << formatHeader;
+    for (size_t i = 0; i < kernelsNum; i++)
+        oss << ".kernel kernel" << i << "\n    .config\n    .dims x\n";
+    for (size_t i = 0; i < kernelsNum; i++)
+        oss << ".kernel kernel" << i << "\n.text\nkernel" << i << ":\n"
+            ".rept 256\n    v_add_f32 v1, v2, v3\n    s_mov_b32 s1, 0x1234\n.endr\n"
+            "    s_endpgm\n";
+    return oss.str();
+}
+
+int main(int argc, const char** argv)
+{
+    size_t kernelsNum = 500;
+    size_t repeatsNum = 20;
+    if (argc >= 2)
+        kernelsNum = ::strtoul(argv[1], nullptr, 10);
+    if (argc >= 3)
+        repeatsNum = ::strtoul(argv[2], nullptr, 10);
+    
+    static const std::pair<const char*, const char*> formats[3] =
+    {
+        { "AMD", ".amd\n.gpu Pitcairn\n.driver_version 140000\n" },
+        { "AMDCL2", ".amdcl2\n.gpu Tonga\n.driver_version 191205\n" },
+        { "Gallium", ".gallium\n.gpu Pitcairn\n" }
+    };
+    for (const auto& format: formats)
+    {
+        const std::string source = generateSource(format.second, kernelsNum);
+        std::istringstream input(source);
+        std::ostringstream errorStream;
+        Assembler assembler("bench.s", input, 0, BinaryFormat::AMD,
+                    GPUDeviceType::CAPE_VERDE, errorStream);
+        if (!assembler.assemble())
+        {
+            std::cerr << errorStream.str() << std::endl;
+            return 1;
+        }
+        
+        Array<cxbyte> binary;
+        BenchClock::time_point start = BenchClock::now();
+        for (size_t r = 0; r < repeatsNum; r++)
+            assembler.writeBinary(binary);
+        const double arrayTime = elapsedMs(start) / repeatsNum;
+        
+        Array<cxbyte> streamBinary(binary.size());
+        start = BenchClock::now();
+        for (size_t r = 0; r < repeatsNum; r++)
+        {
+            ArrayOStream aos(streamBinary.size(),
+                        reinterpret_cast<char*>(streamBinary.data()));
+            assembler.writeBinary(aos);
+        }
+        const double streamTime = elapsedMs(start) / repeatsNum;
+        
+        std::cout << format.first << " binary (" << kernelsNum << " kernels, " <<
+                binary.size() << " bytes): to memory " << arrayTime <<
+                " ms, to stream " << streamTime << " ms";
+        if (!std::equal(binary.begin(), binary.end(), streamBinary.begin()))
+        {
+            std::cerr << "\nBinaries generated to memory and to stream differ!" <<
+                    std::endl;
+            return 1;
+        }
+        
+        // parallel preparing of kernels (AMD and AMD OpenCL 2.0 binaries)
+        std::unique_ptr<AmdGPUBinGenerator> amdBinGen;
+        std::unique_ptr<AmdCL2GPUBinGenerator> amdCL2BinGen;
+        const AsmFormatHandler* formatHandler = assembler.getFormatHandler();
+        if (assembler.getBinaryFormat() == BinaryFormat::AMD)
+            amdBinGen.reset(new AmdGPUBinGenerator(
+                    static_cast<const AsmAmdHandler*>(formatHandler)->getOutput()));
+        else if (assembler.getBinaryFormat() == BinaryFormat::AMDCL2)
+            amdCL2BinGen.reset(new AmdCL2GPUBinGenerator(
+                    static_cast<const AsmAmdCL2Handler*>(formatHandler)->getOutput()));
+        if (amdBinGen != nullptr || amdCL2BinGen != nullptr)
+        {
+            Array<cxbyte> parallelBinary;
+            if (amdBinGen != nullptr)
+                amdBinGen->setThreadsNum(0);
+            else
+                amdCL2BinGen->setThreadsNum(0);
+            start = BenchClock::now();
+            for (size_t r = 0; r < repeatsNum; r++)
+                if (amdBinGen != nullptr)
+                    amdBinGen->generate(parallelBinary);
+                else
+                    amdCL2BinGen->generate(parallelBinary);
+            const double parallelTime = elapsedMs(start) / repeatsNum;
+            std::cout << ", parallel (" << ThreadPool::getHardwareThreadsNum() <<
+                    " threads) " << parallelTime << " ms";
+            if (parallelBinary.size() != binary.size() ||
+                !std::equal(binary.begin(), binary.end(), parallelBinary.begin()))
+            {
+                std::cerr << "\nBinaries generated serially and in parallel differ!" <<
+                        std::endl;
+                return 1;
+            }
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
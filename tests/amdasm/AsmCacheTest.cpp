@@ -0,0 +1,244 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <string>
+#include <ctime>
+#ifdef HAVE_WINDOWS
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/AsmCache.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* cacheDir = "AsmCacheTest.cache";
+static const char* includeFilename = "AsmCacheTest.inc";
+
+static void writeFile(const char* filename, const char* content)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << content;
+}
+
+static void clearCacheDir()
+{
+    try
+    {
+        for (const std::string& name: listDirectory(cacheDir))
+            ::remove(joinPaths(cacheDir, name).c_str());
+    }
+    catch(const Exception& ex)
+    { } // directory not exists
+}
+
+struct AsmCacheTestAssembly
+{
+    std::string source;
+    std::istringstream input;
+    std::ostringstream msgStream;
+    Assembler assembler;
+    
+    explicit AsmCacheTestAssembly(const std::string& _source,
+            GPUDeviceType devType = GPUDeviceType::PITCAIRN)
+        : source(_source), input(source),
+          assembler("", input, ASM_WARNINGS, BinaryFormat::RAWCODE, devType, msgStream)
+    { }
+    
+    AsmCacheKey makeKey() const
+    { return AsmBinaryCache::makeKey(assembler, source.size(), source.c_str()); }
+};
+
+static const char* testSource = R"ffDXD(
+        .include "AsmCacheTest.inc"
+        s_mov_b32 s1, s2
+        v_add_f32 v1, v2, v3
+        .warning "cached warning"
+)ffDXD";
+
+static void testAsmCache()
+{
+    const std::string testName = "testAsmCache";
+    clearCacheDir();
+    writeFile(includeFilename, "s_endpgm\n");
+    AsmBinaryCache cache(cacheDir);
+    
+    AsmCacheTestAssembly asm1(testSource);
+    const AsmCacheKey key = asm1.makeKey();
+    Array<cxbyte> binary;
+    std::string messages;
+    const std::vector<CString>& incDirs = asm1.assembler.getIncludeDirs();
+    assertTrue(testName, "miss1", !cache.load(key, incDirs, binary, messages));
+    assertTrue(testName, "assemble1", asm1.assembler.assemble());
+    Array<cxbyte> expBinary;
+    asm1.assembler.writeBinary(expBinary);
+    assertValue(testName, "includedFilesNum", size_t(1),
+                asm1.assembler.getIncludedFiles().size());
+    cache.store(key, expBinary, asm1.msgStream.str(),
+                asm1.assembler.getIncludedFileNames(),
+                asm1.assembler.getIncludedFiles());
+    
+    // same inputs
+    AsmCacheTestAssembly asm2(testSource);
+    assertTrue(testName, "sameKey", key == asm2.makeKey());
+    assertTrue(testName, "hit1", cache.load(key, incDirs, binary, messages));
+    assertArray(testName, "binary", expBinary, binary);
+    assertString(testName, "messages", asm1.msgStream.str().c_str(), messages);
+    assertTrue(testName, "messagesNotEmpty", !messages.empty());
+    
+    // other device type or other defsym gives other key
+    AsmCacheTestAssembly asm3(testSource, GPUDeviceType::TONGA);
+    assertTrue(testName, "otherDevType", key != asm3.makeKey());
+    AsmCacheTestAssembly asm4(testSource);
+    asm4.assembler.addInitialDefSym("xxx", 1);
+    assertTrue(testName, "otherDefSym", key != asm4.makeKey());
+    
+    // change content of included file
+    writeFile(includeFilename, "s_nop 7\n");
+    assertTrue(testName, "missAfterChange", !cache.load(key, incDirs, binary, messages));
+    assertValue(testName, "hitsNum", uint64_t(1), cache.getHitsNum());
+    assertValue(testName, "missesNum", uint64_t(2), cache.getMissesNum());
+    ::remove(includeFilename);
+}
+
+static void testAsmCacheEviction()
+{
+    const std::string testName = "testAsmCacheEviction";
+    clearCacheDir();
+    // only three entries can be held in cache
+    AsmBinaryCache cache(cacheDir, 3*1100);
+    const Array<cxbyte> binary(1000);
+    std::vector<AsmCacheKey> keys;
+    for (cxuint i = 0; i < 5; i++)
+    {
+        AsmCacheKey key;
+        key.add(uint64_t(i));
+        keys.push_back(key);
+        cache.store(key, binary, "", { }, { });
+    }
+    cxuint entriesNum = 0;
+    for (const std::string& name: listDirectory(cacheDir))
+        if (name.find(".clrxbin") != std::string::npos)
+            entriesNum++;
+    assertTrue(testName, "entriesNum", entriesNum <= 3);
+    Array<cxbyte> outBinary;
+    std::string messages;
+    assertTrue(testName, "lastStored", cache.load(keys[4], { }, outBinary, messages));
+    assertValue(testName, "binarySize", size_t(1000), outBinary.size());
+    clearCacheDir();
+}
+
+static const char* includeDir1 = "AsmCacheTest.incdir1";
+static const char* includeDir2 = "AsmCacheTest.incdir2";
+
+static const char* shadowTestSource = R"ffDXD(
+        .include "AsmCacheTest2.inc"
+        s_mov_b32 s1, s2
+)ffDXD";
+
+static void testAsmCacheIncludeResolution()
+{
+    const std::string testName = "testAsmCacheIncludeResolution";
+    clearCacheDir();
+    for (const char* dir: { includeDir1, includeDir2 })
+        try
+        { makeDir(dir); }
+        catch(const Exception& ex)
+        { } // ignore if exists
+    const std::string shadowedInc = joinPaths(includeDir1, "AsmCacheTest2.inc");
+    const std::string usedInc = joinPaths(includeDir2, "AsmCacheTest2.inc");
+    ::remove(shadowedInc.c_str());
+    writeFile(usedInc.c_str(), "s_endpgm\n");
+    AsmBinaryCache cache(cacheDir);
+    
+    AsmCacheTestAssembly asm1(shadowTestSource);
+    asm1.assembler.addIncludeDir(includeDir1);
+    asm1.assembler.addIncludeDir(includeDir2);
+    const AsmCacheKey key = asm1.makeKey();
+    assertTrue(testName, "assemble", asm1.assembler.assemble());
+    assertValue(testName, "includedFileName", std::string("AsmCacheTest2.inc"),
+                asm1.assembler.getIncludedFileNames()[0]);
+    assertValue(testName, "includedFile", usedInc, asm1.assembler.getIncludedFiles()[0]);
+    Array<cxbyte> expBinary;
+    asm1.assembler.writeBinary(expBinary);
+    cache.store(key, expBinary, asm1.msgStream.str(),
+                asm1.assembler.getIncludedFileNames(),
+                asm1.assembler.getIncludedFiles());
+    
+    const std::vector<CString>& incDirs = asm1.assembler.getIncludeDirs();
+    Array<cxbyte> binary;
+    std::string messages;
+    assertTrue(testName, "hit", cache.load(key, incDirs, binary, messages));
+    // file with same name in earlier include directory shadows used file
+    writeFile(shadowedInc.c_str(), "s_nop 7\n");
+    assertTrue(testName, "missShadowed", !cache.load(key, incDirs, binary, messages));
+    ::remove(shadowedInc.c_str());
+    assertTrue(testName, "hitAgain", cache.load(key, incDirs, binary, messages));
+    ::remove(usedInc.c_str());
+    assertTrue(testName, "missRemoved", !cache.load(key, incDirs, binary, messages));
+    clearCacheDir();
+}
+
+static void testAsmCacheOrphanedFiles()
+{
+    const std::string testName = "testAsmCacheOrphanedFiles";
+    clearCacheDir();
+    AsmBinaryCache cache(cacheDir);
+    // temporary files left by crashed writers
+    const std::string oldTmpPath = joinPaths(cacheDir,
+                "00000000000000000000000000000000.clrxbin.tmp1_1");
+    const std::string newTmpPath = joinPaths(cacheDir,
+                "00000000000000000000000000000001.clrxbin.tmp1_1");
+    writeFile(oldTmpPath.c_str(), "xxx");
+    writeFile(newTmpPath.c_str(), "xxx");
+    struct utimbuf times;
+    times.actime = times.modtime = ::time(nullptr) - 2*3600;
+    ::utime(oldTmpPath.c_str(), &times);
+    
+    AsmCacheKey key;
+    key.add(uint64_t(77));
+    cache.store(key, Array<cxbyte>(100), "", { }, { });
+    bool oldExists = false, newExists = false;
+    for (const std::string& name: listDirectory(cacheDir))
+    {
+        oldExists |= (joinPaths(cacheDir, name) == oldTmpPath);
+        newExists |= (joinPaths(cacheDir, name) == newTmpPath);
+    }
+    assertTrue(testName, "oldRemoved", !oldExists);
+    assertTrue(testName, "newKept", newExists);
+    clearCacheDir();
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testAsmCache);
+    retVal |= callTest(testAsmCacheEviction);
+    retVal |= callTest(testAsmCacheIncludeResolution);
+    retVal |= callTest(testAsmCacheOrphanedFiles);
+    return retVal;
+}
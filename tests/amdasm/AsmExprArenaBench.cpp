@@ -0,0 +1,84 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "BenchAllocCounter.h"
+
+using namespace CLRX;
+
+/* benchmark of the expression allocation in assembler.
+ * assembles synthetic source with many forward references (symbols are used before
+ * their definitions) and counts heap allocations while assembling.
+ * usage: AsmExprArenaBench [SYMBOLS] */
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static double elapsedMs(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(BenchClock::now()-start).count();
+}
+
+int main(int argc, const char** argv)
+{
+    size_t symbolsNum = 50000;
+    if (argc >= 2)
+        symbolsNum = ::strtoul(argv[1], nullptr, 10);
+    
+    // all expressions refer to symbols defined at end of source
+    std::ostringstream sourceStream;
+    for (size_t i = 0; i < symbolsNum; i++)
+        sourceStream << "s_mov_b32 s1, sym" << i << "+sym" << (i+1) << "*2\n"
+                ".int sym" << i << "-(sym" << (i+1) << ">>1)\n"
+                "val" << i << " = sym" << i << "+sym" << (i+1) << "\n";
+    for (size_t i = 0; i <= symbolsNum; i++)
+        sourceStream << "sym" << i << " = " << (i*3) << "\n";
+    const std::string source = sourceStream.str();
+    
+    std::istringstream input(source);
+    std::ostringstream errorStream;
+    size_t allocationsNum = 0;
+    double asmTime = 0.0;
+    bool good = false;
+    {
+        const size_t startAllocs = getBenchHeapAllocationsNum();
+        BenchClock::time_point start = BenchClock::now();
+        Assembler assembler("bench.s", input, 0, BinaryFormat::RAWCODE,
+                    GPUDeviceType::TONGA, errorStream);
+        good = assembler.assemble();
+        asmTime = elapsedMs(start);
+        allocationsNum = getBenchHeapAllocationsNum() - startAllocs;
+    }
+    
+    std::cout << "Assembling " << symbolsNum << " forward references: " <<
+            asmTime << " ms, " << allocationsNum << " heap allocations" << std::endl;
+    if (!good)
+    {
+        std::cerr << errorStream.str() << std::endl;
+        return 1;
+    }
+    return 0;
+}
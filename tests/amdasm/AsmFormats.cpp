@@ -1617,7 +1617,8 @@ test.s:45:5: Error: Config can't be defined if metadata,header,setup,stub sectio
     }
 };
 
-static void testAssembler(cxuint testId, const AsmTestCase& testCase)
+static void testAssembler(cxuint testId, const AsmTestCase& testCase,
+            cxuint threadsNum)
 {
     std::istringstream input(testCase.input);
     std::ostringstream errorStream;
@@ -1625,6 +1626,7 @@ static void testAssembler(cxuint testId, const AsmTestCase& testCase)
     
     Assembler assembler("test.s", input, (ASM_ALL|ASM_TESTRUN)&~ASM_ALTMACRO,
             BinaryFormat::AMD, GPUDeviceType::CAPE_VERDE, errorStream, printStream);
+    assembler.setThreadsNum(threadsNum);
     bool good = assembler.assemble();
     
     std::ostringstream dumpOss;
@@ -1641,8 +1643,8 @@ static void testAssembler(cxuint testId, const AsmTestCase& testCase)
                         assembler.getFormatHandler())->getOutput());
     }
     /* compare results */
-    char testName[30];
-    snprintf(testName, 30, "Test #%u", testId);
+    char testName[40];
+    snprintf(testName, 40, "Test #%u (threads=%u)", testId, threadsNum);
     
     assertValue(testName, "good", int(testCase.good), int(good));
     assertString(testName, "dump", testCase.dump, dumpOss.str());
@@ -1653,12 +1655,13 @@ int main(int argc, const char** argv)
 {
     int retVal = 0;
     for (size_t i = 0; i < sizeof(asmTestCases1Tbl)/sizeof(AsmTestCase); i++)
-        try
-        { testAssembler(i, asmTestCases1Tbl[i]); }
-        catch(const std::exception& ex)
-        {
-            std::cerr << ex.what() << std::endl;
-            retVal = 1;
-        }
+        for (cxuint threadsNum: { 1, 4 }) // serial and parallel assembling
+            try
+            { testAssembler(i, asmTestCases1Tbl[i], threadsNum); }
+            catch(const std::exception& ex)
+            {
+                std::cerr << ex.what() << std::endl;
+                retVal = 1;
+            }
     return retVal;
 }
@@ -0,0 +1,212 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+// maximal chunk size used by parallel preassembling (from AsmParallel.cpp)
+static const size_t maxChunkLinesNum = 4096;
+
+/* source generator that counts lines, because some statements must be placed
+ * at chunk boundaries */
+class SourceGenerator
+{
+private:
+    std::string source;
+    size_t linesNum;
+public:
+    SourceGenerator() : linesNum(0)
+    { }
+    
+    void addLine(const std::string& line)
+    {
+        source += line;
+        source.push_back('\n');
+        linesNum++;
+    }
+    
+    size_t getLinesNum() const
+    { return linesNum; }
+    const std::string& getSource() const
+    { return source; }
+};
+
+// put instructions (with forward references to symbols and macro calls)
+static void generateInstrs(SourceGenerator& gen, cxuint kernelId, size_t instrsNum)
+{
+    for (size_t i = 0; i < instrsNum; i++)
+    {
+        const std::string is = std::to_string(i);
+        switch (i % 7)
+        {
+            case 0:
+                gen.addLine("        s_mov_b32 s" + std::to_string(i%90) + ", " + is);
+                break;
+            case 1:
+                gen.addLine("        v_add_f32 v" + std::to_string(i%200) + ", v1, v" +
+                        std::to_string((i>>3)%200));
+                break;
+            case 2:
+                // forward reference to symbol defined at end of source
+                gen.addLine("        s_add_u32 s3, s4, fwdsym" +
+                        std::to_string(kernelId));
+                break;
+            case 3:
+                gen.addLine("        v_mov_b32 v" + std::to_string(i%100) + ", s" +
+                        std::to_string(i%50) + "; s_nop " + std::to_string(i&7));
+                break;
+            case 4:
+                gen.addLine("        vaddm " + std::to_string(i%100) + ", " +
+                        std::to_string((i>>2)%100));
+                break;
+            case 5:
+                gen.addLine("        s_and_b32 s" + std::to_string(i%60) +
+                        ", s1, 0x" + std::to_string(i*31));
+                break;
+            default:
+                gen.addLine("        v_mul_lo_u32 v5, v" + std::to_string(i%150) +
+                        ", v6");
+                break;
+        }
+    }
+}
+
+// put macro or repetition whose content crosses chunk boundary at boundaryLine
+static void generateCrossing(SourceGenerator& gen, size_t boundaryLine, cxuint crossId)
+{
+    generateInstrs(gen, 0, boundaryLine-10-gen.getLinesNum());
+    const std::string cs = std::to_string(crossId);
+    if ((crossId & 1) == 0)
+    {
+        gen.addLine("        .macro crossmac" + cs + " a, b=3");
+        for (cxuint i = 0; i < 20; i++)
+            gen.addLine("            v_sub_f32 v\\a, v\\b, v" + std::to_string(i) +
+                    "; s_mov_b32 s" + std::to_string(i) + ", \\a");
+        gen.addLine("        .endm");
+        gen.addLine("        crossmac" + cs + " 7");
+    }
+    else
+    {
+        gen.addLine("        .rept 3");
+        for (cxuint i = 0; i < 20; i++)
+            gen.addLine("        s_xor_b32 s" + std::to_string(i) + ", s" +
+                    std::to_string(i+1) + ", " + std::to_string(i+crossId));
+        gen.addLine("        .endr");
+    }
+}
+
+static std::string generateParallelSource()
+{
+    SourceGenerator gen;
+    gen.addLine(".amd");
+    gen.addLine(".gpu Pitcairn");
+    gen.addLine(".macro vaddm a, b");
+    gen.addLine("    v_add_f32 v\\a, v\\b, v3");
+    gen.addLine(".endm");
+    for (cxuint k = 0; k < 6; k++)
+    {
+        gen.addLine(".kernel kernel" + std::to_string(k));
+        const size_t kernelLineNo = gen.getLinesNum();
+        gen.addLine("    .config");
+        gen.addLine("        .dims x");
+        gen.addLine("    .text");
+        gen.addLine("        s_branch farlabel" + std::to_string(k));
+        if (k == 2)
+        {   // long kernel: chunks are split inside that kernel
+            generateCrossing(gen, kernelLineNo + maxChunkLinesNum, 0);
+            generateInstrs(gen, k, 300);
+            gen.addLine("        .warning \"warning in long kernel\"");
+            generateCrossing(gen, kernelLineNo + 2*maxChunkLinesNum, 1);
+            // use macro defined in previous chunk
+            gen.addLine("        crossmac0 9, 10");
+            generateCrossing(gen, kernelLineNo + 3*maxChunkLinesNum, 2);
+        }
+        else
+            generateInstrs(gen, k, 400 + k*50);
+        // use macros defined in previous chunks
+        if (k > 2)
+            gen.addLine("        crossmac0 " + std::to_string(k) + "; crossmac2 11");
+        gen.addLine("farlabel" + std::to_string(k) + ":");
+        gen.addLine("        s_endpgm");
+    }
+    for (cxuint k = 0; k < 6; k++)
+        gen.addLine("fwdsym" + std::to_string(k) + " = " + std::to_string(k*33+5));
+    return gen.getSource();
+}
+
+struct AsmParallelResult
+{
+    bool good;
+    Array<cxbyte> binary;
+    std::string messages;
+    uint64_t preassembledInstrs;
+};
+
+static AsmParallelResult assembleSource(const std::string& source, cxuint threadsNum)
+{
+    std::istringstream input(source);
+    std::ostringstream msgStream;
+    Assembler assembler("test.s", input, ASM_WARNINGS, BinaryFormat::AMD,
+                GPUDeviceType::CAPE_VERDE, msgStream);
+    assembler.setThreadsNum(threadsNum);
+    assembler.setStatsEnabled(true);
+    AsmParallelResult result;
+    result.good = assembler.assemble();
+    if (result.good)
+        assembler.writeBinary(result.binary);
+    result.messages = msgStream.str();
+    result.preassembledInstrs = assembler.getStats()->preassembledInstrs;
+    return result;
+}
+
+static void testAsmParallelChunks()
+{
+    const std::string testName = "testAsmParallelChunks";
+    const std::string source = generateParallelSource();
+    const AsmParallelResult expected = assembleSource(source, 1);
+    assertTrue(testName, "expectedGood", expected.good);
+    assertValue(testName, "expectedPreassembled", uint64_t(0),
+                expected.preassembledInstrs);
+    for (cxuint threadsNum: { 2, 4 })
+    {
+        const std::string caseName = "threads" + std::to_string(threadsNum);
+        const AsmParallelResult result = assembleSource(source, threadsNum);
+        assertValue(testName, caseName+".good", int(expected.good), int(result.good));
+        assertArray(testName, caseName+".binary", expected.binary, result.binary);
+        assertString(testName, caseName+".messages", expected.messages.c_str(),
+                    result.messages);
+        // instructions from all chunks (also after chunk boundaries) are preassembled
+        assertTrue(testName, caseName+".preassembled",
+                   result.preassembledInstrs > 3*maxChunkLinesNum);
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testAsmParallelChunks);
+    return retVal;
+}
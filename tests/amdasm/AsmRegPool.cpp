@@ -303,14 +303,16 @@ kx7: s_mov_b32 s23, s0
     }
 };
 
-static void testAsmRegPoolTestCase(cxuint testId, const AsmRegPoolTestCase& testCase)
+static void testAsmRegPoolTestCase(cxuint testId, const AsmRegPoolTestCase& testCase,
+            cxuint threadsNum)
 {
-    char testName[30];
-    snprintf(testName, 30, "Test #%u", testId);
+    char testName[40];
+    snprintf(testName, 40, "Test #%u (threads=%u)", testId, threadsNum);
     
     std::istringstream input(testCase.input);
     Assembler assembler("test.s", input, (ASM_ALL|ASM_TESTRUN)&~ASM_ALTMACRO,
             BinaryFormat::AMD, GPUDeviceType::CAPE_VERDE);
+    assembler.setThreadsNum(threadsNum);
     assertTrue(testName, "good", assembler.assemble());
     // retrieve data
     if (assembler.getBinaryFormat()==BinaryFormat::AMD)
@@ -366,12 +368,13 @@ int main(int argc, const char** argv)
 {
     int retVal = 0;
     for (cxuint i = 0; i < sizeof(regPoolTestCasesTbl)/sizeof(AsmRegPoolTestCase); i++)
-        try
-        { testAsmRegPoolTestCase(i, regPoolTestCasesTbl[i]); }
-        catch(const std::exception& ex)
-        {
-            std::cerr << ex.what() << std::endl;
-            retVal = 1;
-        }
+        for (cxuint threadsNum: { 1, 4 }) // serial and parallel assembling
+            try
+            { testAsmRegPoolTestCase(i, regPoolTestCasesTbl[i], threadsNum); }
+            catch(const std::exception& ex)
+            {
+                std::cerr << ex.what() << std::endl;
+                retVal = 1;
+            }
     return retVal;
 }
@@ -0,0 +1,156 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/AsmSession.h>
+
+using namespace CLRX;
+
+/* benchmark of incremental reassembling (tuning runs).
+ * generates large included file with many macros (and common code) and main source
+ * that uses these macros depending on TUNE symbol. Source is assembled many times
+ * with other TUNE values: without session (every run reads whole included file and
+ * collects its macros) and with session (included file and macros reused).
+ * usage: AsmSessionBench [MACROS] [RUNS] */
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static double elapsedMs(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(BenchClock::now()-start).count();
+}
+
+static const char* includeFilename = "AsmSessionBench.inc";
+
+static std::string generateInclude(size_t macrosNum)
+{
+    std::ostringstream oss;
+    oss << "/* generated included file */\n";
+    for (size_t i = 0; i < macrosNum; i++)
+        oss << ".macro mac" << i << " dst, src, count=2  # macro " << i << "\n"
+            "    .rept \\count\n"
+            "        v_add_f32 v\\dst, v\\src, v" << (i&63) << "\n"
+            "        v_mul_f32 v\\dst, " << i << ".5, v\\dst\n"
+            "    .endr\n"
+            "    s_mov_b32 s\\dst, " << (i*17) << " /* constant */\n"
+            ".endm\n";
+    return oss.str();
+}
+
+static std::string generateSource(size_t macrosNum)
+{
+    std::ostringstream oss;
+    oss << ".include \"" << includeFilename << "\"\n";
+    for (size_t i = 0; i < 64; i++)
+        oss << "mac" << (i*31 % macrosNum) << " " << (i&15) << ", " <<
+                ((i+1)&15) << ", TUNE\n";
+    oss << "s_endpgm\n";
+    return oss.str();
+}
+
+static bool assemble(Assembler& assembler, std::ostream& errorStream,
+            const std::ostringstream& msgStream, Array<cxbyte>& binary)
+{
+    if (!assembler.assemble())
+    {
+        errorStream << msgStream.str() << std::endl;
+        return false;
+    }
+    assembler.writeBinary(binary);
+    return true;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t macrosNum = 20000;
+    size_t runsNum = 20;
+    if (argc >= 2)
+        macrosNum = ::strtoul(argv[1], nullptr, 10);
+    if (argc >= 3)
+        runsNum = ::strtoul(argv[2], nullptr, 10);
+    if (macrosNum == 0)
+        macrosNum = 1;
+    
+    {
+        std::ofstream ofs(includeFilename, std::ios::binary);
+        ofs << generateInclude(macrosNum);
+    }
+    const std::string source = generateSource(macrosNum);
+    std::vector<Array<cxbyte> > binaries(runsNum);
+    
+    // without session
+    BenchClock::time_point start = BenchClock::now();
+    for (size_t r = 0; r < runsNum; r++)
+    {
+        std::istringstream input(source);
+        std::ostringstream msgStream;
+        Assembler assembler("bench.s", input, 0, BinaryFormat::RAWCODE,
+                    GPUDeviceType::PITCAIRN, msgStream);
+        assembler.addInitialDefSym("TUNE", r+1);
+        if (!assemble(assembler, std::cerr, msgStream, binaries[r]))
+            return 1;
+    }
+    const double coldTime = elapsedMs(start) / runsNum;
+    
+    // with session
+    std::ostringstream msgStream;
+    AsmSession session(0, BinaryFormat::RAWCODE, GPUDeviceType::PITCAIRN, msgStream);
+    double firstTime = 0.0;
+    start = BenchClock::now();
+    for (size_t r = 0; r < runsNum; r++)
+    {
+        std::istringstream input(source);
+        std::unique_ptr<Assembler> assembler(session.createAssembler("bench.s", input,
+                    { { "TUNE", r+1 } }));
+        Array<cxbyte> binary;
+        if (!assemble(*assembler, std::cerr, msgStream, binary))
+            return 1;
+        if (r == 0)
+            firstTime = elapsedMs(start);
+        if (binary.size() != binaries[r].size() ||
+            !std::equal(binary.begin(), binary.end(), binaries[r].begin()))
+        {
+            std::cerr << "Binaries generated with and without session differ!" <<
+                        std::endl;
+            return 1;
+        }
+    }
+    const double totalTime = elapsedMs(start);
+    const double warmTime = runsNum > 1 ? (totalTime-firstTime) / (runsNum-1) : 0.0;
+    ::remove(includeFilename);
+    
+    std::cout << "Tuning runs (" << macrosNum << " macros, " << runsNum <<
+            " runs): without session " << coldTime << " ms/run, with session: first " <<
+            firstTime << " ms, next " << warmTime << " ms/run\n"
+            "Session: file hits " << session.getCachedFileHits() << ", file misses " <<
+            session.getCachedFileMisses() << ", macro hits " <<
+            session.getCachedMacroHits() << std::endl;
+    return 0;
+}
@@ -0,0 +1,256 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <string>
+#include <memory>
+#include <ctime>
+#ifdef HAVE_WINDOWS
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/AsmSession.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* includeFilename = "AsmSessionTest.inc";
+
+static void writeFile(const char* filename, const char* content)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << content;
+}
+
+// rewrite file and wait for change of timestamp of file
+static void rewriteFile(const char* filename, const char* content)
+{
+    const uint64_t oldTimestamp = getFileTimestamp(filename);
+    do {
+        writeFile(filename, content);
+    } while (getFileTimestamp(filename) == oldTimestamp);
+}
+
+static const char* includeSource = R"ffDXD(/* included file */
+        .ifndef INCLUDED
+        .set INCLUDED, 1
+        .macro putnops count=1
+            .rept \count
+            s_nop 1     # comment
+            .endr
+        .endm
+        .macro warnmacro
+            .warning "warning from macro"
+        .endm
+        .if TUNE > 2
+        .macro tunemac a, b
+            v_add_f32 v\a, v\b, v3 ; s_nop \a
+        .endm
+        .else
+        .macro tunemac a, b
+            v_sub_f32 v\a, v\b, v3
+        .endm
+        .endif
+        .endif
+        s_mov_b32 s1, \
+                TUNE
+)ffDXD";
+
+static const char* testSource = R"ffDXD(
+        .include "AsmSessionTest.inc"
+        putnops TUNE
+        tunemac 4, 5
+        warnmacro
+        .ifgt TUNE-4
+        .include "AsmSessionTest.inc"
+        .endif
+)ffDXD";
+
+struct AsmSessionTestResult
+{
+    bool good;
+    Array<cxbyte> binary;
+    std::string messages;
+};
+
+static AsmSessionTestResult assembleWithoutSession(uint64_t tune)
+{
+    std::istringstream input(testSource);
+    std::ostringstream msgStream;
+    Assembler assembler("test.s", input, ASM_WARNINGS, BinaryFormat::RAWCODE,
+                GPUDeviceType::PITCAIRN, msgStream);
+    assembler.addInitialDefSym("TUNE", tune);
+    AsmSessionTestResult result;
+    result.good = assembler.assemble();
+    if (result.good)
+        assembler.writeBinary(result.binary);
+    result.messages = msgStream.str();
+    return result;
+}
+
+static AsmSessionTestResult assembleWithSession(AsmSession& session,
+            std::ostringstream& msgStream, uint64_t tune)
+{
+    std::istringstream input(testSource);
+    msgStream.str("");
+    std::unique_ptr<Assembler> assembler(session.createAssembler("test.s", input,
+                { { "TUNE", tune } }));
+    AsmSessionTestResult result;
+    result.good = assembler->assemble();
+    if (result.good)
+        assembler->writeBinary(result.binary);
+    result.messages = msgStream.str();
+    return result;
+}
+
+static void checkResults(const std::string& testName, const std::string& caseName,
+            const AsmSessionTestResult& expected, const AsmSessionTestResult& result)
+{
+    assertValue(testName, caseName+".good", int(expected.good), int(result.good));
+    assertArray(testName, caseName+".binary", expected.binary, result.binary);
+    assertString(testName, caseName+".messages", expected.messages.c_str(),
+                result.messages);
+}
+
+static void testAsmSession()
+{
+    const std::string testName = "testAsmSession";
+    writeFile(includeFilename, includeSource);
+    std::ostringstream msgStream;
+    AsmSession session(ASM_WARNINGS, BinaryFormat::RAWCODE, GPUDeviceType::PITCAIRN,
+                msgStream);
+    // assemble with other TUNE values (with second inclusion if TUNE>4)
+    for (uint64_t tune = 0; tune < 7; tune++)
+    {
+        const std::string caseName = "tune" + std::to_string(tune);
+        const AsmSessionTestResult expected = assembleWithoutSession(tune);
+        assertTrue(testName, caseName+".expectedGood", expected.good);
+        checkResults(testName, caseName, expected,
+                     assembleWithSession(session, msgStream, tune));
+    }
+    assertValue(testName, "cachedFilesNum", size_t(1), session.getCachedFilesNum());
+    assertValue(testName, "fileMisses", uint64_t(1), session.getCachedFileMisses());
+    assertValue(testName, "fileHits", uint64_t(8), session.getCachedFileHits());
+    // tunemac is defined in other place if TUNE>2
+    assertValue(testName, "macroHits", uint64_t(17), session.getCachedMacroHits());
+
+    // change included file
+    const std::string changedSource = std::string(includeSource) +
+            "        s_endpgm\n";
+    rewriteFile(includeFilename, changedSource.c_str());
+    for (uint64_t tune = 2; tune < 6; tune++)
+    {
+        const std::string caseName = "changed" + std::to_string(tune);
+        checkResults(testName, caseName, assembleWithoutSession(tune),
+                     assembleWithSession(session, msgStream, tune));
+    }
+    assertValue(testName, "fileMisses2", uint64_t(2), session.getCachedFileMisses());
+
+    // file with warnings while filtering is not cached
+    const std::string warnSource = std::string(includeSource) +
+            "        .ascii \"unterminated\n";
+    rewriteFile(includeFilename, warnSource.c_str());
+    for (uint64_t tune = 1; tune < 3; tune++)
+    {
+        const std::string caseName = "warning" + std::to_string(tune);
+        checkResults(testName, caseName, assembleWithoutSession(tune),
+                     assembleWithSession(session, msgStream, tune));
+    }
+    assertValue(testName, "fileMisses3", uint64_t(4), session.getCachedFileMisses());
+    ::remove(includeFilename);
+}
+
+static const char* changesIncludeFilename = "AsmSessionTest2.inc";
+
+// write file and set its modification time
+static void writeFileWithTime(const char* filename, const char* content, time_t mtime)
+{
+    writeFile(filename, content);
+    struct utimbuf times;
+    times.actime = times.modtime = mtime;
+    ::utime(filename, &times);
+}
+
+static Array<cxbyte> assembleChangesSource(AsmSession& session)
+{
+    std::istringstream input(".include \"AsmSessionTest2.inc\"\n");
+    std::unique_ptr<Assembler> assembler(session.createAssembler("test.s", input));
+    Array<cxbyte> binary;
+    if (assembler->assemble())
+        assembler->writeBinary(binary);
+    return binary;
+}
+
+static void testAsmSessionFileChanges()
+{
+    const std::string testName = "testAsmSessionFileChanges";
+    std::ostringstream msgStream;
+    AsmSession session(ASM_WARNINGS, BinaryFormat::RAWCODE, GPUDeviceType::PITCAIRN,
+                msgStream);
+    const time_t oldTime = ::time(nullptr) - 3600;
+    writeFileWithTime(changesIncludeFilename, ".byte 1\n", oldTime);
+    assertArray(testName, "first", Array<cxbyte>({ 1 }), assembleChangesSource(session));
+    assertArray(testName, "cached", Array<cxbyte>({ 1 }), assembleChangesSource(session));
+    assertValue(testName, "hits0", uint64_t(1), session.getCachedFileHits());
+    
+    // other size, this same timestamp
+    writeFileWithTime(changesIncludeFilename, ".byte 2,3\n", oldTime);
+    assertArray(testName, "otherSize", Array<cxbyte>({ 2, 3 }),
+                assembleChangesSource(session));
+    assertValue(testName, "misses1", uint64_t(2), session.getCachedFileMisses());
+    
+    // file replaced by other file (other inode), this same size and timestamp
+    const std::string tmpFilename = std::string(changesIncludeFilename) + ".tmp";
+    writeFileWithTime(tmpFilename.c_str(), ".byte 4,5\n", oldTime);
+    ::remove(changesIncludeFilename);
+    ::rename(tmpFilename.c_str(), changesIncludeFilename);
+    assertArray(testName, "otherInode", Array<cxbyte>({ 4, 5 }),
+                assembleChangesSource(session));
+    assertValue(testName, "misses2", uint64_t(3), session.getCachedFileMisses());
+    
+    // file rewritten in place in timestamp granularity: same size, timestamp and inode
+    const time_t newTime = ::time(nullptr) + 10;
+    writeFileWithTime(changesIncludeFilename, ".byte 6,7\n", newTime);
+    assertArray(testName, "racy", Array<cxbyte>({ 6, 7 }),
+                assembleChangesSource(session));
+    assertArray(testName, "racyCached", Array<cxbyte>({ 6, 7 }),
+                assembleChangesSource(session));
+    writeFileWithTime(changesIncludeFilename, ".byte 8,9\n", newTime);
+    assertArray(testName, "racyChanged", Array<cxbyte>({ 8, 9 }),
+                assembleChangesSource(session));
+    assertValue(testName, "misses3", uint64_t(5), session.getCachedFileMisses());
+    assertValue(testName, "hits3", uint64_t(2), session.getCachedFileHits());
+    assertString(testName, "messages", "", msgStream.str());
+    ::remove(changesIncludeFilename);
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testAsmSession);
+    retVal |= callTest(testAsmSessionFileChanges);
+    return retVal;
+}
@@ -0,0 +1,104 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <string>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* testSource = R"ffDXD(
+        .macro mac1 a
+            s_mov_b32 s\a, 1
+        .endm
+        .rept 3
+        v_add_f32 v1, v2, v3
+        .endr
+        .irp x, 1, 2
+        s_add_u32 s\x, s1, s2
+        .endr
+        mac1 4
+        mac1 5
+        .set sym1, 5
+        .set sym2, sym3+1
+        .set sym3, 8
+        s_nop 2
+        s_endpgm
+)ffDXD";
+
+static size_t findEncoding(const std::string& testName, const AsmStats& stats,
+            const char* encodingName)
+{
+    for (size_t i = 0; i < stats.encodings.size(); i++)
+        if (::strcmp(stats.encodingNames[i], encodingName) == 0)
+            return i;
+    assertTrue(testName, std::string("encoding ")+encodingName, false);
+    return 0;
+}
+
+static void testAsmStats()
+{
+    const std::string testName = "testAsmStats";
+    std::istringstream input(testSource);
+    std::ostringstream msgStream;
+    Assembler assembler("test.s", input, ASM_WARNINGS, BinaryFormat::RAWCODE,
+                GPUDeviceType::PITCAIRN, msgStream);
+    assertTrue(testName, "disabledStats", assembler.getStats() == nullptr);
+    assembler.setStatsEnabled(true);
+    assertTrue(testName, "good", assembler.assemble());
+    Array<cxbyte> binary;
+    assembler.writeBinary(binary);
+    
+    const AsmStats& stats = *assembler.getStats();
+    assertValue(testName, "streamLines", uint64_t(18), stats.readLines[0].count);
+    assertValue(testName, "repeatLines", uint64_t(7), stats.readLines[1].count);
+    assertValue(testName, "macroLines", uint64_t(4), stats.readLines[2].count);
+    assertValue(testName, "pseudoOps", uint64_t(6), stats.pseudoOps.count);
+    assertValue(testName, "instructions", uint64_t(9), stats.instructions.count);
+    assertValue(testName, "VOP2", uint64_t(3),
+                stats.encodings[findEncoding(testName, stats, "VOP2")].count);
+    assertValue(testName, "SOP2", uint64_t(2),
+                stats.encodings[findEncoding(testName, stats, "SOP2")].count);
+    assertValue(testName, "SOP1", uint64_t(2),
+                stats.encodings[findEncoding(testName, stats, "SOP1")].count);
+    assertValue(testName, "SOPP", uint64_t(2),
+                stats.encodings[findEncoding(testName, stats, "SOPP")].count);
+    assertValue(testName, "preassembledInstrs", uint64_t(0), stats.preassembledInstrs);
+    assertValue(testName, "macroSubsts", uint64_t(2), stats.macroSubsts);
+    assertValue(testName, "repetitions", uint64_t(2), stats.repetitions);
+    assertValue(testName, "maxSymbolsNum", size_t(4), stats.maxSymbolsNum);
+    assertValue(testName, "maxExprsNum", size_t(2), stats.maxExprsNum);
+    assertValue(testName, "prepareBinary", uint64_t(1), stats.prepareBinary.count);
+    assertValue(testName, "writeBinary", uint64_t(1), stats.writeBinary.count);
+    
+    assembler.setStatsEnabled(false);
+    assertTrue(testName, "disabledStats2", assembler.getStats() == nullptr);
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testAsmStats);
+    return retVal;
+}
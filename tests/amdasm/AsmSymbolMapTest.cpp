@@ -0,0 +1,143 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static void testAsmSymbolMap()
+{
+    const std::string testName = "testAsmSymbolMap";
+    AsmSymbolMap symbolMap({ std::make_pair(".", AsmSymbol(0, uint64_t(0))) });
+    assertValue(testName, "initSize", size_t(1), symbolMap.size());
+    assertString(testName, "initName", ".", symbolMap.begin()->first);
+    
+    // insert many symbols (with rehashing) and check whether entries are not moved
+    const size_t symbolsNum = 5000;
+    std::vector<AsmSymbolEntry*> entries;
+    for (size_t i = 0; i < symbolsNum; i++)
+    {
+        const std::string name = "sym" + std::to_string(i);
+        std::pair<AsmSymbolMap::iterator, bool> res =
+                symbolMap.insert(std::make_pair(CString(name), AsmSymbol(0, i)));
+        assertTrue(testName, "inserted", res.second);
+        entries.push_back(&*res.first);
+    }
+    assertValue(testName, "size", symbolsNum+1, symbolMap.size());
+    for (size_t i = 0; i < symbolsNum; i++)
+    {
+        const std::string name = "sym" + std::to_string(i);
+        // find by name given as pointer and length (name is not null-terminated)
+        const std::string longName = name + "xyz";
+        AsmSymbolMap::iterator it = symbolMap.find(longName.c_str(), name.size());
+        assertTrue(testName, "found", it != symbolMap.end());
+        assertTrue(testName, "sameEntry", &*it == entries[i]);
+        assertValue(testName, "value", uint64_t(i), it->second.value);
+    }
+    // insert existing symbol
+    std::pair<AsmSymbolMap::iterator, bool> res = symbolMap.insert("sym17", 5);
+    assertTrue(testName, "notInserted", !res.second);
+    assertTrue(testName, "existing", &*res.first == entries[17]);
+    assertTrue(testName, "notFound", symbolMap.find("sym", 3) == symbolMap.end());
+    assertTrue(testName, "notFound2", symbolMap.find("sym17x") == symbolMap.end());
+    
+    // erase half of symbols
+    for (size_t i = 0; i < symbolsNum; i += 2)
+        symbolMap.erase(symbolMap.find(CString("sym" + std::to_string(i))));
+    assertValue(testName, "sizeAfterErase", symbolsNum/2+1, symbolMap.size());
+    size_t iteratedNum = 0;
+    for (const AsmSymbolEntry& entry: symbolMap)
+    {
+        if (entry.first != ".")
+            assertTrue(testName, "oddValue", (entry.second.value&1) != 0);
+        iteratedNum++;
+    }
+    assertValue(testName, "iteratedNum", symbolsNum/2+1, iteratedNum);
+    for (size_t i = 0; i < symbolsNum; i++)
+    {
+        const AsmSymbolMap& constMap = symbolMap;
+        AsmSymbolMap::const_iterator it = constMap.find(
+                    CString("sym" + std::to_string(i)));
+        assertTrue(testName, "findAfterErase", (it != constMap.end()) == ((i&1) != 0));
+    }
+    // insert again erased symbols
+    for (size_t i = 0; i < symbolsNum; i += 2)
+        symbolMap[CString("sym" + std::to_string(i))] = AsmSymbol(0, i);
+    assertValue(testName, "sizeAfterReinsert", symbolsNum+1, symbolMap.size());
+    assertTrue(testName, "oddStable", &*symbolMap.find("sym4001") == entries[4001]);
+    assertValue(testName, "reinsertedValue", uint64_t(4000),
+                symbolMap.find("sym4000")->second.value);
+}
+
+static const char* undefSymbolSource = R"ffDXD(.rawcode
+1:      .byte 1, 2
+        x = 1b+1
+        .undef x
+2:      .byte 3
+        x = 2b+10
+        y = 1b
+        .byte 3f-2b
+        .undef x
+        z = x+2
+3:      .byte 4
+        x = 3b+20
+        .undef y
+2:      .byte 5
+        y = 2b-1b+1
+)ffDXD";
+
+static void testUndefSymbolAndLocalLabels()
+{
+    const std::string testName = "testUndefSymbolAndLocalLabels";
+    std::istringstream input(undefSymbolSource);
+    std::ostringstream msgStream;
+    Assembler assembler("test.s", input, ASM_WARNINGS, BinaryFormat::RAWCODE,
+                GPUDeviceType::PITCAIRN, msgStream);
+    const bool good = assembler.assemble();
+    assertString(testName, "messages", "", msgStream.str());
+    assertTrue(testName, "good", good);
+    const AsmSymbolMap& symbolMap = assembler.getSymbolMap();
+    const struct { const char* name; uint64_t value; } expectedSymbols[] =
+    {
+        { "x", 24 }, { "y", 6 }, { "z", 26 }, { "1b", 0 }, { "2b", 5 }, { "3b", 4 }
+    };
+    for (const auto& expected: expectedSymbols)
+    {
+        AsmSymbolMap::const_iterator it = symbolMap.find(expected.name);
+        assertTrue(testName, std::string("found ")+expected.name, it != symbolMap.end());
+        assertTrue(testName, std::string("hasValue ")+expected.name,
+                   it->second.hasValue);
+        assertValue(testName, std::string("value ")+expected.name,
+                    expected.value, it->second.value);
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testAsmSymbolMap);
+    retVal |= callTest(testUndefSymbolAndLocalLabels);
+    return retVal;
+}
@@ -0,0 +1,372 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#ifndef HAVE_WINDOWS
+#include <sys/resource.h>
+#endif
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <chrono>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include <CLRX/amdbin/AmdCL2Binaries.h>
+#include <CLRX/amdbin/GalliumBinaries.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/Disassembler.h>
+#include "BenchAllocCounter.h"
+
+using namespace CLRX;
+
+/* assembler and disassembler throughput benchmark.
+ * generates reproducible synthetic sources (straight-line VOP3 code, repetitions,
+ * macros, forward references, multi-kernel AMD, AMD OpenCL 2.0 and GalliumCompute
+ * binaries), assembles them (with binary writing) and disassembles generated binaries.
+ * results (lines/s, bytes/s, heap allocations, peak RSS) are printed in JSON format.
+ * peak RSS is peak of whole process, hence single workload should be choosen to
+ * get its real peak RSS.
+ * usage: AsmThroughputBench [INSTRS] [WORKLOAD] */
+
+typedef std::chrono::high_resolution_clock BenchClock;
+    
+static double elapsedMs(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(BenchClock::now()-start).count();
+}
+
+// get peak resident set size of process in kilobytes (0 if not available)
+static size_t getPeakRSS()
+{
+#ifndef HAVE_WINDOWS
+    struct rusage usage;
+    if (::getrusage(RUSAGE_SELF, &usage) == 0)
+        return usage.ru_maxrss;
+#endif
+    return 0;
+}
+
+// stream buffer that counts and drops output (disassembler output)
+class CountingStreamBuf: public std::streambuf
+{
+private:
+    size_t counted;
+protected:
+    int_type overflow(int_type ch)
+    {
+        counted++;
+        return traits_type::not_eof(ch);
+    }
+    std::streamsize xsputn(const char*, std::streamsize n)
+    {
+        counted += n;
+        return n;
+    }
+public:
+    CountingStreamBuf() : counted(0)
+    { }
+    size_t getCounted() const
+    { return counted; }
+};
+
+struct Workload
+{
+    const char* name;
+    BinaryFormat format;
+    GPUDeviceType deviceType;
+    std::string (*generate)(size_t instrsNum);
+};
+
+static const char* vop3Instrs[4] =
+{
+    "v_mad_f32 v", "v_fma_f32 v", "v_med3_i32 v", "v_bfe_u32 v"
+};
+
+// straight-line VOP3 code
+static std::string generateVOP3(size_t instrsNum)
+{
+    std::ostringstream oss;
+    for (size_t i = 0; i < instrsNum; i++)
+        oss << "        " << vop3Instrs[i&3] << (i%97) << ", v" << ((i+5)%101) <<
+                ", s" << ((i+3)%50) << ", v" << ((i+11)%103) << "\n";
+    return oss.str();
+}
+
+// repetitions with counters
+static std::string generateRept(size_t instrsNum)
+{
+    std::ostringstream oss;
+    oss << "        cnt = 0\n        .rept " << (instrsNum>>3) << "\n"
+        "        v_add_f32 v1, v2, v3\n"
+        "        v_mad_f32 v4, v5, s6, v7\n"
+        "        s_mov_b32 s1, cnt&0xffff\n"
+        "        v_mov_b32 v5, cnt*3\n"
+        "        .rept 2\n"
+        "        s_add_u32 s2, s3, s4\n"
+        "        v_cndmask_b32 v6, v7, v8, vcc\n"
+        "        .endr\n"
+        "        cnt = cnt+1\n"
+        "        .endr\n";
+    return oss.str();
+}
+
+// macro calls with arguments
+static std::string generateMacro(size_t instrsNum)
+{
+    std::ostringstream oss;
+    oss << "        .macro vadd dst, src0, src1, sc\n"
+        "        v_add_f32 \\dst, \\src0, \\src1\n"
+        "        v_mad_f32 \\dst, \\src0, \\sc, \\src1\n"
+        "        s_mov_b32 \\sc, 0x1234\n"
+        "        v_mov_b32 \\src1, \\sc\n"
+        "        .endm\n";
+    for (size_t i = 0; i < (instrsNum>>2); i++)
+        oss << "        vadd v" << (i%97) << ", v" << ((i+5)%101) << ", v" <<
+                ((i+11)%103) << ", s" << ((i+3)%50) << "\n";
+    return oss.str();
+}
+
+// symbols used before their definitions
+static std::string generateForwardRefs(size_t instrsNum)
+{
+    std::ostringstream oss;
+    const size_t symbolsNum = instrsNum>>1;
+    for (size_t i = 0; i < symbolsNum; i++)
+        oss << "        s_mov_b32 s1, sym" << i << "+sym" << (i+1) << "*2\n"
+            "        s_add_u32 s2, s3, sym" << i << "-(sym" << (i+1) << ">>1)\n"
+            "        val" << i << " = sym" << i << "+sym" << (i+1) << "\n";
+    for (size_t i = 0; i <= symbolsNum; i++)
+        oss << "sym" << i << " = " << (i*3) << "\n";
+    return oss.str();
+}
+
+// multi-kernel binary: kernels with 1000 instructions
+static void generateKernels(std::ostream& oss, size_t instrsNum, bool config)
+{
+    const size_t kernelsNum = std::max(instrsNum/1000, size_t(1));
+    for (size_t i = 0; i < kernelsNum; i++)
+    {
+        oss << ".kernel kernel" << i << "\n";
+        if (config)
+            oss << "    .config\n    .dims x\n    .sgprsnum 20\n    .vgprsnum 16\n";
+        oss << ".text\nkernel" << i << ":\n";
+        for (size_t j = 0; j < 999; j++)
+            oss << "        " << vop3Instrs[j&3] << (j%16) << ", v" << ((j+5)%16) <<
+                    ", s" << ((j+3)%20) << ", v" << ((j+11)%16) << "\n";
+        oss << "        s_endpgm\n";
+    }
+}
+
+static std::string generateAmd(size_t instrsNum)
+{
+    std::ostringstream oss;
+    oss << ".amd\n.gpu Pitcairn\n.driver_version 140000\n";
+    generateKernels(oss, instrsNum, true);
+    return oss.str();
+}
+
+static std::string generateAmdCL2(size_t instrsNum)
+{
+    std::ostringstream oss;
+    oss << ".amdcl2\n.gpu Tonga\n.driver_version 191205\n";
+    generateKernels(oss, instrsNum, true);
+    return oss.str();
+}
+
+static std::string generateGallium(size_t instrsNum)
+{
+    std::ostringstream oss;
+    oss << ".gallium\n.gpu Pitcairn\n";
+    const size_t kernelsNum = std::max(instrsNum/1000, size_t(1));
+    for (size_t i = 0; i < kernelsNum; i++)
+        oss << ".kernel kernel" << i << "\n    .args\n    .arg scalar, 4\n";
+    generateKernels(oss, instrsNum, false);
+    return oss.str();
+}
+
+static const Workload workloads[] =
+{
+    { "vop3", BinaryFormat::RAWCODE, GPUDeviceType::PITCAIRN, generateVOP3 },
+    { "rept", BinaryFormat::RAWCODE, GPUDeviceType::PITCAIRN, generateRept },
+    { "macro", BinaryFormat::RAWCODE, GPUDeviceType::PITCAIRN, generateMacro },
+    { "forwardref", BinaryFormat::RAWCODE, GPUDeviceType::PITCAIRN,
+        generateForwardRefs },
+    { "amd", BinaryFormat::AMD, GPUDeviceType::PITCAIRN, generateAmd },
+    { "amdcl2", BinaryFormat::AMDCL2, GPUDeviceType::TONGA, generateAmdCL2 },
+    { "gallium", BinaryFormat::GALLIUM, GPUDeviceType::PITCAIRN, generateGallium }
+};
+
+static const Flags disasmFlags = DISASM_DUMPCODE | DISASM_METADATA | DISASM_DUMPDATA |
+        DISASM_CALNOTES | DISASM_CONFIG;
+
+// disassemble binary, returns number of disassembled instructions
+static size_t disassembleBinary(BinaryFormat format, GPUDeviceType deviceType,
+            const Array<cxbyte>& binary, std::ostream& output)
+{
+    if (format == BinaryFormat::AMD)
+    {
+        std::unique_ptr<AmdMainBinaryBase> base(createAmdBinaryFromCode(binary.size(),
+                const_cast<cxbyte*>(binary.data()), AMDBIN_CREATE_KERNELINFO |
+                AMDBIN_CREATE_KERNELINFOMAP | AMDBIN_CREATE_INNERBINMAP |
+                AMDBIN_CREATE_KERNELHEADERS | AMDBIN_CREATE_KERNELHEADERMAP |
+                AMDBIN_INNER_CREATE_CALNOTES | AMDBIN_CREATE_INFOSTRINGS));
+        std::unique_ptr<Disassembler> disasm;
+        if (base->getType() == AmdMainType::GPU_BINARY)
+            disasm.reset(new Disassembler(
+                    *static_cast<AmdMainGPUBinary32*>(base.get()), output, disasmFlags));
+        else
+            disasm.reset(new Disassembler(
+                    *static_cast<AmdMainGPUBinary64*>(base.get()), output, disasmFlags));
+        disasm->disassemble();
+        return disasm->getInstrsNum();
+    }
+    else if (format == BinaryFormat::AMDCL2)
+    {
+        AmdCL2MainGPUBinary amdBin(binary.size(), const_cast<cxbyte*>(binary.data()),
+                AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_KERNELINFOMAP |
+                AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_KERNELHEADERS |
+                AMDBIN_CREATE_KERNELHEADERMAP | AMDBIN_CREATE_INFOSTRINGS |
+                AMDBIN_INNER_CREATE_KERNELDATA | AMDBIN_INNER_CREATE_KERNELDATAMAP |
+                AMDBIN_INNER_CREATE_KERNELSTUBS);
+        Disassembler disasm(amdBin, output, disasmFlags);
+        disasm.disassemble();
+        return disasm.getInstrsNum();
+    }
+    else if (format == BinaryFormat::GALLIUM)
+    {
+        GalliumBinary galliumBin(binary.size(), const_cast<cxbyte*>(binary.data()), 0);
+        Disassembler disasm(deviceType, galliumBin, output, disasmFlags);
+        disasm.disassemble();
+        return disasm.getInstrsNum();
+    }
+    Disassembler disasm(deviceType, binary.size(), binary.data(), output, disasmFlags);
+    disasm.disassemble();
+    return disasm.getInstrsNum();
+}
+
+static double perSecond(size_t value, double timeMs)
+{
+    return (timeMs > 0.0) ? double(value) * 1000.0 / timeMs : 0.0;
+}
+
+static bool runWorkload(const Workload& workload, size_t instrsNum, bool first)
+{
+    const std::string source = workload.generate(instrsNum);
+    const size_t sourceLines = std::count(source.begin(), source.end(), '\n');
+    
+    // assemble and write binary
+    std::istringstream input(source);
+    std::ostringstream errorStream;
+    Array<cxbyte> binary;
+    size_t startAllocs = getBenchHeapAllocationsNum();
+    size_t startAllocSize = getBenchHeapAllocatedSize();
+    BenchClock::time_point start = BenchClock::now();
+    {
+        Assembler assembler("bench.s", input, 0, workload.format,
+                    workload.deviceType, errorStream);
+        if (!assembler.assemble())
+        {
+            std::cerr << "Workload " << workload.name << ": " <<
+                    errorStream.str() << std::endl;
+            return false;
+        }
+        assembler.writeBinary(binary);
+    }
+    const double asmTime = elapsedMs(start);
+    const size_t asmAllocs = getBenchHeapAllocationsNum() - startAllocs;
+    const size_t asmAllocSize = getBenchHeapAllocatedSize() - startAllocSize;
+    
+    // disassemble binary
+    CountingStreamBuf countingBuf;
+    std::ostream disasmOutput(&countingBuf);
+    startAllocs = getBenchHeapAllocationsNum();
+    startAllocSize = getBenchHeapAllocatedSize();
+    start = BenchClock::now();
+    const size_t instrsDisasmNum = disassembleBinary(workload.format,
+                workload.deviceType, binary, disasmOutput);
+    const double disasmTime = elapsedMs(start);
+    const size_t disasmAllocs = getBenchHeapAllocationsNum() - startAllocs;
+    const size_t disasmAllocSize = getBenchHeapAllocatedSize() - startAllocSize;
+    
+    if (!first)
+        std::cout << ",\n";
+    std::cout << "    {\n"
+        "      \"name\": \"" << workload.name << "\",\n"
+        "      \"sourceLines\": " << sourceLines << ",\n"
+        "      \"sourceBytes\": " << source.size() << ",\n"
+        "      \"binaryBytes\": " << binary.size() << ",\n"
+        "      \"assemble\": {\n"
+        "        \"timeMs\": " << asmTime << ",\n"
+        "        \"linesPerSec\": " << perSecond(sourceLines, asmTime) << ",\n"
+        "        \"instrsPerSec\": " << perSecond(instrsDisasmNum, asmTime) << ",\n"
+        "        \"bytesPerSec\": " << perSecond(source.size(), asmTime) << ",\n"
+        "        \"allocations\": " << asmAllocs << ",\n"
+        "        \"allocatedBytes\": " << asmAllocSize << "\n"
+        "      },\n"
+        "      \"disassemble\": {\n"
+        "        \"timeMs\": " << disasmTime << ",\n"
+        "        \"instrs\": " << instrsDisasmNum << ",\n"
+        "        \"instrsPerSec\": " << perSecond(instrsDisasmNum, disasmTime) << ",\n"
+        "        \"bytesPerSec\": " << perSecond(binary.size(), disasmTime) << ",\n"
+        "        \"outputBytes\": " << countingBuf.getCounted() << ",\n"
+        "        \"allocations\": " << disasmAllocs << ",\n"
+        "        \"allocatedBytes\": " << disasmAllocSize << "\n"
+        "      },\n"
+        "      \"peakRssKB\": " << getPeakRSS() << "\n"
+        "    }";
+    return true;
+}
+
+int main(int argc, const char** argv)
+{
+    size_t instrsNum = 1000000;
+    const char* workloadName = nullptr;
+    if (argc >= 2)
+        instrsNum = ::strtoul(argv[1], nullptr, 10);
+    if (argc >= 3)
+        workloadName = argv[2];
+    
+    if (workloadName != nullptr && std::none_of(std::begin(workloads),
+            std::end(workloads), [workloadName](const Workload& workload)
+            { return ::strcmp(workloadName, workload.name) == 0; }))
+    {
+        std::cerr << "Unknown workload '" << workloadName << "'" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "{\n  \"instrs\": " << instrsNum << ",\n  \"workloads\": [\n";
+    bool first = true;
+    for (const Workload& workload: workloads)
+    {
+        if (workloadName != nullptr && ::strcmp(workloadName, workload.name) != 0)
+            continue;
+        if (!runWorkload(workload, instrsNum, first))
+            return 1;
+        first = false;
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+    return 0;
+}
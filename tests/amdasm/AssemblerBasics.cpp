@@ -3618,6 +3618,43 @@ loop:   .rept 10
             { "cloopc", 44U, 0, 0U, true, true, false, 0, 0 }
         },
         true, "", ""
+    },
+    /* prepared statements in repetitions and macros */
+    {   R"ffDXD(            .rawcode
+            cnt = 0
+            .rept 3
+            .if cnt==1
+            .macro s_nop x
+            .byte 0xaa
+            .endm
+            .endif
+            s_nop 0
+            cnt = cnt+1
+            .endr
+            .macro put a,b
+            \a \b
+            .endm
+            put .byte, 1
+            put .short, 2
+            put s_sleep, 3
+            .irp e, 0,=5
+            s_sleep \e
+            .endr
+            .irp e, 1,:
+            s_sethalt \e
+            .endr)ffDXD",
+        BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, false, { },
+        { { ".text", ASMKERN_GLOBAL, AsmSectionType::CODE,
+            { 0x00, 0x00, 0x80, 0xbf, 0xaa, 0xaa, 0x01, 0x02, 0x00,
+              0x03, 0x00, 0x8e, 0xbf, 0x00, 0x00, 0x8e, 0xbf,
+              0x01, 0x00, 0x8d, 0xbf } } },
+        {
+            { ".", 21U, 0, 0U, true, false, false, 0, 0 },
+            { "cnt", 3U, ASMSECT_ABS, 0U, true, false, false, 0, 0 },
+            { "s_sethalt", 21U, 0, 0U, true, true, false, 0, 0 },
+            { "s_sleep", 5U, ASMSECT_ABS, 0U, true, false, false, 0, 0 }
+        },
+        true, "", ""
     }
 };
 
@@ -0,0 +1,33 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef __CLRXTEST_BENCHALLOCCOUNTER_H__
+#define __CLRXTEST_BENCHALLOCCOUNTER_H__
+
+#include <cstddef>
+
+/* counting of heap allocations in benchmarks. BenchAllocCounter.cpp replaces
+ * global operator new and delete, and it must be linked to benchmark */
+
+// returns number of heap allocations since start of program
+size_t getBenchHeapAllocationsNum();
+// returns total size of heap allocations since start of program
+size_t getBenchHeapAllocatedSize();
+
+#endif
@@ -1241,7 +1241,8 @@ one1:
     }
 };
 
-static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
+static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase,
+            cxuint threadsNum)
 {
     std::ostringstream disasmOss;
     std::string resultStr;
@@ -1253,12 +1254,14 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
         if (testCase.amdInput != nullptr)
         {
             Disassembler disasm(testCase.amdInput, disasmOss, disasmFlags);
+            disasm.setThreadsNum(threadsNum);
             disasm.disassemble();
             resultStr = disasmOss.str();
         }
         else if (testCase.galliumInput != nullptr)
         {
             Disassembler disasm(testCase.galliumInput, disasmOss, disasmFlags);
+            disasm.setThreadsNum(threadsNum);
             disasm.disassemble();
             resultStr = disasmOss.str();
         }
@@ -1276,6 +1279,7 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
                     AMDBIN_CREATE_INFOSTRINGS));
             AmdMainGPUBinary32* amdGpuBin = static_cast<AmdMainGPUBinary32*>(base.get());
             Disassembler disasm(*amdGpuBin, disasmOss, disasmFlags);
+            disasm.setThreadsNum(threadsNum);
             disasm.disassemble();
             resultStr = disasmOss.str();
         }
@@ -1288,6 +1292,7 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
                 AMDBIN_CREATE_INFOSTRINGS | AMDBIN_INNER_CREATE_KERNELDATA |
                 AMDBIN_INNER_CREATE_KERNELDATAMAP | AMDBIN_INNER_CREATE_KERNELSTUBS);
             Disassembler disasm(amdBin, disasmOss, disasmFlags);
+            disasm.setThreadsNum(threadsNum);
             disasm.disassemble();
             resultStr = disasmOss.str();
         }
@@ -1296,6 +1301,7 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
             GalliumBinary galliumBin(binaryData.size(),binaryData.data(), 0);
             Disassembler disasm(GPUDeviceType::CAPE_VERDE, galliumBin,
                             disasmOss, disasmFlags);
+            disasm.setThreadsNum(threadsNum);
             disasm.disassemble();
             resultStr = disasmOss.str();
         }
@@ -1304,7 +1310,8 @@ static void testDisasmData(cxuint testId, const DisasmAmdTestCase& testCase)
     if (::strcmp(testCase.expectedString, resultStr.c_str()) != 0)
     {   // print error
         std::ostringstream oss;
-        oss << "Failed for #" << testId << std::endl;
+        oss << "Failed for #" << testId << " (threads: " << threadsNum << ")" <<
+                std::endl;
         oss << resultStr << std::endl;
         oss.flush();
         throw Exception(oss.str());
@@ -1315,12 +1322,13 @@ int main(int argc, const char** argv)
 {
     int retVal = 0;
     for (cxuint i = 0; i < sizeof(disasmDataTestCases)/sizeof(DisasmAmdTestCase); i++)
-        try
-        { testDisasmData(i, disasmDataTestCases[i]); }
-        catch(const std::exception& ex)
-        {
-            std::cerr << ex.what() << std::endl;
-            retVal = 1;
-        }
+        for (cxuint threadsNum: { 1, 4 })
+            try
+            { testDisasmData(i, disasmDataTestCases[i], threadsNum); }
+            catch(const std::exception& ex)
+            {
+                std::cerr << ex.what() << std::endl;
+                retVal = 1;
+            }
     return retVal;
 }
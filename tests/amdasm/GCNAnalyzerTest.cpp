@@ -0,0 +1,253 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include <CLRX/amdbin/AmdCL2Binaries.h>
+#include <CLRX/amdbin/GalliumBinaries.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/GCNAnalyzer.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* rawCodeSource = R"ffDXD(
+        s_load_dwordx4 s[4:7], s[0:1], 0x10
+        s_waitcnt lgkmcnt(0)
+        v_add_f32 v5, v2, v3
+        v_mad_f32 v9, v1, v2, v3
+        buffer_load_dwordx2 v[10:11], v1, s[8:11], 0 offen
+        ds_read_b32 v12, v1
+        v_cmp_gt_f32 vcc, v1, v2
+        s_waitcnt vmcnt(0) & lgkmcnt(0)
+        s_mov_b32 s20, 0x12345
+        s_endpgm
+)ffDXD";
+
+static Array<cxbyte> assembleSource(const std::string& testName, const char* source,
+            BinaryFormat binFormat, GPUDeviceType deviceType)
+{
+    std::istringstream input(source);
+    std::ostringstream msgStream;
+    Assembler assembler("test.s", input, ASM_WARNINGS, binFormat,
+                deviceType, msgStream);
+    Array<cxbyte> binary;
+    const bool good = assembler.assemble();
+    assertTrue(testName, "assemble: "+msgStream.str(), good);
+    assembler.writeBinary(binary);
+    return binary;
+}
+
+static void testGCNAnalyzeRawCode()
+{
+    const std::string testName = "testGCNAnalyzeRawCode";
+    const Array<cxbyte> code = assembleSource(testName, rawCodeSource,
+                BinaryFormat::RAWCODE, GPUDeviceType::PITCAIRN);
+    const GCNCodeStats stats = analyzeGCNCode(GPUArchitecture::GCN1_0,
+                code.size(), code.data());
+    assertValue(testName, "instrsNum", size_t(10), stats.instrsNum);
+    assertValue(testName, "illegalInstrsNum", size_t(0), stats.illegalInstrsNum);
+    assertValue(testName, "SMRD", size_t(1),
+                stats.encodingInstrsNum[cxuint(GCNEncoding::SMRD)]);
+    assertValue(testName, "SOPP", size_t(3),
+                stats.encodingInstrsNum[cxuint(GCNEncoding::SOPP)]);
+    assertValue(testName, "SOP1", size_t(1),
+                stats.encodingInstrsNum[cxuint(GCNEncoding::SOP1)]);
+    assertValue(testName, "VOP2", size_t(1),
+                stats.encodingInstrsNum[cxuint(GCNEncoding::VOP2)]);
+    assertValue(testName, "VOP3A", size_t(1),
+                stats.encodingInstrsNum[cxuint(GCNEncoding::VOP3A)]);
+    assertValue(testName, "VOPC", size_t(1),
+                stats.encodingInstrsNum[cxuint(GCNEncoding::VOPC)]);
+    assertValue(testName, "MUBUF", size_t(1),
+                stats.encodingInstrsNum[cxuint(GCNEncoding::MUBUF)]);
+    assertValue(testName, "DS", size_t(1),
+                stats.encodingInstrsNum[cxuint(GCNEncoding::DS)]);
+    assertValue(testName, "scalarMemOps", size_t(1), stats.scalarMemOps);
+    assertValue(testName, "vectorMemOps", size_t(1), stats.vectorMemOps);
+    assertValue(testName, "localMemOps", size_t(1), stats.localMemOps);
+    assertValue(testName, "waitcntsNum", size_t(2), stats.waitcntsNum);
+    assertValue(testName, "waitcntDensity", 0.2, stats.getWaitcntDensity());
+    assertValue(testName, "usedSGPRsNum", cxuint(21), stats.usedSGPRsNum);
+    assertValue(testName, "usedVGPRsNum", cxuint(13), stats.usedVGPRsNum);
+    assertValue(testName, "regFlags", Flags(GCN_VCC), stats.regFlags);
+    assertValue(testName, "occupancy", cxuint(10), stats.getOccupancy());
+
+    // unfinished instruction at end of code
+    const GCNCodeStats stats2 = analyzeGCNCode(GPUArchitecture::GCN1_0,
+                code.size()-8, code.data());
+    assertValue(testName, "instrsNum2", size_t(9), stats2.instrsNum);
+    assertValue(testName, "usedSGPRsNum2", cxuint(21), stats2.usedSGPRsNum);
+}
+
+static void testGCNOccupancy()
+{
+    const std::string testName = "testGCNOccupancy";
+    assertValue(testName, "vgprs", cxuint(3),
+            estimateGCNOccupancy(GPUArchitecture::GCN1_0, 10, 65, 0, 0));
+    assertValue(testName, "sgprs", cxuint(5),
+            estimateGCNOccupancy(GPUArchitecture::GCN1_1, 94, 10, GCN_VCC, 0));
+    assertValue(testName, "sgprsGCN12", cxuint(8),
+            estimateGCNOccupancy(GPUArchitecture::GCN1_2, 90, 10, GCN_VCC, 0));
+    assertValue(testName, "lds", cxuint(4),
+            estimateGCNOccupancy(GPUArchitecture::GCN1_0, 8, 8, 0, 16384, 256));
+    assertValue(testName, "ldsSmallGroup", cxuint(1),
+            estimateGCNOccupancy(GPUArchitecture::GCN1_0, 8, 8, 0, 16384, 64));
+    assertValue(testName, "tooManySGPRs", cxuint(0),
+            estimateGCNOccupancy(GPUArchitecture::GCN1_0, 103, 8, GCN_VCC, 0));
+    assertValue(testName, "tooManyVGPRs", cxuint(0),
+            estimateGCNOccupancy(GPUArchitecture::GCN1_0, 8, 257, 0, 0));
+}
+
+static const char* galliumSource = R"ffDXD(.gallium
+        .gpu Pitcairn
+        .kernel kernelA
+            .config
+            .dims x
+            .localsize 1024
+        .kernel kernelB
+            .config
+            .dims xy
+        .text
+kernelA:
+        s_load_dword s4, s[0:1], 0x0
+        s_waitcnt lgkmcnt(0)
+        v_mov_b32 v7, s4
+        ds_write_b32 v0, v7
+        s_endpgm
+kernelB:
+        v_add_i32 v3, vcc, v1, v2
+        s_endpgm
+)ffDXD";
+
+static void testGCNAnalyzeGallium()
+{
+    const std::string testName = "testGCNAnalyzeGallium";
+    Array<cxbyte> binary = assembleSource(testName, galliumSource,
+                BinaryFormat::GALLIUM, GPUDeviceType::PITCAIRN);
+    GalliumBinary galliumBin(binary.size(), binary.data(), 0);
+    const std::vector<GCNKernelStats> kernels = analyzeGCNKernels(
+                GPUDeviceType::PITCAIRN, galliumBin);
+    assertValue(testName, "kernelsNum", size_t(2), kernels.size());
+    assertString(testName, "kernelA.name", "kernelA", kernels[0].kernelName);
+    assertValue(testName, "kernelA.instrsNum", size_t(5), kernels[0].stats.instrsNum);
+    assertValue(testName, "kernelA.localMemOps", size_t(1), kernels[0].stats.localMemOps);
+    assertValue(testName, "kernelA.usedSGPRsNum", cxuint(5),
+                kernels[0].stats.usedSGPRsNum);
+    assertValue(testName, "kernelA.usedVGPRsNum", cxuint(8),
+                kernels[0].stats.usedVGPRsNum);
+    assertValue(testName, "kernelA.localSize", size_t(1024), kernels[0].stats.localSize);
+    assertValue(testName, "kernelA.regFlags", Flags(0), kernels[0].stats.regFlags);
+    assertString(testName, "kernelB.name", "kernelB", kernels[1].kernelName);
+    assertValue(testName, "kernelB.instrsNum", size_t(2), kernels[1].stats.instrsNum);
+    assertValue(testName, "kernelB.usedVGPRsNum", cxuint(4),
+                kernels[1].stats.usedVGPRsNum);
+    assertValue(testName, "kernelB.regFlags", Flags(GCN_VCC), kernels[1].stats.regFlags);
+}
+
+static const char* amdCL2Source = R"ffDXD(.amdcl2
+        .gpu Tonga
+        .driver_version 191205
+        .kernel kernelC
+            .config
+            .dims x
+            .localsize 2048
+        .text
+kernelC:
+        s_load_dwordx2 s[6:7], s[4:5], 0x0
+        s_waitcnt lgkmcnt(0)
+        flat_load_dword v5, v[1:2]
+        s_waitcnt vmcnt(0) & lgkmcnt(0)
+        v_mov_b32 v4, v5
+        s_endpgm
+)ffDXD";
+
+static void testGCNAnalyzeAmdCL2()
+{
+    const std::string testName = "testGCNAnalyzeAmdCL2";
+    Array<cxbyte> binary = assembleSource(testName, amdCL2Source,
+                BinaryFormat::AMDCL2, GPUDeviceType::TONGA);
+    AmdCL2MainGPUBinary amdBin(binary.size(), binary.data(),
+                AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_KERNELINFOMAP |
+                AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_KERNELHEADERS |
+                AMDBIN_CREATE_KERNELHEADERMAP | AMDBIN_INNER_CREATE_KERNELDATA |
+                AMDBIN_INNER_CREATE_KERNELDATAMAP | AMDBIN_INNER_CREATE_KERNELSTUBS);
+    const std::vector<GCNKernelStats> kernels = analyzeGCNKernels(amdBin);
+    assertValue(testName, "kernelsNum", size_t(1), kernels.size());
+    assertString(testName, "name", "kernelC", kernels[0].kernelName);
+    const GCNCodeStats& stats = kernels[0].stats;
+    assertTrue(testName, "arch", stats.arch == GPUArchitecture::GCN1_2);
+    assertValue(testName, "instrsNum", size_t(6), stats.instrsNum);
+    assertValue(testName, "SMEM", size_t(1),
+                stats.encodingInstrsNum[cxuint(GCNEncoding::SMEM)]);
+    assertValue(testName, "FLAT", size_t(1),
+                stats.encodingInstrsNum[cxuint(GCNEncoding::FLAT)]);
+    assertValue(testName, "scalarMemOps", size_t(1), stats.scalarMemOps);
+    assertValue(testName, "vectorMemOps", size_t(1), stats.vectorMemOps);
+    assertValue(testName, "waitcntsNum", size_t(2), stats.waitcntsNum);
+    assertValue(testName, "usedSGPRsNum", cxuint(8), stats.usedSGPRsNum);
+    assertValue(testName, "usedVGPRsNum", cxuint(6), stats.usedVGPRsNum);
+    assertValue(testName, "localSize", size_t(2048), stats.localSize);
+}
+
+static const char* amdSource = R"ffDXD(.amd
+        .gpu Pitcairn
+        .driver_version 140000
+        .kernel kernelD
+            .config
+            .dims x
+            .hwlocal 4096
+        .text
+            v_mov_b32 v9, 0
+            s_endpgm
+)ffDXD";
+
+static void testGCNAnalyzeAmd()
+{
+    const std::string testName = "testGCNAnalyzeAmd";
+    Array<cxbyte> binary = assembleSource(testName, amdSource,
+                BinaryFormat::AMD, GPUDeviceType::PITCAIRN);
+    AmdMainGPUBinary32 amdBin(binary.size(), binary.data(),
+                AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_KERNELINFOMAP |
+                AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_KERNELHEADERS |
+                AMDBIN_CREATE_KERNELHEADERMAP);
+    const std::vector<GCNKernelStats> kernels = analyzeGCNKernels(amdBin);
+    assertValue(testName, "kernelsNum", size_t(1), kernels.size());
+    assertString(testName, "name", "kernelD", kernels[0].kernelName);
+    assertValue(testName, "instrsNum", size_t(2), kernels[0].stats.instrsNum);
+    assertValue(testName, "usedVGPRsNum", cxuint(10), kernels[0].stats.usedVGPRsNum);
+    assertValue(testName, "localSize", size_t(4096), kernels[0].stats.localSize);
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testGCNAnalyzeRawCode);
+    retVal |= callTest(testGCNOccupancy);
+    retVal |= callTest(testGCNAnalyzeGallium);
+    retVal |= callTest(testGCNAnalyzeAmdCL2);
+    retVal |= callTest(testGCNAnalyzeAmd);
+    return retVal;
+}
@@ -0,0 +1,181 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <climits>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/GCNDecoder.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* gcn10Source = R"ffDXD(
+        s_load_dwordx2 s[4:5], s[0:1], 0x10
+        v_add_f32 v5, 1.0, v3
+        v_mul_f32 v6, 0x40490fdb, v1
+        v_addc_u32 v1, vcc, v2, v3, vcc
+        v_madak_f32 v1, v2, v3, 0x3f800000
+        v_cmp_gt_f32 vcc, s7, v2
+        ds_write_b32 v1, v2 offset:8
+        s_waitcnt lgkmcnt(0)
+        s_endpgm
+)ffDXD";
+
+static const char* gcn12Source = R"ffDXD(
+        s_load_dword s4, s[0:1], 0x10
+        s_mov_b64 s[8:9], flat_scratch
+        s_endpgm
+)ffDXD";
+
+struct OperandCase
+{
+    GCNOperandType type;
+    cxuint regsNum;
+    uint32_t value;
+};
+
+static Array<cxbyte> assembleSource(const std::string& testName, const char* source,
+            GPUDeviceType deviceType)
+{
+    std::istringstream input(source);
+    std::ostringstream msgStream;
+    Assembler assembler("test.s", input, ASM_WARNINGS, BinaryFormat::RAWCODE,
+                deviceType, msgStream);
+    Array<cxbyte> binary;
+    const bool good = assembler.assemble();
+    assertTrue(testName, "assemble: "+msgStream.str(), good);
+    assembler.writeBinary(binary);
+    return binary;
+}
+
+static void checkRecord(const std::string& testName, const GCNInstrRecord& record,
+            size_t offset, GCNEncoding encoding, cxuint length, const char* mnemonic,
+            std::initializer_list<OperandCase> operands)
+{
+    std::ostringstream oss;
+    oss << mnemonic << "@" << offset;
+    const std::string caseName = oss.str();
+    assertValue(testName, caseName+".offset", offset, record.offset);
+    assertValue(testName, caseName+".encoding", cxuint(encoding),
+                cxuint(record.encoding));
+    assertValue(testName, caseName+".length", length, cxuint(record.length));
+    assertString(testName, caseName+".mnemonic", mnemonic,
+                getGCNInstrMnemonic(record.instrId));
+    assertValue(testName, caseName+".operandsNum", cxuint(operands.size()),
+                cxuint(record.operandsNum));
+    cxuint i = 0;
+    for (const OperandCase& opCase: operands)
+    {
+        const GCNOperand& operand = record.operands[i];
+        std::ostringstream opOss;
+        opOss << caseName << ".operand#" << i;
+        assertValue(testName, opOss.str()+".type", cxuint(opCase.type),
+                    cxuint(operand.type));
+        assertValue(testName, opOss.str()+".regsNum", opCase.regsNum,
+                    cxuint(operand.regsNum));
+        assertValue(testName, opOss.str()+".value", opCase.value, operand.value);
+        i++;
+    }
+}
+
+static void testGCN10Decode()
+{
+    const std::string testName = "testGCN10Decode";
+    const Array<cxbyte> code = assembleSource(testName, gcn10Source,
+                GPUDeviceType::PITCAIRN);
+    std::vector<GCNInstrRecord> records;
+    // relocation in literal of v_madak_f32
+    const size_t relocOffsets[1] = { 28 };
+    decodeGCNCode(GPUArchitecture::GCN1_0, code.size(), code.data(), records,
+                1, relocOffsets);
+    assertValue(testName, "recordsNum", size_t(9), records.size());
+
+    checkRecord(testName, records[0], 0, GCNEncoding::SMRD, 1, "s_load_dwordx2",
+        { { GCNOperandType::SGPR, 2, 4 }, { GCNOperandType::SGPR, 2, 0 },
+          { GCNOperandType::IMMEDIATE, 0, 0x10 } });
+    assertValue(testName, "opcode0", cxuint(1), cxuint(records[0].opcode));
+    checkRecord(testName, records[1], 4, GCNEncoding::VOP2, 1, "v_add_f32",
+        { { GCNOperandType::VGPR, 1, 5 }, { GCNOperandType::CONSTANT, 1, 242 },
+          { GCNOperandType::VGPR, 1, 3 } });
+    checkRecord(testName, records[2], 8, GCNEncoding::VOP2, 2, "v_mul_f32",
+        { { GCNOperandType::VGPR, 1, 6 }, { GCNOperandType::LITERAL, 1, 0x40490fdb },
+          { GCNOperandType::VGPR, 1, 1 } });
+    checkRecord(testName, records[3], 16, GCNEncoding::VOP2, 1, "v_addc_u32",
+        { { GCNOperandType::VGPR, 1, 1 }, { GCNOperandType::SREG, 2, 106 },
+          { GCNOperandType::VGPR, 1, 2 }, { GCNOperandType::VGPR, 1, 3 },
+          { GCNOperandType::SREG, 2, 106 } });
+    checkRecord(testName, records[4], 20, GCNEncoding::VOP2, 2, "v_madak_f32",
+        { { GCNOperandType::VGPR, 1, 1 }, { GCNOperandType::VGPR, 1, 2 },
+          { GCNOperandType::VGPR, 1, 3 }, { GCNOperandType::LITERAL, 1, 0x3f800000 } });
+    checkRecord(testName, records[5], 28, GCNEncoding::VOPC, 1, "v_cmp_gt_f32",
+        { { GCNOperandType::SREG, 2, 106 }, { GCNOperandType::SGPR, 1, 7 },
+          { GCNOperandType::VGPR, 1, 2 } });
+    checkRecord(testName, records[6], 32, GCNEncoding::DS, 2, "ds_write_b32",
+        { { GCNOperandType::VGPR, 1, 1 }, { GCNOperandType::VGPR, 1, 2 },
+          { GCNOperandType::IMMEDIATE, 0, 8 } });
+    checkRecord(testName, records[7], 40, GCNEncoding::SOPP, 1, "s_waitcnt",
+        { { GCNOperandType::IMMEDIATE, 0, 0x7f } });
+    checkRecord(testName, records[8], 44, GCNEncoding::SOPP, 1, "s_endpgm", { });
+
+    // relocations
+    assertValue(testName, "relocIndex2", UINT_MAX, records[2].relocIndex);
+    assertValue(testName, "relocIndex4", UINT_MAX, records[4].relocIndex);
+    assertValue(testName, "relocIndex5", 0U, records[5].relocIndex);
+    assertValue(testName, "relocIndex6", UINT_MAX, records[6].relocIndex);
+
+    assertTrue(testName, "illegalMnemonic",
+                getGCNInstrMnemonic(GCNINSTR_ILLEGAL) == nullptr);
+}
+
+static void testGCN12Decode()
+{
+    const std::string testName = "testGCN12Decode";
+    const Array<cxbyte> code = assembleSource(testName, gcn12Source,
+                GPUDeviceType::TONGA);
+    std::vector<GCNInstrRecord> records;
+    decodeGCNCode(GPUArchitecture::GCN1_2, code.size(), code.data(), records);
+    assertValue(testName, "recordsNum", size_t(3), records.size());
+    checkRecord(testName, records[0], 0, GCNEncoding::SMEM, 2, "s_load_dword",
+        { { GCNOperandType::SGPR, 1, 4 }, { GCNOperandType::SGPR, 2, 0 },
+          { GCNOperandType::IMMEDIATE, 0, 0x10 } });
+    checkRecord(testName, records[1], 8, GCNEncoding::SOP1, 1, "s_mov_b64",
+        { { GCNOperandType::SGPR, 2, 8 }, { GCNOperandType::SREG, 2, 102 } });
+    checkRecord(testName, records[2], 12, GCNEncoding::SOPP, 1, "s_endpgm", { });
+    assertValue(testName, "relocIndex0", UINT_MAX, records[0].relocIndex);
+
+    // unfinished instruction at end of code
+    decodeGCNCode(GPUArchitecture::GCN1_2, 4, code.data(), records);
+    assertValue(testName, "recordsNum2", size_t(1), records.size());
+    assertValue(testName, "words1", 0U, records[0].words[1]);
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testGCN10Decode);
+    retVal |= callTest(testGCN12Decode);
+    return retVal;
+}
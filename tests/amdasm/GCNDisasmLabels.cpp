@@ -220,11 +220,11 @@ static const GCNDisasmLabelCase decGCN12LabelCases[] =
       ".L12_0:\n        s_branch        .L4_0\n" },
     { { 0xbf820002U, 0x4934d715U, 0x3d4cU, 0xbf82fffdU },  /* VOP2 : V_VMADAK_F16 */
       "        s_branch        .L12_0\n.L4_0:\n        v_madmk_f16     "
-      "v154, v21, 0x3d4c /* 1.3242h */, v107\n"
+      "v154, v21, 0x3d4c /* 1.324h */, v107\n"
       ".L12_0:\n        s_branch        .L4_0\n" },
     { { 0xbf820002U, 0x4b34d715U, 0x3d4cU, 0xbf82fffdU },  /* VOP2 : V_VMADAK_F16 */
       "        s_branch        .L12_0\n.L4_0:\n        v_madak_f16     "
-      "v154, v21, v107, 0x3d4c /* 1.3242h */\n"
+      "v154, v21, v107, 0x3d4c /* 1.324h */\n"
       ".L12_0:\n        s_branch        .L4_0\n" },
     { { 0xbf820001U, 0x7f3c0d4fU, 0xbf82fffeU },  /* VOP1 */
       "        s_branch        .L8_0\n.L4_0:\n        v_cvt_f32_u32   v158, v79\n"
@@ -237,7 +237,7 @@ static const GCNDisasmLabelCase decGCN12LabelCases[] =
       ".L8_0:\n        s_branch        .L4_0\n" },
     { { 0xbf820002U, 0x7c4192ffU, 0x3d4cU, 0xbf82fffdU },  /* VOPC with literal */
       "        s_branch        .L12_0\n.L4_0:\n        v_cmp_f_f16     "
-      "vcc, 0x3d4c /* 1.3242h */, v201\n.L12_0:\n        s_branch        .L4_0\n" },
+      "vcc, 0x3d4c /* 1.324h */, v201\n.L12_0:\n        s_branch        .L4_0\n" },
     { { 0xbf820002U, 0xd1d10037U, 0x07974d4fU, 0xbf82fffdU },  /* VOP3 */
       "        s_branch        .L12_0\n.L4_0:\n        v_min3_i32      v55, v79, v166, v229\n"
       ".L12_0:\n        s_branch        .L4_0\n" },
@@ -328,7 +328,7 @@ static void testDecGCNNamedLabels()
         "testLabel1=.-1\n"
         ".L4_0:\n"
         "nextInstr:\n"
-        "        v_sub_f32       v154, 0x11110000 /* 1.14384831e-28f */, v107\n"
+        "        v_sub_f32       v154, 0x11110000 /* 1.1438483e-28f */, v107\n"
         "        s_lshr_b32      s21, s2, s61\n"
         "        s_branch        nextInstr\n")
         throw Exception("FAILED namedLabelsTest: result: "+disOss.str());
@@ -458,6 +458,48 @@ static void testDecGCNRelocations()
         throw Exception("FAILED relocationTest: result: "+disOss.str());
 }
 
+/* testing instruction boundaries in code longer than 64 words
+ * (literals that look like jumps and unfinished instruction at end of block) */
+static void testDecGCNLongCode()
+{
+    Array<uint32_t> code(82);
+    code[0] = LEV(0xbf800000U); // s_nop
+    std::string expected = ".L0_0:\n        s_nop           0x0\n";
+    for (cxuint i = 0; i < 40; i++)
+    {   // s_mov_b32 with literal (s_branch code)
+        code[1+i*2] = LEV(0xbe8103ffU);
+        code[2+i*2] = LEV(0xbf82fffeU);
+        expected += "        s_mov_b32       s1, 0xbf82fffe\n";
+    }
+    code[81] = LEV(0xbf82ffaeU);
+    expected += "        s_branch        .L0_0\n";
+    
+    for (cxuint k = 0; k < 2; k++)
+    {
+        std::ostringstream disOss;
+        AmdDisasmInput input;
+        input.deviceType = GPUDeviceType::PITCAIRN;
+        input.is64BitMode = false;
+        Disassembler disasm(&input, disOss, DISASM_FLOATLITS);
+        GCNDisassembler gcnDisasm(disasm);
+        if (k == 1)
+        {   // 63 s_nop and s_mov_b32 without literal
+            std::fill(code.begin(), code.begin()+63, LEV(0xbf800000U));
+            code[63] = LEV(0xbe8103ffU);
+            expected = "        /* WARNING: Unfinished instruction at end! */\n";
+            for (cxuint i = 0; i < 63; i++)
+                expected += "        s_nop           0x0\n";
+            expected += "        s_mov_b32       s1, lit(0)\n";
+        }
+        gcnDisasm.setInput(k==0 ? code.size()<<2 : 64<<2,
+                    reinterpret_cast<const cxbyte*>(code.data()));
+        gcnDisasm.beforeDisassemble();
+        gcnDisasm.disassemble();
+        if (disOss.str() != expected)
+            throw Exception("FAILED longCodeTest: result: "+disOss.str());
+    }
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -490,6 +532,7 @@ int main(int argc, const char** argv)
     {
         testDecGCNNamedLabels();
         testDecGCNRelocations();
+        testDecGCNLongCode();
     }
     catch(const std::exception& ex)
     {
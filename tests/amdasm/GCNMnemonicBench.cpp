@@ -0,0 +1,119 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+
+using namespace CLRX;
+
+/* benchmark of the mnemonic lookup in GCNAssembler.
+ * measures GCNAssembler::checkMnemonic and whole assembling of the synthetic source.
+ * usage: GCNMnemonicBench [REPEATS] */
+
+static const char* benchMnemonics[] =
+{
+    "s_mov_b32", "s_add_u32", "s_and_b64", "s_waitcnt", "s_nop", "s_endpgm",
+    "s_load_dwordx4", "s_buffer_load_dword", "s_cmp_eq_u32", "s_cbranch_scc0",
+    "v_mov_b32", "v_add_f32", "v_mul_f32", "v_mad_f32", "v_cndmask_b32",
+    "v_cmp_gt_f32", "v_lshlrev_b32", "v_and_b32", "v_mac_f32", "v_rcp_f32",
+    "v_cvt_f32_u32", "v_readfirstlane_b32", "v_fma_f32", "v_bfe_u32",
+    "ds_read_b32", "ds_write_b32", "buffer_load_dword", "buffer_store_dword",
+    "tbuffer_load_format_x", "image_sample", "v_interp_p1_f32", "v_add_i32",
+    "v_sub_f32_e64", "v_min_f32_e32", "unknown_instr", "v_max_i32"
+};
+
+static const char* benchSourceLines[] =
+{
+    "s_mov_b32 s1, s2",
+    "s_add_u32 s5, s6, s7",
+    "s_waitcnt vmcnt(0) & lgkmcnt(0)",
+    "v_mov_b32 v1, v2",
+    "v_add_f32 v1, v2, v3",
+    "v_mul_f32 v5, v6, v7",
+    "v_mad_f32 v1, v2, v3, v4",
+    "v_cndmask_b32 v1, v2, v3, vcc",
+    "v_cmp_gt_f32 vcc, v1, v2",
+    "v_lshlrev_b32 v4, 2, v4",
+    "ds_read_b32 v1, v2",
+    "buffer_load_dword v1, v2, s[4:7], s1 offen",
+    "s_nop 1"
+};
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static double elapsedMs(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(BenchClock::now()-start).count();
+}
+
+int main(int argc, const char** argv)
+{
+    size_t repeats = 200000;
+    if (argc >= 2)
+        repeats = ::strtoul(argv[1], nullptr, 10);
+    const size_t mnemonicsNum = sizeof(benchMnemonics)/sizeof(const char*);
+    
+    std::istringstream emptyInput("");
+    std::ostringstream errorStream;
+    Assembler assembler("bench.s", emptyInput, 0, BinaryFormat::GALLIUM,
+                GPUDeviceType::TONGA, errorStream);
+    GCNAssembler gcnAsm(assembler);
+    
+    std::vector<CString> mnemonics(benchMnemonics, benchMnemonics+mnemonicsNum);
+    size_t found = 0;
+    BenchClock::time_point start = BenchClock::now();
+    for (size_t r = 0; r < repeats; r++)
+        for (const CString& mnemonic: mnemonics)
+            found += gcnAsm.checkMnemonic(mnemonic);
+    const double lookupTime = elapsedMs(start);
+    
+    const double lookups = double(repeats)*mnemonicsNum;
+    std::cout << "Lookups: " << size_t(lookups) << " (found " << found << ")\n";
+    std::cout << "checkMnemonic: " << lookupTime << " ms, " <<
+            (lookupTime*1e6/lookups) << " ns/lookup\n";
+    
+    // assemble synthetic source
+    std::string source;
+    const size_t linesNum = sizeof(benchSourceLines)/sizeof(const char*);
+    for (size_t r = 0; r < (repeats>>4)+1; r++)
+        for (const char* line: benchSourceLines)
+            source.append(line).append("\n");
+    std::istringstream input(source);
+    Assembler sourceAsm("bench.s", input, 0, BinaryFormat::GALLIUM,
+                GPUDeviceType::TONGA, errorStream);
+    start = BenchClock::now();
+    const bool good = sourceAsm.assemble();
+    const double asmTime = elapsedMs(start);
+    const double lines = double((repeats>>4)+1)*linesNum;
+    std::cout << "Assembling " << size_t(lines) << " lines: " << asmTime << " ms, " <<
+            (lines*1e3/asmTime) << " lines/s" << std::endl;
+    if (!good)
+    {
+        std::cerr << errorStream.str() << std::endl;
+        return 1;
+    }
+    return 0;
+}
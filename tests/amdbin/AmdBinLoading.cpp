@@ -20,6 +20,8 @@
 #include <CLRX/Config.h>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <vector>
 #include <CLRX/utils/Containers.h>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/amdbin/AmdBinaries.h>
@@ -490,6 +492,80 @@ static void testKernelArgs(const char* filename, const char* kernelName,
     }
 }
 
+static void testLazyLoading(const char* filename)
+{
+    const std::string testName = std::string("testLazyLoading:") + filename;
+    
+    Array<cxbyte> data = loadDataFromFile(filename);
+    std::unique_ptr<AmdMainGPUBinaryBase> eager(static_cast<AmdMainGPUBinaryBase*>(
+                createAmdBinaryFromCode(data.size(), data.data())));
+    std::unique_ptr<AmdMainGPUBinaryBase> lazy(static_cast<AmdMainGPUBinaryBase*>(
+                createAmdBinaryFromCode(data.size(), data.data(),
+                        AMDBIN_CREATE_ALL | AMDBIN_CREATE_LAZY)));
+    
+    const size_t kernelsNum = eager->getKernelInfosNum();
+    assertValue(testName, "kernelInfosNum", kernelsNum, lazy->getKernelInfosNum());
+    assertValue(testName, "innerBinariesNum", eager->getInnerBinariesNum(),
+                lazy->getInnerBinariesNum());
+    
+    // access to kernels by name from many threads at once
+    const cxuint threadsNum = 4;
+    std::vector<std::vector<const KernelInfo*> > threadKernelInfos(threadsNum);
+    std::vector<std::vector<const AmdInnerGPUBinary32*> >
+            threadInnerBinaries(threadsNum);
+    std::vector<std::thread> threads;
+    for (cxuint t = 0; t < threadsNum; t++)
+        threads.push_back(std::thread([&lazy, &eager, &threadKernelInfos,
+                        &threadInnerBinaries, kernelsNum, t]()
+        {
+            for (size_t i = 0; i < kernelsNum; i++)
+            {
+                // every thread gets kernels in other order
+                const size_t k = (t&1) ? kernelsNum-1-i : i;
+                const char* name = eager->getKernelInfo(k).kernelName.c_str();
+                threadKernelInfos[t].push_back(&lazy->getKernelInfo(name));
+                threadInnerBinaries[t].push_back(&lazy->getInnerBinary(name));
+            }
+        }));
+    for (std::thread& thread: threads)
+        thread.join();
+    
+    for (cxuint t = 0; t < threadsNum; t++)
+        for (size_t i = 0; i < kernelsNum; i++)
+        {
+            const size_t k = (t&1) ? kernelsNum-1-i : i;
+            std::ostringstream oss;
+            oss << "thread" << t << " kernel#" << k;
+            const std::string caseName = oss.str();
+            const KernelInfo& expKernelInfo = eager->getKernelInfo(k);
+            const KernelInfo& kernelInfo = *threadKernelInfos[t][i];
+            assertValue(testName, caseName+" kernelInfo", &lazy->getKernelInfo(k),
+                        &kernelInfo);
+            assertValue(testName, caseName+" kernelName", expKernelInfo.kernelName,
+                        kernelInfo.kernelName);
+            assertValue(testName, caseName+" argInfosNum", expKernelInfo.argInfos.size(),
+                        kernelInfo.argInfos.size());
+            for (size_t j = 0; j < kernelInfo.argInfos.size(); j++)
+            {
+                assertValue(testName, caseName+" argName",
+                        expKernelInfo.argInfos[j].argName, kernelInfo.argInfos[j].argName);
+                assertValue(testName, caseName+" argType",
+                        cxuint(expKernelInfo.argInfos[j].argType),
+                        cxuint(kernelInfo.argInfos[j].argType));
+            }
+            const AmdInnerGPUBinary32& expInnerBin =
+                    eager->getInnerBinary(expKernelInfo.kernelName.c_str());
+            const AmdInnerGPUBinary32& innerBin = *threadInnerBinaries[t][i];
+            assertValue(testName, caseName+" innerKernelName",
+                        expInnerBin.getKernelName(), innerBin.getKernelName());
+            assertValue(testName, caseName+" innerSize", expInnerBin.getSize(),
+                        innerBin.getSize());
+            assertValue(testName, caseName+" innerSectionsNum",
+                        expInnerBin.getSectionHeadersNum(),
+                        innerBin.getSectionHeadersNum());
+        }
+}
+
 static const cxbyte defaultHeader[32] = { };
 
 static AmdMainGPUBinaryBase* genAmdBinWithMetadata(const std::string& metadata)
@@ -653,6 +729,10 @@ int main(int argc, const char** argv)
     retVal |= callTest(testKernelArgs, CLRX_SOURCE_DIR
             "/tests/amdbin/amdbins/structkernel2_cpu64.clo", "myKernel1",
             sizeof(expectedCPUKernelArgs2)/sizeof(AmdKernelArg), expectedCPUKernelArgs2);
+    retVal |= callTest(testLazyLoading, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/prginfo8_14_12.clo.1_0.reconf");
+    retVal |= callTest(testLazyLoading, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/prginfo8_14_12_64.clo.1_0.reconf");
     retVal |= callTest(testAmdGPUMetadataGen);
     
     for (cxuint i = 0; i < sizeof(binLoadingTestCases)/sizeof(BinLoadingFailCase); i++)
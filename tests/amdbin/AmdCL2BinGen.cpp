@@ -19,6 +19,7 @@
 
 #include <CLRX/Config.h>
 #include <iostream>
+#include <algorithm>
 #include <sstream>
 #include <map>
 #include <memory>
@@ -684,6 +685,19 @@ static void testOrigBinary(cxuint testCase, const char* origBinaryFilename, bool
                     ": byte=" << i;
             throw Exception(oss.str());
         }
+    
+    // parallel preparing of kernels must give same binary
+    Array<cxbyte> parallelOutput;
+    binGen.setThreadsNum(4);
+    binGen.generate(parallelOutput);
+    if (parallelOutput.size() != output.size() ||
+        !std::equal(output.begin(), output.end(), parallelOutput.begin()))
+    {
+        std::ostringstream oss;
+        oss << "Failed for #" << testCase << " file=" << origBinaryFilename <<
+                ": parallel generation differs";
+        throw Exception(oss.str());
+    }
 }
 
 int main(int argc, const char** argv)
@@ -0,0 +1,313 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <cstdlib>
+#include <CLRX/utils/Utilities.h>
+#include "../../clwrapper/DispatchStruct.h"
+
+using namespace CLRX;
+
+/* benchmark of overhead of CLRXWrapper with mock of AMD OpenCL implementation.
+ * calls of clSetKernelArg, clEnqueueNDRangeKernel and clCreateKernel are
+ * measured directly in mock (through its dispatch table) and through the wrapper.
+ * next, building by assembler (-xasm) is measured for single thread and many threads
+ * and for repeated builds of same program (cache of assembled binaries).
+ * cache is enabled and placed in CLWrapperBenchCache directory in current directory,
+ * unless CLRX_ASMCACHE_DIR is set.
+ * usage: CLWrapperBench MOCKOPENCL_PATH [ITERATIONS [BUILDS]] */
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static void checkCLError(cl_int error, const char* what)
+{
+    if (error != CL_SUCCESS)
+    {
+        std::ostringstream oss;
+        oss << what << " failed with error " << error;
+        throw Exception(oss.str());
+    }
+}
+
+/* generate program with kernels with many instructions,
+ * uniqueId makes source different for each build (to avoid cache hits) */
+static std::string generateSource(cxuint kernelsNum, cxuint instrsNum, size_t uniqueId)
+{
+    std::ostringstream oss;
+    oss << "# build " << uniqueId << "\n";
+    for (cxuint k = 0; k < kernelsNum; k++)
+    {
+        oss << ".kernel benchKernel" << k << "\n"
+            "    .config\n"
+            "        .dims x\n"
+            "        .arg n, uint\n"
+            "        .arg buf, uint*, global\n"
+            "    .text\n";
+        for (cxuint i = 0; i < instrsNum; i++)
+            oss << "        v_add_i32 v" << (i&15) << ", vcc, s" << (i&7) <<
+                    ", v" << ((i+1)&15) << "\n"
+                "        s_mul_i32 s" << (8+(i&7)) << ", s" << (i&7) << ", 0x" <<
+                    std::hex << (i*17+k) << std::dec << "\n";
+        oss << "        s_endpgm\n";
+    }
+    return oss.str();
+}
+
+struct BenchObjects
+{
+    CLRXIcdDispatch* dispatch;
+    cl_context context;
+    cl_command_queue queue;
+    cl_program program;
+    cl_kernel kernel;
+    cl_mem buffer;
+};
+
+template<typename Call>
+static double measureNs(size_t iterations, Call call)
+{
+    const auto start = BenchClock::now();
+    for (size_t i = 0; i < iterations; i++)
+        call();
+    return std::chrono::duration<double, std::nano>(BenchClock::now()-start).count() /
+            iterations;
+}
+
+static void runCallBench(const BenchObjects& objs, size_t iterations, double* results)
+{
+    const CLRXIcdDispatch* d = objs.dispatch;
+    const cl_uint n = 1024;
+    const size_t workSize = 1024;
+    results[0] = measureNs(iterations, [&objs, d, n]()
+    {
+        checkCLError(d->clSetKernelArg(objs.kernel, 0, sizeof(cl_uint), &n),
+                    "clSetKernelArg");
+        checkCLError(d->clSetKernelArg(objs.kernel, 1, sizeof(cl_mem), &objs.buffer),
+                    "clSetKernelArg");
+    }) / 2;
+    results[1] = measureNs(iterations, [&objs, d, workSize]()
+    {
+        checkCLError(d->clEnqueueNDRangeKernel(objs.queue, objs.kernel, 1, nullptr,
+                    &workSize, nullptr, 0, nullptr, nullptr), "clEnqueueNDRangeKernel");
+    });
+    checkCLError(d->clFinish(objs.queue), "clFinish");
+    results[2] = measureNs(iterations, [&objs, d, workSize]()
+    {
+        cl_event event;
+        checkCLError(d->clEnqueueNDRangeKernel(objs.queue, objs.kernel, 1, nullptr,
+                    &workSize, nullptr, 0, nullptr, &event), "clEnqueueNDRangeKernel");
+        checkCLError(d->clReleaseEvent(event), "clReleaseEvent");
+    });
+    checkCLError(d->clFinish(objs.queue), "clFinish");
+    results[3] = measureNs(std::max(iterations/10, size_t(1)), [&objs, d]()
+    {
+        cl_int error;
+        cl_kernel kernel = d->clCreateKernel(objs.program, "benchKernel0", &error);
+        checkCLError(error, "clCreateKernel");
+        checkCLError(d->clReleaseKernel(kernel), "clReleaseKernel");
+    });
+}
+
+/* create objects to benchmark. if binary is not given, program is built by
+ * assembler (wrapper), otherwise program is created from binary (mock) */
+static void createObjects(BenchObjects& objs, cl_platform_id platform,
+            const std::vector<unsigned char>& binary)
+{
+    objs.dispatch = platform->dispatch;
+    const CLRXIcdDispatch* d = objs.dispatch;
+    cl_int error;
+    cl_device_id device;
+    checkCLError(d->clGetDeviceIDs(platform, CL_DEVICE_TYPE_GPU, 1, &device, nullptr),
+                "clGetDeviceIDs");
+    objs.context = d->clCreateContext(nullptr, 1, &device, nullptr, nullptr, &error);
+    checkCLError(error, "clCreateContext");
+    objs.queue = d->clCreateCommandQueue(objs.context, device, 0, &error);
+    checkCLError(error, "clCreateCommandQueue");
+    if (binary.empty())
+    {
+        const std::string source = generateSource(1, 16, 0);
+        const char* sourceStr = source.c_str();
+        objs.program = d->clCreateProgramWithSource(objs.context, 1, &sourceStr,
+                    nullptr, &error);
+        checkCLError(error, "clCreateProgramWithSource");
+        checkCLError(d->clBuildProgram(objs.program, 1, &device, "-xasm",
+                    nullptr, nullptr), "clBuildProgram");
+    }
+    else
+    {
+        const size_t binarySize = binary.size();
+        const unsigned char* binaryPtr = binary.data();
+        objs.program = d->clCreateProgramWithBinary(objs.context, 1, &device,
+                    &binarySize, &binaryPtr, nullptr, &error);
+        checkCLError(error, "clCreateProgramWithBinary");
+        checkCLError(d->clBuildProgram(objs.program, 1, &device, "",
+                    nullptr, nullptr), "clBuildProgram");
+    }
+    objs.kernel = d->clCreateKernel(objs.program, "benchKernel0", &error);
+    checkCLError(error, "clCreateKernel");
+    objs.buffer = d->clCreateBuffer(objs.context, 0, 4096, nullptr, &error);
+    checkCLError(error, "clCreateBuffer");
+}
+
+static std::vector<unsigned char> getProgramBinary(const BenchObjects& objs)
+{
+    const CLRXIcdDispatch* d = objs.dispatch;
+    size_t binarySize;
+    checkCLError(d->clGetProgramInfo(objs.program, CL_PROGRAM_BINARY_SIZES,
+                sizeof(size_t), &binarySize, nullptr), "clGetProgramInfo");
+    std::vector<unsigned char> binary(binarySize);
+    unsigned char* binaryPtr = binary.data();
+    checkCLError(d->clGetProgramInfo(objs.program, CL_PROGRAM_BINARIES,
+                sizeof(unsigned char*), &binaryPtr, nullptr), "clGetProgramInfo");
+    return binary;
+}
+
+static void releaseObjects(const BenchObjects& objs)
+{
+    const CLRXIcdDispatch* d = objs.dispatch;
+    d->clReleaseMemObject(objs.buffer);
+    d->clReleaseKernel(objs.kernel);
+    d->clReleaseProgram(objs.program);
+    d->clReleaseCommandQueue(objs.queue);
+    d->clReleaseContext(objs.context);
+}
+
+/* build program for all devices, returns time in milliseconds */
+static double buildProgram(cl_context context, const std::string& source)
+{
+    cl_int error;
+    const char* sourceStr = source.c_str();
+    const auto start = BenchClock::now();
+    cl_program program = clCreateProgramWithSource(context, 1, &sourceStr,
+                nullptr, &error);
+    checkCLError(error, "clCreateProgramWithSource");
+    checkCLError(clBuildProgram(program, 0, nullptr, "-xasm", nullptr, nullptr),
+                "clBuildProgram");
+    const double time = std::chrono::duration<double, std::milli>(
+                BenchClock::now()-start).count();
+    clReleaseProgram(program);
+    return time;
+}
+
+static void runBuildBench(cl_platform_id platform, size_t buildsNum)
+{
+    cl_int error;
+    cl_uint devicesNum;
+    checkCLError(clGetDeviceIDs(platform, CL_DEVICE_TYPE_GPU, 0, nullptr, &devicesNum),
+                "clGetDeviceIDs");
+    std::vector<cl_device_id> devices(devicesNum);
+    checkCLError(clGetDeviceIDs(platform, CL_DEVICE_TYPE_GPU, devicesNum,
+                devices.data(), nullptr), "clGetDeviceIDs");
+    cl_context context = clCreateContext(nullptr, devicesNum, devices.data(),
+                nullptr, nullptr, &error);
+    checkCLError(error, "clCreateContext");
+
+    const cxuint threadsNum = std::max(std::thread::hardware_concurrency(), 1U);
+    // unique identifier of source for every run of benchmark to avoid cache hits
+    const size_t runId = std::chrono::system_clock::now().time_since_epoch().count();
+    size_t uniqueId = 0;
+    std::cout << "Build -xasm (" << devicesNum << " devices, 8 kernels):\n";
+    std::vector<cxuint> threadsNums = { 1U };
+    if (threadsNum > 1)
+        threadsNums.push_back(threadsNum);
+    for (cxuint threads: threadsNums)
+    {
+        ::setenv("CLRX_ASM_THREADS", std::to_string(threads).c_str(), 1);
+        double time = 0.0;
+        for (size_t i = 0; i < buildsNum; i++)
+            time += buildProgram(context, generateSource(8, 500, runId + uniqueId++));
+        std::cout << "  " << threads << " threads: " << time/buildsNum <<
+                " ms per build\n";
+    }
+    const std::string source = generateSource(8, 500, runId + uniqueId++);
+    std::cout << "  first build: " << buildProgram(context, source) << " ms\n";
+    double time = 0.0;
+    for (size_t i = 0; i < buildsNum; i++)
+        time += buildProgram(context, source);
+    std::cout << "  repeated build (cached): " << time/buildsNum << " ms per build\n";
+    clReleaseContext(context);
+}
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: CLWrapperBench MOCKOPENCL_PATH [ITERATIONS [BUILDS]]" <<
+                std::endl;
+        return 1;
+    }
+    size_t iterations = 1000000;
+    size_t buildsNum = 10;
+    if (argc >= 3)
+        iterations = std::max(::strtoul(argv[2], nullptr, 10), 1UL);
+    if (argc >= 4)
+        buildsNum = std::max(::strtoul(argv[3], nullptr, 10), 1UL);
+    // must be set before first call of OpenCL function
+    ::setenv("CLRX_AMDOCL_PATH", argv[1], 1);
+    ::setenv("CLRX_ASMCACHE", "1", 1);
+    ::setenv("CLRX_ASMCACHE_DIR", "CLWrapperBenchCache", 0);
+    try
+    {
+        cl_platform_id platform;
+        checkCLError(clGetPlatformIDs(1, &platform, nullptr), "clGetPlatformIDs");
+        BenchObjects wrapperObjs;
+        createObjects(wrapperObjs, platform, {});
+
+        // get platform directly from mock
+        DynLibrary mockLibrary(argv[1], DYNLIB_NOW);
+        typedef cl_int (CL_API_CALL *GetPlatformIDsFn)(cl_uint, cl_platform_id*,
+                    cl_uint*);
+        GetPlatformIDsFn mockGetPlatformIDs = (GetPlatformIDsFn)
+                mockLibrary.getSymbol("clIcdGetPlatformIDsKHR");
+        cl_platform_id mockPlatform;
+        checkCLError(mockGetPlatformIDs(1, &mockPlatform, nullptr),
+                    "clIcdGetPlatformIDsKHR");
+        BenchObjects mockObjs;
+        createObjects(mockObjs, mockPlatform, getProgramBinary(wrapperObjs));
+
+        double mockResults[4], wrapperResults[4];
+        runCallBench(mockObjs, iterations, mockResults);
+        runCallBench(wrapperObjs, iterations, wrapperResults);
+        const char* callNames[4] = { "clSetKernelArg", "clEnqueueNDRangeKernel",
+                "clEnqueueNDRangeKernel+event", "clCreateKernel+release" };
+        std::cout << "Iterations: " << iterations << "\n";
+        for (cxuint i = 0; i < 4; i++)
+            std::cout << callNames[i] << ": mock " << mockResults[i] <<
+                    " ns, wrapper " << wrapperResults[i] << " ns, overhead " <<
+                    (wrapperResults[i]-mockResults[i]) << " ns per call\n";
+        releaseObjects(mockObjs);
+        releaseObjects(wrapperObjs);
+
+        runBuildBench(platform, buildsNum);
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    std::cout.flush();
+    return 0;
+}
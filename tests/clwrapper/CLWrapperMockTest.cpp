@@ -0,0 +1,226 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <CL/cl.h>
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+/* test of CLRXWrapper with mock of AMD OpenCL implementation (MockOpenCL).
+ * usage: CLWrapperMockTest MOCKOPENCL_PATH */
+
+static const char* testKernelSource = R"ffDXD(
+.kernel testKernel
+    .config
+        .dims x
+        .arg n, uint
+        .arg buf, uint*, global
+    .text
+        s_endpgm
+.kernel testKernel2
+    .config
+        .dims x
+        .arg buf, uint*, global
+    .text
+        s_endpgm
+)ffDXD";
+
+static void assertCLSuccess(const std::string& testName, const std::string& caseName,
+            cl_int error)
+{ assertValue(testName, caseName, cl_int(CL_SUCCESS), error); }
+
+static std::string getDeviceString(cl_device_id device, cl_device_info paramName)
+{
+    size_t size = 0;
+    if (clGetDeviceInfo(device, paramName, 0, nullptr, &size) != CL_SUCCESS)
+        throw Exception("Can't get device info");
+    std::vector<char> buf(size);
+    if (clGetDeviceInfo(device, paramName, size, buf.data(), nullptr) != CL_SUCCESS)
+        throw Exception("Can't get device info");
+    return buf.data();
+}
+
+static cl_platform_id getPlatform(const std::string& testName)
+{
+    cl_uint platformsNum = 0;
+    assertCLSuccess(testName, "getPlatformsNum",
+                clGetPlatformIDs(0, nullptr, &platformsNum));
+    assertValue(testName, "platformsNum", cl_uint(1), platformsNum);
+    cl_platform_id platform = nullptr;
+    assertCLSuccess(testName, "getPlatforms", clGetPlatformIDs(1, &platform, nullptr));
+    return platform;
+}
+
+static void testPlatformAndDevices()
+{
+    const std::string testName = "testPlatformAndDevices";
+    cl_platform_id platform = getPlatform(testName);
+    char extensions[512];
+    assertCLSuccess(testName, "getExtensions", clGetPlatformInfo(platform,
+                CL_PLATFORM_EXTENSIONS, sizeof(extensions), extensions, nullptr));
+    // extensions of CLRXWrapper
+    assertTrue(testName, "radeonExtender",
+                ::strstr(extensions, "cl_radeon_extender") != nullptr);
+
+    cl_uint devicesNum = 0;
+    assertCLSuccess(testName, "getDevicesNum", clGetDeviceIDs(platform,
+                CL_DEVICE_TYPE_ALL, 0, nullptr, &devicesNum));
+    assertValue(testName, "devicesNum", cl_uint(3), devicesNum);
+    cl_device_id devices[3];
+    assertCLSuccess(testName, "getDevices", clGetDeviceIDs(platform,
+                CL_DEVICE_TYPE_GPU, 3, devices, nullptr));
+    const char* deviceNames[3] = { "Pitcairn", "Tonga", "Fiji" };
+    for (cxuint i = 0; i < 3; i++)
+    {
+        assertString(testName, "deviceName", deviceNames[i],
+                    getDeviceString(devices[i], CL_DEVICE_NAME));
+        cl_platform_id devPlatform = nullptr;
+        assertCLSuccess(testName, "getDevicePlatform", clGetDeviceInfo(devices[i],
+                    CL_DEVICE_PLATFORM, sizeof(cl_platform_id), &devPlatform, nullptr));
+        // wrapper must return own platform
+        assertTrue(testName, "devicePlatform", devPlatform == platform);
+    }
+}
+
+static void CL_CALLBACK testEventCallback(cl_event event, cl_int status, void* userData)
+{
+    if (status == CL_COMPLETE)
+        *static_cast<cxuint*>(userData) += 1;
+}
+
+static void testBuildAndEnqueue()
+{
+    const std::string testName = "testBuildAndEnqueue";
+    cl_platform_id platform = getPlatform(testName);
+    cl_device_id devices[3];
+    assertCLSuccess(testName, "getDevices", clGetDeviceIDs(platform,
+                CL_DEVICE_TYPE_GPU, 3, devices, nullptr));
+    cl_int error;
+    cl_context_properties props[3] = { CL_CONTEXT_PLATFORM,
+                cl_context_properties(platform), 0 };
+    cl_context context = clCreateContext(props, 3, devices, nullptr, nullptr, &error);
+    assertCLSuccess(testName, "createContext", error);
+    cl_command_queue queue = clCreateCommandQueue(context, devices[1], 0, &error);
+    assertCLSuccess(testName, "createCommandQueue", error);
+
+    // mock can not compile OpenCL C
+    cl_program program = clCreateProgramWithSource(context, 1, &testKernelSource,
+                nullptr, &error);
+    assertCLSuccess(testName, "createProgram", error);
+    assertValue(testName, "buildOpenCLC", cl_int(CL_BUILD_PROGRAM_FAILURE),
+                clBuildProgram(program, 0, nullptr, "", nullptr, nullptr));
+    assertCLSuccess(testName, "buildAsm", clBuildProgram(program, 0, nullptr, "-xasm",
+                nullptr, nullptr));
+    for (cxuint i = 0; i < 3; i++)
+    {
+        cl_build_status status = CL_BUILD_NONE;
+        assertCLSuccess(testName, "getBuildStatus", clGetProgramBuildInfo(program,
+                    devices[i], CL_PROGRAM_BUILD_STATUS, sizeof(cl_build_status),
+                    &status, nullptr));
+        assertValue(testName, "buildStatus", cl_build_status(CL_BUILD_SUCCESS), status);
+    }
+
+    cl_kernel kernel = clCreateKernel(program, "testKernel", &error);
+    assertCLSuccess(testName, "createKernel", error);
+    cl_kernel kernel2 = clCreateKernel(program, "testKernel2", &error);
+    assertCLSuccess(testName, "createKernel2", error);
+    cl_uint argsNum = 0;
+    assertCLSuccess(testName, "getKernelArgsNum", clGetKernelInfo(kernel,
+                CL_KERNEL_NUM_ARGS, sizeof(cl_uint), &argsNum, nullptr));
+    assertValue(testName, "kernelArgsNum", cl_uint(2), argsNum);
+    clCreateKernel(program, "unknownKernel", &error);
+    assertValue(testName, "createUnknownKernel", cl_int(CL_INVALID_KERNEL_NAME), error);
+
+    cl_uint hostData[16];
+    for (cxuint i = 0; i < 16; i++)
+        hostData[i] = i*7;
+    cl_mem buffer = clCreateBuffer(context, CL_MEM_COPY_HOST_PTR, sizeof(hostData),
+                hostData, &error);
+    assertCLSuccess(testName, "createBuffer", error);
+    const cl_uint n = 16;
+    assertCLSuccess(testName, "setArg0", clSetKernelArg(kernel, 0, sizeof(cl_uint), &n));
+    assertCLSuccess(testName, "setArg1", clSetKernelArg(kernel, 1,
+                sizeof(cl_mem), &buffer));
+    assertValue(testName, "setArg2", cl_int(CL_INVALID_ARG_INDEX),
+                clSetKernelArg(kernel, 2, sizeof(cl_uint), &n));
+    assertCLSuccess(testName, "setKernel2Arg0", clSetKernelArg(kernel2, 0,
+                sizeof(cl_mem), &buffer));
+
+    const size_t workSize = 64;
+    cl_event event1, event2;
+    assertCLSuccess(testName, "enqueueKernel", clEnqueueNDRangeKernel(queue, kernel,
+                1, nullptr, &workSize, nullptr, 0, nullptr, &event1));
+    cxuint callbacksNum = 0;
+    assertCLSuccess(testName, "setEventCallback", clSetEventCallback(event1,
+                CL_COMPLETE, testEventCallback, &callbacksNum));
+    assertCLSuccess(testName, "enqueueKernel2", clEnqueueNDRangeKernel(queue, kernel2,
+                1, nullptr, &workSize, nullptr, 1, &event1, &event2));
+    assertCLSuccess(testName, "enqueueKernelNoEvent", clEnqueueNDRangeKernel(queue,
+                kernel, 1, nullptr, &workSize, nullptr, 0, nullptr, nullptr));
+    cl_command_queue eventQueue = nullptr;
+    assertCLSuccess(testName, "getEventQueue", clGetEventInfo(event2,
+                CL_EVENT_COMMAND_QUEUE, sizeof(cl_command_queue), &eventQueue, nullptr));
+    assertTrue(testName, "eventQueue", eventQueue == queue);
+    assertCLSuccess(testName, "waitForEvents", clWaitForEvents(1, &event2));
+    assertCLSuccess(testName, "finish", clFinish(queue));
+    cl_int status = CL_QUEUED;
+    assertCLSuccess(testName, "getEventStatus", clGetEventInfo(event1,
+                CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(cl_int), &status, nullptr));
+    assertValue(testName, "eventStatus", cl_int(CL_COMPLETE), status);
+    assertValue(testName, "callbacksNum", cxuint(1), callbacksNum);
+
+    cl_uint readData[16];
+    assertCLSuccess(testName, "readBuffer", clEnqueueReadBuffer(queue, buffer, CL_TRUE,
+                0, sizeof(readData), readData, 0, nullptr, nullptr));
+    assertArray(testName, "readData", Array<cl_uint>(hostData, hostData+16),
+                16, readData);
+
+    assertCLSuccess(testName, "releaseEvent1", clReleaseEvent(event1));
+    assertCLSuccess(testName, "releaseEvent2", clReleaseEvent(event2));
+    assertCLSuccess(testName, "releaseBuffer", clReleaseMemObject(buffer));
+    assertCLSuccess(testName, "releaseKernel", clReleaseKernel(kernel));
+    assertCLSuccess(testName, "releaseKernel2", clReleaseKernel(kernel2));
+    assertCLSuccess(testName, "releaseProgram", clReleaseProgram(program));
+    assertCLSuccess(testName, "releaseQueue", clReleaseCommandQueue(queue));
+    assertCLSuccess(testName, "releaseContext", clReleaseContext(context));
+}
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: CLWrapperMockTest MOCKOPENCL_PATH" << std::endl;
+        return 1;
+    }
+    // must be set before first call of OpenCL function
+    ::setenv("CLRX_AMDOCL_PATH", argv[1], 1);
+    ::setenv("CLRX_MOCKCL_DEVICES", "Pitcairn,Tonga,Fiji", 1);
+    ::setenv("CLRX_MOCKCL_EXEC_LATENCY", "20000", 1);
+    int retVal = 0;
+    retVal |= callTest(testPlatformAndDevices);
+    retVal |= callTest(testBuildAndEnqueue);
+    return retVal;
+}
@@ -0,0 +1,1630 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include <CLRX/amdbin/AmdCL2Binaries.h>
+#include "../../clwrapper/DispatchStruct.h"
+
+using namespace CLRX;
+
+/* mock of AMD OpenCL implementation (AMDOCL) to test and benchmark CLRXWrapper
+ * without GPU. CLRXWrapper loads this library through CLRX_AMDOCL_PATH.
+ * mock does not execute anything, it only simulates latencies of implementation.
+ * environment variables:
+ * CLRX_MOCKCL_DEVICES=NAME,... - names of GPU devices (default: Pitcairn,Tonga,Fiji)
+ * CLRX_MOCKCL_CALL_LATENCY=N - time of every call in nanoseconds (busy waiting)
+ * CLRX_MOCKCL_BUILD_LATENCY=N - time of program building for single device
+ *          in microseconds
+ * CLRX_MOCKCL_EXEC_LATENCY=N - execution time of enqueued command in nanoseconds
+ *
+ * commands are executed in order of enqueueing. completion of commands is checked
+ * in calls of the mock (enqueueing, flush, finish, waiting for events
+ * and getting event status) and event callbacks are called inside these calls.
+ * programs can be built only from binaries (sources are not compiled). */
+
+struct MockPlatform: _cl_platform_id
+{ };
+
+struct MockDevice: _cl_device_id
+{
+    std::string name;
+};
+
+struct MockContext: _cl_context
+{
+    std::atomic<size_t> refCount;
+    std::vector<cl_device_id> devices;
+
+    MockContext() : refCount(1)
+    { }
+};
+
+struct MockEvent;
+
+struct MockCommandQueue: _cl_command_queue
+{
+    std::atomic<size_t> refCount;
+    MockContext* context;
+    cl_device_id device;
+    cl_command_queue_properties properties;
+    std::mutex mutex;
+    uint64_t lastEndTime;   // end time of last enqueued command
+    std::vector<MockEvent*> pendingEvents;  // sorted by end time
+
+    MockCommandQueue() : refCount(1), context(nullptr), device(nullptr),
+            properties(0), lastEndTime(0)
+    { }
+    ~MockCommandQueue();
+};
+
+struct MockMemObject: _cl_mem
+{
+    std::atomic<size_t> refCount;
+    MockContext* context;
+    cl_mem_flags flags;
+    size_t size;
+    void* hostPtr;
+    std::unique_ptr<cxbyte[]> content;
+
+    MockMemObject() : refCount(1), context(nullptr), flags(0), size(0), hostPtr(nullptr)
+    { }
+    ~MockMemObject();
+};
+
+struct MockKernelEntry
+{
+    std::string name;
+    cxuint argsNum;
+};
+
+struct MockProgram: _cl_program
+{
+    std::atomic<size_t> refCount;
+    MockContext* context;
+    std::string source;
+    std::vector<cl_device_id> devices;
+    Array<Array<cxbyte> > binaries; // empty if program created from source
+    std::mutex mutex;
+    std::unique_ptr<cl_build_status[]> buildStatuses;
+    std::string buildOptions;
+    std::vector<MockKernelEntry> kernels; // sorted by name
+
+    MockProgram() : refCount(1), context(nullptr)
+    { }
+    ~MockProgram();
+};
+
+struct MockKernel: _cl_kernel
+{
+    std::atomic<size_t> refCount;
+    MockProgram* program;
+    const MockKernelEntry* entry;
+
+    MockKernel() : refCount(1), program(nullptr), entry(nullptr)
+    { }
+    ~MockKernel();
+};
+
+struct MockEventCallback
+{
+    cl_int callbackType;
+    void (CL_CALLBACK * notify)(cl_event, cl_int, void*);
+    void* userData;
+};
+
+struct MockEvent: _cl_event
+{
+    std::atomic<size_t> refCount;
+    MockContext* context;
+    MockCommandQueue* queue;
+    cl_command_type commandType;
+    uint64_t endTime;
+    std::mutex mutex;
+    bool complete;
+    std::vector<MockEventCallback> callbacks;
+
+    MockEvent() : refCount(1), context(nullptr), queue(nullptr), commandType(0),
+            endTime(0), complete(false)
+    { }
+    ~MockEvent();
+};
+
+/* use pure pointers - mock must be available to end of program,
+ * even after main routine and within atexit callback */
+static std::once_flag mockOnceFlag;
+static CLRXIcdDispatch* mockDispatch = nullptr;
+static MockPlatform* mockPlatform = nullptr;
+static MockDevice* mockDevices = nullptr;
+static cl_uint mockDevicesNum = 0;
+
+static uint64_t mockCallLatency = 0;
+static uint64_t mockBuildLatency = 0;
+static uint64_t mockExecLatency = 0;
+
+/* the driver version is detected from this string by CLRX */
+static const char* mockPlatformVersion = "OpenCL 1.2 AMD-APP (1800.11)";
+static const char* mockDriverVersion = "1800.11 (VM)";
+static const char* mockVendor = "Advanced Micro Devices, Inc.";
+
+/*
+ * mock utilities
+ */
+
+static inline uint64_t mockTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void mockWaitUntil(uint64_t time)
+{
+    uint64_t now = mockTime();
+    while (now < time)
+    {
+        if (time-now > 200000)
+            // sleep if longer than 200 microseconds, and finish by busy waiting
+            std::this_thread::sleep_for(std::chrono::nanoseconds(time-now-100000));
+        now = mockTime();
+    }
+}
+
+static inline void mockCallDelay()
+{
+    if (mockCallLatency != 0)
+        mockWaitUntil(mockTime() + mockCallLatency);
+}
+
+template<typename T>
+static inline void mockReleaseObject(T* object)
+{
+    if (object->refCount.fetch_sub(1) == 1)
+        delete object;
+}
+
+MockCommandQueue::~MockCommandQueue()
+{ mockReleaseObject(context); }
+
+MockMemObject::~MockMemObject()
+{ mockReleaseObject(context); }
+
+MockProgram::~MockProgram()
+{ mockReleaseObject(context); }
+
+MockKernel::~MockKernel()
+{ mockReleaseObject(program); }
+
+MockEvent::~MockEvent()
+{ mockReleaseObject(context); }
+
+static cl_int mockGetInfo(const void* value, size_t valueSize, size_t paramValueSize,
+            void* paramValue, size_t* paramValueSizeRet)
+{
+    if (paramValue != nullptr)
+    {
+        if (paramValueSize < valueSize)
+            return CL_INVALID_VALUE;
+        ::memcpy(paramValue, value, valueSize);
+    }
+    if (paramValueSizeRet != nullptr)
+        *paramValueSizeRet = valueSize;
+    return CL_SUCCESS;
+}
+
+template<typename T>
+static inline cl_int mockGetValueInfo(const T& value, size_t paramValueSize,
+            void* paramValue, size_t* paramValueSizeRet)
+{ return mockGetInfo(&value, sizeof(T), paramValueSize, paramValue, paramValueSizeRet); }
+
+static inline cl_int mockGetStringInfo(const char* str, size_t paramValueSize,
+            void* paramValue, size_t* paramValueSizeRet)
+{
+    return mockGetInfo(str, ::strlen(str)+1, paramValueSize, paramValue,
+                paramValueSizeRet);
+}
+
+static bool mockIsContextDevice(const MockContext* c, cl_device_id device)
+{ return std::find(c->devices.begin(), c->devices.end(), device) != c->devices.end(); }
+
+/*
+ * command queue execution
+ */
+
+static void mockCompleteEvent(MockEvent* e)
+{
+    std::vector<MockEventCallback> callbacks;
+    MockCommandQueue* q;
+    {
+        std::lock_guard<std::mutex> lock(e->mutex);
+        e->complete = true;
+        callbacks.swap(e->callbacks);
+        q = e->queue;
+    }
+    for (const MockEventCallback& callback: callbacks)
+        callback.notify(e, callback.callbackType, callback.userData);
+    // release references held by pending event
+    mockReleaseObject(e);
+    mockReleaseObject(q);
+}
+
+/* complete all commands that finished before current time */
+static void mockProcessQueue(MockCommandQueue* q)
+{
+    std::vector<MockEvent*> completed;
+    {
+        std::lock_guard<std::mutex> lock(q->mutex);
+        if (q->pendingEvents.empty())
+            return;
+        const uint64_t now = mockTime();
+        size_t count = 0;
+        while (count < q->pendingEvents.size() && q->pendingEvents[count]->endTime <= now)
+            count++;
+        completed.assign(q->pendingEvents.begin(), q->pendingEvents.begin()+count);
+        q->pendingEvents.erase(q->pendingEvents.begin(), q->pendingEvents.begin()+count);
+    }
+    for (MockEvent* e: completed)
+        mockCompleteEvent(e);
+}
+
+static void mockFinishQueue(MockCommandQueue* q)
+{
+    uint64_t endTime;
+    {
+        std::lock_guard<std::mutex> lock(q->mutex);
+        endTime = q->lastEndTime;
+    }
+    mockWaitUntil(endTime);
+    mockProcessQueue(q);
+}
+
+static void mockWaitForEvent(MockEvent* e)
+{
+    MockCommandQueue* q;
+    {
+        std::lock_guard<std::mutex> lock(e->mutex);
+        if (e->complete)
+            return;
+        // queue is alive while event is pending
+        q = e->queue;
+        q->refCount.fetch_add(1);
+    }
+    mockWaitUntil(e->endTime);
+    mockProcessQueue(q);
+    mockReleaseObject(q);
+}
+
+static cl_int mockEnqueueCommand(MockCommandQueue* q, cl_command_type commandType,
+            bool blocking, cl_uint numEventsInWaitList, const cl_event* eventWaitList,
+            cl_event* event)
+{
+    if ((numEventsInWaitList == 0 && eventWaitList != nullptr) ||
+        (numEventsInWaitList != 0 && eventWaitList == nullptr))
+        return CL_INVALID_EVENT_WAIT_LIST;
+
+    uint64_t startTime = mockTime();
+    for (cl_uint i = 0; i < numEventsInWaitList; i++)
+    {
+        if (eventWaitList[i] == nullptr)
+            return CL_INVALID_EVENT_WAIT_LIST;
+        const MockEvent* waitEvent = static_cast<const MockEvent*>(eventWaitList[i]);
+        if (waitEvent->context != q->context)
+            return CL_INVALID_CONTEXT;
+        startTime = std::max(startTime, waitEvent->endTime);
+    }
+
+    MockEvent* outEvent = nullptr;
+    if (event != nullptr)
+    {
+        try
+        { outEvent = new MockEvent; }
+        catch(const std::bad_alloc& ex)
+        { return CL_OUT_OF_HOST_MEMORY; }
+        outEvent->dispatch = mockDispatch;
+        outEvent->context = q->context;
+        outEvent->queue = q;
+        outEvent->commandType = commandType;
+        outEvent->refCount.store(2); // reference for application and pending list
+        q->context->refCount.fetch_add(1);
+    }
+
+    uint64_t endTime;
+    {
+        std::lock_guard<std::mutex> lock(q->mutex);
+        endTime = std::max(startTime, q->lastEndTime) + mockExecLatency;
+        q->lastEndTime = endTime;
+        if (outEvent != nullptr)
+        {
+            outEvent->endTime = endTime;
+            try
+            { q->pendingEvents.push_back(outEvent); }
+            catch(const std::bad_alloc& ex)
+            {
+                delete outEvent;
+                return CL_OUT_OF_HOST_MEMORY;
+            }
+            q->refCount.fetch_add(1); // pending event holds queue
+        }
+    }
+
+    if (blocking)
+        mockWaitUntil(endTime);
+    mockProcessQueue(q);
+    if (event != nullptr)
+        *event = outEvent;
+    return CL_SUCCESS;
+}
+
+/*
+ * program utilities
+ */
+
+/* get kernel names and their arguments numbers from binary */
+static void mockGetBinaryKernels(Array<cxbyte>& binary,
+            std::vector<MockKernelEntry>& kernels)
+{
+    std::unique_ptr<AmdMainBinaryBase> amdBin;
+    bool binCL20 = false;
+    if (isAmdCL2Binary(binary.size(), binary.data()))
+    {
+        amdBin.reset(new AmdCL2MainGPUBinary(binary.size(), binary.data(),
+                    AMDBIN_CREATE_KERNELINFO));
+        binCL20 = true;
+    }
+    else
+        amdBin.reset(createAmdBinaryFromCode(binary.size(), binary.data(),
+                    AMDBIN_CREATE_KERNELINFO));
+
+    const size_t kernelsNum = amdBin->getKernelInfosNum();
+    for (size_t i = 0; i < kernelsNum; i++)
+    {
+        const KernelInfo& kernelInfo = amdBin->getKernelInfo(i);
+        // for CL2 binary format: 6 first arguments are kernel setup
+        const cxuint argsNum = kernelInfo.argInfos.size();
+        kernels.push_back({ kernelInfo.kernelName.c_str(),
+                (binCL20 && argsNum >= 6) ? argsNum-6 : argsNum });
+    }
+}
+
+/*
+ * mock entry points
+ */
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetPlatformIDs(cl_uint num_entries, cl_platform_id* platforms,
+            cl_uint* num_platforms) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if ((num_entries == 0 && platforms != nullptr) ||
+        (platforms == nullptr && num_platforms == nullptr))
+        return CL_INVALID_VALUE;
+    if (platforms != nullptr)
+        platforms[0] = mockPlatform;
+    if (num_platforms != nullptr)
+        *num_platforms = 1;
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclIcdGetPlatformIDsKHR(cl_uint num_entries, cl_platform_id* platforms,
+            cl_uint* num_platforms) CL_API_SUFFIX__VERSION_1_0
+{ return mockclGetPlatformIDs(num_entries, platforms, num_platforms); }
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetPlatformInfo(cl_platform_id platform, cl_platform_info param_name,
+            size_t param_value_size, void* param_value,
+            size_t* param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (platform != mockPlatform)
+        return CL_INVALID_PLATFORM;
+    const char* str = nullptr;
+    switch(param_name)
+    {
+        case CL_PLATFORM_PROFILE:
+            str = "FULL_PROFILE";
+            break;
+        case CL_PLATFORM_VERSION:
+            str = mockPlatformVersion;
+            break;
+        case CL_PLATFORM_NAME:
+            str = "AMD Accelerated Parallel Processing";
+            break;
+        case CL_PLATFORM_VENDOR:
+            str = mockVendor;
+            break;
+        case CL_PLATFORM_EXTENSIONS:
+            str = "cl_khr_icd cl_amd_event_callback ";
+            break;
+        default:
+            return CL_INVALID_VALUE;
+    }
+    return mockGetStringInfo(str, param_value_size, param_value, param_value_size_ret);
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetDeviceIDs(cl_platform_id platform, cl_device_type device_type,
+            cl_uint num_entries, cl_device_id* devices,
+            cl_uint* num_devices) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (platform != mockPlatform)
+        return CL_INVALID_PLATFORM;
+    if ((num_entries == 0 && devices != nullptr) ||
+        (devices == nullptr && num_devices == nullptr))
+        return CL_INVALID_VALUE;
+    // only GPU devices
+    if ((device_type & (CL_DEVICE_TYPE_GPU|CL_DEVICE_TYPE_DEFAULT)) == 0 ||
+        mockDevicesNum == 0)
+        return CL_DEVICE_NOT_FOUND;
+
+    const cl_uint devicesNum = (device_type == CL_DEVICE_TYPE_DEFAULT) ?
+                1 : mockDevicesNum;
+    if (devices != nullptr)
+        for (cl_uint i = 0; i < std::min(num_entries, devicesNum); i++)
+            devices[i] = mockDevices + i;
+    if (num_devices != nullptr)
+        *num_devices = devicesNum;
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetDeviceInfo(cl_device_id device, cl_device_info param_name,
+            size_t param_value_size, void* param_value,
+            size_t* param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (device < mockDevices || device >= mockDevices+mockDevicesNum)
+        return CL_INVALID_DEVICE;
+    const MockDevice* d = static_cast<const MockDevice*>(device);
+
+    switch(param_name)
+    {
+        case CL_DEVICE_TYPE:
+            return mockGetValueInfo(cl_device_type(CL_DEVICE_TYPE_GPU),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_VENDOR_ID:
+            return mockGetValueInfo(cl_uint(0x1002),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_MAX_COMPUTE_UNITS:
+            return mockGetValueInfo(cl_uint(32),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_MAX_WORK_GROUP_SIZE:
+            return mockGetValueInfo(size_t(256),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_ADDRESS_BITS:
+            return mockGetValueInfo(cl_uint(64),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_MAX_MEM_ALLOC_SIZE:
+            return mockGetValueInfo(cl_ulong(1)<<30,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_GLOBAL_MEM_SIZE:
+            return mockGetValueInfo(cl_ulong(1)<<32,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_LOCAL_MEM_SIZE:
+            return mockGetValueInfo(cl_ulong(32768),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_AVAILABLE:
+        case CL_DEVICE_COMPILER_AVAILABLE:
+            return mockGetValueInfo(cl_bool(CL_TRUE),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_NAME:
+            return mockGetStringInfo(d->name.c_str(),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_VENDOR:
+            return mockGetStringInfo(mockVendor,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DRIVER_VERSION:
+            return mockGetStringInfo(mockDriverVersion,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_PROFILE:
+            return mockGetStringInfo("FULL_PROFILE",
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_VERSION:
+            return mockGetStringInfo(mockPlatformVersion,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_OPENCL_C_VERSION:
+            return mockGetStringInfo("OpenCL C 1.2 ",
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_EXTENSIONS:
+            return mockGetStringInfo("cl_khr_global_int32_base_atomics "
+                        "cl_khr_byte_addressable_store cl_khr_icd ",
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_DEVICE_PLATFORM:
+            return mockGetValueInfo(cl_platform_id(mockPlatform),
+                        param_value_size, param_value, param_value_size_ret);
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static MockContext* mockCreateContext(const cl_context_properties* properties,
+            cl_uint num_devices, const cl_device_id* devices, cl_int* errcode_ret)
+{
+    cl_int error = CL_SUCCESS;
+    if (properties != nullptr)
+        for (const cl_context_properties* p = properties; *p != 0; p += 2)
+            if (p[0] == CL_CONTEXT_PLATFORM && p[1] != cl_context_properties(mockPlatform))
+                error = CL_INVALID_PLATFORM;
+    for (cl_uint i = 0; i < num_devices; i++)
+        if (devices[i] < mockDevices || devices[i] >= mockDevices+mockDevicesNum)
+            error = CL_INVALID_DEVICE;
+
+    MockContext* outContext = nullptr;
+    if (error == CL_SUCCESS)
+        try
+        {
+            outContext = new MockContext;
+            outContext->dispatch = mockDispatch;
+            outContext->devices.assign(devices, devices + num_devices);
+        }
+        catch(const std::bad_alloc& ex)
+        {
+            delete outContext;
+            outContext = nullptr;
+            error = CL_OUT_OF_HOST_MEMORY;
+        }
+    if (errcode_ret != nullptr)
+        *errcode_ret = error;
+    return outContext;
+}
+
+static CL_API_ENTRY cl_context CL_API_CALL
+mockclCreateContext(const cl_context_properties* properties,
+            cl_uint num_devices, const cl_device_id* devices,
+            void (CL_CALLBACK* pfn_notify)(const char*, const void*, size_t, void*),
+            void* user_data, cl_int* errcode_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (devices == nullptr || num_devices == 0 ||
+        (pfn_notify == nullptr && user_data != nullptr))
+    {
+        if (errcode_ret != nullptr)
+            *errcode_ret = CL_INVALID_VALUE;
+        return nullptr;
+    }
+    return mockCreateContext(properties, num_devices, devices, errcode_ret);
+}
+
+static CL_API_ENTRY cl_context CL_API_CALL
+mockclCreateContextFromType(const cl_context_properties* properties,
+            cl_device_type device_type,
+            void (CL_CALLBACK* pfn_notify)(const char*, const void*, size_t, void*),
+            void* user_data, cl_int* errcode_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (pfn_notify == nullptr && user_data != nullptr)
+    {
+        if (errcode_ret != nullptr)
+            *errcode_ret = CL_INVALID_VALUE;
+        return nullptr;
+    }
+    if ((device_type & (CL_DEVICE_TYPE_GPU|CL_DEVICE_TYPE_DEFAULT)) == 0 ||
+        mockDevicesNum == 0)
+    {
+        if (errcode_ret != nullptr)
+            *errcode_ret = CL_DEVICE_NOT_FOUND;
+        return nullptr;
+    }
+    std::vector<cl_device_id> devices;
+    for (cl_uint i = 0; i < mockDevicesNum; i++)
+        devices.push_back(mockDevices + i);
+    return mockCreateContext(properties, devices.size(), devices.data(), errcode_ret);
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclRetainContext(cl_context context) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (context == nullptr)
+        return CL_INVALID_CONTEXT;
+    static_cast<MockContext*>(context)->refCount.fetch_add(1);
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclReleaseContext(cl_context context) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (context == nullptr)
+        return CL_INVALID_CONTEXT;
+    mockReleaseObject(static_cast<MockContext*>(context));
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetContextInfo(cl_context context, cl_context_info param_name,
+            size_t param_value_size, void* param_value,
+            size_t* param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (context == nullptr)
+        return CL_INVALID_CONTEXT;
+    const MockContext* c = static_cast<const MockContext*>(context);
+    switch(param_name)
+    {
+        case CL_CONTEXT_REFERENCE_COUNT:
+            return mockGetValueInfo(cl_uint(c->refCount.load()),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_CONTEXT_NUM_DEVICES:
+            return mockGetValueInfo(cl_uint(c->devices.size()),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_CONTEXT_DEVICES:
+            return mockGetInfo(c->devices.data(), sizeof(cl_device_id)*c->devices.size(),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_CONTEXT_PROPERTIES:
+            return mockGetInfo(nullptr, 0,
+                        param_value_size, param_value, param_value_size_ret);
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static CL_API_ENTRY cl_command_queue CL_API_CALL
+mockclCreateCommandQueue(cl_context context, cl_device_id device,
+            cl_command_queue_properties properties,
+            cl_int* errcode_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    cl_int error = CL_SUCCESS;
+    MockContext* c = static_cast<MockContext*>(context);
+    MockCommandQueue* outQueue = nullptr;
+    if (context == nullptr)
+        error = CL_INVALID_CONTEXT;
+    else if (device == nullptr || !mockIsContextDevice(c, device))
+        error = CL_INVALID_DEVICE;
+    else
+        try
+        {
+            outQueue = new MockCommandQueue;
+            outQueue->dispatch = mockDispatch;
+            outQueue->context = c;
+            outQueue->device = device;
+            outQueue->properties = properties;
+            c->refCount.fetch_add(1);
+        }
+        catch(const std::bad_alloc& ex)
+        { error = CL_OUT_OF_HOST_MEMORY; }
+    if (errcode_ret != nullptr)
+        *errcode_ret = error;
+    return outQueue;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclRetainCommandQueue(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (command_queue == nullptr)
+        return CL_INVALID_COMMAND_QUEUE;
+    static_cast<MockCommandQueue*>(command_queue)->refCount.fetch_add(1);
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclReleaseCommandQueue(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (command_queue == nullptr)
+        return CL_INVALID_COMMAND_QUEUE;
+    MockCommandQueue* q = static_cast<MockCommandQueue*>(command_queue);
+    // release implies flush, pending events hold queue, hence finish all commands
+    mockFinishQueue(q);
+    mockReleaseObject(q);
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetCommandQueueInfo(cl_command_queue command_queue,
+            cl_command_queue_info param_name, size_t param_value_size,
+            void* param_value, size_t* param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (command_queue == nullptr)
+        return CL_INVALID_COMMAND_QUEUE;
+    const MockCommandQueue* q = static_cast<const MockCommandQueue*>(command_queue);
+    switch(param_name)
+    {
+        case CL_QUEUE_CONTEXT:
+            return mockGetValueInfo(cl_context(q->context),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_QUEUE_DEVICE:
+            return mockGetValueInfo(q->device,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_QUEUE_REFERENCE_COUNT:
+            return mockGetValueInfo(cl_uint(q->refCount.load()),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_QUEUE_PROPERTIES:
+            return mockGetValueInfo(q->properties,
+                        param_value_size, param_value, param_value_size_ret);
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static CL_API_ENTRY cl_mem CL_API_CALL
+mockclCreateBuffer(cl_context context, cl_mem_flags flags, size_t size,
+            void* host_ptr, cl_int* errcode_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    cl_int error = CL_SUCCESS;
+    MockMemObject* outBuffer = nullptr;
+    const bool useHostPtr = (flags & (CL_MEM_USE_HOST_PTR|CL_MEM_COPY_HOST_PTR)) != 0;
+    if (context == nullptr)
+        error = CL_INVALID_CONTEXT;
+    else if (size == 0)
+        error = CL_INVALID_BUFFER_SIZE;
+    else if (useHostPtr != (host_ptr != nullptr))
+        error = CL_INVALID_HOST_PTR;
+    else
+        try
+        {
+            outBuffer = new MockMemObject;
+            outBuffer->dispatch = mockDispatch;
+            outBuffer->flags = flags;
+            outBuffer->size = size;
+            outBuffer->hostPtr = (flags & CL_MEM_USE_HOST_PTR) ? host_ptr : nullptr;
+            outBuffer->content.reset(new cxbyte[size]);
+            if (useHostPtr)
+                ::memcpy(outBuffer->content.get(), host_ptr, size);
+            outBuffer->context = static_cast<MockContext*>(context);
+            outBuffer->context->refCount.fetch_add(1);
+        }
+        catch(const std::bad_alloc& ex)
+        {
+            delete outBuffer;
+            outBuffer = nullptr;
+            error = CL_OUT_OF_HOST_MEMORY;
+        }
+    if (errcode_ret != nullptr)
+        *errcode_ret = error;
+    return outBuffer;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclRetainMemObject(cl_mem memobj) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (memobj == nullptr)
+        return CL_INVALID_MEM_OBJECT;
+    static_cast<MockMemObject*>(memobj)->refCount.fetch_add(1);
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclReleaseMemObject(cl_mem memobj) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (memobj == nullptr)
+        return CL_INVALID_MEM_OBJECT;
+    mockReleaseObject(static_cast<MockMemObject*>(memobj));
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetMemObjectInfo(cl_mem memobj, cl_mem_info param_name, size_t param_value_size,
+            void* param_value, size_t* param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (memobj == nullptr)
+        return CL_INVALID_MEM_OBJECT;
+    const MockMemObject* m = static_cast<const MockMemObject*>(memobj);
+    switch(param_name)
+    {
+        case CL_MEM_TYPE:
+            return mockGetValueInfo(cl_mem_object_type(CL_MEM_OBJECT_BUFFER),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_MEM_FLAGS:
+            return mockGetValueInfo(m->flags,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_MEM_SIZE:
+            return mockGetValueInfo(m->size,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_MEM_HOST_PTR:
+            return mockGetValueInfo(m->hostPtr,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_MEM_REFERENCE_COUNT:
+            return mockGetValueInfo(cl_uint(m->refCount.load()),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_MEM_CONTEXT:
+            return mockGetValueInfo(cl_context(m->context),
+                        param_value_size, param_value, param_value_size_ret);
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static MockProgram* mockCreateProgram(cl_context context)
+{
+    MockContext* c = static_cast<MockContext*>(context);
+    MockProgram* outProgram = new MockProgram;
+    outProgram->dispatch = mockDispatch;
+    outProgram->context = c;
+    c->refCount.fetch_add(1);
+    return outProgram;
+}
+
+static CL_API_ENTRY cl_program CL_API_CALL
+mockclCreateProgramWithSource(cl_context context, cl_uint count, const char** strings,
+            const size_t* lengths, cl_int* errcode_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    cl_int error = CL_SUCCESS;
+    MockProgram* outProgram = nullptr;
+    if (context == nullptr)
+        error = CL_INVALID_CONTEXT;
+    else if (count == 0 || strings == nullptr)
+        error = CL_INVALID_VALUE;
+    else
+        try
+        {
+            std::string source;
+            for (cl_uint i = 0; i < count; i++)
+            {
+                if (strings[i] == nullptr)
+                {
+                    error = CL_INVALID_VALUE;
+                    break;
+                }
+                if (lengths == nullptr || lengths[i] == 0)
+                    source.append(strings[i]);
+                else
+                    source.append(strings[i], lengths[i]);
+            }
+            if (error == CL_SUCCESS)
+            {
+                outProgram = mockCreateProgram(context);
+                outProgram->source = std::move(source);
+                const MockContext* c = static_cast<const MockContext*>(context);
+                outProgram->devices = c->devices;
+                outProgram->buildStatuses.reset(new cl_build_status[c->devices.size()]);
+                std::fill(outProgram->buildStatuses.get(),
+                        outProgram->buildStatuses.get()+c->devices.size(), CL_BUILD_NONE);
+            }
+        }
+        catch(const std::bad_alloc& ex)
+        {
+            if (outProgram != nullptr)
+                mockReleaseObject(outProgram);
+            outProgram = nullptr;
+            error = CL_OUT_OF_HOST_MEMORY;
+        }
+    if (errcode_ret != nullptr)
+        *errcode_ret = error;
+    return outProgram;
+}
+
+static CL_API_ENTRY cl_program CL_API_CALL
+mockclCreateProgramWithBinary(cl_context context, cl_uint num_devices,
+            const cl_device_id* device_list, const size_t* lengths,
+            const unsigned char** binaries, cl_int* binary_status,
+            cl_int* errcode_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    cl_int error = CL_SUCCESS;
+    MockProgram* outProgram = nullptr;
+    const MockContext* c = static_cast<const MockContext*>(context);
+    if (context == nullptr)
+        error = CL_INVALID_CONTEXT;
+    else if (num_devices == 0 || device_list == nullptr ||
+        lengths == nullptr || binaries == nullptr)
+        error = CL_INVALID_VALUE;
+    else
+        for (cl_uint i = 0; i < num_devices; i++)
+            if (!mockIsContextDevice(c, device_list[i]))
+                error = CL_INVALID_DEVICE;
+            else if (lengths[i] == 0 || binaries[i] == nullptr)
+            {
+                if (binary_status != nullptr)
+                    binary_status[i] = CL_INVALID_VALUE;
+                error = CL_INVALID_VALUE;
+            }
+            else if (binary_status != nullptr)
+                binary_status[i] = CL_SUCCESS;
+
+    if (error == CL_SUCCESS)
+        try
+        {
+            outProgram = mockCreateProgram(context);
+            outProgram->devices.assign(device_list, device_list + num_devices);
+            outProgram->binaries.resize(num_devices);
+            for (cl_uint i = 0; i < num_devices; i++)
+                outProgram->binaries[i].assign(binaries[i], binaries[i] + lengths[i]);
+            outProgram->buildStatuses.reset(new cl_build_status[num_devices]);
+            std::fill(outProgram->buildStatuses.get(),
+                    outProgram->buildStatuses.get()+num_devices, CL_BUILD_NONE);
+        }
+        catch(const std::bad_alloc& ex)
+        {
+            if (outProgram != nullptr)
+                mockReleaseObject(outProgram);
+            outProgram = nullptr;
+            error = CL_OUT_OF_HOST_MEMORY;
+        }
+    if (errcode_ret != nullptr)
+        *errcode_ret = error;
+    return outProgram;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclRetainProgram(cl_program program) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (program == nullptr)
+        return CL_INVALID_PROGRAM;
+    static_cast<MockProgram*>(program)->refCount.fetch_add(1);
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclReleaseProgram(cl_program program) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (program == nullptr)
+        return CL_INVALID_PROGRAM;
+    mockReleaseObject(static_cast<MockProgram*>(program));
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclBuildProgram(cl_program program, cl_uint num_devices,
+            const cl_device_id* device_list, const char* options,
+            void (CL_CALLBACK* pfn_notify)(cl_program, void*),
+            void* user_data) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (program == nullptr)
+        return CL_INVALID_PROGRAM;
+    if ((num_devices == 0 && device_list != nullptr) ||
+        (num_devices != 0 && device_list == nullptr) ||
+        (pfn_notify == nullptr && user_data != nullptr))
+        return CL_INVALID_VALUE;
+
+    MockProgram* p = static_cast<MockProgram*>(program);
+    cl_int error = CL_SUCCESS;
+    try
+    {
+        std::lock_guard<std::mutex> lock(p->mutex);
+        // choose devices indices to build
+        std::vector<size_t> buildIndices;
+        if (device_list == nullptr)
+            for (size_t i = 0; i < p->devices.size(); i++)
+                buildIndices.push_back(i);
+        else
+            for (cl_uint i = 0; i < num_devices; i++)
+            {
+                auto it = std::find(p->devices.begin(), p->devices.end(), device_list[i]);
+                if (it == p->devices.end())
+                    return CL_INVALID_DEVICE;
+                buildIndices.push_back(it - p->devices.begin());
+            }
+
+        if (mockBuildLatency != 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(
+                        mockBuildLatency*buildIndices.size()));
+
+        p->buildOptions = (options != nullptr) ? options : "";
+        p->kernels.clear();
+        for (size_t index: buildIndices)
+        {
+            if (p->binaries.empty())
+            {   // mock does not have compiler
+                p->buildStatuses[index] = CL_BUILD_ERROR;
+                error = CL_BUILD_PROGRAM_FAILURE;
+                continue;
+            }
+            try
+            {
+                mockGetBinaryKernels(p->binaries[index], p->kernels);
+                p->buildStatuses[index] = CL_BUILD_SUCCESS;
+            }
+            catch(const Exception& ex)
+            {   // invalid binary
+                p->buildStatuses[index] = CL_BUILD_ERROR;
+                error = CL_BUILD_PROGRAM_FAILURE;
+            }
+        }
+        // remove duplicates from many devices
+        std::sort(p->kernels.begin(), p->kernels.end(),
+                [](const MockKernelEntry& a, const MockKernelEntry& b)
+                { return a.name < b.name; });
+        p->kernels.erase(std::unique(p->kernels.begin(), p->kernels.end(),
+                [](const MockKernelEntry& a, const MockKernelEntry& b)
+                { return a.name == b.name; }), p->kernels.end());
+    }
+    catch(const std::bad_alloc& ex)
+    { return CL_OUT_OF_HOST_MEMORY; }
+
+    if (pfn_notify != nullptr)
+        pfn_notify(program, user_data);
+    return error;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetProgramInfo(cl_program program, cl_program_info param_name,
+            size_t param_value_size, void* param_value,
+            size_t* param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (program == nullptr)
+        return CL_INVALID_PROGRAM;
+    MockProgram* p = static_cast<MockProgram*>(program);
+    std::lock_guard<std::mutex> lock(p->mutex);
+    const size_t devicesNum = p->devices.size();
+    switch(param_name)
+    {
+        case CL_PROGRAM_REFERENCE_COUNT:
+            return mockGetValueInfo(cl_uint(p->refCount.load()),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_PROGRAM_CONTEXT:
+            return mockGetValueInfo(cl_context(p->context),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_PROGRAM_NUM_DEVICES:
+            return mockGetValueInfo(cl_uint(devicesNum),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_PROGRAM_DEVICES:
+            return mockGetInfo(p->devices.data(), sizeof(cl_device_id)*devicesNum,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_PROGRAM_SOURCE:
+            return mockGetStringInfo(p->source.c_str(),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_PROGRAM_BINARY_SIZES:
+        {
+            if (param_value != nullptr && param_value_size < sizeof(size_t)*devicesNum)
+                return CL_INVALID_VALUE;
+            if (param_value != nullptr)
+                for (size_t i = 0; i < devicesNum; i++)
+                    static_cast<size_t*>(param_value)[i] =
+                        (!p->binaries.empty() && p->buildStatuses[i] == CL_BUILD_SUCCESS) ?
+                            p->binaries[i].size() : 0;
+            if (param_value_size_ret != nullptr)
+                *param_value_size_ret = sizeof(size_t)*devicesNum;
+            return CL_SUCCESS;
+        }
+        case CL_PROGRAM_BINARIES:
+        {
+            if (param_value != nullptr && param_value_size < sizeof(cxbyte*)*devicesNum)
+                return CL_INVALID_VALUE;
+            if (param_value != nullptr)
+                for (size_t i = 0; i < devicesNum; i++)
+                {
+                    cxbyte* dest = static_cast<cxbyte**>(param_value)[i];
+                    if (dest != nullptr && !p->binaries.empty() &&
+                        p->buildStatuses[i] == CL_BUILD_SUCCESS)
+                        std::copy(p->binaries[i].begin(), p->binaries[i].end(), dest);
+                }
+            if (param_value_size_ret != nullptr)
+                *param_value_size_ret = sizeof(cxbyte*)*devicesNum;
+            return CL_SUCCESS;
+        }
+        case CL_PROGRAM_NUM_KERNELS:
+            return mockGetValueInfo(size_t(p->kernels.size()),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_PROGRAM_KERNEL_NAMES:
+        {
+            std::string names;
+            for (const MockKernelEntry& entry: p->kernels)
+            {
+                if (!names.empty())
+                    names.push_back(';');
+                names.append(entry.name);
+            }
+            return mockGetStringInfo(names.c_str(),
+                        param_value_size, param_value, param_value_size_ret);
+        }
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetProgramBuildInfo(cl_program program, cl_device_id device,
+            cl_program_build_info param_name, size_t param_value_size,
+            void* param_value, size_t* param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (program == nullptr)
+        return CL_INVALID_PROGRAM;
+    MockProgram* p = static_cast<MockProgram*>(program);
+    std::lock_guard<std::mutex> lock(p->mutex);
+    auto it = std::find(p->devices.begin(), p->devices.end(), device);
+    if (it == p->devices.end())
+        return CL_INVALID_DEVICE;
+    const cl_build_status status = p->buildStatuses[it - p->devices.begin()];
+    switch(param_name)
+    {
+        case CL_PROGRAM_BUILD_STATUS:
+            return mockGetValueInfo(status,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_PROGRAM_BUILD_OPTIONS:
+            return mockGetStringInfo(p->buildOptions.c_str(),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_PROGRAM_BUILD_LOG:
+            return mockGetStringInfo((status == CL_BUILD_ERROR) ?
+                        "mock can not build this program" : "",
+                        param_value_size, param_value, param_value_size_ret);
+#ifdef CL_VERSION_1_2
+        case CL_PROGRAM_BINARY_TYPE:
+            return mockGetValueInfo(cl_program_binary_type(
+                        (status == CL_BUILD_SUCCESS) ? CL_PROGRAM_BINARY_TYPE_EXECUTABLE :
+                        CL_PROGRAM_BINARY_TYPE_NONE),
+                        param_value_size, param_value, param_value_size_ret);
+#endif
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static CL_API_ENTRY cl_kernel CL_API_CALL
+mockclCreateKernel(cl_program program, const char* kernel_name,
+            cl_int* errcode_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    cl_int error = CL_SUCCESS;
+    MockKernel* outKernel = nullptr;
+    if (program == nullptr)
+        error = CL_INVALID_PROGRAM;
+    else if (kernel_name == nullptr)
+        error = CL_INVALID_VALUE;
+    else
+    {
+        MockProgram* p = static_cast<MockProgram*>(program);
+        std::lock_guard<std::mutex> lock(p->mutex);
+        auto it = std::lower_bound(p->kernels.begin(), p->kernels.end(), kernel_name,
+                [](const MockKernelEntry& a, const char* b)
+                { return a.name.compare(b) < 0; });
+        if (std::find(p->buildStatuses.get(), p->buildStatuses.get()+p->devices.size(),
+                    CL_BUILD_SUCCESS) == p->buildStatuses.get()+p->devices.size())
+            error = CL_INVALID_PROGRAM_EXECUTABLE;
+        else if (it == p->kernels.end() || it->name != kernel_name)
+            error = CL_INVALID_KERNEL_NAME;
+        else
+            try
+            {
+                outKernel = new MockKernel;
+                outKernel->dispatch = mockDispatch;
+                outKernel->program = p;
+                outKernel->entry = &*it;
+                p->refCount.fetch_add(1);
+            }
+            catch(const std::bad_alloc& ex)
+            { error = CL_OUT_OF_HOST_MEMORY; }
+    }
+    if (errcode_ret != nullptr)
+        *errcode_ret = error;
+    return outKernel;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclRetainKernel(cl_kernel kernel) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (kernel == nullptr)
+        return CL_INVALID_KERNEL;
+    static_cast<MockKernel*>(kernel)->refCount.fetch_add(1);
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclReleaseKernel(cl_kernel kernel) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (kernel == nullptr)
+        return CL_INVALID_KERNEL;
+    mockReleaseObject(static_cast<MockKernel*>(kernel));
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclSetKernelArg(cl_kernel kernel, cl_uint arg_index, size_t arg_size,
+            const void* arg_value) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (kernel == nullptr)
+        return CL_INVALID_KERNEL;
+    const MockKernel* k = static_cast<const MockKernel*>(kernel);
+    if (arg_index >= k->entry->argsNum)
+        return CL_INVALID_ARG_INDEX;
+    if (arg_size == 0)
+        return CL_INVALID_ARG_SIZE;
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetKernelInfo(cl_kernel kernel, cl_kernel_info param_name,
+            size_t param_value_size, void* param_value,
+            size_t* param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (kernel == nullptr)
+        return CL_INVALID_KERNEL;
+    const MockKernel* k = static_cast<const MockKernel*>(kernel);
+    switch(param_name)
+    {
+        case CL_KERNEL_FUNCTION_NAME:
+            return mockGetStringInfo(k->entry->name.c_str(),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_KERNEL_NUM_ARGS:
+            return mockGetValueInfo(cl_uint(k->entry->argsNum),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_KERNEL_REFERENCE_COUNT:
+            return mockGetValueInfo(cl_uint(k->refCount.load()),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_KERNEL_CONTEXT:
+            return mockGetValueInfo(cl_context(k->program->context),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_KERNEL_PROGRAM:
+            return mockGetValueInfo(cl_program(k->program),
+                        param_value_size, param_value, param_value_size_ret);
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclWaitForEvents(cl_uint num_events, const cl_event* event_list)
+            CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (num_events == 0 || event_list == nullptr)
+        return CL_INVALID_VALUE;
+    for (cl_uint i = 0; i < num_events; i++)
+        if (event_list[i] == nullptr)
+            return CL_INVALID_EVENT;
+    for (cl_uint i = 0; i < num_events; i++)
+        mockWaitForEvent(static_cast<MockEvent*>(event_list[i]));
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclGetEventInfo(cl_event event, cl_event_info param_name,
+            size_t param_value_size, void* param_value,
+            size_t* param_value_size_ret) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (event == nullptr)
+        return CL_INVALID_EVENT;
+    MockEvent* e = static_cast<MockEvent*>(event);
+    switch(param_name)
+    {
+        case CL_EVENT_COMMAND_QUEUE:
+            return mockGetValueInfo(cl_command_queue(e->queue),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_EVENT_CONTEXT:
+            return mockGetValueInfo(cl_context(e->context),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_EVENT_COMMAND_TYPE:
+            return mockGetValueInfo(e->commandType,
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_EVENT_REFERENCE_COUNT:
+            return mockGetValueInfo(cl_uint(e->refCount.load()),
+                        param_value_size, param_value, param_value_size_ret);
+        case CL_EVENT_COMMAND_EXECUTION_STATUS:
+        {
+            if (mockTime() >= e->endTime)
+                mockWaitForEvent(e); // complete event if it finished
+            bool complete;
+            {
+                std::lock_guard<std::mutex> lock(e->mutex);
+                complete = e->complete;
+            }
+            return mockGetValueInfo(cl_int(complete ? CL_COMPLETE : CL_SUBMITTED),
+                        param_value_size, param_value, param_value_size_ret);
+        }
+        default:
+            return CL_INVALID_VALUE;
+    }
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclRetainEvent(cl_event event) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (event == nullptr)
+        return CL_INVALID_EVENT;
+    static_cast<MockEvent*>(event)->refCount.fetch_add(1);
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclReleaseEvent(cl_event event) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (event == nullptr)
+        return CL_INVALID_EVENT;
+    mockReleaseObject(static_cast<MockEvent*>(event));
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclSetEventCallback(cl_event event, cl_int command_exec_callback_type,
+            void (CL_CALLBACK* pfn_notify)(cl_event, cl_int, void*),
+            void* user_data) CL_API_SUFFIX__VERSION_1_1
+{
+    mockCallDelay();
+    if (event == nullptr)
+        return CL_INVALID_EVENT;
+    if (pfn_notify == nullptr || (command_exec_callback_type != CL_COMPLETE &&
+        command_exec_callback_type != CL_RUNNING &&
+        command_exec_callback_type != CL_SUBMITTED))
+        return CL_INVALID_VALUE;
+    MockEvent* e = static_cast<MockEvent*>(event);
+    {
+        std::lock_guard<std::mutex> lock(e->mutex);
+        if (!e->complete)
+            try
+            {
+                e->callbacks.push_back({ command_exec_callback_type,
+                            pfn_notify, user_data });
+                return CL_SUCCESS;
+            }
+            catch(const std::bad_alloc& ex)
+            { return CL_OUT_OF_HOST_MEMORY; }
+    }
+    // already complete
+    pfn_notify(event, command_exec_callback_type, user_data);
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclFlush(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (command_queue == nullptr)
+        return CL_INVALID_COMMAND_QUEUE;
+    mockProcessQueue(static_cast<MockCommandQueue*>(command_queue));
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclFinish(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (command_queue == nullptr)
+        return CL_INVALID_COMMAND_QUEUE;
+    mockFinishQueue(static_cast<MockCommandQueue*>(command_queue));
+    return CL_SUCCESS;
+}
+
+static cl_int mockCheckBufferRange(MockCommandQueue* q, cl_mem buffer, size_t offset,
+            size_t size, const void* ptr)
+{
+    if (buffer == nullptr)
+        return CL_INVALID_MEM_OBJECT;
+    const MockMemObject* m = static_cast<const MockMemObject*>(buffer);
+    if (m->context != q->context)
+        return CL_INVALID_CONTEXT;
+    if (ptr == nullptr || size == 0 || offset > m->size || size > m->size-offset)
+        return CL_INVALID_VALUE;
+    return CL_SUCCESS;
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclEnqueueReadBuffer(cl_command_queue command_queue, cl_mem buffer,
+            cl_bool blocking_read, size_t offset, size_t size, void* ptr,
+            cl_uint num_events_in_wait_list, const cl_event* event_wait_list,
+            cl_event* event) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (command_queue == nullptr)
+        return CL_INVALID_COMMAND_QUEUE;
+    MockCommandQueue* q = static_cast<MockCommandQueue*>(command_queue);
+    const cl_int error = mockCheckBufferRange(q, buffer, offset, size, ptr);
+    if (error != CL_SUCCESS)
+        return error;
+    ::memcpy(ptr, static_cast<MockMemObject*>(buffer)->content.get() + offset, size);
+    return mockEnqueueCommand(q, CL_COMMAND_READ_BUFFER, blocking_read,
+                num_events_in_wait_list, event_wait_list, event);
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclEnqueueWriteBuffer(cl_command_queue command_queue, cl_mem buffer,
+            cl_bool blocking_write, size_t offset, size_t size, const void* ptr,
+            cl_uint num_events_in_wait_list, const cl_event* event_wait_list,
+            cl_event* event) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (command_queue == nullptr)
+        return CL_INVALID_COMMAND_QUEUE;
+    MockCommandQueue* q = static_cast<MockCommandQueue*>(command_queue);
+    const cl_int error = mockCheckBufferRange(q, buffer, offset, size, ptr);
+    if (error != CL_SUCCESS)
+        return error;
+    ::memcpy(static_cast<MockMemObject*>(buffer)->content.get() + offset, ptr, size);
+    return mockEnqueueCommand(q, CL_COMMAND_WRITE_BUFFER, blocking_write,
+                num_events_in_wait_list, event_wait_list, event);
+}
+
+static CL_API_ENTRY cl_int CL_API_CALL
+mockclEnqueueNDRangeKernel(cl_command_queue command_queue, cl_kernel kernel,
+            cl_uint work_dim, const size_t* global_work_offset,
+            const size_t* global_work_size, const size_t* local_work_size,
+            cl_uint num_events_in_wait_list, const cl_event* event_wait_list,
+            cl_event* event) CL_API_SUFFIX__VERSION_1_0
+{
+    mockCallDelay();
+    if (command_queue == nullptr)
+        return CL_INVALID_COMMAND_QUEUE;
+    if (kernel == nullptr)
+        return CL_INVALID_KERNEL;
+    MockCommandQueue* q = static_cast<MockCommandQueue*>(command_queue);
+    if (static_cast<const MockKernel*>(kernel)->program->context != q->context)
+        return CL_INVALID_CONTEXT;
+    if (work_dim == 0 || work_dim > 3)
+        return CL_INVALID_WORK_DIMENSION;
+    if (global_work_size == nullptr)
+        return CL_INVALID_GLOBAL_WORK_SIZE;
+    for (cl_uint i = 0; i < work_dim; i++)
+    {
+        if (global_work_size[i] == 0)
+            return CL_INVALID_GLOBAL_WORK_SIZE;
+        if (local_work_size != nullptr && (local_work_size[i] == 0 ||
+            global_work_size[i] % local_work_size[i] != 0))
+            return CL_INVALID_WORK_GROUP_SIZE;
+    }
+    return mockEnqueueCommand(q, CL_COMMAND_NDRANGE_KERNEL, false,
+                num_events_in_wait_list, event_wait_list, event);
+}
+
+static CL_API_ENTRY void* CL_API_CALL
+mockclGetExtensionFunctionAddress(const char* func_name) CL_API_SUFFIX__VERSION_1_0
+{
+    if (func_name != nullptr && ::strcmp(func_name, "clIcdGetPlatformIDsKHR") == 0)
+        return (void*)mockclIcdGetPlatformIDsKHR;
+    return nullptr;
+}
+
+#ifdef CL_VERSION_1_2
+static CL_API_ENTRY void* CL_API_CALL
+mockclGetExtensionFunctionAddressForPlatform(cl_platform_id platform,
+            const char* func_name) CL_API_SUFFIX__VERSION_1_2
+{
+    if (platform != mockPlatform)
+        return nullptr;
+    return mockclGetExtensionFunctionAddress(func_name);
+}
+#endif
+
+static void mockInitialize()
+{
+    mockCallLatency = parseEnvVariable<cxullong>("CLRX_MOCKCL_CALL_LATENCY", 0);
+    mockBuildLatency = parseEnvVariable<cxullong>("CLRX_MOCKCL_BUILD_LATENCY", 0);
+    mockExecLatency = parseEnvVariable<cxullong>("CLRX_MOCKCL_EXEC_LATENCY", 0);
+    const std::string devicesString = parseEnvVariable<std::string>(
+                "CLRX_MOCKCL_DEVICES", "Pitcairn,Tonga,Fiji");
+
+    std::vector<std::string> deviceNames;
+    for (size_t pos = 0; pos <= devicesString.size(); )
+    {
+        size_t end = devicesString.find(',', pos);
+        if (end == std::string::npos)
+            end = devicesString.size();
+        std::string name = devicesString.substr(pos, end-pos);
+        // trim spaces
+        name.erase(0, name.find_first_not_of(' '));
+        name.erase(name.find_last_not_of(' ')+1);
+        if (!name.empty())
+            deviceNames.push_back(name);
+        pos = end+1;
+    }
+
+    mockDispatch = new CLRXIcdDispatch;
+    std::fill(mockDispatch->entries, mockDispatch->entries + CLRXICD_ENTRIES_NUM, nullptr);
+    mockDispatch->clGetPlatformIDs = mockclGetPlatformIDs;
+    mockDispatch->clGetPlatformInfo = mockclGetPlatformInfo;
+    mockDispatch->clGetDeviceIDs = mockclGetDeviceIDs;
+    mockDispatch->clGetDeviceInfo = mockclGetDeviceInfo;
+    mockDispatch->clCreateContext = mockclCreateContext;
+    mockDispatch->clCreateContextFromType = mockclCreateContextFromType;
+    mockDispatch->clRetainContext = mockclRetainContext;
+    mockDispatch->clReleaseContext = mockclReleaseContext;
+    mockDispatch->clGetContextInfo = mockclGetContextInfo;
+    mockDispatch->clCreateCommandQueue = mockclCreateCommandQueue;
+    mockDispatch->clRetainCommandQueue = mockclRetainCommandQueue;
+    mockDispatch->clReleaseCommandQueue = mockclReleaseCommandQueue;
+    mockDispatch->clGetCommandQueueInfo = mockclGetCommandQueueInfo;
+    mockDispatch->clCreateBuffer = mockclCreateBuffer;
+    mockDispatch->clRetainMemObject = mockclRetainMemObject;
+    mockDispatch->clReleaseMemObject = mockclReleaseMemObject;
+    mockDispatch->clGetMemObjectInfo = mockclGetMemObjectInfo;
+    mockDispatch->clCreateProgramWithSource = mockclCreateProgramWithSource;
+    mockDispatch->clCreateProgramWithBinary = mockclCreateProgramWithBinary;
+    mockDispatch->clRetainProgram = mockclRetainProgram;
+    mockDispatch->clReleaseProgram = mockclReleaseProgram;
+    mockDispatch->clBuildProgram = mockclBuildProgram;
+    mockDispatch->clGetProgramInfo = mockclGetProgramInfo;
+    mockDispatch->clGetProgramBuildInfo = mockclGetProgramBuildInfo;
+    mockDispatch->clCreateKernel = mockclCreateKernel;
+    mockDispatch->clRetainKernel = mockclRetainKernel;
+    mockDispatch->clReleaseKernel = mockclReleaseKernel;
+    mockDispatch->clSetKernelArg = mockclSetKernelArg;
+    mockDispatch->clGetKernelInfo = mockclGetKernelInfo;
+    mockDispatch->clWaitForEvents = mockclWaitForEvents;
+    mockDispatch->clGetEventInfo = mockclGetEventInfo;
+    mockDispatch->clRetainEvent = mockclRetainEvent;
+    mockDispatch->clReleaseEvent = mockclReleaseEvent;
+    mockDispatch->clFlush = mockclFlush;
+    mockDispatch->clFinish = mockclFinish;
+    mockDispatch->clEnqueueReadBuffer = mockclEnqueueReadBuffer;
+    mockDispatch->clEnqueueWriteBuffer = mockclEnqueueWriteBuffer;
+    mockDispatch->clEnqueueNDRangeKernel = mockclEnqueueNDRangeKernel;
+    mockDispatch->clGetExtensionFunctionAddress = mockclGetExtensionFunctionAddress;
+    mockDispatch->clSetEventCallback = mockclSetEventCallback;
+#ifdef CL_VERSION_1_2
+    mockDispatch->clGetExtensionFunctionAddressForPlatform =
+            mockclGetExtensionFunctionAddressForPlatform;
+#endif
+
+    mockPlatform = new MockPlatform;
+    mockPlatform->dispatch = mockDispatch;
+    mockDevicesNum = deviceNames.size();
+    mockDevices = new MockDevice[mockDevicesNum];
+    for (cl_uint i = 0; i < mockDevicesNum; i++)
+    {
+        mockDevices[i].dispatch = mockDispatch;
+        mockDevices[i].name = deviceNames[i];
+    }
+}
+
+/*
+ * exported functions (used by CLRXWrapper and ICD loaders)
+ */
+
+extern "C"
+{
+
+CL_API_ENTRY cl_int CL_API_CALL
+clGetPlatformIDs(cl_uint num_entries, cl_platform_id* platforms,
+            cl_uint* num_platforms) CL_API_SUFFIX__VERSION_1_0
+{
+    std::call_once(mockOnceFlag, mockInitialize);
+    return mockclGetPlatformIDs(num_entries, platforms, num_platforms);
+}
+
+CL_API_ENTRY cl_int CL_API_CALL
+clIcdGetPlatformIDsKHR(cl_uint num_entries, cl_platform_id* platforms,
+            cl_uint* num_platforms) CL_API_SUFFIX__VERSION_1_0
+{
+    std::call_once(mockOnceFlag, mockInitialize);
+    return mockclIcdGetPlatformIDsKHR(num_entries, platforms, num_platforms);
+}
+
+CL_API_ENTRY void* CL_API_CALL
+clGetExtensionFunctionAddress(const char* func_name) CL_API_SUFFIX__VERSION_1_0
+{
+    std::call_once(mockOnceFlag, mockInitialize);
+    return mockclGetExtensionFunctionAddress(func_name);
+}
+
+CL_API_ENTRY CL_EXT_PREFIX__VERSION_1_1_DEPRECATED cl_int CL_API_CALL
+clUnloadCompiler(void) CL_EXT_SUFFIX__VERSION_1_1_DEPRECATED
+{ return CL_SUCCESS; }
+
+}
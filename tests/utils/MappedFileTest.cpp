@@ -0,0 +1,161 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <exception>
+#ifndef HAVE_WINDOWS
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* mappedFilename = "MappedFileTest.bin";
+static const char* emptyFilename = "MappedFileTest.empty";
+
+static void writeFile(const char* filename, const std::string& content)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs.write(content.data(), content.size());
+}
+
+static std::string generateContent(size_t size)
+{
+    std::string content(size, ' ');
+    for (size_t i = 0; i < size; i++)
+        content[i] = char((i*37) ^ (i>>8));
+    return content;
+}
+
+static void testMappedRegularFile()
+{
+    const std::string testName = "testMappedRegularFile";
+    // bigger than single page, size not aligned to page size
+    const std::string content = generateContent(3*4096+123);
+    writeFile(mappedFilename, content);
+    {
+        MappedFile mapped(mappedFilename);
+        assertTrue(testName, "isMapped", mapped.isMapped());
+        assertValue(testName, "size", content.size(), mapped.size());
+        assertTrue(testName, "content", ::memcmp(mapped.data(), content.data(),
+                    content.size()) == 0);
+        // private mapping: changes must not be visible in file
+        mapped.data()[0] ^= 0xff;
+        mapped.data()[content.size()-1] ^= 0xff;
+    }
+    Array<cxbyte> loaded = loadDataFromFile(mappedFilename);
+    assertValue(testName, "fileSize", content.size(), loaded.size());
+    assertTrue(testName, "fileNotChanged", ::memcmp(loaded.data(), content.data(),
+                content.size()) == 0);
+    ::remove(mappedFilename);
+}
+
+static void testMappedEmptyFile()
+{
+    const std::string testName = "testMappedEmptyFile";
+    writeFile(emptyFilename, "");
+    {
+        MappedFile mapped(emptyFilename);
+        assertValue(testName, "size", size_t(0), mapped.size());
+        assertTrue(testName, "notMapped", !mapped.isMapped());
+    }
+    ::remove(emptyFilename);
+}
+
+static void testMappedFileErrors()
+{
+    const std::string testName = "testMappedFileErrors";
+    bool thrown = false;
+    try
+    { MappedFile mapped("MappedFileTest.notexists"); }
+    catch(const Exception& ex)
+    { thrown = true; }
+    assertTrue(testName, "notExists", thrown);
+    thrown = false;
+    try
+    { MappedFile mapped("."); }
+    catch(const Exception& ex)
+    { thrown = true; }
+    assertTrue(testName, "directory", thrown);
+}
+
+#ifndef HAVE_WINDOWS
+static void testMappedFileFromPipe()
+{
+    const std::string testName = "testMappedFileFromPipe";
+    const char* fifoName = "MappedFileTest.fifo";
+    ::remove(fifoName);
+    if (::mkfifo(fifoName, 0600) != 0)
+        throw Exception("Can't create FIFO");
+    // bigger than pipe buffer
+    const std::string content = generateContent(200000);
+    std::thread writer([fifoName, &content]()
+    {
+        const int fd = ::open(fifoName, O_WRONLY);
+        if (fd < 0)
+            return;
+        for (size_t pos = 0; pos < content.size(); )
+        {
+            const ssize_t written = ::write(fd, content.data()+pos, content.size()-pos);
+            if (written <= 0)
+                break;
+            pos += written;
+        }
+        ::close(fd);
+    });
+    std::exception_ptr error;
+    try
+    {
+        MappedFile mapped(fifoName);
+        // pipe is not regular file, hence it must be loaded
+        assertTrue(testName, "notMapped", !mapped.isMapped());
+        assertValue(testName, "size", content.size(), mapped.size());
+        assertTrue(testName, "content", ::memcmp(mapped.data(), content.data(),
+                    content.size()) == 0);
+    }
+    catch(...)
+    { error = std::current_exception(); }
+    writer.join();
+    ::remove(fifoName);
+    if (error)
+        std::rethrow_exception(error);
+}
+#endif
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testMappedRegularFile);
+    retVal |= callTest(testMappedEmptyFile);
+    retVal |= callTest(testMappedFileErrors);
+#ifndef HAVE_WINDOWS
+    retVal |= callTest(testMappedFileFromPipe);
+#endif
+    return retVal;
+}
@@ -0,0 +1,100 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstring>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/MemoryArena.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static void testMemoryArenaReuse()
+{
+    const std::string testName = "testMemoryArenaReuse";
+    MemoryArena arena(65536);
+    // small blocks reused by blocks with same size
+    void* small1 = arena.allocate(40);
+    arena.deallocate(small1, 40);
+    assertTrue(testName, "smallReused", arena.allocate(37) == small1);
+    // medium blocks reused by blocks from same power of two
+    void* medium1 = arena.allocate(600);
+    arena.deallocate(medium1, 600);
+    assertTrue(testName, "mediumReused", arena.allocate(1000) == medium1);
+    void* medium2 = arena.allocate(5000);
+    ::memset(medium2, 0xaa, 8192); // rounded to 8192
+    arena.deallocate(medium2, 5000);
+    assertTrue(testName, "mediumReused2", arena.allocate(8192) == medium2);
+    assertValue(testName, "chunksNum", size_t(1), arena.getChunksNum());
+    
+    // big blocks are returned to heap
+    const size_t sizeBefore = arena.getAllocatedSize();
+    void* big1 = arena.allocate(20000);
+    void* big2 = arena.allocate(100000);
+    ::memset(big1, 0x55, 20000);
+    ::memset(big2, 0x55, 100000);
+    assertTrue(testName, "bigAllocated", arena.getAllocatedSize() > sizeBefore+120000);
+    arena.deallocate(big1, 20000);
+    void* big3 = arena.allocate(30000);
+    arena.deallocate(big2, 100000);
+    arena.deallocate(big3, 30000);
+    assertValue(testName, "bigFreed", sizeBefore, arena.getAllocatedSize());
+    // not freed big block will be freed by destructor
+    arena.allocate(50000);
+}
+
+static void testMemoryArenaBounded()
+{
+    const std::string testName = "testMemoryArenaBounded";
+    MemoryArena arena(65536);
+    std::vector<std::pair<void*, size_t> > blocks;
+    size_t firstAllocatedSize = 0;
+    // many rounds of allocations with this same sizes (as in repetitions)
+    for (cxuint round = 0; round < 200; round++)
+    {
+        uint32_t seed = 12345;
+        for (cxuint i = 0; i < 50; i++)
+        {
+            seed = seed*1103515245U + 12345U;
+            const size_t size = 1 + ((seed>>8) % ((i&3)==0 ? 200000 : 6000));
+            void* ptr = arena.allocate(size);
+            ::memset(ptr, 0, size);
+            blocks.push_back(std::make_pair(ptr, size));
+        }
+        for (const auto& block: blocks)
+            arena.deallocate(block.first, block.second);
+        blocks.clear();
+        if (round == 0)
+            firstAllocatedSize = arena.getAllocatedSize();
+        // memory held by arena does not grow after first round
+        assertValue(testName, "bounded", firstAllocatedSize, arena.getAllocatedSize());
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testMemoryArenaReuse);
+    retVal |= callTest(testMemoryArenaBounded);
+    return retVal;
+}
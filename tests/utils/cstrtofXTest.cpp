@@ -1377,6 +1377,297 @@ static const CStrtofXTestCase cstrtofXTestCases[] =
             0x4c20000000000001ULL },
 };
 
+// parse value, returns false if exception thrown
+static bool parseFloatValue(FloatType type, const std::string& str, uint64_t& result)
+{
+    const char* end;
+    try
+    {
+        switch (type)
+        {
+            case FT_H:
+                result = cstrtohCStyle(str.c_str(), str.c_str()+str.size(), end);
+                break;
+            case FT_F:
+            {
+                FloatUnion resultU;
+                resultU.f = cstrtovCStyle<float>(str.c_str(), str.c_str()+str.size(), end);
+                result = resultU.u;
+                break;
+            }
+            default:
+            {
+                DoubleUnion resultU;
+                resultU.d = cstrtovCStyle<double>(str.c_str(),
+                            str.c_str()+str.size(), end);
+                result = resultU.u;
+                break;
+            }
+        }
+    }
+    catch(const ParseException& ex)
+    { return false; }
+    return true;
+}
+
+/* compare results for values with up to 19 significant digits (fast path)
+ * with results for same values with trailing zeroes (slow path) */
+static void testFastPathRandom(FloatType type, cxint minExp, cxint maxExp)
+{
+    static const char* typeNames[3] = { "half", "float", "double" };
+    uint64_t seed = 0x1234567ULL + type;
+    for (cxuint i = 0; i < 200000; i++)
+    {
+        std::string digits;
+        seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+        const cxuint digitsNum = 1 + (seed>>33)%19;
+        for (cxuint k = 0; k < digitsNum; k++)
+        {
+            seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+            cxuint digit = (seed>>33)%10;
+            // many values with nines and zeroes (near half)
+            if (k != 0 && (seed>>60) >= 12)
+                digit = (seed>>59)&1 ? 9 : 0;
+            if (k == 0 && digit == 0)
+                digit = 1;
+            digits.push_back('0'+digit);
+        }
+        seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+        const cxint exponent = minExp + cxint((seed>>33)%(maxExp-minExp+1));
+        
+        std::ostringstream fastOss, slowOss;
+        fastOss << digits[0] << "." << digits.substr(1) << "e" << exponent;
+        slowOss << digits[0] << "." << digits.substr(1) << "00000000000000000000e" <<
+                exponent;
+        uint64_t fastResult = 0, slowResult = 0;
+        const bool fastGood = parseFloatValue(type, fastOss.str(), fastResult);
+        const bool slowGood = parseFloatValue(type, slowOss.str(), slowResult);
+        if (fastGood != slowGood || fastResult != slowResult)
+        {
+            std::ostringstream oss;
+            oss << "Failed fast path for string='" << fastOss.str() << "' and type=" <<
+                    typeNames[type] << ". Result: 0x" << std::hex <<
+                    fastResult << "(" << fastGood << ")!=0x" << slowResult <<
+                    "(" << slowGood << ")";
+            oss.flush();
+            throw Exception(oss.str());
+        }
+    }
+}
+
+// multiply decimal number (digits in reversed order) by small value
+static void mulDecimal(std::string& revDigits, cxuint mul)
+{
+    cxuint carry = 0;
+    for (char& c: revDigits)
+    {
+        const cxuint v = (c-'0')*mul + carry;
+        c = '0' + v%10;
+        carry = v/10;
+    }
+    for (; carry != 0; carry /= 10)
+        revDigits.push_back('0' + carry%10);
+}
+
+// get exact decimal representation of value*2^power2 (digits and decimal exponent)
+static std::string getExactDecimal(uint64_t value, cxint power2, cxint& decExp)
+{
+    std::string revDigits;
+    do {
+        revDigits.push_back('0' + value%10);
+        value /= 10;
+    } while (value != 0);
+    decExp = 0;
+    for (; power2 > 0; power2--)
+        mulDecimal(revDigits, 2);
+    for (; power2 < 0; power2++, decExp--)
+        mulDecimal(revDigits, 5);
+    return std::string(revDigits.rbegin(), revDigits.rend());
+}
+
+static std::string decimalToString(const std::string& digits, cxint decExp)
+{
+    std::ostringstream oss;
+    oss << digits << "e" << decExp;
+    return oss.str();
+}
+
+/* check all half values and all halves between them (rounding to nearest even) */
+static void testHalfExhaustive()
+{
+    for (cxuint v = 0; v < 0x7bff; v++)
+    {
+        // value and half between value and next value: (2*mantisa+1)*2^(exp-1)
+        const cxuint exponent = v>>10;
+        const uint64_t mantisa = (v&0x3ff) | (exponent!=0 ? 0x400 : 0);
+        const cxint power2 = cxint(exponent!=0 ? exponent : 1) - 25;
+        cxint exactExp, halfExp;
+        const std::string exactDigits = getExactDecimal(mantisa, power2, exactExp);
+        const std::string halfDigits = getExactDecimal(mantisa*2+1, power2-1, halfExp);
+        // slightly above and below half (10*half+1 and 10*half-1)
+        const std::string aboveDigits = halfDigits + "1";
+        std::string belowDigits = halfDigits + "0";
+        size_t pos = belowDigits.size()-1;
+        for (; belowDigits[pos] == '0'; pos--)
+            belowDigits[pos] = '9';
+        belowDigits[pos]--;
+        
+        const std::pair<std::string, uint64_t> cases[4] =
+        {
+            { decimalToString(exactDigits, exactExp), v },
+            { decimalToString(halfDigits, halfExp), (v&1) ? v+1 : v },
+            { decimalToString(aboveDigits, halfExp-1), v+1 },
+            { decimalToString(belowDigits, halfExp-1), v }
+        };
+        for (const auto& testCase: cases)
+        {
+            uint64_t result = 0;
+            if (!parseFloatValue(FT_H, testCase.first, result) ||
+                result != testCase.second)
+            {
+                std::ostringstream oss;
+                oss << "Failed exhaustive half for string='" << testCase.first <<
+                        "'. Result: 0x" << std::hex << testCase.second << "!=0x" <<
+                        result;
+                oss.flush();
+                throw Exception(oss.str());
+            }
+        }
+    }
+}
+
+struct FXtocstrTestCase
+{
+    FloatType type;
+    uint64_t value;
+    bool scientific;
+    const char* expected;
+};
+
+static const FXtocstrTestCase fXtocstrTestCases[] =
+{
+    { FT_H, 0x3c00, false, "1" },
+    { FT_H, 0x3c00, true, "1e+0" },
+    { FT_H, 0x3d4c, false, "1.324" },
+    { FT_H, 0x3555, false, "0.3333" },
+    { FT_H, 0x6400, false, "1024" },
+    { FT_H, 0x7000, false, "8190" },
+    { FT_H, 0x7bff, false, "6.55e+4" },
+    { FT_H, 0x0001, false, "6e-8" },
+    { FT_H, 0x8000, true, "-0e+0" },
+    { FT_H, 0x7c00, false, "inf" },
+    { FT_F, 0x00000011U, false, "2.4e-44" },
+    { FT_F, 0x00000001U, false, "1e-45" },
+    { FT_F, 0x3eaaaaabU, false, "0.33333334" },
+    { FT_F, 0x3eaaaaabU, true, "3.3333334e-1" },
+    { FT_F, 0x4cebc0deU, false, "123602670" },
+    { FT_F, 0x4e6e6b28U, false, "1e+9" },
+    { FT_F, 0x3727c5acU, false, "0.00001" },
+    { FT_F, 0x358637bdU, false, "1e-6" },
+    { FT_F, 0x7f7fffffU, false, "3.4028235e+38" },
+    { FT_F, 0xc0200000U, false, "-2.5" },
+    { FT_D, 0x3fd5555555555555ULL, false, "0.3333333333333333" },
+    { FT_D, 0x3fb999999999999aULL, false, "0.1" },
+    { FT_D, 0x4376345785d8a000ULL, false, "100000000000000000" },
+    { FT_D, 0x43abc16d674ec800ULL, false, "1e+18" },
+    { FT_D, 0x0000000000000001ULL, false, "5e-324" },
+    { FT_D, 0x7fefffffffffffffULL, false, "1.7976931348623157e+308" },
+    { FT_D, 0x3ff0000000000001ULL, true, "1.0000000000000002e+0" },
+    { FT_D, 0x44b52d02c7e14af6ULL, false, "1e+23" }
+};
+
+static std::string formatFloatValue(FloatType type, uint64_t value, bool scientific)
+{
+    char buf[32];
+    switch (type)
+    {
+        case FT_H:
+            htocstrCStyle(value, buf, 32, scientific);
+            break;
+        case FT_F:
+        {
+            FloatUnion valueU;
+            valueU.u = value;
+            ftocstrCStyle(valueU.f, buf, 32, scientific);
+            break;
+        }
+        default:
+        {
+            DoubleUnion valueU;
+            valueU.u = value;
+            dtocstrCStyle(valueU.d, buf, 32, scientific);
+            break;
+        }
+    }
+    return buf;
+}
+
+static void testFXtocstr(cxuint testId, const FXtocstrTestCase& testCase)
+{
+    const std::string result = formatFloatValue(testCase.type, testCase.value,
+                testCase.scientific);
+    if (result != testCase.expected)
+    {
+        std::ostringstream oss;
+        oss << "Failed formatting for #" << testId << " with value=0x" << std::hex <<
+                testCase.value << ". Result: '" << testCase.expected << "'!='" <<
+                result << "'";
+        oss.flush();
+        throw Exception(oss.str());
+    }
+}
+
+/* check whether all half values are printed with shortest number of digits
+ * that gives same value after parsing */
+static void testHalfShortestExhaustive()
+{
+    for (cxuint v = 1; v < 0x7c00; v++)
+    {
+        const std::string formatted = formatFloatValue(FT_H, v, true);
+        uint64_t result = 0;
+        if (!parseFloatValue(FT_H, formatted, result) || result != v)
+        {
+            std::ostringstream oss;
+            oss << "Failed half tripping for value=0x" << std::hex << v <<
+                    " and string='" << formatted << "'. Result: 0x" << result;
+            oss.flush();
+            throw Exception(oss.str());
+        }
+        const size_t digitsNum = formatted.find('e') - (formatted.size() > 1 &&
+                    formatted[1] == '.');
+        if (digitsNum == 1)
+            continue;
+        // exact value truncated and rounded up to one digit fewer
+        const cxuint exponent = v>>10;
+        const uint64_t mantisa = (v&0x3ff) | (exponent!=0 ? 0x400 : 0);
+        cxint exactExp;
+        const std::string exactDigits = getExactDecimal(mantisa,
+                    cxint(exponent!=0 ? exponent : 1) - 25, exactExp);
+        const cxint shorterExp = exactExp + cxint(exactDigits.size()-digitsNum+1);
+        std::string truncDigits = exactDigits.substr(0, digitsNum-1);
+        std::string roundUpDigits = truncDigits;
+        size_t pos = roundUpDigits.size();
+        for (; pos > 0 && roundUpDigits[pos-1] == '9'; pos--)
+            roundUpDigits[pos-1] = '0';
+        if (pos == 0)
+            roundUpDigits.insert(roundUpDigits.begin(), '1');
+        else
+            roundUpDigits[pos-1]++;
+        
+        for (const std::string& digits: { truncDigits, roundUpDigits })
+            if (parseFloatValue(FT_H, decimalToString(digits, shorterExp), result) &&
+                result == v)
+            {
+                std::ostringstream oss;
+                oss << "Failed half shortest for value=0x" << std::hex << v <<
+                        " and string='" << formatted << "'. Shorter: '" <<
+                        decimalToString(digits, shorterExp) << "'";
+                oss.flush();
+                throw Exception(oss.str());
+            }
+    }
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -1396,5 +1687,32 @@ int main(int argc, const char** argv)
             std::cerr << ex.what() << std::endl;
             retVal = 1;
         }
+    try
+    {
+        testFastPathRandom(FT_H, -9, 5);
+        testFastPathRandom(FT_F, -47, 39);
+        testFastPathRandom(FT_D, -325, 309);
+        testHalfExhaustive();
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    for (cxuint i = 0; i < sizeof(fXtocstrTestCases)/sizeof(FXtocstrTestCase); i++)
+        try
+        { testFXtocstr(i, fXtocstrTestCases[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    try
+    { testHalfShortestExhaustive(); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
     return retVal;
 }
@@ -290,3 +290,8 @@ VectorIOStream::VectorIOStream(std::vector<char>& vector)
 {
     rdbuf(&buffer);
 }
+
+void FastOutputBuffer::throwMemoryOverflow()
+{
+    throw Exception("FastOutputBuffer: Output memory overflow");
+}
@@ -0,0 +1,107 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <cstddef>
+#include <algorithm>
+#include <CLRX/utils/MemoryArena.h>
+
+using namespace CLRX;
+
+MemoryArena::MemoryArena(size_t _chunkSize) : chunkSize(alignSize(_chunkSize)),
+        maxMediumSize(0), chunks(nullptr), bigBlocks(nullptr), current(nullptr),
+        end(nullptr), allocationsNum(0), chunksNum(0), allocatedSize(0)
+{
+    std::fill(freeLists, freeLists + maxReusedSize/alignment, nullptr);
+    std::fill(mediumFreeLists, mediumFreeLists + mediumListsNum, nullptr);
+    // medium blocks are allocated from chunks
+    size_t classSize = maxReusedSize<<1;
+    for (cxuint i = 0; i < mediumListsNum && classSize <= (chunkSize>>2);
+                i++, classSize <<= 1)
+        maxMediumSize = classSize;
+}
+
+MemoryArena::~MemoryArena()
+{
+    while (chunks != nullptr)
+    {
+        Chunk* next = chunks->next;
+        delete[] reinterpret_cast<FreeBlock*>(chunks);
+        chunks = next;
+    }
+    while (bigBlocks != nullptr)
+    {
+        BigBlock* next = bigBlocks->next;
+        delete[] reinterpret_cast<FreeBlock*>(bigBlocks);
+        bigBlocks = next;
+    }
+}
+
+void* MemoryArena::allocateSlow(size_t size)
+{
+    const size_t headerSize = alignSize(sizeof(Chunk));
+    // blocks greater than quarter of chunk are held in separate chunks
+    const bool bigBlock = (size > (chunkSize>>2));
+    const size_t dataSize = bigBlock ? size : chunkSize;
+    // allocate as FreeBlock array to get properly aligned memory
+    FreeBlock* chunkData = new FreeBlock[(headerSize + dataSize) / sizeof(FreeBlock)];
+    Chunk* chunk = reinterpret_cast<Chunk*>(chunkData);
+    chunk->next = chunks;
+    chunk->size = dataSize;
+    chunks = chunk;
+    chunksNum++;
+    allocatedSize += headerSize + dataSize;
+    
+    cxbyte* data = reinterpret_cast<cxbyte*>(chunkData) + headerSize;
+    if (bigBlock)
+        return data;
+    current = data + size;
+    end = data + dataSize;
+    return data;
+}
+
+void* MemoryArena::allocateBig(size_t size)
+{
+    const size_t headerSize = alignSize(sizeof(BigBlock));
+    FreeBlock* blockData = new FreeBlock[(headerSize + size) / sizeof(FreeBlock)];
+    BigBlock* block = reinterpret_cast<BigBlock*>(blockData);
+    block->prev = nullptr;
+    block->next = bigBlocks;
+    block->size = headerSize + size;
+    if (bigBlocks != nullptr)
+        bigBlocks->prev = block;
+    bigBlocks = block;
+    allocatedSize += headerSize + size;
+    return reinterpret_cast<cxbyte*>(blockData) + headerSize;
+}
+
+void MemoryArena::deallocateBig(void* ptr)
+{
+    const size_t headerSize = alignSize(sizeof(BigBlock));
+    BigBlock* block = reinterpret_cast<BigBlock*>(
+                reinterpret_cast<cxbyte*>(ptr) - headerSize);
+    if (block->prev != nullptr)
+        block->prev->next = block->next;
+    else
+        bigBlocks = block->next;
+    if (block->next != nullptr)
+        block->next->prev = block->prev;
+    allocatedSize -= block->size;
+    delete[] reinterpret_cast<FreeBlock*>(block);
+}
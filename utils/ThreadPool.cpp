@@ -0,0 +1,144 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2016 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <CLRX/utils/ThreadPool.h>
+
+using namespace CLRX;
+
+ThreadPool::ThreadPool(cxuint threadsNum) : task(nullptr), tasksNum(0), nextTask(0),
+        busyWorkers(0), generation(0), stopping(false), exceptionIndex(SIZE_MAX)
+{
+    if (threadsNum == 0)
+        threadsNum = getHardwareThreadsNum();
+    threads.reserve(threadsNum-1);
+    for (cxuint i = 1; i < threadsNum; i++)
+        threads.push_back(std::thread(&ThreadPool::workerRoutine, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workCond.notify_all();
+    for (std::thread& thread: threads)
+        thread.join();
+}
+
+cxuint ThreadPool::getHardwareThreadsNum()
+{
+    const cxuint threadsNum = std::thread::hardware_concurrency();
+    return (threadsNum != 0) ? threadsNum : 1;
+}
+
+void ThreadPool::runTasks(cxuint threadsNum, size_t tasksNum,
+            const std::function<void(size_t)>& task)
+{
+    if (threadsNum == 0)
+        threadsNum = getHardwareThreadsNum();
+    if (threadsNum == 1 || tasksNum < 2)
+    {   // serial mode
+        for (size_t i = 0; i < tasksNum; i++)
+            task(i);
+        return;
+    }
+    ThreadPool threadPool(std::min(size_t(threadsNum), tasksNum));
+    threadPool.run(tasksNum, task);
+}
+
+void ThreadPool::executeTasks(const std::function<void(size_t)>& curTask,
+                size_t curTasksNum)
+{
+    while (true)
+    {
+        const size_t index = nextTask.fetch_add(1);
+        if (index >= curTasksNum)
+            break;
+        try
+        { curTask(index); }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (index < exceptionIndex)
+            {   // keep exception from first task
+                exception = std::current_exception();
+                exceptionIndex = index;
+            }
+        }
+    }
+}
+
+void ThreadPool::workerRoutine()
+{
+    uint64_t lastGeneration = 0;
+    while (true)
+    {
+        const std::function<void(size_t)>* curTask;
+        size_t curTasksNum;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workCond.wait(lock, [this, lastGeneration]
+                    { return stopping || generation != lastGeneration; });
+            if (stopping)
+                return;
+            lastGeneration = generation;
+            if (task == nullptr)
+                continue; // run already finished
+            curTask = task;
+            curTasksNum = tasksNum;
+            busyWorkers++;
+        }
+        executeTasks(*curTask, curTasksNum);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        doneCond.notify_all();
+    }
+}
+
+void ThreadPool::run(size_t inTasksNum, const std::function<void(size_t)>& inTask)
+{
+    std::lock_guard<std::mutex> runLock(runMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &inTask;
+        tasksNum = inTasksNum;
+        nextTask.store(0);
+        exception = std::exception_ptr();
+        exceptionIndex = SIZE_MAX;
+        generation++;
+    }
+    workCond.notify_all();
+    executeTasks(inTask, inTasksNum);
+    std::exception_ptr toRethrow;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        // wait until all tasks finished
+        doneCond.wait(lock, [this] { return busyWorkers == 0; });
+        task = nullptr;
+        toRethrow = exception;
+        exception = std::exception_ptr();
+    }
+    if (toRethrow)
+        std::rethrow_exception(toRethrow);
+}
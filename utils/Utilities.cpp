@@ -28,9 +28,12 @@
 #else
 #include <pwd.h>
 #include <unistd.h>
+#include <dirent.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #endif
 #include <fstream>
+#include <algorithm>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <mutex>
@@ -442,6 +445,120 @@ Array<cxbyte> CLRX::loadDataFromFile(const char* filename)
     return buf;
 }
 
+MappedFile::MappedFile(const char* filename) : dataSize(0), mappedData(nullptr)
+#ifdef HAVE_WINDOWS
+        , mapHandle(nullptr)
+#endif
+{
+    if (isDirectory(filename))
+        throw Exception("This is directory!");
+#ifdef HAVE_WINDOWS
+    HANDLE fileHandle = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        throw Exception("Can't open file");
+    LARGE_INTEGER fileSize;
+    if (GetFileType(fileHandle) != FILE_TYPE_DISK ||
+        !GetFileSizeEx(fileHandle, &fileSize))
+    {   // not regular file
+        CloseHandle(fileHandle);
+        loadedData = loadDataFromFile(filename);
+        dataSize = loadedData.size();
+        return;
+    }
+    if (uint64_t(fileSize.QuadPart) > SIZE_MAX)
+    {
+        CloseHandle(fileHandle);
+        throw Exception("File is too big to map");
+    }
+    dataSize = fileSize.QuadPart;
+    if (dataSize == 0)
+    {   // empty file can not be mapped
+        CloseHandle(fileHandle);
+        return;
+    }
+    mapHandle = CreateFileMapping(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(fileHandle);
+    if (mapHandle == nullptr)
+        throw Exception("Can't map file");
+    mappedData = (cxbyte*)MapViewOfFile(mapHandle, FILE_MAP_COPY, 0, 0, 0);
+    if (mappedData == nullptr)
+    {
+        CloseHandle(mapHandle);
+        throw Exception("Can't map file");
+    }
+#else
+    int fd = ::open(filename, O_RDONLY);
+    if (fd == -1)
+        throw Exception("Can't open file");
+    struct stat stBuf;
+    if (::fstat(fd, &stBuf) != 0 || !S_ISREG(stBuf.st_mode))
+    {   /* not regular file: read from already opened descriptor,
+         * because reopening pipe loses data written between opens */
+        size_t readBufSize = 256;
+        try
+        {
+            loadedData.resize(readBufSize);
+            while (true)
+            {
+                const ssize_t readed = ::read(fd, loadedData.data()+dataSize,
+                            readBufSize-dataSize);
+                if (readed < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw Exception("Can't read file");
+                }
+                if (readed == 0)
+                    break;
+                dataSize += readed;
+                if (dataSize == readBufSize)
+                {   // grow buffer
+                    readBufSize = (readBufSize<<1) + 1;
+                    loadedData.resize(readBufSize);
+                }
+            }
+        }
+        catch(...)
+        {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+        loadedData.resize(dataSize);
+        return;
+    }
+    if (uint64_t(stBuf.st_size) > SIZE_MAX)
+    {
+        ::close(fd);
+        throw Exception("File is too big to map");
+    }
+    dataSize = stBuf.st_size;
+    if (dataSize == 0)
+    {   // empty file can not be mapped
+        ::close(fd);
+        return;
+    }
+    void* ptr = ::mmap(nullptr, dataSize, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED)
+        throw Exception("Can't map file");
+    mappedData = (cxbyte*)ptr;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    if (mappedData == nullptr)
+        return;
+#ifdef HAVE_WINDOWS
+    UnmapViewOfFile(mappedData);
+    CloseHandle(mapHandle);
+#else
+    ::munmap(mappedData, dataSize);
+#endif
+}
+
 void CLRX::filesystemPath(char* path)
 {
     while (*path != 0)  // change to native dir separator
@@ -477,6 +594,11 @@ std::string CLRX::joinPaths(const std::string& path1, const std::string& path2)
 }
 
 uint64_t CLRX::getFileTimestamp(const char* filename)
+{
+    return getFileStatus(filename).timestamp;
+}
+
+FileStatus CLRX::getFileStatus(const char* filename)
 {
     struct stat stBuf;
     errno = 0;
@@ -489,11 +611,16 @@ uint64_t CLRX::getFileTimestamp(const char* filename)
         else
             throw Exception("Can't determine whether path refers to directory");
     }
+    FileStatus status;
 #if _POSIX_C_SOURCE>=200800L
-    return stBuf.st_mtim.tv_sec*1000000000ULL + stBuf.st_mtim.tv_nsec;
+    status.timestamp = stBuf.st_mtim.tv_sec*1000000000ULL + stBuf.st_mtim.tv_nsec;
 #else
-    return stBuf.st_mtime*1000000000ULL;
+    status.timestamp = stBuf.st_mtime*1000000000ULL;
 #endif
+    status.size = stBuf.st_size;
+    status.inode = stBuf.st_ino;
+    status.device = stBuf.st_dev;
+    return status;
 }
 
 std::string CLRX::getHomeDir()
@@ -541,3 +668,43 @@ void CLRX::makeDir(const char* dirname)
             throw Exception("Can't create directory");
     }
 }
+
+std::vector<std::string> CLRX::listDirectory(const char* dirname)
+{
+    std::vector<std::string> names;
+#ifdef HAVE_WINDOWS
+    WIN32_FIND_DATA findData;
+    const std::string pattern = joinPaths(dirname, "*");
+    HANDLE handle = FindFirstFile(pattern.c_str(), &findData);
+    if (handle == INVALID_HANDLE_VALUE)
+        throw Exception("Can't open directory");
+    do {
+        if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+            names.push_back(findData.cFileName);
+    } while (FindNextFile(handle, &findData));
+    FindClose(handle);
+#else
+    DIR* dir = ::opendir(dirname);
+    if (dir == nullptr)
+        throw Exception("Can't open directory");
+    try
+    {
+        struct dirent* entry;
+        while ((entry = ::readdir(dir)) != nullptr)
+        {
+            const std::string path = joinPaths(dirname, entry->d_name);
+            struct stat stBuf;
+            if (::stat(path.c_str(), &stBuf) == 0 && S_ISREG(stBuf.st_mode))
+                names.push_back(entry->d_name);
+        }
+    }
+    catch(...)
+    {
+        ::closedir(dir);
+        throw;
+    }
+    ::closedir(dir);
+#endif
+    std::sort(names.begin(), names.end());
+    return names;
+}